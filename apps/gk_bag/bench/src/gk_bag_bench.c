@@ -0,0 +1,837 @@
+#include "gk_bag.h"
+#include "gk_trace.h"
+#include "gk_filter.h"
+#include "gk_fixed.h"
+#include "gk_recorder.h"
+#include "gk_punch_classifier.h"
+#include "gk_drill.h"
+#include "gk_punch_train.h"
+#include "tal_log.h"
+#include "tkl_output.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+
+// 主机端回放/基准测试: 在Ubuntu板上运行gk_bag的采集处理链路
+// 数据源为合成数据 (带打击点真值) 或gkrec导出的会话文件
+
+#define BENCH_DEFAULT_SECONDS   600     // 默认合成10分钟数据
+#define BENCH_DEFAULT_HIT_RATE  2.0f    // 合成数据的平均打击频率 (次/秒)
+#define BENCH_STAGE_SAMPLES     200000  // 定点/浮点分阶段对比的样本数
+#define BENCH_MAX_HITS          65536
+#define BENCH_CLASSIFY_PUNCHES  2000    // 拳法分类评估的打击数
+#define BENCH_BAG_SAMPLES       60000   // 多沙袋对比中每个沙袋的样本数
+#define BENCH_MAX_LABELS        8192    // 会话标注文件的最大打击数
+#define BENCH_LABEL_TOL_MS      60      // 标注的起始时刻与回放估计的起始时刻的最大偏差
+#define BENCH_DEFAULT_MAX_ERR_CM 1.5f   // 默认的平均定位误差门限 (cm)，-e 0关闭
+#define BENCH_DRILL_FLUSH_US    16700   // 提示上屏到送显完成的延迟 (一帧)，刻意不与采样周期对齐
+#define BENCH_DRILL_REACT_MIN_MS 150     // 合成反应时间范围，在速度训练的提示时间窗之内
+#define BENCH_DRILL_REACT_MAX_MS 450
+
+// 完整链路合成数据的传感器偏差，使其与求解器的模型不完全一致 (-i关闭)
+#define BENCH_NOISE_LEVEL       0.5f    // 每通道噪声峰峰值 (N / N·m)
+#define BENCH_GAIN_ERROR        0.02f   // 通道增益误差 ±2%
+#define BENCH_CROSSTALK         0.01f   // 通道间串扰 ±1%
+#define BENCH_MOUNT_ERROR       0.005f  // 安装偏移误差 ±5mm
+#define BENCH_RADIUS_ERROR      0.01f   // 接触点半径偏差 ±1cm
+
+// 定点/浮点一致性门限，超出时返回1
+#define BENCH_TOL_CAL           1.0e-4f // 校准输出 (N / N·m)，主要来自零点取整到半个计数
+#define BENCH_TOL_FILTER        1.0e-3f // 滤波器组输出 (N / N·m)
+#define BENCH_TOL_SOLVER_CM     0.01f   // 接触点 (cm)，含满量程输入的预缩放
+#define BENCH_TOL_REACTION_US   1000    // 反应时间 (us)，训练计划按1ms的精度报告
+// ADS131M06的计数换算 (与force_sensor.c一致)，校准对比在其满量程±2^23计数内进行
+#define BENCH_ADS_FORCE_LSB     1.0e-4f
+#define BENCH_ADS_TORQUE_LSB    1.0e-5f
+#define BENCH_ADS_FULL_SCALE    ((1 << 23) - 1)
+
+#ifdef FORCE_SENSOR_MAX_BAGS
+#define BENCH_MAX_BAGS          FORCE_SENSOR_MAX_BAGS
+#else
+#define BENCH_MAX_BAGS          1
+#endif
+
+#ifdef FORCE_SENSOR_SAMPLE_RATE
+#define BENCH_SAMPLE_RATE_HZ    FORCE_SENSOR_SAMPLE_RATE
+#else
+#define BENCH_SAMPLE_RATE_HZ    1000
+#endif
+#ifdef FORCE_DETECTION_THRESHOLD
+#define BENCH_THRESHOLD         ((float)FORCE_DETECTION_THRESHOLD)
+#else
+#define BENCH_THRESHOLD         5.0f
+#endif
+#if defined(FORCE_SENSOR_FIXED_POINT) && (FORCE_SENSOR_FIXED_POINT == 1)
+#define BENCH_PIPELINE_NAME     "fixed"
+#define BENCH_FLOAT_SOLVER      0
+#else
+#define BENCH_PIPELINE_NAME     "float"
+#define BENCH_FLOAT_SOLVER      1   // gk_calculate_hit_point为浮点实现，可与定点求解器对比
+#endif
+
+typedef struct {
+    uint32_t samples;
+    uint32_t seed;
+    float hit_rate;
+    float max_err_cm;           // >0时作为回归门限: 平均定位误差超出则返回1
+    bool ideal;                 // 合成数据与求解器模型完全一致，只有默认噪声
+    float min_accuracy;         // >0时作为回归门限: 拳法分类准确率 (%) 低于此值则返回1
+    const char* file;
+    const char* labels;         // 与file配合: 拳法标注文件，按标注评估分类准确率
+    const char* train_out;      // 非NULL时训练拳法分类器并写出模型源文件
+    bool verbose;
+} bench_opts_t;
+
+// .gkr会话文件回放源
+typedef struct {
+    FILE* fp;
+    uint8_t block[GK_REC_BLOCK_SIZE];
+    gk_rec_sample_t samples[GK_REC_BLOCK_SIZE / GK_REC_CHANNELS];
+    int count;
+    int pos;
+    uint32_t sample_rate_hz;
+    uint32_t bad_blocks;
+    const gk_rec_sample_t* last;  // 最近一次读出的记录，用于对比记录的滤波结果
+} bench_file_t;
+
+// 会话的拳法标注: 每行 "time_ms,type"，time_ms为会话记录中打击起始的时刻，type为gk_punch_type_name的名称
+typedef struct {
+    uint32_t time_ms;
+    gk_punch_type_t type;
+    bool used;
+} bench_label_t;
+
+typedef struct {
+    bench_label_t items[BENCH_MAX_LABELS];
+    uint32_t count;
+    uint32_t matched;
+    uint32_t correct;
+    uint32_t unlabeled;         // 没有对应标注的打击
+    uint32_t confusion[GK_PUNCH_CLASSES][GK_PUNCH_CLASSES];
+} bench_labels_t;
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_file_read(void* ctx, float raw[6])
+{
+    bench_file_t* f = (bench_file_t*)ctx;
+
+    while (f->pos >= f->count) {
+        if (fread(f->block, 1, GK_REC_BLOCK_SIZE, f->fp) != GK_REC_BLOCK_SIZE) {
+            return OPRT_NOT_FOUND;
+        }
+        int count = gk_rec_decode_block(f->block, GK_REC_BLOCK_SIZE, f->samples, (int)CNTSOF(f->samples));
+        if (count < 0) {
+            f->bad_blocks++;
+            continue;
+        }
+        if (f->sample_rate_hz == 0) {
+            gk_rec_block_hdr_t hdr;
+            memcpy(&hdr, f->block, sizeof(hdr));
+            f->sample_rate_hz = hdr.sample_rate_hz;
+        }
+        f->count = count;
+        f->pos = 0;
+    }
+
+    f->last = &f->samples[f->pos++];
+    for (int i = 0; i < 6; i++) {
+        raw[i] = GK_Q16_TO_FLOAT(f->last->raw[i]);
+    }
+    return OPRT_OK;
+}
+
+static int bench_labels_load(const char* path, bench_labels_t* labels)
+{
+    char line[64];
+    char name[16];
+    unsigned int time_ms;
+    FILE* fp = fopen(path, "r");
+
+    if (!fp) {
+        printf("cannot open %s\n", path);
+        return OPRT_NOT_FOUND;
+    }
+    memset(labels, 0, sizeof(bench_labels_t));
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || sscanf(line, "%u,%15[a-z]", &time_ms, name) != 2) {
+            continue; // 注释、表头或空行
+        }
+        int t = GK_PUNCH_JAB;
+        while (t < GK_PUNCH_TYPE_MAX && strcmp(name, gk_punch_type_name((gk_punch_type_t)t)) != 0) {
+            t++;
+        }
+        if (t == GK_PUNCH_TYPE_MAX || labels->count == BENCH_MAX_LABELS) {
+            printf("%s: bad label line: %s", path, line);
+            fclose(fp);
+            return OPRT_INVALID_PARM;
+        }
+        labels->items[labels->count].time_ms = time_ms;
+        labels->items[labels->count].type = (gk_punch_type_t)t;
+        labels->count++;
+    }
+    fclose(fp);
+    return (labels->count > 0) ? OPRT_OK : OPRT_NOT_FOUND;
+}
+
+// 按起始时刻找最近的未使用标注，并计入混淆矩阵
+static void bench_labels_match(bench_labels_t* labels, uint32_t onset_ms, gk_punch_type_t type)
+{
+    bench_label_t* best = NULL;
+    uint32_t best_dt = BENCH_LABEL_TOL_MS + 1;
+
+    for (uint32_t i = 0; i < labels->count; i++) {
+        bench_label_t* l = &labels->items[i];
+        uint32_t dt = (l->time_ms > onset_ms) ? l->time_ms - onset_ms : onset_ms - l->time_ms;
+        if (!l->used && dt < best_dt) {
+            best = l;
+            best_dt = dt;
+        }
+    }
+    if (!best) {
+        labels->unlabeled++;
+        return;
+    }
+
+    best->used = true;
+    labels->matched++;
+    if (type >= GK_PUNCH_JAB && type < GK_PUNCH_TYPE_MAX) {
+        labels->confusion[best->type - GK_PUNCH_JAB][type - GK_PUNCH_JAB]++;
+        labels->correct += (type == best->type);
+    }
+}
+
+static void bench_print_confusion(uint32_t confusion[GK_PUNCH_CLASSES][GK_PUNCH_CLASSES])
+{
+    printf("confusion    truth \\ predicted\n");
+    for (int t = 0; t < GK_PUNCH_CLASSES; t++) {
+        printf("  %-9s ", gk_punch_type_name((gk_punch_type_t)(GK_PUNCH_JAB + t)));
+        for (int p = 0; p < GK_PUNCH_CLASSES; p++) {
+            printf(" %5u", (unsigned int)confusion[t][p]);
+        }
+        printf("\n");
+    }
+}
+
+static bool bench_check_accuracy(const bench_opts_t* opts, float accuracy)
+{
+    if (opts->min_accuracy > 0.0f && accuracy < opts->min_accuracy) {
+        printf("FAIL: punch classification accuracy %.1f%% < %.1f%%\n", accuracy, opts->min_accuracy);
+        return false;
+    }
+    return true;
+}
+
+static int bench_cmp_float(const void* a, const void* b)
+{
+    float fa = *(const float*)a;
+    float fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// 完整链路: gk_sensor_read_data (数据源 -> 校准 -> 滤波) + gk_sensor_detect_punch (分段 + 打击点求解)
+static int bench_pipeline(const bench_opts_t* opts)
+{
+    static gk_trace_synth_t synth;
+    static bench_file_t file;
+    static bench_labels_t labels;
+    static float errors[BENCH_MAX_HITS];
+    uint32_t rate = BENCH_SAMPLE_RATE_HZ;
+
+    if (opts->labels && bench_labels_load(opts->labels, &labels) != OPRT_OK) {
+        return OPRT_INVALID_PARM;
+    }
+
+    gk_sensor_init();
+    if (opts->file) {
+        memset(&file, 0, sizeof(file));
+        file.fp = fopen(opts->file, "rb");
+        if (!file.fp) {
+            printf("cannot open %s\n", opts->file);
+            return OPRT_NOT_FOUND;
+        }
+        gk_sensor_set_source(bench_file_read, &file);
+    } else {
+        gk_trace_synth_cfg_t cfg = GK_TRACE_SYNTH_DEFAULT(rate);
+        cfg.seed = opts->seed;
+        cfg.hits_per_second = opts->hit_rate;
+        if (!opts->ideal) {
+            cfg.noise_level = BENCH_NOISE_LEVEL;
+            cfg.gain_error = BENCH_GAIN_ERROR;
+            cfg.crosstalk = BENCH_CROSSTALK;
+            cfg.mount_error = BENCH_MOUNT_ERROR;
+            cfg.radius_error = BENCH_RADIUS_ERROR;
+        }
+        gk_trace_synth_init(&synth, &cfg);
+        gk_sensor_set_source(gk_trace_synth_read, &synth);
+    }
+
+    uint32_t n = 0, hits = 0, matched = 0, false_hits = 0, last_truth = 0;
+    uint32_t types[GK_PUNCH_TYPE_MAX] = {0};
+    float filt_diff = 0.0f;
+    double residual_sum = 0.0;
+    gk_force_data_t frame;
+    gk_punch_event_t event;
+
+    uint64_t t0 = bench_now_ns();
+    while (n < opts->samples && gk_sensor_read_data(&frame) == OPRT_OK) {
+        n++;
+        if (opts->file && file.last) {
+            const float* f = &frame.fx;
+            for (int i = 0; i < 6; i++) {
+                float d = fabsf(f[i] - GK_Q16_TO_FLOAT(file.last->filtered[i]));
+                filt_diff = (d > filt_diff) ? d : filt_diff;
+            }
+        }
+        if (gk_sensor_detect_punch(&frame, &event) != OPRT_OK) {
+            continue;
+        }
+        hits++;
+        residual_sum += event.hit.residual;
+        types[(event.type < GK_PUNCH_TYPE_MAX) ? event.type : GK_PUNCH_UNKNOWN]++;
+
+        if (opts->labels && file.last) {
+            // 释放时刻减去持续时间和滤波器组的群延迟，即原始数据中打击起始的时刻
+            uint32_t delay_ms = GK_FILTER_DELAY_SAMPLES * 1000u / (file.sample_rate_hz ? file.sample_rate_hz : rate);
+            uint32_t onset_ms = file.last->time_ms - (uint32_t)lroundf(event.duration_ms) - delay_ms;
+            bench_labels_match(&labels, onset_ms, event.type);
+        }
+
+        gk_trace_truth_t truth;
+        if (opts->file || !gk_trace_synth_truth(&synth, &truth)) {
+            continue;
+        }
+        if (truth.index == last_truth) {
+            false_hits++; // 同一次打击被分成了多个事件
+            continue;
+        }
+        last_truth = truth.index;
+        if (matched < BENCH_MAX_HITS) {
+            errors[matched] = hypotf(event.hit.x - truth.x, event.hit.y - truth.y);
+        }
+        matched++;
+    }
+    uint64_t elapsed = bench_now_ns() - t0;
+
+    if (opts->file) {
+        rate = file.sample_rate_hz ? file.sample_rate_hz : rate;
+        fclose(file.fp);
+    }
+    gk_sensor_set_source(NULL, NULL);
+
+    if (n == 0) {
+        printf("no samples\n");
+        return OPRT_NOT_FOUND;
+    }
+
+    float trace_s = (float)n / rate;
+    printf("== pipeline (%s%s) ==\n", BENCH_PIPELINE_NAME,
+           opts->file ? ", replay" : (opts->ideal ? ", ideal model" : ", model mismatch"));
+    printf("samples      %u (%.1f s @ %u Hz)\n", (unsigned int)n, trace_s, (unsigned int)rate);
+    printf("ns/sample    %.1f\n", (double)elapsed / n);
+    printf("hits         %u (%.3f hits/s)\n", (unsigned int)hits, hits / trace_s);
+    if (hits > 0) {
+        printf("residual cm  mean %.3f\n", residual_sum / hits);
+        printf("types       ");
+        for (int t = 0; t < GK_PUNCH_TYPE_MAX; t++) {
+            printf(" %s %u", gk_punch_type_name((gk_punch_type_t)t), (unsigned int)types[t]);
+        }
+        printf("\n");
+    }
+
+    if (opts->file) {
+        printf("bad blocks   %u\n", (unsigned int)file.bad_blocks);
+        printf("filter diff  %.4f N (max vs recorded filtered frames)\n", filt_diff);
+        if (!opts->labels) {
+            return OPRT_OK;
+        }
+
+        float accuracy = labels.matched ? 100.0f * labels.correct / labels.matched : 0.0f;
+        printf("== classifier (labeled session, %u labels) ==\n", (unsigned int)labels.count);
+        printf("matched      %u, missed %u, unlabeled hits %u\n", (unsigned int)labels.matched,
+               (unsigned int)(labels.count - labels.matched), (unsigned int)labels.unlabeled);
+        printf("accuracy     %.1f%%\n", accuracy);
+        bench_print_confusion(labels.confusion);
+        return bench_check_accuracy(opts, accuracy) ? OPRT_OK : OPRT_COM_ERROR;
+    }
+
+    uint32_t punches = synth.truth.index;
+    printf("punches      %u, missed %u, split %u\n", (unsigned int)punches,
+           (unsigned int)(punches - matched), (unsigned int)false_hits);
+
+    uint32_t m = (matched < BENCH_MAX_HITS) ? matched : BENCH_MAX_HITS;
+    if (m == 0) {
+        return (opts->max_err_cm > 0.0f) ? OPRT_COM_ERROR : OPRT_OK;
+    }
+    double sum = 0.0;
+    for (uint32_t i = 0; i < m; i++) {
+        sum += errors[i];
+    }
+    qsort(errors, m, sizeof(float), bench_cmp_float);
+    float mean = (float)(sum / m);
+    printf("loc err cm   mean %.3f  p95 %.3f  max %.3f\n", mean, errors[(m * 95) / 100], errors[m - 1]);
+
+    if (opts->max_err_cm > 0.0f && mean > opts->max_err_cm) {
+        printf("FAIL: mean localization error %.3f cm > %.3f cm\n", mean, opts->max_err_cm);
+        return OPRT_COM_ERROR;
+    }
+    return OPRT_OK;
+}
+
+static bool bench_check(const char* name, float diff, float tol, const char* unit)
+{
+    if (diff > tol) {
+        printf("FAIL: %s fixed vs float %.6f %s > %.6f %s\n", name, diff, unit, tol, unit);
+        return false;
+    }
+    return true;
+}
+
+// 定点校准: ADC计数经gk_fixed_cal_t得到的Q16，与双精度的(计数·lsb - offset)·scale对比
+static float bench_stage_calibrate(float (*frames)[6], uint32_t n)
+{
+    static const float offset[6] = {1.25f, -0.80f, -9.81f, 0.05f, -0.02f, 0.01f};
+    static const float scale[6] = {1.01f, 0.99f, 1.00f, 1.02f, 0.98f, 1.00f};
+    float lsb[6];
+    gk_fixed_cal_t cal;
+    float max_diff = 0.0f;
+
+    for (int ch = 0; ch < 6; ch++) {
+        lsb[ch] = (ch < 3) ? BENCH_ADS_FORCE_LSB : BENCH_ADS_TORQUE_LSB;
+        gk_fixed_cal_set(&cal, ch, offset[ch] / lsb[ch], lsb[ch] * scale[ch]);
+    }
+
+    // 合成帧之后追加满量程的两端
+    for (uint32_t i = 0; i < n + 2; i++) {
+        int32_t raw[6];
+        gk_q16_t out[6];
+        for (int ch = 0; ch < 6; ch++) {
+            if (i < n) {
+                raw[ch] = (int32_t)lrintf((frames[i][ch] + offset[ch]) / lsb[ch]);
+            } else {
+                raw[ch] = (i == n) ? BENCH_ADS_FULL_SCALE : -BENCH_ADS_FULL_SCALE;
+            }
+        }
+        gk_fixed_calibrate(&cal, raw, out);
+        for (int ch = 0; ch < 6; ch++) {
+            double ref = ((double)raw[ch] * lsb[ch] - offset[ch]) * scale[ch];
+            float d = (float)fabs(ref - GK_Q16_TO_FLOAT(out[ch]));
+            max_diff = (d > max_diff) ? d : max_diff;
+        }
+    }
+    return max_diff;
+}
+
+// 满量程输入: 把打击帧放大到int32的上限附近，预缩放后接触点应与原帧一致
+static float bench_stage_full_scale(gk_q16_t (*frames_q16)[6], const uint32_t* impacts, uint32_t n_impacts,
+                                    gk_q16_t threshold)
+{
+    float max_cm = 0.0f;
+
+    for (uint32_t k = 0; k < n_impacts; k++) {
+        const gk_q16_t* ft = frames_q16[impacts[k]];
+        int32_t max_abs = 1;
+        for (int ch = 0; ch < 6; ch++) {
+            int32_t v = (ft[ch] < 0) ? -ft[ch] : ft[ch];
+            max_abs = (v > max_abs) ? v : max_abs;
+        }
+        int shift = 0;
+        while (shift < 30 && ((int64_t)max_abs << (shift + 1)) < INT32_MAX) {
+            shift++;
+        }
+        gk_q16_t big[6];
+        for (int ch = 0; ch < 6; ch++) {
+            big[ch] = (gk_q16_t)((int64_t)ft[ch] * ((int64_t)1 << shift));
+        }
+
+        gk_q16_t x, y, force, bx, by, bforce;
+        if (gk_fixed_solve_hit_point(ft, threshold, &x, &y, &force) != OPRT_OK ||
+            gk_fixed_solve_hit_point(big, threshold, &bx, &by, &bforce) != OPRT_OK) {
+            continue;
+        }
+        float d = hypotf(GK_Q16_TO_FLOAT(x - bx), GK_Q16_TO_FLOAT(y - by));
+        max_cm = (d > max_cm) ? d : max_cm;
+    }
+    return max_cm;
+}
+
+// 分阶段对比: 浮点/定点校准、滤波器组和接触点求解器的耗时与结果偏差，偏差超出门限时返回错误
+static int bench_stages(const bench_opts_t* opts)
+{
+    static float frames[BENCH_STAGE_SAMPLES][6];
+    static gk_q16_t frames_q16[BENCH_STAGE_SAMPLES][6];
+    static gk_filter_bank_t bank;
+    static gk_filter_bank_q16_t bank_q16;
+    static gk_trace_synth_t synth;
+    static uint32_t impacts[BENCH_STAGE_SAMPLES];
+    bool ok = true;
+
+    // 已去皮的合成数据 (gravity = 0)，即校准后的输入
+    gk_trace_synth_cfg_t cfg = GK_TRACE_SYNTH_DEFAULT(BENCH_SAMPLE_RATE_HZ);
+    cfg.seed = opts->seed;
+    cfg.gravity = 0.0f;
+    cfg.hits_per_second = 4.0f;
+    gk_trace_synth_init(&synth, &cfg);
+
+    uint32_t n_impacts = 0;
+    for (uint32_t i = 0; i < BENCH_STAGE_SAMPLES; i++) {
+        gk_trace_synth_read(&synth, frames[i]);
+        for (int ch = 0; ch < 6; ch++) {
+            frames_q16[i][ch] = GK_FLOAT_TO_Q16(frames[i][ch]);
+        }
+        float f_sq = frames[i][0] * frames[i][0] + frames[i][1] * frames[i][1] + frames[i][2] * frames[i][2];
+        if (f_sq >= BENCH_THRESHOLD * BENCH_THRESHOLD) {
+            impacts[n_impacts++] = i;
+        }
+    }
+
+    printf("== stages (%u samples, %u impact frames) ==\n", BENCH_STAGE_SAMPLES, (unsigned int)n_impacts);
+
+    // 浮点转定点在超出范围时饱和
+    if (GK_FLOAT_TO_Q30(2.0f) != INT32_MAX || GK_FLOAT_TO_Q30(-3.0f) != INT32_MIN || GK_FLOAT_TO_Q16(NAN) != 0) {
+        printf("FAIL: float to fixed conversion does not saturate\n");
+        ok = false;
+    }
+
+    float cal_diff = bench_stage_calibrate(frames, BENCH_STAGE_SAMPLES);
+    printf("calibrate    max diff %.6f (counts -> Q16 vs double)\n", cal_diff);
+    ok &= bench_check("calibration", cal_diff, BENCH_TOL_CAL, "N");
+
+    // 滤波器组: 同一输入分别跑一遍，逐帧比较输出
+    float out[6];
+    gk_q16_t out_q16[6];
+    float max_diff = 0.0f;
+    uint64_t t_float = 0, t_q16 = 0;
+
+    gk_filter_bank_reset(&bank);
+    gk_filter_bank_q16_reset(&bank_q16);
+    for (uint32_t i = 0; i < BENCH_STAGE_SAMPLES; i++) {
+        uint64_t t0 = bench_now_ns();
+        gk_filter_bank_process(&bank, frames[i], out);
+        uint64_t t1 = bench_now_ns();
+        gk_filter_bank_q16_process(&bank_q16, frames_q16[i], out_q16);
+        uint64_t t2 = bench_now_ns();
+        t_float += t1 - t0;
+        t_q16 += t2 - t1;
+        for (int ch = 0; ch < 6; ch++) {
+            float d = fabsf(out[ch] - GK_Q16_TO_FLOAT(out_q16[ch]));
+            max_diff = (d > max_diff) ? d : max_diff;
+        }
+    }
+    printf("filter       float %.1f ns/sample, q16 %.1f ns/sample, max diff %.6f N\n",
+           (double)t_float / BENCH_STAGE_SAMPLES, (double)t_q16 / BENCH_STAGE_SAMPLES, max_diff);
+    ok &= bench_check("filter", max_diff, BENCH_TOL_FILTER, "N");
+
+    if (n_impacts == 0) {
+        return ok ? OPRT_OK : OPRT_COM_ERROR;
+    }
+
+    // 接触点求解器: 只在超过阈值的打击帧上比较
+    gk_q16_t threshold = GK_FLOAT_TO_Q16(BENCH_THRESHOLD);
+    double sum_diff = 0.0;
+    float max_cm = 0.0f;
+    uint32_t compared = 0;
+    t_float = 0;
+    t_q16 = 0;
+    for (uint32_t k = 0; k < n_impacts; k++) {
+        uint32_t i = impacts[k];
+        gk_force_data_t fd = {frames[i][0], frames[i][1], frames[i][2], frames[i][3], frames[i][4], frames[i][5], 0};
+        gk_hit_point_t hp;
+        gk_q16_t x, y, force;
+
+        uint64_t t0 = bench_now_ns();
+        int ret_float = gk_calculate_hit_point(&fd, &hp);
+        uint64_t t1 = bench_now_ns();
+        int ret_fixed = gk_fixed_solve_hit_point(frames_q16[i], threshold, &x, &y, &force);
+        uint64_t t2 = bench_now_ns();
+        t_float += t1 - t0;
+        t_q16 += t2 - t1;
+
+        if (ret_float == OPRT_OK && ret_fixed == OPRT_OK) {
+            float d = hypotf(hp.x - GK_Q16_TO_FLOAT(x), hp.y - GK_Q16_TO_FLOAT(y));
+            sum_diff += d;
+            max_cm = (d > max_cm) ? d : max_cm;
+            compared++;
+        }
+    }
+    printf("solver       %s %.1f ns/call, fixed %.1f ns/call\n", BENCH_FLOAT_SOLVER ? "float" : "pipeline",
+           (double)t_float / n_impacts, (double)t_q16 / n_impacts);
+#if BENCH_FLOAT_SOLVER
+    if (compared > 0) {
+        printf("solver diff  mean %.5f cm, max %.5f cm (fixed vs float)\n", sum_diff / compared, max_cm);
+        ok &= bench_check("solver", max_cm, BENCH_TOL_SOLVER_CM, "cm");
+    }
+#endif
+
+    float full_cm = bench_stage_full_scale(frames_q16, impacts, n_impacts, threshold);
+    printf("full scale   max %.5f cm (inputs scaled to the int32 limit vs unscaled)\n", full_cm);
+    ok &= bench_check("full-scale solver", full_cm, BENCH_TOL_SOLVER_CM, "cm");
+
+    return ok ? OPRT_OK : OPRT_COM_ERROR;
+}
+
+// 多沙袋: 同一线程轮流为每个实例读取一帧并分段，与采集线程的调度方式相同
+// 每帧耗时应与沙袋数无关，总耗时随沙袋数线性增长
+static void bench_bags(const bench_opts_t* opts)
+{
+    static gk_trace_synth_t synth[BENCH_MAX_BAGS];
+    gk_sensor_t* bags[BENCH_MAX_BAGS];
+
+    printf("== bags (%u samples per bag) ==\n", BENCH_BAG_SAMPLES);
+    for (int n = 1; n <= BENCH_MAX_BAGS; n++) {
+        gk_sensor_init();
+        bags[0] = gk_sensor_get(0);
+        for (int b = 1; b < n; b++) {
+            gk_sensor_cfg_t cfg = {.id = (uint8_t)b};
+            if (gk_sensor_open(&cfg, &bags[b]) != OPRT_OK) {
+                printf("cannot open bag %d\n", b);
+                n = b;
+                break;
+            }
+        }
+        for (int b = 0; b < n; b++) {
+            gk_trace_synth_cfg_t cfg = GK_TRACE_SYNTH_DEFAULT(BENCH_SAMPLE_RATE_HZ);
+            cfg.seed = opts->seed + b;
+            cfg.hits_per_second = opts->hit_rate;
+            gk_trace_synth_init(&synth[b], &cfg);
+            gk_sensor_dev_set_source(bags[b], gk_trace_synth_read, &synth[b]);
+        }
+
+        uint64_t t0 = bench_now_ns();
+        for (uint32_t i = 0; i < BENCH_BAG_SAMPLES; i++) {
+            for (int b = 0; b < n; b++) {
+                gk_force_data_t frame;
+                gk_punch_event_t event;
+                if (gk_sensor_dev_read_data(bags[b], &frame) == OPRT_OK) {
+                    gk_sensor_dev_detect_punch(bags[b], &frame, &event);
+                }
+            }
+        }
+        uint64_t elapsed = bench_now_ns() - t0;
+
+        printf("%d bag%s       %.1f ns/sample, %.1f ns/period, hits", n, (n > 1) ? "s" : " ",
+               (double)elapsed / ((uint64_t)BENCH_BAG_SAMPLES * n), (double)elapsed / BENCH_BAG_SAMPLES);
+        for (int b = 0; b < n; b++) {
+            printf(" %u/%u", (unsigned int)gk_sensor_dev_get_hit_count(bags[b]), (unsigned int)synth[b].truth.index);
+        }
+        printf("\n");
+
+        gk_sensor_dev_set_source(bags[0], NULL, NULL);
+        for (int b = 1; b < n; b++) {
+            gk_sensor_close(bags[b]);
+        }
+    }
+}
+
+// 拳法分类: 在与训练种子不同的带标签合成打击上评估随固件发布的模型
+static int bench_classifier(const bench_opts_t* opts)
+{
+    static gk_punch_features_t feats[BENCH_CLASSIFY_PUNCHES];
+    static uint8_t labels[BENCH_CLASSIFY_PUNCHES];
+    uint32_t confusion[GK_PUNCH_CLASSES][GK_PUNCH_CLASSES] = {{0}};
+
+    // 模型以种子1/2训练和测试，评估数据错开种子
+    uint32_t n = gk_punch_dataset_collect(opts->seed + 1000, BENCH_SAMPLE_RATE_HZ, BENCH_THRESHOLD,
+                                          BENCH_CLASSIFY_PUNCHES, feats, labels);
+    if (n == 0) {
+        printf("no punches\n");
+        return OPRT_NOT_FOUND;
+    }
+
+    uint32_t correct = 0;
+    uint64_t elapsed = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t t0 = bench_now_ns();
+        gk_punch_type_t type = gk_punch_classify(&feats[i]);
+        elapsed += bench_now_ns() - t0;
+        confusion[labels[i] - GK_PUNCH_JAB][type - GK_PUNCH_JAB]++;
+        correct += (type == labels[i]);
+    }
+
+    float accuracy = 100.0f * correct / n;
+    printf("== classifier (%u punches) ==\n", (unsigned int)n);
+    printf("ns/classify  %.1f\n", (double)elapsed / n);
+    printf("accuracy     %.1f%%\n", accuracy);
+    bench_print_confusion(confusion);
+    return bench_check_accuracy(opts, accuracy) ? OPRT_OK : OPRT_COM_ERROR;
+}
+
+// 训练计划的反应时间: 每次提示送显后在已知的反应时间处合成一次打击，经固件链路分段后送入gk_drill，
+// 与真值 (打击起始样本的时刻 - 送显时刻) 对比。帧时间戳按样本序号给出，排除主机调度的抖动
+static int bench_drill(const bench_opts_t* opts)
+{
+    static gk_trace_synth_t synth;
+    const gk_drill_program_t* prog = &gk_drill_programs[GK_DRILL_SPEED];
+    uint32_t rate = BENCH_SAMPLE_RATE_HZ;
+
+    gk_trace_synth_cfg_t cfg = GK_TRACE_SYNTH_DEFAULT(rate);
+    cfg.seed = opts->seed;
+    cfg.hits_per_second = 0.0f; // 打击只在提示之后出现
+    gk_trace_synth_init(&synth, &cfg);
+    gk_sensor_init();
+    gk_sensor_set_source(gk_trace_synth_read, &synth);
+
+    if (gk_drill_init() != OPRT_OK || gk_drill_start(prog, opts->seed, 0) != OPRT_OK) {
+        gk_sensor_set_source(NULL, NULL);
+        return OPRT_COM_ERROR;
+    }
+
+    uint32_t rng = opts->seed ? opts->seed : 1;
+    uint32_t last_seq = 0, matched = 0, last_index = 0;
+    uint64_t flush_us = 0, now_us = 0, truth_us = 0;
+    int64_t err_sum = 0, bias_sum = 0;
+    uint32_t err_max = 0;
+    gk_drill_view_t view;
+    gk_force_data_t frame;
+    gk_punch_event_t event;
+
+    while (gk_drill_poll(now_us, &view) != 0 && gk_sensor_read_data(&frame) == OPRT_OK) {
+        // 新提示一帧之后送显，送显后按随机的反应时间安排下一次打击
+        if (view.cue != GK_DRILL_ZONE_NONE && view.cue_seq != last_seq) {
+            last_seq = view.cue_seq;
+            flush_us = now_us + BENCH_DRILL_FLUSH_US;
+        }
+        if (flush_us && now_us >= flush_us) {
+            gk_drill_cue_flushed(flush_us);
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            uint32_t react_ms = BENCH_DRILL_REACT_MIN_MS + rng % (BENCH_DRILL_REACT_MAX_MS - BENCH_DRILL_REACT_MIN_MS);
+            synth.next_onset = (uint32_t)((flush_us + react_ms * 1000ull) * rate / 1000000) + 1;
+            truth_us = (uint64_t)synth.next_onset * 1000000 / rate - flush_us;
+            flush_us = 0;
+        }
+
+        // 采集时刻按样本序号计算，与合成真值的时钟一致
+        frame.timestamp = (uint64_t)(synth.sample - 1) * 1000000 / rate;
+        now_us = frame.timestamp + 1000000 / rate;
+        if (gk_sensor_detect_punch(&frame, &event) != OPRT_OK || synth.truth.index == last_index) {
+            continue;
+        }
+        last_index = synth.truth.index;
+        if (gk_drill_feed_punch(&event) != OPRT_OK) {
+            continue;
+        }
+        gk_drill_poll(frame.timestamp, &view);
+        int64_t err = (int64_t)view.result.reaction_last_us - (int64_t)truth_us;
+        uint32_t abs_err = (uint32_t)((err < 0) ? -err : err);
+        bias_sum += err;
+        err_sum += abs_err;
+        err_max = (abs_err > err_max) ? abs_err : err_max;
+        matched++;
+    }
+    gk_drill_stop();
+    gk_sensor_set_source(NULL, NULL);
+
+    const gk_drill_result_t* r = &view.result;
+    printf("== drill reaction (%s, %u Hz) ==\n", prog->name, (unsigned int)rate);
+    printf("cues         %u, hits %u, misses %u, extra %u\n", (unsigned int)r->cues, (unsigned int)r->hits,
+           (unsigned int)r->misses, (unsigned int)r->extra);
+    if (matched == 0) {
+        printf("FAIL: no punch matched a cue\n");
+        return OPRT_COM_ERROR;
+    }
+    printf("react err us mean %.1f  bias %+.1f  max %u\n", (double)err_sum / matched, (double)bias_sum / matched,
+           (unsigned int)err_max);
+    if (r->hits != r->cues || err_max > BENCH_TOL_REACTION_US) {
+        printf("FAIL: reaction time error %u us > %u us or missed cues\n", (unsigned int)err_max, BENCH_TOL_REACTION_US);
+        return OPRT_COM_ERROR;
+    }
+    return OPRT_OK;
+}
+
+static void bench_usage(const char* prog)
+{
+    printf("usage: %s [-n samples] [-s seed] [-r hits/s] [-e max_mean_err_cm] [-a min_accuracy_pct] [-f session.gkr] "
+           "[-l labels.csv] [-T model.c] [-i] [-v]\n",
+           prog);
+}
+
+int main(int argc, char* argv[])
+{
+    bench_opts_t opts = {
+        .samples = BENCH_DEFAULT_SECONDS * BENCH_SAMPLE_RATE_HZ,
+        .seed = 1,
+        .hit_rate = BENCH_DEFAULT_HIT_RATE,
+        .max_err_cm = BENCH_DEFAULT_MAX_ERR_CM,
+    };
+    bool samples_set = false;
+    int c;
+
+    while ((c = getopt(argc, argv, "n:s:r:e:a:f:l:T:ivh")) != -1) {
+        switch (c) {
+        case 'n':
+            opts.samples = (uint32_t)strtoul(optarg, NULL, 10);
+            samples_set = true;
+            break;
+        case 's':
+            opts.seed = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            opts.hit_rate = strtof(optarg, NULL);
+            break;
+        case 'e':
+            opts.max_err_cm = strtof(optarg, NULL);
+            break;
+        case 'a':
+            opts.min_accuracy = strtof(optarg, NULL);
+            break;
+        case 'f':
+            opts.file = optarg;
+            break;
+        case 'l':
+            opts.labels = optarg;
+            break;
+        case 'T':
+            opts.train_out = optarg;
+            break;
+        case 'i':
+            opts.ideal = true;
+            break;
+        case 'v':
+            opts.verbose = true;
+            break;
+        default:
+            bench_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (opts.labels && !opts.file) {
+        bench_usage(argv[0]);
+        return 2;
+    }
+    if (opts.file && !samples_set) {
+        opts.samples = UINT32_MAX; // 回放整个会话
+    }
+
+    // 每次打击都会打印日志，默认只保留错误日志以免影响计时
+    tal_log_init(opts.verbose ? TAL_LOG_LEVEL_DEBUG : TAL_LOG_LEVEL_ERR, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    if (opts.train_out) {
+        return (gk_punch_train(opts.train_out, opts.seed, BENCH_SAMPLE_RATE_HZ, BENCH_THRESHOLD) == OPRT_OK) ? 0 : 1;
+    }
+
+    int ret = bench_pipeline(&opts);
+    if (!opts.file) {
+        if (bench_stages(&opts) != OPRT_OK) {
+            ret = OPRT_COM_ERROR;
+        }
+        bench_bags(&opts);
+        if (bench_classifier(&opts) != OPRT_OK) {
+            ret = OPRT_COM_ERROR;
+        }
+        if (bench_drill(&opts) != OPRT_OK) {
+            ret = OPRT_COM_ERROR;
+        }
+    }
+
+    return (ret == OPRT_OK) ? 0 : 1;
+}
@@ -0,0 +1,449 @@
+#include "gk_punch_train.h"
+#include "gk_punch_detector.h"
+#include "gk_filter.h"
+#include "gk_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+// 主机端拳法分类器训练: 带标签的合成打击 -> 浮点两层感知机 (小批量SGD + 动量) -> 训练后量化 -> C源文件
+
+#ifdef PUNCH_RELEASE_RATIO
+#define TRAIN_RELEASE_FACTOR    (PUNCH_RELEASE_RATIO / 100.0f)
+#else
+#define TRAIN_RELEASE_FACTOR    0.6f
+#endif
+#ifndef PUNCH_REFRACTORY_MS
+#define PUNCH_REFRACTORY_MS     60
+#endif
+#ifndef PUNCH_MAX_DURATION_MS
+#define PUNCH_MAX_DURATION_MS   300
+#endif
+
+#define TRAIN_PUNCHES           8000    // 训练集打击数
+#define TEST_PUNCHES            2000    // 测试集打击数
+#define TRAIN_EPOCHS            80
+#define TRAIN_BATCH             32
+#define TRAIN_LR                0.05f
+#define TRAIN_MOMENTUM          0.9f
+#define TRAIN_WEIGHT_DECAY      1e-4f
+#define TRAIN_CLIP_SIGMA        4.0f    // 标准化后的特征截断到±4σ，即int8的满量程
+#define TRAIN_HITS_PER_SECOND   3.0f
+
+#define F GK_PUNCH_FEATURES
+#define H GK_PUNCH_HIDDEN
+#define C GK_PUNCH_CLASSES
+
+typedef struct {
+    float w1[H][F];
+    float b1[H];
+    float w2[C][H];
+    float b2[C];
+} train_net_t;
+
+static uint32_t g_train_rng = 1;
+
+static float train_uniform(void)
+{
+    uint32_t x = g_train_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_train_rng = x;
+    return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+uint32_t gk_punch_dataset_collect(uint32_t seed, uint32_t sample_rate_hz, float threshold, uint32_t max,
+                                  gk_punch_features_t* feats, uint8_t* labels)
+{
+    static gk_trace_synth_t synth;
+    static gk_filter_bank_t bank;
+    static gk_punch_detector_t det;
+
+    // 已去皮的合成数据，即校准后的输入
+    gk_trace_synth_cfg_t cfg = GK_TRACE_SYNTH_DEFAULT(sample_rate_hz);
+    cfg.seed = seed;
+    cfg.gravity = 0.0f;
+    cfg.hits_per_second = TRAIN_HITS_PER_SECOND;
+    cfg.punch_types = true;
+    gk_trace_synth_init(&synth, &cfg);
+    gk_filter_bank_reset(&bank);
+
+    gk_punch_detector_cfg_t det_cfg = {
+        .onset_threshold = threshold,
+        .release_threshold = threshold * TRAIN_RELEASE_FACTOR,
+        .refractory_samples = PUNCH_REFRACTORY_MS * sample_rate_hz / 1000,
+        .max_samples = PUNCH_MAX_DURATION_MS * sample_rate_hz / 1000,
+        .sample_period_s = 1.0f / sample_rate_hz,
+    };
+    gk_punch_detector_init(&det, &det_cfg);
+
+    uint32_t n = 0, last_truth = 0;
+    uint64_t sample = 0;
+    // 超时保护: 平均每次打击不应超过10秒的样本
+    uint64_t limit = (uint64_t)max * sample_rate_hz * 10;
+    while (n < max && sample < limit) {
+        float raw[6], out[6];
+        gk_trace_synth_read(&synth, raw);
+        gk_filter_bank_process(&bank, raw, out);
+
+        gk_force_data_t frame = {out[0], out[1], out[2], out[3], out[4], out[5], sample * 1000000ull / sample_rate_hz};
+        gk_punch_event_t event;
+        sample++;
+        if (!gk_punch_detector_feed(&det, &frame, &event, NULL)) {
+            continue;
+        }
+
+        gk_trace_truth_t truth;
+        if (!gk_trace_synth_truth(&synth, &truth) || truth.index == last_truth) {
+            continue; // 同一次打击被分成多个事件时只取第一个
+        }
+        last_truth = truth.index;
+        gk_punch_features_extract(&event, det.impulse_ft, &feats[n]);
+        labels[n] = (uint8_t)truth.type;
+        n++;
+    }
+    return n;
+}
+
+static void train_normalize(const gk_punch_features_t* in, float out[F], const float mean[F], const float std[F])
+{
+    for (int i = 0; i < F; i++) {
+        float z = (in->v[i] - mean[i]) / std[i];
+        out[i] = fmaxf(-TRAIN_CLIP_SIGMA, fminf(TRAIN_CLIP_SIGMA, z));
+    }
+}
+
+// 前向传播，返回预测类别，hidden/prob可为NULL
+static int train_forward(const train_net_t* net, const float x[F], float hidden[H], float prob[C])
+{
+    float h[H], logit[C];
+    for (int j = 0; j < H; j++) {
+        float acc = net->b1[j];
+        for (int i = 0; i < F; i++) {
+            acc += net->w1[j][i] * x[i];
+        }
+        h[j] = (acc > 0.0f) ? acc : 0.0f;
+    }
+    int best = 0;
+    float max_logit = -1e30f;
+    for (int k = 0; k < C; k++) {
+        float acc = net->b2[k];
+        for (int j = 0; j < H; j++) {
+            acc += net->w2[k][j] * h[j];
+        }
+        logit[k] = acc;
+        if (acc > max_logit) {
+            max_logit = acc;
+            best = k;
+        }
+    }
+    if (hidden) {
+        memcpy(hidden, h, sizeof(h));
+    }
+    if (prob) {
+        float sum = 0.0f;
+        for (int k = 0; k < C; k++) {
+            prob[k] = expf(logit[k] - max_logit);
+            sum += prob[k];
+        }
+        for (int k = 0; k < C; k++) {
+            prob[k] /= sum;
+        }
+    }
+    return best;
+}
+
+static void train_sgd(train_net_t* net, float (*x)[F], const uint8_t* labels, uint32_t n)
+{
+    static train_net_t grad, vel;
+    static uint32_t order[TRAIN_PUNCHES];
+
+    memset(&vel, 0, sizeof(vel));
+    for (uint32_t i = 0; i < n; i++) {
+        order[i] = i;
+    }
+
+    for (int epoch = 0; epoch < TRAIN_EPOCHS; epoch++) {
+        // 每轮打乱顺序
+        for (uint32_t i = n - 1; i > 0; i--) {
+            uint32_t j = (uint32_t)(train_uniform() * (i + 1));
+            uint32_t t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+        float lr = TRAIN_LR * (1.0f - 0.9f * epoch / TRAIN_EPOCHS);
+
+        for (uint32_t start = 0; start < n; start += TRAIN_BATCH) {
+            uint32_t end = (start + TRAIN_BATCH < n) ? start + TRAIN_BATCH : n;
+            memset(&grad, 0, sizeof(grad));
+
+            for (uint32_t b = start; b < end; b++) {
+                const float* xi = x[order[b]];
+                int y = labels[order[b]] - GK_PUNCH_JAB;
+                float h[H], p[C], dh[H] = {0};
+                train_forward(net, xi, h, p);
+
+                // softmax交叉熵对输出的梯度为 p - onehot
+                for (int k = 0; k < C; k++) {
+                    float d = p[k] - ((k == y) ? 1.0f : 0.0f);
+                    grad.b2[k] += d;
+                    for (int j = 0; j < H; j++) {
+                        grad.w2[k][j] += d * h[j];
+                        dh[j] += d * net->w2[k][j];
+                    }
+                }
+                for (int j = 0; j < H; j++) {
+                    if (h[j] <= 0.0f) {
+                        continue;
+                    }
+                    grad.b1[j] += dh[j];
+                    for (int i = 0; i < F; i++) {
+                        grad.w1[j][i] += dh[j] * xi[i];
+                    }
+                }
+            }
+
+            // 参数和梯度按同一顺序展开成一维数组更新
+            float* p = (float*)net;
+            float* g = (float*)&grad;
+            float* v = (float*)&vel;
+            float scale = 1.0f / (end - start);
+            for (size_t i = 0; i < sizeof(train_net_t) / sizeof(float); i++) {
+                v[i] = TRAIN_MOMENTUM * v[i] - lr * (g[i] * scale + TRAIN_WEIGHT_DECAY * p[i]);
+                p[i] += v[i];
+            }
+        }
+    }
+}
+
+static float train_accuracy(const train_net_t* net, float (*x)[F], const uint8_t* labels, uint32_t n)
+{
+    uint32_t correct = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        correct += (train_forward(net, x[i], NULL, NULL) + GK_PUNCH_JAB == labels[i]);
+    }
+    return n ? (float)correct / n : 0.0f;
+}
+
+static float train_accuracy_q(const gk_punch_model_t* model, const gk_punch_features_t* feats, const uint8_t* labels,
+                              uint32_t n)
+{
+    uint32_t correct = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        correct += (gk_punch_classify_model(model, &feats[i], NULL) == labels[i]);
+    }
+    return n ? (float)correct / n : 0.0f;
+}
+
+static int8_t train_q8(float v)
+{
+    v = fmaxf(-127.0f, fminf(127.0f, roundf(v)));
+    return (int8_t)v;
+}
+
+// 训练后量化: 输入满量程±4σ，权重按层对称量化，隐藏层按训练集上的最大激活量化
+static void train_quantize(const train_net_t* net, float (*x)[F], uint32_t n, const float mean[F],
+                           const float std[F], gk_punch_model_t* model)
+{
+    float s_x = TRAIN_CLIP_SIGMA / 127.0f;
+    float w1_max = 1e-9f, w2_max = 1e-9f, h_max = 1e-9f;
+
+    for (int j = 0; j < H; j++) {
+        for (int i = 0; i < F; i++) {
+            w1_max = fmaxf(w1_max, fabsf(net->w1[j][i]));
+        }
+    }
+    for (int k = 0; k < C; k++) {
+        for (int j = 0; j < H; j++) {
+            w2_max = fmaxf(w2_max, fabsf(net->w2[k][j]));
+        }
+    }
+    for (uint32_t s = 0; s < n; s++) {
+        float h[H];
+        train_forward(net, x[s], h, NULL);
+        for (int j = 0; j < H; j++) {
+            h_max = fmaxf(h_max, h[j]);
+        }
+    }
+
+    float s_w1 = w1_max / 127.0f;
+    float s_w2 = w2_max / 127.0f;
+    float s_h = h_max / 127.0f;
+
+    memset(model, 0, sizeof(gk_punch_model_t));
+    for (int i = 0; i < F; i++) {
+        model->feat_offset[i] = mean[i];
+        model->feat_scale[i] = 1.0f / (std[i] * s_x);
+    }
+    for (int j = 0; j < H; j++) {
+        for (int i = 0; i < F; i++) {
+            model->w1[j][i] = train_q8(net->w1[j][i] / s_w1);
+        }
+        model->b1[j] = (int32_t)lrintf(net->b1[j] / (s_x * s_w1));
+    }
+    for (int k = 0; k < C; k++) {
+        for (int j = 0; j < H; j++) {
+            model->w2[k][j] = train_q8(net->w2[k][j] / s_w2);
+        }
+        model->b2[k] = (int32_t)lrintf(net->b2[k] / (s_h * s_w2));
+    }
+
+    // 重新量化系数 M = s_x * s_w1 / s_h，表示为 mult1 * 2^-shift1，mult1在[2^30, 2^31)
+    double m = (double)s_x * s_w1 / s_h;
+    int shift = 31;
+    while (m < 0.5) {
+        m *= 2.0;
+        shift++;
+    }
+    while (m >= 1.0) {
+        m *= 0.5;
+        shift--;
+    }
+    int64_t mult = llround(m * 2147483648.0);
+    if (mult == (1ll << 31)) {
+        mult >>= 1; // 四舍五入进位到2^31
+        shift--;
+    }
+    model->mult1 = (int32_t)mult;
+    model->shift1 = shift;
+}
+
+static void train_write_floats(FILE* fp, const char* name, const float* v, int n)
+{
+    fprintf(fp, "    .%s = {\n        ", name);
+    for (int i = 0; i < n; i++) {
+        fprintf(fp, "%.8gf%s", v[i], (i == n - 1) ? "\n" : ((i % 5 == 4) ? ",\n        " : ", "));
+    }
+    fprintf(fp, "    },\n");
+}
+
+static void train_write_i32(FILE* fp, const char* name, const int32_t* v, int n)
+{
+    fprintf(fp, "    .%s = {", name);
+    for (int i = 0; i < n; i++) {
+        fprintf(fp, "%s%d", i ? ", " : "", (int)v[i]);
+    }
+    fprintf(fp, "},\n");
+}
+
+static void train_write_i8(FILE* fp, const char* name, const int8_t* v, int rows, int cols)
+{
+    fprintf(fp, "    .%s = {\n", name);
+    for (int r = 0; r < rows; r++) {
+        fprintf(fp, "        {");
+        for (int c = 0; c < cols; c++) {
+            fprintf(fp, "%s%d", c ? ", " : "", v[r * cols + c]);
+        }
+        fprintf(fp, "},\n");
+    }
+    fprintf(fp, "    },\n");
+}
+
+static int train_export(const char* path, const gk_punch_model_t* model, uint32_t seed, float acc_float,
+                        float acc_q)
+{
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        printf("cannot write %s\n", path);
+        return OPRT_COM_ERROR;
+    }
+
+    fprintf(fp, "#include \"gk_punch_classifier.h\"\n\n");
+    fprintf(fp, "// 由 gk_bag_bench -T 生成，不要手工修改\n");
+    fprintf(fp, "// 训练数据: 合成打击%u次 (种子%u)，测试集%u次 (种子%u)\n", TRAIN_PUNCHES, (unsigned int)seed,
+            TEST_PUNCHES, (unsigned int)(seed + 1));
+    fprintf(fp, "// 测试集准确率: 浮点 %.1f%%, int8 %.1f%%\n", acc_float * 100.0f, acc_q * 100.0f);
+    fprintf(fp, "const gk_punch_model_t gk_punch_model = {\n");
+    train_write_floats(fp, "feat_offset", model->feat_offset, F);
+    train_write_floats(fp, "feat_scale", model->feat_scale, F);
+    train_write_i8(fp, "w1", &model->w1[0][0], H, F);
+    train_write_i32(fp, "b1", model->b1, H);
+    fprintf(fp, "    .mult1 = %d,\n", (int)model->mult1);
+    fprintf(fp, "    .shift1 = %d,\n", (int)model->shift1);
+    train_write_i8(fp, "w2", &model->w2[0][0], C, H);
+    train_write_i32(fp, "b2", model->b2, C);
+    fprintf(fp, "};\n");
+    fclose(fp);
+    return OPRT_OK;
+}
+
+int gk_punch_train(const char* out_path, uint32_t seed, uint32_t sample_rate_hz, float threshold)
+{
+    static gk_punch_features_t train_feats[TRAIN_PUNCHES], test_feats[TEST_PUNCHES];
+    static uint8_t train_labels[TRAIN_PUNCHES], test_labels[TEST_PUNCHES];
+    static float train_x[TRAIN_PUNCHES][F], test_x[TEST_PUNCHES][F];
+    static train_net_t net;
+    static gk_punch_model_t model;
+
+    uint32_t n_train = gk_punch_dataset_collect(seed, sample_rate_hz, threshold, TRAIN_PUNCHES, train_feats,
+                                                train_labels);
+    uint32_t n_test = gk_punch_dataset_collect(seed + 1, sample_rate_hz, threshold, TEST_PUNCHES, test_feats,
+                                               test_labels);
+    if (n_train < TRAIN_PUNCHES / 2 || n_test == 0) {
+        printf("not enough punches: train %u, test %u\n", (unsigned int)n_train, (unsigned int)n_test);
+        return OPRT_COM_ERROR;
+    }
+
+    // 特征标准化参数取自训练集
+    float mean[F] = {0}, std[F] = {0};
+    for (uint32_t s = 0; s < n_train; s++) {
+        for (int i = 0; i < F; i++) {
+            mean[i] += train_feats[s].v[i];
+        }
+    }
+    for (int i = 0; i < F; i++) {
+        mean[i] /= n_train;
+    }
+    for (uint32_t s = 0; s < n_train; s++) {
+        for (int i = 0; i < F; i++) {
+            float d = train_feats[s].v[i] - mean[i];
+            std[i] += d * d;
+        }
+    }
+    for (int i = 0; i < F; i++) {
+        std[i] = sqrtf(std[i] / n_train);
+        if (std[i] < 1e-6f) {
+            std[i] = 1.0f;
+        }
+    }
+    for (uint32_t s = 0; s < n_train; s++) {
+        train_normalize(&train_feats[s], train_x[s], mean, std);
+    }
+    for (uint32_t s = 0; s < n_test; s++) {
+        train_normalize(&test_feats[s], test_x[s], mean, std);
+    }
+
+    // He初始化
+    g_train_rng = seed ? seed : 1;
+    memset(&net, 0, sizeof(net));
+    for (int j = 0; j < H; j++) {
+        for (int i = 0; i < F; i++) {
+            net.w1[j][i] = (train_uniform() * 2.0f - 1.0f) * sqrtf(6.0f / F);
+        }
+    }
+    for (int k = 0; k < C; k++) {
+        for (int j = 0; j < H; j++) {
+            net.w2[k][j] = (train_uniform() * 2.0f - 1.0f) * sqrtf(6.0f / H);
+        }
+    }
+
+    train_sgd(&net, train_x, train_labels, n_train);
+    train_quantize(&net, train_x, n_train, mean, std, &model);
+
+    float acc_train = train_accuracy(&net, train_x, train_labels, n_train);
+    float acc_test = train_accuracy(&net, test_x, test_labels, n_test);
+    float acc_train_q = train_accuracy_q(&model, train_feats, train_labels, n_train);
+    float acc_test_q = train_accuracy_q(&model, test_feats, test_labels, n_test);
+
+    printf("== punch classifier training ==\n");
+    printf("punches      train %u, test %u\n", (unsigned int)n_train, (unsigned int)n_test);
+    printf("accuracy     float train %.1f%% test %.1f%%\n", acc_train * 100.0f, acc_test * 100.0f);
+    printf("accuracy     int8  train %.1f%% test %.1f%%\n", acc_train_q * 100.0f, acc_test_q * 100.0f);
+
+    if (train_export(out_path, &model, seed, acc_test, acc_test_q) != OPRT_OK) {
+        return OPRT_COM_ERROR;
+    }
+    printf("model        %s\n", out_path);
+    return OPRT_OK;
+}
@@ -0,0 +1,23 @@
+#ifndef __GK_PUNCH_TRAIN_H__
+#define __GK_PUNCH_TRAIN_H__
+
+#include "gk_punch_classifier.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 从带拳法标签的合成数据中收集打击特征: 合成 -> 滤波 -> 打击分段 -> 特征提取，与固件链路相同
+// 返回收集到的打击数 (不超过max)，labels为GK_PUNCH_JAB..GK_PUNCH_UPPERCUT
+uint32_t gk_punch_dataset_collect(uint32_t seed, uint32_t sample_rate_hz, float threshold, uint32_t max,
+                                  gk_punch_features_t* feats, uint8_t* labels);
+
+// 训练浮点网络，量化为gk_punch_model_t并写出C源文件 (替换src/gk_punch_model.c)
+// 训练集和测试集来自不同的随机种子，打印两者的浮点和int8准确率
+int gk_punch_train(const char* out_path, uint32_t seed, uint32_t sample_rate_hz, float threshold);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_PUNCH_TRAIN_H__ */
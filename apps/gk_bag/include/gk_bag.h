@@ -2,12 +2,27 @@
 #define __GK_BAG_H__
 
 #include "tuya_cloud_types.h"
+#include "tuya_iot_config.h"
+#include "tal_log.h"
+#if defined(ENABLE_LIBLVGL) && (ENABLE_LIBLVGL == 1)
 #include "lvgl.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// 带模块标签的日志
+#ifndef TAL_PR_INFO
+#define TAL_PR_INFO(tag, fmt, ...)  PR_INFO("[%s] " fmt, tag, ##__VA_ARGS__)
+#endif
+#ifndef TAL_PR_WARN
+#define TAL_PR_WARN(tag, fmt, ...)  PR_WARN("[%s] " fmt, tag, ##__VA_ARGS__)
+#endif
+#ifndef TAL_PR_ERR
+#define TAL_PR_ERR(tag, fmt, ...)   PR_ERR("[%s] " fmt, tag, ##__VA_ARGS__)
+#endif
+
 // 用户信息结构
 typedef struct {
     char user_id[64];
@@ -31,7 +46,7 @@ typedef struct {
 typedef struct {
     float fx, fy, fz;  // 力分量
     float mx, my, mz;  // 力矩分量
-    uint32_t timestamp;
+    uint64_t timestamp;  // 采集时刻 (单调时钟，微秒)
 } gk_force_data_t;
 
 // 增强的打击点计算结果
@@ -39,9 +54,56 @@ typedef struct {
     float x, y;        // 打击坐标（厘米）
     float force;       // 打击力大小（牛顿）
     float residual;    // 算法残差，用于精度评估
-    uint32_t timestamp;
+    uint64_t timestamp;  // 峰值帧的采集时刻 (微秒)
 } gk_hit_point_t;
 
+// 拳法类型，由打击分类器给出
+typedef enum {
+    GK_PUNCH_UNKNOWN = 0,      // 未分类 (分类器未启用)
+    GK_PUNCH_JAB,              // 刺拳
+    GK_PUNCH_CROSS,            // 直拳
+    GK_PUNCH_HOOK,             // 摆拳
+    GK_PUNCH_UPPERCUT,         // 勾拳
+    GK_PUNCH_TYPE_MAX
+} gk_punch_type_t;
+
+// 一次完整打击事件 (起始 -> 峰值 -> 释放)
+typedef struct {
+    gk_hit_point_t hit;        // 峰值时刻的打击位置与力
+    float peak_force;          // 峰值力 (N)
+    float impulse;             // 冲量 (N·s)
+    float rise_time_ms;        // 起始到峰值的时间
+    float duration_ms;         // 起始到释放的时间
+    uint32_t sample_count;     // 打击持续的样本数
+    uint64_t timestamp;        // 起始帧的采集时刻 (微秒)
+    gk_punch_type_t type;      // 拳法类型
+} gk_punch_event_t;
+
+// 传感器采集统计
+typedef struct {
+    uint32_t sample_rate_hz;   // 配置的采样率
+    uint32_t samples;          // 已采集帧数
+    uint32_t dropped;          // 环形缓冲区满而丢弃的帧数
+    uint32_t overruns;         // 采集线程被抢占而错过的采样周期数
+    uint32_t read_errors;      // 传感器读取失败次数
+    uint32_t ring_depth;       // 环形缓冲区容量
+    uint32_t ring_pending;     // 当前待消费帧数
+    uint32_t ring_high_water;  // 环形缓冲区最高占用
+    uint32_t classify_us_max;  // 拳法特征提取+分类的最长耗时 (微秒)，未开启拳法识别时为0
+    uint32_t classify_us_mean; // 拳法特征提取+分类的平均耗时 (微秒)
+} gk_sensor_stats_t;
+
+// 原始数据源回调: 填充一帧校准前的Fx Fy Fz Mx My Mz，数据耗尽时返回非OPRT_OK
+typedef int (*gk_sensor_source_cb_t)(void* ctx, float raw[6]);
+
+// 传感器实例: 一个控制器驱动多个沙袋时每个沙袋一个，各自的校准、滤波、打击分段、统计和环形缓冲区
+typedef struct gk_sensor gk_sensor_t;
+
+typedef struct {
+    uint8_t id;                // 沙袋编号 (0 ~ FORCE_SENSOR_MAX_BAGS-1)，决定校准记录的tal_kv键
+    const char* dev_name;      // 板级注册的ft_sensor设备名，NULL或打开失败时使用合成数据源
+} gk_sensor_cfg_t;
+
 // GUI页面枚举 (已简化)
 typedef enum {
     GK_PAGE_MAIN_STATS = 0,
@@ -59,20 +121,59 @@ int gk_sensor_init(void);
 void gk_set_default_user_info(void);
 gk_user_info_t* gk_get_user_info(void);
 
-// GUI功能
+// GUI功能: 可在任意线程调用，只投递到GUI更新邮箱 (gk_gui_mailbox.c)，由LVGL线程在下一个刷新周期应用
 void gk_gui_show_page(gk_page_t page);
 void gk_gui_update_combat_stats(gk_combat_stats_t* stats);
 void gk_gui_update_hit_visual(gk_hit_point_t* hit_point);  // 使用punchingBag算法增强
+
+// 以下函数直接调用LVGL，只能在LVGL线程 (定时器、事件回调) 或持有lv_vendor_disp_lock时调用
+void gk_gui_apply_page(gk_page_t page);
+void gk_gui_apply_combat_stats(const gk_combat_stats_t* stats);
+// hit为最新一次打击，heat为同一刷新周期内的全部打击 (含hit)，全部计入热力图
+void gk_gui_apply_hit_visual(const gk_hit_point_t* hit, const gk_hit_point_t* heat, uint32_t heat_count);
+// 主统计页面显示时创建内容并借用画布缓冲区，隐藏时删除
 void gk_gui_update_main_stats_page(void);
+void gk_gui_release_main_stats_page(void);
+#if defined(ENABLE_LIBLVGL) && (ENABLE_LIBLVGL == 1)
+lv_obj_t* gk_gui_get_page(gk_page_t page);
 void gk_gui_draw_stick_figure(lv_obj_t* parent, int height, int weight, int gender);
+#endif
 
-// 传感器功能
+// 传感器功能: 以下无句柄接口操作gk_sensor_init打开的沙袋0
 int gk_sensor_read_data(gk_force_data_t* data);
 int gk_calculate_hit_point(gk_force_data_t* force_data, gk_hit_point_t* hit_point);
+int gk_sensor_detect_punch(const gk_force_data_t* frame, gk_punch_event_t* event);
 uint32_t gk_sensor_get_hit_count(void);
 float gk_sensor_get_max_force_session(void);
 void gk_sensor_reset_session_stats(void);
+// 零点校准: 立即返回，由读取线程在后续采样中完成，gk_sensor_poll_calibration写入tal_kv
 int gk_sensor_calibrate(void);
+void gk_sensor_poll_calibration(void);
+
+// 采集线程: 以配置采样率写入无锁环形缓冲区，消费者按自身节奏取出
+// 运行中gk_sensor_init和gk_sensor_read_data/gk_sensor_dev_read_data返回OPRT_RESOURCE_NOT_READY
+int gk_sensor_start_acquisition(void);
+void gk_sensor_stop_acquisition(void);
+int gk_sensor_fetch_frames(gk_force_data_t* frames, int max_frames);
+void gk_sensor_get_stats(gk_sensor_stats_t* stats);
+
+// 替换原始数据源 (记录回放/主机基准测试)，read_cb为NULL时恢复内置模拟源
+int gk_sensor_set_source(gk_sensor_source_cb_t read_cb, void* ctx);
+
+// 多沙袋: 在gk_sensor_start_acquisition之前打开，采集线程按打开的实例统一调度，运行中不能打开或关闭
+// 每个采样周期轮流为每个实例读取一帧，耗时与沙袋数成正比，任何实例都不会占用其他实例的采样
+int gk_sensor_open(const gk_sensor_cfg_t* cfg, gk_sensor_t** hdl);
+int gk_sensor_close(gk_sensor_t* hdl);
+gk_sensor_t* gk_sensor_get(uint8_t id);    // 未打开时返回NULL
+int gk_sensor_dev_read_data(gk_sensor_t* hdl, gk_force_data_t* data);
+int gk_sensor_dev_detect_punch(gk_sensor_t* hdl, const gk_force_data_t* frame, gk_punch_event_t* event);
+int gk_sensor_dev_fetch_frames(gk_sensor_t* hdl, gk_force_data_t* frames, int max_frames);
+void gk_sensor_dev_get_stats(gk_sensor_t* hdl, gk_sensor_stats_t* stats);
+uint32_t gk_sensor_dev_get_hit_count(gk_sensor_t* hdl);
+float gk_sensor_dev_get_max_force_session(gk_sensor_t* hdl);
+void gk_sensor_dev_reset_session_stats(gk_sensor_t* hdl);
+int gk_sensor_dev_calibrate(gk_sensor_t* hdl);
+int gk_sensor_dev_set_source(gk_sensor_t* hdl, gk_sensor_source_cb_t read_cb, void* ctx);
 
 #ifdef __cplusplus
 }
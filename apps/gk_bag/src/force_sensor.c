@@ -1,191 +1,673 @@
 #include "gk_bag.h"
 #include "tal_log.h"
-#include "tal_time.h"
+#include "tal_system.h"
+#include "tal_thread.h"
+#include "gk_frame_ring.h"
+#include "gk_filter.h"
+#include "gk_fixed.h"
+#include "gk_punch_detector.h"
+#include "gk_punch_classifier.h"
+#include "gk_recorder.h"
+#include "gk_sensor_cal.h"
+#include "gk_trace.h"
 #include "math.h"
+#if defined(FORCE_SENSOR_SRC_ADS131M06) && (FORCE_SENSOR_SRC_ADS131M06 == 1)
+#include "tdd_ft_sensor_ads131m06.h"
+#define SENSOR_USE_TDL          1
+#elif defined(FORCE_SENSOR_SRC_TRACE) && (FORCE_SENSOR_SRC_TRACE == 1)
+#include "tdd_ft_sensor_trace.h"
+#define SENSOR_USE_TDL          1
+#else
+#define SENSOR_USE_TDL          0
+#endif
 
 #define TAG "FORCE_SENSOR"
 
 // 传感器配置
-#define SENSOR_I2C_ADDR         0x48
-#define SENSOR_SAMPLE_RATE_HZ   100
+#define SENSOR_DEV_NAME         "gk_ft_sensor"
+#define SENSOR_DRDY_TIMEOUT_MS  100     // 等待数据就绪的超时，超时后检查采集是否已停止
+// ADS131M06输出的计数到物理量的换算 (±2^23计数)，按传感器标定证书修改，
+// 细微偏差由校准参数中的scale修正
+#define SENSOR_ADS_FORCE_LSB    1.0e-4f // N/计数，满量程约±838N
+#define SENSOR_ADS_TORQUE_LSB   1.0e-5f // N·m/计数，满量程约±84N·m
+#ifdef FORCE_SENSOR_SAMPLE_RATE
+#define SENSOR_SAMPLE_RATE_HZ   FORCE_SENSOR_SAMPLE_RATE
+#else
+#define SENSOR_SAMPLE_RATE_HZ   1000
+#endif
+#ifdef FORCE_SENSOR_RING_DEPTH
+#define SENSOR_RING_DEPTH       FORCE_SENSOR_RING_DEPTH
+#else
+#define SENSOR_RING_DEPTH       256
+#endif
+#if (SENSOR_RING_DEPTH & (SENSOR_RING_DEPTH - 1)) != 0
+#error "FORCE_SENSOR_RING_DEPTH must be a power of two"
+#endif
+// 无FPU平台使用定点校准/滤波/求解
+#if defined(FORCE_SENSOR_FIXED_POINT) && (FORCE_SENSOR_FIXED_POINT == 1)
+#define SENSOR_USE_FIXED_POINT  1
+#else
+#define SENSOR_USE_FIXED_POINT  0
+#endif
+#define SENSOR_PERIOD_US        (1000000 / SENSOR_SAMPLE_RATE_HZ)
+// 多设备: 节拍之后其他设备最多等待一个采样周期 (向上取整到毫秒)，连续多轮超时的设备改为不等待
+#define SENSOR_DRDY_PEER_WAIT_MS    ((SENSOR_PERIOD_US + 999) / 1000)
+#define SENSOR_DRDY_STALL_ROUNDS    8
+// 采集线程单次唤醒最多补采20ms的数据，超出部分计为overrun
+#define SENSOR_MAX_BURST        ((SENSOR_SAMPLE_RATE_HZ / 50) > 4 ? (SENSOR_SAMPLE_RATE_HZ / 50) : 4)
+#ifdef FORCE_DETECTION_THRESHOLD
+#define FORCE_THRESHOLD         ((float)FORCE_DETECTION_THRESHOLD) // 注册为打击的最小力值 (N)
+#else
 #define FORCE_THRESHOLD         5.0f    // 注册为打击的最小力值 (N)
+#endif
+#ifdef PUNCH_RELEASE_RATIO
+#define PUNCH_RELEASE_FACTOR    (PUNCH_RELEASE_RATIO / 100.0f)
+#else
+#define PUNCH_RELEASE_FACTOR    0.6f    // 释放阈值 = 起始阈值 * 比例
+#endif
+#ifndef PUNCH_REFRACTORY_MS
+#define PUNCH_REFRACTORY_MS     60
+#endif
+#ifndef PUNCH_MAX_DURATION_MS
+#define PUNCH_MAX_DURATION_MS   300
+#endif
 #define NOISE_FILTER_ALPHA      0.8f    // 低通滤波器系数
+// 零点校准平均的样本数 (0.5秒)
+#define SENSOR_CAL_SAMPLES      (SENSOR_SAMPLE_RATE_HZ / 2)
+// 空闲期零漂跟踪
+#if defined(FORCE_SENSOR_DRIFT_TRACKING) && (FORCE_SENSOR_DRIFT_TRACKING == 1)
+#define SENSOR_DRIFT_TRACKING   1
+#else
+#define SENSOR_DRIFT_TRACKING   0
+#endif
+#ifdef FORCE_SENSOR_DRIFT_TAU_SEC
+#define SENSOR_DRIFT_TAU_MS     (FORCE_SENSOR_DRIFT_TAU_SEC * 1000)
+#else
+#define SENSOR_DRIFT_TAU_MS     30000
+#endif
+#define SENSOR_DRIFT_WINDOW_MS  100
+#define SENSOR_DRIFT_QUIET_N    (FORCE_THRESHOLD * PUNCH_RELEASE_FACTOR * 0.5f) // 校准后|F|低于此值视为空闲
+#define SENSOR_DRIFT_MAX_FORCE  5.0f    // 零点相对持久化基准的最大偏移 (N)
+#define SENSOR_DRIFT_MAX_TORQUE 0.5f    // (N·m)
 
-// 传感器校准数据 (实际实现中将从flash加载)
-static struct {
-    float fx_offset, fy_offset, fz_offset;
-    float mx_offset, my_offset, mz_offset;
-    float fx_scale, fy_scale, fz_scale;
-    float mx_scale, my_scale, mz_scale;
-    bool is_calibrated;
-} g_sensor_cal = {0};
+// 同一控制器驱动的沙袋数，每个沙袋一个传感器实例
+#ifdef FORCE_SENSOR_MAX_BAGS
+#define SENSOR_MAX_INSTANCES    FORCE_SENSOR_MAX_BAGS
+#else
+#define SENSOR_MAX_INSTANCES    1
+#endif
+
+// 校准前的一帧原始数据
+// 定点链路从数据源到滤波输出全部为整数: 设备数据源为ADC计数，
+// 合成数据源和替代数据源本身是浮点的，在数据源处转换为Q16 (每计数1/65536)
+#if SENSOR_USE_FIXED_POINT
+typedef int32_t sensor_raw_t;
+#else
+typedef float sensor_raw_t;
+#endif
+
+// 传感器校准数据: 启动时从tal_kv加载，零点在空闲期由零漂跟踪更新 (仅读取线程修改)
+typedef struct {
+    float offset[6];
+    float scale[6];
+    bool is_calibrated;         // 已从tal_kv加载或完成过零点校准
+#if SENSOR_USE_FIXED_POINT
+    float raw_lsb[6];           // 当前数据源每计数对应的物理量
+    gk_fixed_cal_t fixed;       // 计数 -> 校准后Q16，由浮点参数同步生成
+    gk_fixed_cal_t unit;        // 计数 -> 校准前Q16 (零点累加和会话录制)
+#endif
+#if SENSOR_DRIFT_TRACKING
+    gk_drift_tracker_t drift;
+#if SENSOR_USE_FIXED_POINT
+    int64_t drift_sum[6];       // 当前零漂窗口的整数累加 (Q16)，每窗口交给drift一次
+    uint32_t drift_count;
+    bool drift_quiet;
+#endif
+#endif
+    
+    // 零点校准: 读取线程在后续采样中累加，不停止采样
+    volatile bool cal_request;
+    uint32_t cal_count;
+#if SENSOR_USE_FIXED_POINT
+    int64_t cal_sum[6];         // 校准前Q16的累加
+#else
+    float cal_sum[6];
+#endif
+    float cal_result[6];
+    uint32_t cal_done;          // 完成次数，读取线程release写入
+    uint32_t cal_saved;         // 已写入tal_kv的次数 (主任务)
+} sensor_cal_t;
 
 // 增强的传感器状态，包含滤波历史
-static struct {
+typedef struct {
     gk_force_data_t last_data;
     gk_force_data_t filtered_data;
     bool is_initialized;
     uint32_t hit_count;
     float max_force_session;
+    uint32_t classify_count;    // 拳法分类耗时统计 (微秒)
+    uint32_t classify_us_max;
+    uint64_t classify_us_sum;
+    
+    // 数据滤波器组 (基于punchingBag dataloader: 中值滤波 + 移动平均)
+#if SENSOR_USE_FIXED_POINT
+    gk_filter_bank_q16_t filter;
+#else
+    gk_filter_bank_t filter;
+#endif
+    
+    // 打击分段 (在消费者线程中运行)
+    gk_punch_detector_t punch;
+} sensor_state_t;
+
+// 单个沙袋的采集状态 (生产者侧计数仅由采集线程修改)
+typedef struct {
+    gk_frame_ring_t ring;
+    uint32_t samples;
+    uint32_t overruns;
+    uint32_t read_errors;
+#if SENSOR_USE_TDL
+    TDL_FT_SENSOR_HANDLE_T dev; // 数据就绪中断驱动的传感器设备，打开失败时为NULL
+    uint8_t drdy_misses;        // 非节拍设备连续未按时就绪的轮数
+#endif
+} sensor_acq_t;
+
+// 一个沙袋的全部传感状态: 数据源、校准、滤波、打击分段、统计和环形缓冲区
+struct gk_sensor {
+    bool in_use;
+    gk_sensor_cfg_t cfg;
+    sensor_cal_t cal;
+    sensor_state_t state;
+    sensor_acq_t acq;
+    
+    // 原始数据来源: 优先使用gk_sensor_dev_set_source设置的数据源 (主机基准测试回放记录的会话或自定义数据)，
+    // 其次是ft_sensor设备 (ADS131M06或Ubuntu上的trace回放)，都没有时使用合成数据源模拟传感器
+    gk_sensor_source_cb_t source_read;
+    void* source_ctx;
+    gk_trace_synth_t sim;
+    
+    gk_force_data_t ring_buf[SENSOR_RING_DEPTH];
+};
+
+static gk_sensor_t g_sensor_pool[SENSOR_MAX_INSTANCES];
+
+// 采集线程: 所有实例共用一个线程
+static struct {
+    THREAD_HANDLE thread;
+    volatile bool running;
+} g_sensor_acq = {0};
+
+// 默认校准参数: 静止时传感器读到沙袋重力，去皮后Fz为0
+static const float g_sensor_cal_default_offset[6] = {0.0f, 0.0f, -9.81f, 0.0f, 0.0f, 0.0f};
+
+// gk_sensor_init打开的沙袋0，供单沙袋接口使用
+#define SENSOR_DEFAULT          (&g_sensor_pool[0])
+
+#if SENSOR_USE_FIXED_POINT
+// 浮点数据源 (合成数据、替代数据源) 在入口处转换为Q16计数
+static int sensor_read_float_source(gk_sensor_source_cb_t read_cb, void* ctx, sensor_raw_t* raw_data)
+{
+    float ch[6];
+    int rt = read_cb(ctx, ch);
     
-    // 数据滤波缓冲区 (基于punchingBag dataloader)
-    float history[5][6];        // Raw data history for median filter
-    float smoothed_history[5][6]; // Smoothed data history
-    int history_index;
-    int history_count;
-} g_sensor_state = {0};
-
-// 模拟传感器硬件接口 (替换为实际驱动程序)
-static int read_raw_sensor_data(float* raw_data)
-{
-    // 模拟传感器读取 - 替换为实际I2C/SPI通信
-    // 目前生成一些真实的测试数据
-    static float time_counter = 0;
-    time_counter += 0.01f; // 100Hz simulation
-    
-    // 模拟环境噪声
-    float noise_level = 0.1f;
-    
-    // 生成带有小随机变化的基线读数
-    raw_data[0] = (rand() % 1000 - 500) * noise_level / 1000.0f; // Fx
-    raw_data[1] = (rand() % 1000 - 500) * noise_level / 1000.0f; // Fy  
-    raw_data[2] = -9.81f + (rand() % 100 - 50) * noise_level / 100.0f; // Fz (gravity)
-    raw_data[3] = (rand() % 1000 - 500) * noise_level / 1000.0f; // Mx
-    raw_data[4] = (rand() % 1000 - 500) * noise_level / 1000.0f; // My
-    raw_data[5] = (rand() % 1000 - 500) * noise_level / 1000.0f; // Mz
-    
-    // 偶尔模拟一次打击 (用于测试)
-    if ((rand() % 500) == 0) { // Random hit every ~5 seconds at 100Hz
-        float hit_force = 50.0f + (rand() % 100); // 50-150N hit
-        float hit_angle = (rand() % 360) * M_PI / 180.0f;
-        
-        raw_data[0] += hit_force * cos(hit_angle) * 0.5f;
-        raw_data[1] += hit_force * sin(hit_angle) * 0.5f;
-        raw_data[2] += hit_force * 0.8f; // Mainly in Z direction
-        
-        // 添加对应的力矩
-        raw_data[3] += hit_force * 0.1f * sin(hit_angle);
-        raw_data[4] += hit_force * 0.1f * cos(hit_angle);
-        
-        TAL_PR_INFO(TAG, "模拟打击: F=%.1f N, 角度=%.1f 度", hit_force, hit_angle * 180.0f / M_PI);
+    if (rt == OPRT_OK) {
+        for (int i = 0; i < 6; i++) {
+            raw_data[i] = GK_FLOAT_TO_Q16(ch[i]);
+        }
     }
+    return rt;
+}
+#endif
+
+// timestamp_us返回采集时刻: 设备数据源为数据就绪中断的时刻，其他数据源为读取完成的时刻
+// timeout_ms为设备数据源等待数据就绪的时间
+static int read_raw_sensor_data(gk_sensor_t* s, sensor_raw_t* raw_data, uint64_t* timestamp_us, uint32_t timeout_ms)
+{
+    int rt;
     
+    if (s->source_read) {
+#if SENSOR_USE_FIXED_POINT
+        rt = sensor_read_float_source(s->source_read, s->source_ctx, raw_data);
+#else
+        rt = s->source_read(s->source_ctx, raw_data);
+#endif
+        *timestamp_us = tal_system_get_microsecond();
+        return rt;
+    }
+    
+#if SENSOR_USE_TDL
+    if (s->acq.dev) {
+#if SENSOR_USE_FIXED_POINT
+        TDL_FT_RAW_FRAME_T ft;
+        rt = tdl_ft_sensor_dev_read_raw(s->acq.dev, &ft, timeout_ms);
+        if (rt != OPRT_OK) {
+            return rt;
+        }
+        memcpy(raw_data, ft.raw, sizeof(ft.raw));
+#else
+        TDL_FT_FRAME_T ft;
+        rt = tdl_ft_sensor_dev_read(s->acq.dev, &ft, timeout_ms);
+        if (rt != OPRT_OK) {
+            return rt;
+        }
+        memcpy(raw_data, ft.ch, sizeof(ft.ch));
+#endif
+        *timestamp_us = ft.timestamp_us;
+        return OPRT_OK;
+    }
+#else
+    (void)timeout_ms;
+#endif
+    
+    // 模拟传感器: 环境噪声 + 重力 + 平均每5秒一次的随机打击
+#if SENSOR_USE_FIXED_POINT
+    rt = sensor_read_float_source(gk_trace_synth_read, &s->sim, raw_data);
+#else
+    rt = gk_trace_synth_read(&s->sim, raw_data);
+#endif
+    *timestamp_us = tal_system_get_microsecond();
+    return rt;
+}
+
+// 由数据就绪中断驱动采集: 有ft_sensor设备且未设置替代数据源
+static bool sensor_is_drdy_driven(const gk_sensor_t* s)
+{
+#if SENSOR_USE_TDL
+    return s->acq.dev != NULL && s->source_read == NULL;
+#else
+    (void)s;
+    return false;
+#endif
+}
+
+#if SENSOR_USE_TDL
+// 打开实例配置的ft_sensor设备，失败时保留模拟数据源
+// 沙袋0的设备按Kconfig中的引脚自动注册，其他沙袋的设备由板级代码注册
+static void sensor_open_device(gk_sensor_t* s)
+{
+    if (s->cfg.dev_name == NULL) {
+        return;
+    }
+    
+    TDL_FT_SENSOR_HANDLE_T dev = tdl_ft_sensor_find_dev((char*)s->cfg.dev_name);
+    
+    if (dev == NULL && s->cfg.id == 0) {
+#if defined(FORCE_SENSOR_SRC_ADS131M06) && (FORCE_SENSOR_SRC_ADS131M06 == 1)
+        TDD_FT_SENSOR_ADS131M06_CFG_T cfg = {
+            .port = FORCE_SENSOR_SPI_PORT,
+            .spi_clk = FORCE_SENSOR_SPI_CLK,
+            .drdy_pin = FORCE_SENSOR_DRDY_PIN,
+            .rst_pin = FORCE_SENSOR_RST_PIN,
+            .sample_rate_hz = SENSOR_SAMPLE_RATE_HZ,
+            .lsb = {SENSOR_ADS_FORCE_LSB, SENSOR_ADS_FORCE_LSB, SENSOR_ADS_FORCE_LSB,
+                    SENSOR_ADS_TORQUE_LSB, SENSOR_ADS_TORQUE_LSB, SENSOR_ADS_TORQUE_LSB},
+        };
+        tdd_ft_sensor_ads131m06_register((char*)s->cfg.dev_name, &cfg);
+#else
+        TDD_FT_SENSOR_TRACE_CFG_T cfg = {
+            .sample_rate_hz = SENSOR_SAMPLE_RATE_HZ,
+            .skip_cols = FORCE_SENSOR_TRACE_SKIP_COLS,
+            .loop = true,
+        };
+        strncpy(cfg.path, FORCE_SENSOR_TRACE_PATH, sizeof(cfg.path) - 1);
+        tdd_ft_sensor_trace_register((char*)s->cfg.dev_name, &cfg);
+#endif
+        dev = tdl_ft_sensor_find_dev((char*)s->cfg.dev_name);
+    }
+    
+    if (dev == NULL || tdl_ft_sensor_dev_open(dev) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "沙袋%u: 传感器设备%s打开失败，使用模拟数据", s->cfg.id, s->cfg.dev_name);
+        return;
+    }
+#if SENSOR_USE_FIXED_POINT
+    // 定点链路直接读取ADC计数
+    float lsb[6];
+    if (tdl_ft_sensor_dev_get_lsb(dev, lsb) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "沙袋%u: 传感器设备%s不支持计数读取，使用模拟数据", s->cfg.id, s->cfg.dev_name);
+        tdl_ft_sensor_dev_close(dev);
+        return;
+    }
+#endif
+    s->acq.dev = dev;
+}
+#endif
+
+// 校准参数或数据源变化后同步定点副本
+static void sensor_cal_sync_fixed(gk_sensor_t* s)
+{
+#if SENSOR_USE_FIXED_POINT
+    sensor_cal_t* cal = &s->cal;
+    
+    for (int i = 0; i < 6; i++) {
+        cal->raw_lsb[i] = 1.0f / GK_Q16_ONE; // 浮点数据源在入口处转换为Q16
+    }
+#if SENSOR_USE_TDL
+    if (sensor_is_drdy_driven(s)) {
+        tdl_ft_sensor_dev_get_lsb(s->acq.dev, cal->raw_lsb);
+    }
+#endif
+    for (int i = 0; i < 6; i++) {
+        gk_fixed_cal_set(&cal->fixed, i, cal->offset[i] / cal->raw_lsb[i], cal->raw_lsb[i] * cal->scale[i]);
+        gk_fixed_cal_set(&cal->unit, i, 0.0f, cal->raw_lsb[i]);
+    }
+#else
+    (void)s;
+#endif
+}
+
+int gk_sensor_dev_set_source(gk_sensor_t* s, gk_sensor_source_cb_t read_cb, void* ctx)
+{
+    if (!s || !s->in_use) {
+        return OPRT_INVALID_PARM;
+    }
+    if (g_sensor_acq.running) {
+        return OPRT_RESOURCE_NOT_READY; // 采集线程运行中不能切换数据源
+    }
+    
+    s->source_ctx = ctx;
+    s->source_read = read_cb;
+    sensor_cal_sync_fixed(s); // 计数的单位随数据源变化
     return OPRT_OK;
 }
 
-int gk_sensor_init(void)
+int gk_sensor_set_source(gk_sensor_source_cb_t read_cb, void* ctx)
 {
-    TAL_PR_INFO(TAG, "初始化力传感器");
+    return gk_sensor_dev_set_source(SENSOR_DEFAULT, read_cb, ctx);
+}
+
+// 加载持久化校准参数，没有有效数据时使用默认值
+static void sensor_cal_load(gk_sensor_t* s)
+{
+    sensor_cal_t* cal = &s->cal;
+    
+    for (int i = 0; i < 6; i++) {
+        cal->offset[i] = g_sensor_cal_default_offset[i];
+        cal->scale[i] = 1.0f;  // 缩放因子 (传感器特定)
+    }
+    cal->is_calibrated = (gk_sensor_cal_load(s->cfg.id, cal->offset, cal->scale) == OPRT_OK);
+    cal->cal_request = false;
+    cal->cal_count = 0;
+    
+#if SENSOR_DRIFT_TRACKING
+    gk_drift_tracker_cfg_t drift_cfg = {
+        .window_samples = SENSOR_DRIFT_WINDOW_MS * SENSOR_SAMPLE_RATE_HZ / 1000,
+        .gain = (float)SENSOR_DRIFT_WINDOW_MS / SENSOR_DRIFT_TAU_MS,
+        .max_force_drift = SENSOR_DRIFT_MAX_FORCE,
+        .max_torque_drift = SENSOR_DRIFT_MAX_TORQUE,
+    };
+    gk_drift_tracker_init(&cal->drift, &drift_cfg, cal->offset);
+#if SENSOR_USE_FIXED_POINT
+    cal->drift_count = 0;
+    cal->drift_quiet = true;
+#endif
+#endif
+    sensor_cal_sync_fixed(s);
+    
+    TAL_PR_INFO(TAG, "沙袋%u校准参数%s: Fx=%.3f Fy=%.3f Fz=%.3f Mx=%.3f My=%.3f Mz=%.3f", s->cfg.id,
+                cal->is_calibrated ? "已加载" : "使用默认值",
+                cal->offset[0], cal->offset[1], cal->offset[2],
+                cal->offset[3], cal->offset[4], cal->offset[5]);
+}
+
+#if SENSOR_USE_FIXED_POINT
+// 整数累加的均值 (Q16) 转换为物理量，每次零点校准或零漂窗口只做一次
+static void sensor_cal_mean(const int64_t sum[6], uint32_t count, float mean[6])
+{
+    for (int i = 0; i < 6; i++) {
+        mean[i] = (float)(sum[i] / (int64_t)count) * (1.0f / GK_Q16_ONE);
+    }
+}
+#endif
+
+// 读取线程逐帧调用: 进行中的零点校准优先，否则在空闲期跟踪零漂
+// raw_data为校准前的物理量 (定点链路为Q16)，quiet表示本帧校准后的受力低于空闲阈值
+#if SENSOR_USE_FIXED_POINT
+static void sensor_cal_track(gk_sensor_t* s, const gk_q16_t raw_data[6], bool quiet)
+#else
+static void sensor_cal_track(gk_sensor_t* s, const float raw_data[6], bool quiet)
+#endif
+{
+    sensor_cal_t* cal = &s->cal;
     
-    // 初始化I2C/SPI接口 (平台特定)
-    // 为模拟，只标记为已初始化
+    if (cal->cal_request) {
+        if (cal->cal_count == 0) {
+            memset(cal->cal_sum, 0, sizeof(cal->cal_sum));
+        }
+        for (int i = 0; i < 6; i++) {
+            cal->cal_sum[i] += raw_data[i];
+        }
+        if (++cal->cal_count < SENSOR_CAL_SAMPLES) {
+            return;
+        }
     
-    // 从flash加载校准数据
-    // 在实际实现中，这将从持久化存储中读取
-    g_sensor_cal.fx_offset = 0.0f;
-    g_sensor_cal.fy_offset = 0.0f;
-    g_sensor_cal.fz_offset = 9.81f; // Gravity offset
-    g_sensor_cal.mx_offset = 0.0f;
-    g_sensor_cal.my_offset = 0.0f;
-    g_sensor_cal.mz_offset = 0.0f;
+        // 平均值作为零点，Fz包含沙袋重力，去皮后静止时Fz为0
+#if SENSOR_USE_FIXED_POINT
+        sensor_cal_mean(cal->cal_sum, cal->cal_count, cal->offset);
+#else
+        for (int i = 0; i < 6; i++) {
+            cal->offset[i] = cal->cal_sum[i] / cal->cal_count;
+        }
+#endif
+        memcpy(cal->cal_result, cal->offset, sizeof(cal->cal_result));
+        cal->cal_count = 0;
+        cal->cal_request = false;
+        cal->is_calibrated = true;
+#if SENSOR_DRIFT_TRACKING
+        gk_drift_tracker_rebase(&cal->drift, cal->offset);
+#if SENSOR_USE_FIXED_POINT
+        cal->drift_count = 0;
+        cal->drift_quiet = true;
+#endif
+#endif
+        sensor_cal_sync_fixed(s);
+        // 写入tal_kv会阻塞数十毫秒，交给主任务在gk_sensor_poll_calibration中完成
+        __atomic_store_n(&cal->cal_done, cal->cal_done + 1, __ATOMIC_RELEASE);
+        return;
+    }
     
-    // 缩放因子 (传感器特定)
-    g_sensor_cal.fx_scale = 1.0f;
-    g_sensor_cal.fy_scale = 1.0f;
-    g_sensor_cal.fz_scale = 1.0f;
-    g_sensor_cal.mx_scale = 1.0f;
-    g_sensor_cal.my_scale = 1.0f;
-    g_sensor_cal.mz_scale = 1.0f;
+#if SENSOR_DRIFT_TRACKING && SENSOR_USE_FIXED_POINT
+    // 逐帧只做整数累加，整窗后以窗口均值输入零漂跟踪
+    if (cal->drift_count == 0) {
+        memset(cal->drift_sum, 0, sizeof(cal->drift_sum));
+    }
+    for (int i = 0; i < 6; i++) {
+        cal->drift_sum[i] += raw_data[i];
+    }
+    if (!quiet) {
+        cal->drift_quiet = false;
+    }
+    if (++cal->drift_count < cal->drift.cfg.window_samples) {
+        return;
+    }
+    float mean[6];
+    sensor_cal_mean(cal->drift_sum, cal->drift_count, mean);
+    bool window_quiet = cal->drift_quiet;
+    cal->drift_count = 0;
+    cal->drift_quiet = true;
+    if (gk_drift_tracker_feed_window(&cal->drift, mean, window_quiet, cal->offset)) {
+        sensor_cal_sync_fixed(s);
+    }
+#elif SENSOR_DRIFT_TRACKING
+    if (gk_drift_tracker_feed(&cal->drift, raw_data, quiet, cal->offset)) {
+        sensor_cal_sync_fixed(s);
+    }
+#else
+    (void)quiet;
+#endif
+}
+
+// 打开或重新初始化一个实例: 设备、校准、滤波和打击分段，只在采集线程停止时调用
+static void sensor_instance_init(gk_sensor_t* s, const gk_sensor_cfg_t* cfg)
+{
+    if (!s->in_use) {
+        memset(s, 0, offsetof(gk_sensor_t, ring_buf));
+        s->cfg = *cfg;
+        s->in_use = true;
+    }
     
-    g_sensor_cal.is_calibrated = true;
+#if SENSOR_USE_TDL
+    if (s->acq.dev == NULL) {
+        sensor_open_device(s);
+    }
+#endif
+    
+    // 从tal_kv加载校准数据，只读取一个带CRC的小记录
+    sensor_cal_load(s);
+    
+    // 每个沙袋的模拟数据源使用不同种子，避免打击同时出现
+    gk_trace_synth_cfg_t sim_cfg = GK_TRACE_SYNTH_DEFAULT(SENSOR_SAMPLE_RATE_HZ);
+    sim_cfg.seed += s->cfg.id;
+    gk_trace_synth_init(&s->sim, &sim_cfg);
     
     // 初始化传感器状态
-    memset(&g_sensor_state, 0, sizeof(g_sensor_state));
-    g_sensor_state.is_initialized = true;
+    memset(&s->state, 0, sizeof(s->state));
+#if SENSOR_USE_FIXED_POINT
+    gk_filter_bank_q16_reset(&s->state.filter);
+#else
+    gk_filter_bank_reset(&s->state.filter);
+#endif
+    
+    gk_punch_detector_cfg_t punch_cfg = {
+        .onset_threshold = FORCE_THRESHOLD,
+        .release_threshold = FORCE_THRESHOLD * PUNCH_RELEASE_FACTOR,
+        .refractory_samples = PUNCH_REFRACTORY_MS * SENSOR_SAMPLE_RATE_HZ / 1000,
+        .max_samples = PUNCH_MAX_DURATION_MS * SENSOR_SAMPLE_RATE_HZ / 1000,
+        .sample_period_s = 1.0f / SENSOR_SAMPLE_RATE_HZ,
+    };
+    gk_punch_detector_init(&s->state.punch, &punch_cfg);
+    s->state.is_initialized = true;
+    
+    gk_frame_ring_init(&s->acq.ring, s->ring_buf, SENSOR_RING_DEPTH);
+}
+
+int gk_sensor_init(void)
+{
+    if (g_sensor_acq.running) {
+        return OPRT_RESOURCE_NOT_READY; // 滤波和打击分段状态归采集线程所有
+    }
+    
+    TAL_PR_INFO(TAG, "初始化力传感器");
+    
+    gk_sensor_cfg_t cfg = {
+        .id = 0,
+#if SENSOR_USE_TDL
+        .dev_name = SENSOR_DEV_NAME,
+#endif
+    };
+    sensor_instance_init(SENSOR_DEFAULT, &cfg);
     
     TAL_PR_INFO(TAG, "力传感器初始化成功");
     return OPRT_OK;
 }
 
-// 增强的中值滤波实现 (来自punchingBag)
-static float calculate_median(float values[], int count)
+int gk_sensor_open(const gk_sensor_cfg_t* cfg, gk_sensor_t** hdl)
 {
-    // 小数组的简单冒泡排序
-    float temp_array[5];
-    for (int i = 0; i < count; i++) {
-        temp_array[i] = values[i];
+    if (!cfg || !hdl || cfg->id >= SENSOR_MAX_INSTANCES) {
+        return OPRT_INVALID_PARM;
+    }
+    if (g_sensor_acq.running) {
+        return OPRT_RESOURCE_NOT_READY; // 采集线程按打开的实例调度，运行中不能增减
     }
     
-    for (int i = 0; i < count - 1; i++) {
-        for (int j = 0; j < count - i - 1; j++) {
-            if (temp_array[j] > temp_array[j + 1]) {
-                float temp = temp_array[j];
-                temp_array[j] = temp_array[j + 1];
-                temp_array[j + 1] = temp;
-            }
-        }
+    gk_sensor_t* s = &g_sensor_pool[cfg->id];
+    if (s->in_use) {
+        TAL_PR_ERR(TAG, "沙袋%u已打开", cfg->id);
+        return OPRT_COM_ERROR;
     }
     
-    return temp_array[count / 2];
+    sensor_instance_init(s, cfg);
+    TAL_PR_INFO(TAG, "沙袋%u已打开: %s", cfg->id, sensor_is_drdy_driven(s) ? cfg->dev_name : "模拟数据");
+    *hdl = s;
+    return OPRT_OK;
 }
 
-int gk_sensor_read_data(gk_force_data_t* data)
+int gk_sensor_close(gk_sensor_t* s)
 {
-    if (!g_sensor_state.is_initialized || !data) {
+    if (!s || !s->in_use) {
         return OPRT_INVALID_PARM;
     }
+    if (g_sensor_acq.running) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
     
-    float raw_data[6];
-    if (read_raw_sensor_data(raw_data) != OPRT_OK) {
-        return OPRT_COM_ERROR;
+#if SENSOR_USE_TDL
+    if (s->acq.dev) {
+        tdl_ft_sensor_dev_close(s->acq.dev);
     }
+#endif
+    s->in_use = false;
+    s->state.is_initialized = false;
+    return OPRT_OK;
+}
+
+gk_sensor_t* gk_sensor_get(uint8_t id)
+{
+    if (id >= SENSOR_MAX_INSTANCES || !g_sensor_pool[id].in_use) {
+        return NULL;
+    }
+    return &g_sensor_pool[id];
+}
+
+// 一帧校准前的数据和滤波输出 (供零点跟踪和会话录制)
+typedef struct {
+#if SENSOR_USE_FIXED_POINT
+    gk_q16_t raw[6];
+    gk_q16_t filtered[6];
+#else
+    float raw[6];
+#endif
+} sensor_sample_t;
+
+// 读取一帧并完成校准和滤波，smp返回校准前的原始数据
+static int sensor_read_frame(gk_sensor_t* s, gk_force_data_t* data, sensor_sample_t* smp, uint32_t timeout_ms)
+{
+    sensor_raw_t raw_data[6];
     
-    // 应用校准
-    float calibrated_data[6];
-    calibrated_data[0] = (raw_data[0] - g_sensor_cal.fx_offset) * g_sensor_cal.fx_scale;
-    calibrated_data[1] = (raw_data[1] - g_sensor_cal.fy_offset) * g_sensor_cal.fy_scale;
-    calibrated_data[2] = (raw_data[2] - g_sensor_cal.fz_offset) * g_sensor_cal.fz_scale;
-    calibrated_data[3] = (raw_data[3] - g_sensor_cal.mx_offset) * g_sensor_cal.mx_scale;
-    calibrated_data[4] = (raw_data[4] - g_sensor_cal.my_offset) * g_sensor_cal.my_scale;
-    calibrated_data[5] = (raw_data[5] - g_sensor_cal.mz_offset) * g_sensor_cal.mz_scale;
+    // 时间戳在采集时获取，校准和滤波的耗时不计入
+    int rt = read_raw_sensor_data(s, raw_data, &data->timestamp, timeout_ms);
+    if (rt != OPRT_OK) {
+        return (rt == OPRT_TIMEOUT) ? OPRT_TIMEOUT : OPRT_COM_ERROR;
+    }
     
-    // 基于punchingBag dataloader算法的增强滤波
+#if SENSOR_USE_FIXED_POINT
+    // 定点路径: 从计数开始的校准、空闲判定和滤波全部为整数运算，
+    // 只在写入对外的gk_force_data_t时转换为浮点
+    gk_q16_t calibrated_q16[6];
+    gk_fixed_calibrate(&s->cal.fixed, raw_data, calibrated_q16);
+    gk_fixed_calibrate(&s->cal.unit, raw_data, smp->raw);
     
-    // 步骤1: 添加到历史缓冲区
-    int idx = g_sensor_state.history_index % 5;
-    for (int i = 0; i < 6; i++) {
-        g_sensor_state.history[idx][i] = calibrated_data[i];
-    }
-    g_sensor_state.history_index++;
-    if (g_sensor_state.history_count < 5) {
-        g_sensor_state.history_count++;
+    // 空闲判定使用未滤波的校准数据: |F|²在Q32下比较，各分量先饱和到±2^30以免平方和溢出
+    const int64_t quiet_q16 = (int64_t)(SENSOR_DRIFT_QUIET_N * GK_Q16_ONE);
+    int64_t force_sq = 0;
+    for (int i = 0; i < 3; i++) {
+        int64_t f = calibrated_q16[i];
+        f = (f > (1 << 30)) ? (1 << 30) : ((f < -(1 << 30)) ? -(1 << 30) : f);
+        force_sq += f * f;
     }
+    bool quiet = force_sq < quiet_q16 * quiet_q16;
+    gk_filter_bank_q16_process(&s->state.filter, calibrated_q16, smp->filtered);
     
-    // 步骤2: 应用中值滤波
-    float median_filtered[6];
-    for (int channel = 0; channel < 6; channel++) {
-        float channel_values[5];
-        for (int i = 0; i < g_sensor_state.history_count; i++) {
-            channel_values[i] = g_sensor_state.history[i][channel];
-        }
-        median_filtered[channel] = calculate_median(channel_values, g_sensor_state.history_count);
+    float smoothed_data[6];
+    for (int i = 0; i < 6; i++) {
+        smoothed_data[i] = GK_Q16_TO_FLOAT(smp->filtered[i]);
     }
+#else
+    memcpy(smp->raw, raw_data, sizeof(smp->raw));
     
-    // 步骤3: 应用移动平均 (平滑)
-    int smooth_idx = (g_sensor_state.history_index - 1) % 5;
+    // 应用校准
+    float calibrated_data[6];
     for (int i = 0; i < 6; i++) {
-        g_sensor_state.smoothed_history[smooth_idx][i] = median_filtered[i];
+        calibrated_data[i] = (raw_data[i] - s->cal.offset[i]) * s->cal.scale[i];
     }
     
-    float smoothed_data[6] = {0};
-    int smooth_count = (g_sensor_state.history_count < 5) ? g_sensor_state.history_count : 5;
-    for (int channel = 0; channel < 6; channel++) {
-        float sum = 0;
-        for (int i = 0; i < smooth_count; i++) {
-            sum += g_sensor_state.smoothed_history[i][channel];
-        }
-        smoothed_data[channel] = sum / smooth_count;
-    }
+    // 空闲判定使用未滤波的校准数据
+    bool quiet = calibrated_data[0] * calibrated_data[0] + calibrated_data[1] * calibrated_data[1] +
+                 calibrated_data[2] * calibrated_data[2] < SENSOR_DRIFT_QUIET_N * SENSOR_DRIFT_QUIET_N;
+    
+    // 基于punchingBag dataloader算法的增强滤波: 六通道一次处理
+    float smoothed_data[6];
+    gk_filter_bank_process(&s->state.filter, calibrated_data, smoothed_data);
+#endif
     
     // 填充输出数据结构
     data->fx = smoothed_data[0];
@@ -194,21 +676,278 @@ int gk_sensor_read_data(gk_force_data_t* data)
     data->mx = smoothed_data[3];
     data->my = smoothed_data[4];
     data->mz = smoothed_data[5];
-    data->timestamp = tal_time_get_posix();
     
-    g_sensor_state.last_data = *data;
-    g_sensor_state.filtered_data = *data;
+    s->state.last_data = *data;
+    s->state.filtered_data = *data;
+    
+    // 本帧已按当前零点校准，零点的更新从下一帧起生效
+    sensor_cal_track(s, smp->raw, quiet);
+    
+    return OPRT_OK;
+}
+
+int gk_sensor_dev_read_data(gk_sensor_t* s, gk_force_data_t* data)
+{
+    if (!s || !s->state.is_initialized || !data) {
+        return OPRT_INVALID_PARM;
+    }
+    if (g_sensor_acq.running) {
+        return OPRT_RESOURCE_NOT_READY; // 采集线程运行中由gk_sensor_fetch_frames取出
+    }
+    
+    sensor_sample_t smp;
+    return sensor_read_frame(s, data, &smp, SENSOR_DRDY_TIMEOUT_MS);
+}
+
+int gk_sensor_read_data(gk_force_data_t* data)
+{
+    return gk_sensor_dev_read_data(SENSOR_DEFAULT, data);
+}
+
+// 读取一帧写入实例的环形缓冲区，沙袋0同时交给会话录制
+// 返回是否读到了一帧
+static bool sensor_acquire_frame(gk_sensor_t* s, uint32_t timeout_ms)
+{
+    gk_force_data_t frame;
+    sensor_sample_t smp;
+    int rt = sensor_read_frame(s, &frame, &smp, timeout_ms);
+    
+    if (rt == OPRT_TIMEOUT) {
+        return false; // 数据就绪超时: 不是读取错误，也不占用采样序号
+    }
+    if (rt != OPRT_OK) {
+        s->acq.read_errors++;
+        return false;
+    }
+    s->acq.samples++;
+    gk_frame_ring_push(&s->acq.ring, &frame);
+#if GK_RECORDER_ENABLE
+    // 会话文件格式只有一路数据，录制沙袋0
+    // 采样周期序号: 读取失败和overrun也占用序号，回放时可据此还原时间轴
+    // 这里只做入队，flash写入在录制线程中完成
+    if (s == SENSOR_DEFAULT) {
+        uint32_t seq = s->acq.samples - 1 + s->acq.overruns + s->acq.read_errors;
+#if SENSOR_USE_FIXED_POINT
+        gk_recorder_push_q16(seq, (uint32_t)(frame.timestamp / 1000), smp.raw, smp.filtered);
+#else
+        gk_recorder_push(seq, (uint32_t)(frame.timestamp / 1000), smp.raw, &frame);
+#endif
+    }
+#endif
+    return true;
+}
+
+#if SENSOR_USE_TDL
+// 中断驱动采集: 第一个设备实例的数据就绪作为节拍，阻塞等待，不轮询不休眠
+// 同一采样率的其他设备相位各不相同，节拍后依次等待各自的数据就绪，每个设备一个周期内必有一帧，
+// 一轮总耗时不超过一个采样周期；先就绪的设备不会多读，每个沙袋每周期最多一帧。
+// 帧的时间戳取自各设备自己的数据就绪时刻，与读取的先后无关。
+// 传感器只保留最新一帧，未及时读取而被覆盖的帧计为overrun
+static void sensor_acq_drdy_round(gk_sensor_t** drdy, int n_drdy)
+{
+    TDL_FT_SENSOR_STATS_T dev_stats;
+    
+    for (int k = 0; k < n_drdy; k++) {
+        gk_sensor_t* s = drdy[k];
+        if (tdl_ft_sensor_dev_get_stats(s->acq.dev, &dev_stats) == OPRT_OK) {
+            s->acq.overruns = dev_stats.overruns;
+        }
+        if (k == 0) {
+            if (!sensor_acquire_frame(s, SENSOR_DRDY_TIMEOUT_MS)) {
+                return; // 节拍设备超时，检查采集是否已停止
+            }
+            continue;
+        }
+
+        // 停止输出的设备不再等待，避免每轮拖慢节拍设备，恢复出帧后重新等待
+        uint32_t wait_ms = (s->acq.drdy_misses < SENSOR_DRDY_STALL_ROUNDS) ? SENSOR_DRDY_PEER_WAIT_MS : 0;
+        if (sensor_acquire_frame(s, wait_ms)) {
+            s->acq.drdy_misses = 0;
+        } else if (s->acq.drdy_misses < SENSOR_DRDY_STALL_ROUNDS) {
+            s->acq.drdy_misses++;
+        }
+    }
+}
+#endif
+
+// 定时采集: 用于合成数据源和替代数据源
+// tal_system_sleep只有毫秒精度，因此按微秒时钟实际经过的时间补采应得的样本数
+// 多个实例逐样本轮流读取，每个实例每轮一帧
+static void sensor_acq_timed_round(gk_sensor_t** timed, int n_timed, uint64_t* last_us, uint32_t* owed_us)
+{
+    uint64_t now_us = tal_system_get_microsecond();
+    *owed_us += (uint32_t)(now_us - *last_us);
+    *last_us = now_us;
+    
+    uint32_t due = *owed_us / SENSOR_PERIOD_US;
+    *owed_us -= due * SENSOR_PERIOD_US;
+    
+    // 线程被长时间抢占时放弃过期样本，避免追赶造成突发
+    if (due > SENSOR_MAX_BURST) {
+        for (int k = 0; k < n_timed; k++) {
+            timed[k]->acq.overruns += due - SENSOR_MAX_BURST;
+        }
+        due = SENSOR_MAX_BURST;
+    }
+    
+    for (uint32_t i = 0; i < due; i++) {
+        for (int k = 0; k < n_timed; k++) {
+            sensor_acquire_frame(timed[k], 0);
+        }
+    }
+}
+
+// 高优先级采集线程: 按传感器采样率采样所有实例并写入各自的环形缓冲区
+// 有设备实例时由数据就绪节拍驱动，定时实例随后按时钟补采；否则按毫秒休眠定时采样
+static void gk_sensor_acq_task(void *arg)
+{
+    gk_sensor_t* drdy[SENSOR_MAX_INSTANCES];
+    gk_sensor_t* timed[SENSOR_MAX_INSTANCES];
+    int n_drdy = 0, n_timed = 0;
+
+    (void)arg;
+    
+    // 运行中不能打开或关闭实例，启动时确定一次调度表
+    for (int i = 0; i < SENSOR_MAX_INSTANCES; i++) {
+        gk_sensor_t* s = &g_sensor_pool[i];
+        if (!s->in_use || !s->state.is_initialized) {
+            continue;
+        }
+        if (sensor_is_drdy_driven(s)) {
+            drdy[n_drdy++] = s;
+        } else {
+            timed[n_timed++] = s;
+        }
+    }
+    
+    TAL_PR_INFO(TAG, "采集线程启动: %d Hz, 数据就绪中断%d个, 定时采样%d个", SENSOR_SAMPLE_RATE_HZ, n_drdy, n_timed);
+    
+    uint32_t sleep_ms = SENSOR_PERIOD_US / 1000;
+    if (sleep_ms == 0) {
+        sleep_ms = 1;
+    }
+    uint64_t last_us = tal_system_get_microsecond();
+    uint32_t owed_us = 0;
+    
+#if !SENSOR_USE_TDL
+    (void)drdy; // 没有设备数据源时n_drdy恒为0
+#endif
+    while (g_sensor_acq.running) {
+#if SENSOR_USE_TDL
+        if (n_drdy > 0) {
+            sensor_acq_drdy_round(drdy, n_drdy);
+            if (n_timed > 0) {
+                sensor_acq_timed_round(timed, n_timed, &last_us, &owed_us);
+            }
+            continue;
+        }
+#endif
+        sensor_acq_timed_round(timed, n_timed, &last_us, &owed_us);
+        tal_system_sleep(sleep_ms);
+    }
+    
+    g_sensor_acq.thread = NULL;
+}
+
+int gk_sensor_start_acquisition(void)
+{
+    if (!SENSOR_DEFAULT->state.is_initialized) {
+        return OPRT_COM_ERROR;
+    }
+    
+    if (g_sensor_acq.running) {
+        return OPRT_OK;
+    }
+    
+    if (g_sensor_acq.thread) {
+        return OPRT_RESOURCE_NOT_READY; // 上一个采集线程尚未退出
+    }
+    
+    THREAD_CFG_T task_cfg = {
+        .priority = THREAD_PRIO_1,
+        .stackDepth = 2048,
+        .thrdname = "gk_sensor_acq"
+    };
+    
+    g_sensor_acq.running = true;
+    if (tal_thread_create_and_start(&g_sensor_acq.thread, NULL, NULL,
+                                   gk_sensor_acq_task, NULL, &task_cfg) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "创建采集线程失败");
+        g_sensor_acq.running = false;
+        return OPRT_COM_ERROR;
+    }
     
     return OPRT_OK;
 }
 
+void gk_sensor_stop_acquisition(void)
+{
+    // 采集线程在下一次唤醒时自行退出
+    g_sensor_acq.running = false;
+}
+
+int gk_sensor_dev_fetch_frames(gk_sensor_t* s, gk_force_data_t* frames, int max_frames)
+{
+    if (!s || !s->in_use || !frames || max_frames <= 0) {
+        return 0;
+    }
+    
+    return (int)gk_frame_ring_pop(&s->acq.ring, frames, (uint32_t)max_frames);
+}
+
+int gk_sensor_fetch_frames(gk_force_data_t* frames, int max_frames)
+{
+    return gk_sensor_dev_fetch_frames(SENSOR_DEFAULT, frames, max_frames);
+}
+
+void gk_sensor_dev_get_stats(gk_sensor_t* s, gk_sensor_stats_t* stats)
+{
+    if (!s || !stats) {
+        return;
+    }
+    
+    stats->sample_rate_hz = SENSOR_SAMPLE_RATE_HZ;
+    stats->samples = s->acq.samples;
+    stats->dropped = s->acq.ring.dropped;
+    stats->overruns = s->acq.overruns;
+    stats->read_errors = s->acq.read_errors;
+    stats->ring_depth = s->acq.ring.capacity;
+    stats->ring_pending = gk_frame_ring_count(&s->acq.ring);
+    stats->ring_high_water = s->acq.ring.high_water;
+    stats->classify_us_max = s->state.classify_us_max;
+    stats->classify_us_mean =
+        s->state.classify_count ? (uint32_t)(s->state.classify_us_sum / s->state.classify_count) : 0;
+}
+
+void gk_sensor_get_stats(gk_sensor_stats_t* stats)
+{
+    gk_sensor_dev_get_stats(SENSOR_DEFAULT, stats);
+}
+
 // 基于punchingBag calculateBoxing算法的增强打击点计算
+// 纯求解函数，不修改会话统计；由gk_sensor_detect_punch在每次打击的峰值帧上调用
 int gk_calculate_hit_point(gk_force_data_t* force_data, gk_hit_point_t* hit_point)
 {
     if (!force_data || !hit_point) {
         return OPRT_INVALID_PARM;
     }
     
+#if SENSOR_USE_FIXED_POINT
+    gk_q16_t ft[6] = {
+        GK_FLOAT_TO_Q16(force_data->fx), GK_FLOAT_TO_Q16(force_data->fy), GK_FLOAT_TO_Q16(force_data->fz),
+        GK_FLOAT_TO_Q16(force_data->mx), GK_FLOAT_TO_Q16(force_data->my), GK_FLOAT_TO_Q16(force_data->mz)
+    };
+    gk_q16_t x_cm, y_cm, force;
+    if (gk_fixed_solve_hit_point(ft, GK_FLOAT_TO_Q16(FORCE_THRESHOLD), &x_cm, &y_cm, &force) != OPRT_OK) {
+        return OPRT_COM_ERROR;
+    }
+    hit_point->x = GK_Q16_TO_FLOAT(x_cm);
+    hit_point->y = GK_Q16_TO_FLOAT(y_cm);
+    hit_point->force = GK_Q16_TO_FLOAT(force);
+    hit_point->residual = 0.0f; // 单帧求解没有冗余，无法评估
+    hit_point->timestamp = force_data->timestamp;
+    return OPRT_OK;
+#else
     // 力和扭矩向量
     float F[3] = {force_data->fx, force_data->fy, force_data->fz};
     float tau[3] = {force_data->mx, force_data->my, force_data->mz};
@@ -270,83 +1009,154 @@ int gk_calculate_hit_point(gk_force_data_t* force_data, gk_hit_point_t* hit_poin
     hit_point->x = gamma[1] * 100.0f;  // Convert m to cm, swap for display
     hit_point->y = gamma[0] * 100.0f;  // Convert m to cm, swap for display
     hit_point->force = force_magnitude;
+    hit_point->residual = 0.0f; // 单帧求解没有冗余，无法评估
     hit_point->timestamp = force_data->timestamp;
     
     // 限制在合理范围内
     hit_point->x = fmaxf(-15.0f, fminf(15.0f, hit_point->x));  // ±15cm
     hit_point->y = fmaxf(-15.0f, fminf(15.0f, hit_point->y));  // ±15cm
     
+    return OPRT_OK;
+#endif
+}
+
+// 逐帧输入打击分段状态机，每次完整打击只求解一次打击点并更新一次统计
+int gk_sensor_dev_detect_punch(gk_sensor_t* s, const gk_force_data_t* frame, gk_punch_event_t* event)
+{
+    if (!s || !frame || !event) {
+        return OPRT_INVALID_PARM;
+    }
+    
+    // 打击位置由分段器在释放时对整次打击求解
+    if (!gk_punch_detector_feed(&s->state.punch, frame, event, NULL)) {
+        return OPRT_NOT_FOUND;
+    }
+    
+    uint32_t classify_us = 0;
+#if GK_PUNCH_CLASSIFIER_ENABLE
+    // 拳法分类: 特征取自整次打击各通道的积分，分段器在下一次起始前保持不变
+    uint64_t t0 = tal_system_get_microsecond();
+    gk_punch_features_t feat;
+    gk_punch_features_extract(event, s->state.punch.impulse_ft, &feat);
+    event->type = gk_punch_classify(&feat);
+    classify_us = (uint32_t)(tal_system_get_microsecond() - t0);
+
+    // 在目标板上实测的耗时，超出预算时只在创新高时告警
+    if (classify_us > s->state.classify_us_max) {
+        s->state.classify_us_max = classify_us;
+        if (classify_us > GK_PUNCH_CLASSIFY_BUDGET_US) {
+            TAL_PR_WARN(TAG, "沙袋%u拳法分类耗时%uus超出预算%uus", s->cfg.id, (unsigned int)classify_us,
+                        (unsigned int)GK_PUNCH_CLASSIFY_BUDGET_US);
+        }
+    }
+    s->state.classify_us_sum += classify_us;
+    s->state.classify_count++;
+#endif
+    
     // 更新会话统计
-    g_sensor_state.hit_count++;
-    if (force_magnitude > g_sensor_state.max_force_session) {
-        g_sensor_state.max_force_session = force_magnitude;
+    s->state.hit_count++;
+    if (event->peak_force > s->state.max_force_session) {
+        s->state.max_force_session = event->peak_force;
     }
     
-    TAL_PR_INFO(TAG, "增强打击计算: 位置(%.1f,%.1f)cm F=%.1fN", 
-                hit_point->x, hit_point->y, hit_point->force);
+    TAL_PR_INFO(TAG, "沙袋%u打击: %s(%uus) 位置(%.1f,%.1f)cm 残差=%.2fcm 峰值=%.1fN 冲量=%.3fN·s 上升=%.1fms 持续=%.1fms",
+                s->cfg.id, gk_punch_type_name(event->type), (unsigned int)classify_us, event->hit.x, event->hit.y,
+                event->hit.residual, event->peak_force, event->impulse, event->rise_time_ms, event->duration_ms);
     
     return OPRT_OK;
 }
 
+int gk_sensor_detect_punch(const gk_force_data_t* frame, gk_punch_event_t* event)
+{
+    return gk_sensor_dev_detect_punch(SENSOR_DEFAULT, frame, event);
+}
+
 // 额外的传感器实用功能
+uint32_t gk_sensor_dev_get_hit_count(gk_sensor_t* s)
+{
+    return s ? s->state.hit_count : 0;
+}
+
+float gk_sensor_dev_get_max_force_session(gk_sensor_t* s)
+{
+    return s ? s->state.max_force_session : 0.0f;
+}
+
+void gk_sensor_dev_reset_session_stats(gk_sensor_t* s)
+{
+    if (!s) {
+        return;
+    }
+    s->state.hit_count = 0;
+    s->state.max_force_session = 0.0f;
+    TAL_PR_INFO(TAG, "沙袋%u会话统计已重置", s->cfg.id);
+}
+
 uint32_t gk_sensor_get_hit_count(void)
 {
-    return g_sensor_state.hit_count;
+    return gk_sensor_dev_get_hit_count(SENSOR_DEFAULT);
 }
 
 float gk_sensor_get_max_force_session(void)
 {
-    return g_sensor_state.max_force_session;
+    return gk_sensor_dev_get_max_force_session(SENSOR_DEFAULT);
 }
 
 void gk_sensor_reset_session_stats(void)
 {
-    g_sensor_state.hit_count = 0;
-    g_sensor_state.max_force_session = 0.0f;
-    TAL_PR_INFO(TAG, "会话统计已重置");
+    gk_sensor_dev_reset_session_stats(SENSOR_DEFAULT);
 }
 
-int gk_sensor_calibrate(void)
+// 零点校准: 不阻塞调用者，也不停止采样
+// 读取线程平均之后SENSOR_CAL_SAMPLES帧作为新零点并立即生效，期间暂停零漂跟踪
+int gk_sensor_dev_calibrate(gk_sensor_t* s)
 {
-    TAL_PR_INFO(TAG, "开始传感器校准");
-    
-    // 校准程序:
-    // 1. 读取多个样本以获取基线偏移
-    // 2. 将校准数据保存到flash
-    
-    const int cal_samples = 100;
-    float sum_fx = 0, sum_fy = 0, sum_fz = 0;
-    float sum_mx = 0, sum_my = 0, sum_mz = 0;
-    
-    for (int i = 0; i < cal_samples; i++) {
-        float raw_data[6];
-        if (read_raw_sensor_data(raw_data) == OPRT_OK) {
-            sum_fx += raw_data[0];
-            sum_fy += raw_data[1]; 
-            sum_fz += raw_data[2];
-            sum_mx += raw_data[3];
-            sum_my += raw_data[4];
-            sum_mz += raw_data[5];
-        }
-        tal_system_sleep(10); // 10ms延迟
+    if (!s || !s->state.is_initialized) {
+        return OPRT_COM_ERROR;
     }
     
-    // 计算平均值作为偏移
-    g_sensor_cal.fx_offset = sum_fx / cal_samples;
-    g_sensor_cal.fy_offset = sum_fy / cal_samples;
-    g_sensor_cal.fz_offset = sum_fz / cal_samples - (-9.81f); // Account for gravity
-    g_sensor_cal.mx_offset = sum_mx / cal_samples;
-    g_sensor_cal.my_offset = sum_my / cal_samples;
-    g_sensor_cal.mz_offset = sum_mz / cal_samples;
-    
-    g_sensor_cal.is_calibrated = true;
+    TAL_PR_INFO(TAG, "沙袋%u开始传感器校准: 平均%d帧", s->cfg.id, SENSOR_CAL_SAMPLES);
+    s->cal.cal_request = true;
+    return OPRT_OK;
+}
+
+int gk_sensor_calibrate(void)
+{
+    return gk_sensor_dev_calibrate(SENSOR_DEFAULT);
+}
+
+// 把读取线程完成的零点校准写入该沙袋的tal_kv记录
+static void sensor_cal_poll(gk_sensor_t* s)
+{
+    sensor_cal_t* cal = &s->cal;
+    uint32_t done = __atomic_load_n(&cal->cal_done, __ATOMIC_ACQUIRE);
+    if (done == cal->cal_saved) {
+        return;
+    }
     
-    // 在实际实现中，在此保存到flash
+    float offset[6];
+    memcpy(offset, cal->cal_result, sizeof(offset));
+    if (__atomic_load_n(&cal->cal_done, __ATOMIC_ACQUIRE) != done) {
+        return; // 拷贝期间又完成了一次校准，下次再保存
+    }
+    cal->cal_saved = done;
     
-    TAL_PR_INFO(TAG, "传感器校准完成");
+    TAL_PR_INFO(TAG, "沙袋%u传感器校准完成", s->cfg.id);
     TAL_PR_INFO(TAG, "Offsets: Fx=%.3f Fy=%.3f Fz=%.3f Mx=%.3f My=%.3f Mz=%.3f",
-                g_sensor_cal.fx_offset, g_sensor_cal.fy_offset, g_sensor_cal.fz_offset,
-                g_sensor_cal.mx_offset, g_sensor_cal.my_offset, g_sensor_cal.mz_offset);
+                offset[0], offset[1], offset[2], offset[3], offset[4], offset[5]);
     
-    return OPRT_OK;
-}
\ No newline at end of file
+    if (gk_sensor_cal_save(s->cfg.id, offset, cal->scale) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "校准数据未保存，重启后恢复原零点");
+    }
+}
+
+// 主任务周期调用: 保存所有沙袋已完成的零点校准
+// 零漂跟踪的结果不写入，温漂在重启后会随温度重新建立，避免频繁擦写flash
+void gk_sensor_poll_calibration(void)
+{
+    for (int i = 0; i < SENSOR_MAX_INSTANCES; i++) {
+        if (g_sensor_pool[i].in_use) {
+            sensor_cal_poll(&g_sensor_pool[i]);
+        }
+    }
+}
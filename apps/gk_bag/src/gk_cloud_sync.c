@@ -0,0 +1,447 @@
+#include "gk_cloud_sync.h"
+
+#if GK_CLOUD_SYNC_ENABLE
+
+#include "tal_log.h"
+#include "tal_system.h"
+#include "tal_thread.h"
+#include "tal_kv.h"
+#include "tal_time_service.h"
+#include "tuya_iot.h"
+#include "tuya_iot_dp.h"
+#include "math.h"
+
+#define TAG "GK_CLOUD_SYNC"
+
+// 当前批次的第一条记录超过此时长即上报，打击很少时也不会积压太久
+#ifdef CLOUD_SYNC_FLUSH_SEC
+#define SYNC_FLUSH_MS           (CLOUD_SYNC_FLUSH_SEC * 1000u)
+#else
+#define SYNC_FLUSH_MS           30000u
+#endif
+
+// 暂存文件上限，写满后丢弃新批次
+#ifdef CLOUD_SYNC_SPOOL_KB
+#define SYNC_SPOOL_BYTES        (CLOUD_SYNC_SPOOL_KB * 1024u)
+#else
+#define SYNC_SPOOL_BYTES        (64u * 1024u)
+#endif
+
+// 主任务 -> 上传线程的批次队列深度 (2的幂)
+#define SYNC_QUEUE_DEPTH        4
+#define SYNC_QUEUE_MASK         (SYNC_QUEUE_DEPTH - 1)
+#define SYNC_MAX_RECORD_BYTES   (GK_SYNC_FIELDS * 5)    // 每字段最多5字节varint
+#define SYNC_IDLE_MS            500
+#define SYNC_SPOOL_PACE_MS      200                     // 补报暂存批次的间隔，限制恢复连接后的突发流量
+#define SYNC_RETRY_MS           5000                    // 上报失败后的重试间隔
+#define SYNC_REPORT_TIMEOUT     3
+#define SYNC_SEQ_RESERVE        256                     // 每次持久化预留的批次序号数，重启后跳过未用完的部分
+
+// tal_kv中的持久化状态
+#define SYNC_KV_SEQ             "gk_sync_seq"           // 已预留的批次序号上限
+#define SYNC_KV_SPOOL_READ      "gk_sync_spool_rd"      // 暂存文件中已上报的偏移
+
+#if (GK_SYNC_BATCH_BYTES < 64) || (GK_SYNC_BATCH_BYTES > 4096)
+#error "CLOUD_SYNC_BATCH_BYTES out of range"
+#endif
+
+#define RING_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RING_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+// 暂存文件中每个批次前的长度字段
+typedef struct {
+    uint16_t len;
+} sync_spool_rec_t;
+
+static struct {
+    bool initialized;
+    THREAD_HANDLE thread;
+
+    // 编码中的批次 (仅主任务访问)
+    gk_sync_batch_hdr_t hdr;
+    uint32_t len;              // 已编码字节数 (含批次头)
+    uint32_t prev_ms;
+    int32_t prev_force;
+
+    // 已封装的批次: 单生产者(主任务)/单消费者(上传线程)
+    uint32_t head;
+    uint32_t tail;
+    uint32_t stamped;          // 已填写序号的批次 (仅上传线程访问)
+    uint16_t queue_len[SYNC_QUEUE_DEPTH];
+
+    // 批次序号 (仅上传线程访问)，跨重启递增
+    uint32_t next_seq;
+    uint32_t seq_limit;        // 已持久化的预留上限，用到此处时再预留一段
+
+    // 暂存文件 (仅上传线程访问)
+    uint32_t spool_read;       // 下一个待上报批次的偏移，每上报一个批次持久化一次
+    uint32_t spool_size;
+
+    gk_cloud_sync_stats_t stats;
+} g_sync = {0};
+
+static uint8_t g_sync_batch[GK_SYNC_BATCH_BYTES];
+static uint8_t g_sync_queue[SYNC_QUEUE_DEPTH][GK_SYNC_BATCH_BYTES];
+// 上报缓冲区: dp_raw_t头 + 批次数据
+static struct {
+    dp_raw_t dp;
+    uint8_t data[GK_SYNC_BATCH_BYTES];
+} g_sync_tx;
+
+/* ---------------------------- 编码 (主任务) ---------------------------- */
+
+static uint32_t sync_zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static uint32_t sync_put_varint(uint8_t* p, uint32_t v)
+{
+    uint32_t n = 0;
+
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static uint32_t sync_quantize(float v, float unit)
+{
+    return (v <= 0.0f) ? 0 : (uint32_t)lroundf(v / unit);
+}
+
+// 把当前批次交给上传线程，队列满时丢弃 (上传线程被长时间阻塞)
+static void sync_seal_batch(void)
+{
+    if (g_sync.hdr.count == 0) {
+        return;
+    }
+
+    uint32_t tail = RING_LOAD_ACQUIRE(&g_sync.tail);
+    if (g_sync.head - tail >= SYNC_QUEUE_DEPTH) {
+        g_sync.stats.dropped++;
+    } else {
+        uint32_t slot = g_sync.head & SYNC_QUEUE_MASK;
+        memcpy(g_sync_batch, &g_sync.hdr, sizeof(gk_sync_batch_hdr_t));
+        memcpy(g_sync_queue[slot], g_sync_batch, g_sync.len);
+        g_sync.queue_len[slot] = (uint16_t)g_sync.len;
+        RING_STORE_RELEASE(&g_sync.head, g_sync.head + 1);
+        g_sync.stats.batches++;
+    }
+
+    g_sync.hdr.count = 0;
+    g_sync.len = sizeof(gk_sync_batch_hdr_t);
+}
+
+void gk_cloud_sync_feed(const gk_punch_event_t* punch)
+{
+    if (!g_sync.initialized || !punch) {
+        return;
+    }
+
+    if (g_sync.len + SYNC_MAX_RECORD_BYTES > GK_SYNC_BATCH_BYTES) {
+        sync_seal_batch();
+    }
+
+    uint32_t time_ms = (uint32_t)(punch->timestamp / 1000);
+    if (g_sync.hdr.count == 0) {
+        g_sync.hdr.version = GK_SYNC_VERSION;
+        g_sync.hdr.fields = GK_SYNC_FIELDS;
+        g_sync.hdr.seq = 0; // 由上传线程填写，主任务不写flash
+        g_sync.hdr.utc = (tal_time_check_time_sync() == OPRT_OK) ? (uint32_t)tal_time_get_posix() : 0;
+        g_sync.hdr.time_ms = time_ms;
+        g_sync.len = sizeof(gk_sync_batch_hdr_t);
+        g_sync.prev_ms = time_ms;
+        g_sync.prev_force = 0;
+    }
+
+    int32_t force = (int32_t)sync_quantize(punch->peak_force, 0.1f);
+    uint8_t* p = g_sync_batch + g_sync.len;
+    uint32_t n = 0;
+
+    n += sync_put_varint(p + n, time_ms - g_sync.prev_ms);
+    n += sync_put_varint(p + n, sync_zigzag(force - g_sync.prev_force));
+    n += sync_put_varint(p + n, sync_zigzag((int32_t)lroundf(punch->hit.x * 10.0f)));
+    n += sync_put_varint(p + n, sync_zigzag((int32_t)lroundf(punch->hit.y * 10.0f)));
+    n += sync_put_varint(p + n, sync_quantize(punch->impulse, 0.001f));
+    n += sync_put_varint(p + n, sync_quantize(punch->rise_time_ms, 0.1f));
+    n += sync_put_varint(p + n, sync_quantize(punch->duration_ms, 0.1f));
+    n += sync_put_varint(p + n, sync_quantize(punch->hit.residual, 0.1f));
+
+    g_sync.len += n;
+    g_sync.hdr.count++;
+    g_sync.prev_ms = time_ms;
+    g_sync.prev_force = force;
+    g_sync.stats.records++;
+}
+
+void gk_cloud_sync_poll(uint32_t now_ms)
+{
+    if (!g_sync.initialized || g_sync.hdr.count == 0) {
+        return;
+    }
+    if ((uint32_t)(now_ms - g_sync.hdr.time_ms) >= SYNC_FLUSH_MS) {
+        sync_seal_batch();
+    }
+}
+
+/* ---------------------------- 上传线程 ---------------------------- */
+
+static uint32_t sync_kv_load_u32(const char* key, uint32_t def)
+{
+    uint8_t* value = NULL;
+    size_t length = 0;
+    uint32_t v = def;
+
+    if (tal_kv_get(key, &value, &length) != OPRT_OK) {
+        return def;
+    }
+    if (length == sizeof(v)) {
+        memcpy(&v, value, sizeof(v));
+    }
+    tal_kv_free(value);
+    return v;
+}
+
+static void sync_kv_save_u32(const char* key, uint32_t v)
+{
+    int rt = tal_kv_set(key, (const uint8_t*)&v, sizeof(v));
+    if (rt != OPRT_OK) {
+        TAL_PR_ERR(TAG, "保存%s失败 %d", key, rt);
+    }
+}
+
+// 为刚封装的批次填写序号，时间已同步时补上封装前为0的UTC时间
+static void sync_stamp_batch(uint8_t* data)
+{
+    gk_sync_batch_hdr_t hdr;
+
+    memcpy(&hdr, data, sizeof(hdr));
+    if (g_sync.next_seq >= g_sync.seq_limit) {
+        // 先持久化预留上限再使用，掉电重启后的序号不会与已上报或已暂存的批次重复
+        g_sync.seq_limit = g_sync.next_seq + SYNC_SEQ_RESERVE;
+        sync_kv_save_u32(SYNC_KV_SEQ, g_sync.seq_limit);
+    }
+    hdr.seq = g_sync.next_seq++;
+
+    // time_ms与主任务的打击时间戳同一时钟，只对本次启动内的批次有效
+    if (hdr.utc == 0 && tal_time_check_time_sync() == OPRT_OK) {
+        uint32_t now_ms = (uint32_t)(tal_system_get_microsecond() / 1000);
+        hdr.utc = (uint32_t)tal_time_get_posix() - (now_ms - hdr.time_ms) / 1000;
+    }
+    memcpy(data, &hdr, sizeof(hdr));
+}
+
+static bool sync_is_online(void)
+{
+    tuya_iot_client_t* client = tuya_iot_client_get();
+    return client != NULL && tuya_iot_activated(client) && tuya_iot_is_connected();
+}
+
+static int sync_report(const uint8_t* data, uint32_t len)
+{
+    dp_raw_t* dp = &g_sync_tx.dp;
+
+    dp->id = GK_SYNC_DPID;
+    dp->len = (uint16_t)len;
+    memcpy(dp->data, data, len);
+    return tuya_iot_dp_raw_report(tuya_iot_client_get(), NULL, dp, SYNC_REPORT_TIMEOUT);
+}
+
+// 追加一个批次到暂存文件，文件已满时丢弃
+static void sync_spool_append(const uint8_t* data, uint32_t len)
+{
+    sync_spool_rec_t rec = {.len = (uint16_t)len};
+    lfs_file_t file;
+
+    if (g_sync.spool_size + sizeof(rec) + len > SYNC_SPOOL_BYTES) {
+        g_sync.stats.spool_dropped++;
+        return;
+    }
+
+    tal_lfs_lock();
+    int result = lfs_file_open(tal_lfs_get(), &file, GK_SYNC_SPOOL_PATH, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_APPEND);
+    if (result >= 0) {
+        if (lfs_file_write(tal_lfs_get(), &file, &rec, sizeof(rec)) == (lfs_ssize_t)sizeof(rec) &&
+            lfs_file_write(tal_lfs_get(), &file, data, len) == (lfs_ssize_t)len) {
+            result = OPRT_OK;
+        } else {
+            result = OPRT_COM_ERROR;
+        }
+        // 关闭时提交，掉电最多丢失正在写入的一个批次
+        lfs_file_close(tal_lfs_get(), &file);
+    }
+    tal_lfs_unlock();
+
+    if (result != OPRT_OK) {
+        TAL_PR_ERR(TAG, "暂存批次失败 %d", result);
+        g_sync.stats.spool_dropped++;
+        return;
+    }
+    g_sync.spool_size += sizeof(rec) + len;
+    g_sync.stats.spilled++;
+}
+
+static void sync_spool_clear(void)
+{
+    // 先删除偏移再删除文件，中途掉电时最多从头重复上报，不会跳过新的暂存数据
+    tal_kv_del(SYNC_KV_SPOOL_READ);
+    tal_lfs_lock();
+    lfs_remove(tal_lfs_get(), GK_SYNC_SPOOL_PATH);
+    tal_lfs_unlock();
+    g_sync.spool_read = 0;
+    g_sync.spool_size = 0;
+}
+
+// 读取暂存文件中下一个待上报的批次，返回长度，文件损坏时返回0
+static uint32_t sync_spool_peek(uint8_t* data)
+{
+    sync_spool_rec_t rec = {0};
+    lfs_file_t file;
+    uint32_t len = 0;
+
+    tal_lfs_lock();
+    if (lfs_file_open(tal_lfs_get(), &file, GK_SYNC_SPOOL_PATH, LFS_O_RDONLY) >= 0) {
+        if (lfs_file_seek(tal_lfs_get(), &file, g_sync.spool_read, LFS_SEEK_SET) >= 0 &&
+            lfs_file_read(tal_lfs_get(), &file, &rec, sizeof(rec)) == (lfs_ssize_t)sizeof(rec) &&
+            rec.len >= sizeof(gk_sync_batch_hdr_t) && rec.len <= GK_SYNC_BATCH_BYTES &&
+            lfs_file_read(tal_lfs_get(), &file, data, rec.len) == (lfs_ssize_t)rec.len) {
+            len = rec.len;
+        }
+        lfs_file_close(tal_lfs_get(), &file);
+    }
+    tal_lfs_unlock();
+
+    if (len > 0 && ((const gk_sync_batch_hdr_t*)data)->version != GK_SYNC_VERSION) {
+        len = 0;
+    }
+    return len;
+}
+
+// 上报暂存文件中最早的一个批次，失败时返回非OPRT_OK
+static int sync_spool_upload_one(void)
+{
+    static uint8_t batch[GK_SYNC_BATCH_BYTES];
+    uint32_t len = sync_spool_peek(batch);
+
+    if (len == 0) {
+        TAL_PR_ERR(TAG, "暂存文件损坏，丢弃剩余%u字节", (unsigned int)(g_sync.spool_size - g_sync.spool_read));
+        sync_spool_clear();
+        return OPRT_OK;
+    }
+
+    int rt = sync_report(batch, len);
+    if (rt != OPRT_OK) {
+        return rt;
+    }
+
+    g_sync.stats.uploaded++;
+    g_sync.spool_read += sizeof(sync_spool_rec_t) + len;
+    if (g_sync.spool_read >= g_sync.spool_size) {
+        sync_spool_clear();
+    } else {
+        sync_kv_save_u32(SYNC_KV_SPOOL_READ, g_sync.spool_read);
+    }
+    return OPRT_OK;
+}
+
+// 低优先级上传线程: 在线时按顺序上报，离线或仍有暂存数据时先写入暂存文件保证顺序
+static void gk_cloud_sync_task(void* arg)
+{
+    (void)arg;
+    while (1) {
+        bool online = sync_is_online();
+        uint32_t wait_ms = SYNC_IDLE_MS;
+
+        uint32_t head = RING_LOAD_ACQUIRE(&g_sync.head);
+        for (; g_sync.stamped != head; g_sync.stamped++) {
+            sync_stamp_batch(g_sync_queue[g_sync.stamped & SYNC_QUEUE_MASK]);
+        }
+        while (g_sync.tail != head) {
+            uint32_t slot = g_sync.tail & SYNC_QUEUE_MASK;
+            if (online && g_sync.spool_size == 0) {
+                if (sync_report(g_sync_queue[slot], g_sync.queue_len[slot]) != OPRT_OK) {
+                    wait_ms = SYNC_RETRY_MS;
+                    break;
+                }
+                g_sync.stats.uploaded++;
+            } else {
+                sync_spool_append(g_sync_queue[slot], g_sync.queue_len[slot]);
+            }
+            RING_STORE_RELEASE(&g_sync.tail, g_sync.tail + 1);
+        }
+
+        // 每轮最多上报一个暂存批次，给新批次让出队列
+        if (online && g_sync.spool_size > 0) {
+            wait_ms = (sync_spool_upload_one() == OPRT_OK) ? SYNC_SPOOL_PACE_MS : SYNC_RETRY_MS;
+        }
+
+        tal_system_sleep(wait_ms);
+    }
+}
+
+int gk_cloud_sync_init(void)
+{
+    if (g_sync.initialized) {
+        return OPRT_OK;
+    }
+
+    lfs_t* lfs = tal_lfs_get();
+    struct lfs_info info;
+
+    if (tal_lfs_lock() != OPRT_OK) {
+        TAL_PR_ERR(TAG, "文件系统未初始化");
+        return OPRT_RESOURCE_NOT_READY;
+    }
+    int result = lfs_mkdir(lfs, GK_SYNC_DIR);
+    if (result < 0 && result != LFS_ERR_EXIST) {
+        tal_lfs_unlock();
+        TAL_PR_ERR(TAG, "创建目录%s失败 %d", GK_SYNC_DIR, result);
+        return OPRT_COM_ERROR;
+    }
+    bool spooled = (lfs_stat(lfs, GK_SYNC_SPOOL_PATH, &info) >= 0);
+    tal_lfs_unlock();
+
+    // 上次未上报完的暂存数据从持久化的偏移继续上报，偏移无效时从头重新上报
+    if (spooled) {
+        g_sync.spool_size = info.size;
+        g_sync.spool_read = sync_kv_load_u32(SYNC_KV_SPOOL_READ, 0);
+        if (g_sync.spool_read >= g_sync.spool_size) {
+            g_sync.spool_read = 0;
+        }
+    }
+
+    // 批次序号从上次预留的上限继续，第一个批次封装时再预留新的一段
+    g_sync.next_seq = sync_kv_load_u32(SYNC_KV_SEQ, 1);
+    g_sync.seq_limit = g_sync.next_seq;
+    g_sync.len = sizeof(gk_sync_batch_hdr_t);
+
+    THREAD_CFG_T task_cfg = {
+        .priority = THREAD_PRIO_5,
+        .stackDepth = 4096,
+        .thrdname = "gk_cloud_sync"
+    };
+    if (tal_thread_create_and_start(&g_sync.thread, NULL, NULL, gk_cloud_sync_task, NULL, &task_cfg) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "创建上传线程失败");
+        return OPRT_COM_ERROR;
+    }
+
+    g_sync.initialized = true;
+    TAL_PR_INFO(TAG, "训练记录同步就绪: DP%d, 批次%u字节, 暂存%u字节待上报, 序号从%u开始", GK_SYNC_DPID,
+                (unsigned int)GK_SYNC_BATCH_BYTES, (unsigned int)(g_sync.spool_size - g_sync.spool_read),
+                (unsigned int)g_sync.next_seq);
+    return OPRT_OK;
+}
+
+void gk_cloud_sync_get_stats(gk_cloud_sync_stats_t* stats)
+{
+    if (!stats) {
+        return;
+    }
+    *stats = g_sync.stats;
+    stats->spool_pending = g_sync.spool_size - g_sync.spool_read;
+}
+
+#endif /* GK_CLOUD_SYNC_ENABLE */
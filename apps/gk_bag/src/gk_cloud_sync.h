@@ -0,0 +1,89 @@
+#ifndef __GK_CLOUD_SYNC_H__
+#define __GK_CLOUD_SYNC_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(ENABLE_CLOUD_SYNC) && (ENABLE_CLOUD_SYNC == 1)
+#define GK_CLOUD_SYNC_ENABLE    1
+#else
+#define GK_CLOUD_SYNC_ENABLE    0
+#endif
+
+// 训练记录上报使用的raw DP
+#ifdef CLOUD_SYNC_DPID
+#define GK_SYNC_DPID            CLOUD_SYNC_DPID
+#else
+#define GK_SYNC_DPID            101
+#endif
+
+// 一个批次的最大字节数 (raw DP的数据长度)
+#ifdef CLOUD_SYNC_BATCH_BYTES
+#define GK_SYNC_BATCH_BYTES     CLOUD_SYNC_BATCH_BYTES
+#else
+#define GK_SYNC_BATCH_BYTES     256
+#endif
+
+// 离线时暂存在tal_kv挂载的littlefs中: /gksync/spool.bin
+#define GK_SYNC_DIR             "/gksync"
+#define GK_SYNC_SPOOL_PATH      GK_SYNC_DIR "/spool.bin"
+
+/*
+ * 训练记录批次格式 (raw DP数据，小端序，version 1)
+ *
+ *   gk_sync_batch_hdr_t | 记录[count]
+ *
+ * 每条记录对应一次完整打击，由8个LEB128变长整数组成:
+ *   dt_ms       起始时刻相对上一条记录的毫秒数，第一条相对hdr.time_ms (即0)
+ *   force       峰值力 (0.1N)，相对上一条的差值经zigzag映射，第一条相对0
+ *   x, y        打击位置 (mm，显示坐标系)，zigzag
+ *   impulse     冲量 (mN·s)
+ *   rise        起始到峰值的时间 (0.1ms)
+ *   duration    起始到释放的时间 (0.1ms)
+ *   residual    打击点估计残差 (mm)
+ * 典型一条记录10-14字节。
+ *
+ * seq跨重启递增 (预留上限持久化在tal_kv中)，云端按seq去重和排序。暂存文件的上报偏移同样持久化，
+ * 只有上报成功到偏移保存之间掉电的那一个批次会在重启后重复上报。
+ */
+#define GK_SYNC_VERSION         1
+#define GK_SYNC_FIELDS          8
+
+typedef struct {
+    uint8_t version;
+    uint8_t fields;            // 每条记录的字段数，新增字段追加在末尾
+    uint16_t count;            // 记录数
+    uint32_t seq;              // 批次序号，跨重启递增，重启时可能跳过一段
+    uint32_t utc;              // 第一条记录的UTC时间 (秒)，封装和上报前时间都未同步时为0
+    uint32_t time_ms;          // 第一条记录的单调时钟毫秒
+} gk_sync_batch_hdr_t;
+
+typedef struct {
+    uint32_t records;          // 已编码的打击数
+    uint32_t batches;          // 已封装的批次数
+    uint32_t uploaded;         // 上报成功的批次数
+    uint32_t spilled;          // 离线时写入暂存文件的批次数
+    uint32_t dropped;          // 上传线程未及时取走、队列已满而丢弃的批次数
+    uint32_t spool_dropped;    // 暂存文件已满或写入失败而丢弃的批次数
+    uint32_t spool_pending;    // 暂存文件中尚未上报的字节数
+} gk_cloud_sync_stats_t;
+
+// 创建上传线程，恢复上次未上报完的暂存文件。依赖tal_kv挂载的littlefs
+int gk_cloud_sync_init(void);
+
+// 主任务调用: 把一次打击编码进当前批次，批次满时交给上传线程，不阻塞在网络或flash上
+void gk_cloud_sync_feed(const gk_punch_event_t* punch);
+
+// 主任务周期调用: 当前批次的第一条记录超过CLOUD_SYNC_FLUSH_SEC时提前交给上传线程
+void gk_cloud_sync_poll(uint32_t now_ms);
+
+void gk_cloud_sync_get_stats(gk_cloud_sync_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_CLOUD_SYNC_H__ */
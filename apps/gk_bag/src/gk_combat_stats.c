@@ -0,0 +1,333 @@
+#include "gk_combat_stats.h"
+#include "math.h"
+
+#ifdef COMBAT_STATS_UPDATE_INTERVAL
+#define COMBAT_PUBLISH_INTERVAL_MS  COMBAT_STATS_UPDATE_INTERVAL
+#else
+#define COMBAT_PUBLISH_INTERVAL_MS  1000
+#endif
+
+// 速度: 10秒滑动窗口，按1秒分桶计数
+#define COMBAT_RATE_BUCKETS         10
+#define COMBAT_RATE_BUCKET_MS       1000
+#define COMBAT_RATE_FULL            4.0f    // 满分打击频率 (次/秒)
+#define COMBAT_RISE_FAST_MS         5.0f    // 上升时间满分
+#define COMBAT_RISE_SLOW_MS         40.0f   // 上升时间零分
+
+// 爆发力: 峰值力P90
+#define COMBAT_POWER_QUANTILE       0.9f
+#define COMBAT_POWER_FULL_N         200.0f
+
+// 耐力: 前N次打击的平均力作为基准，近期平均力为指数加权平均
+#define COMBAT_BASELINE_PUNCHES     10
+#define COMBAT_ENDURANCE_VOLUME     200     // 训练量满分所需打击次数
+
+// 准确度: 位置标准差达到该值时为0分
+#define COMBAT_SPREAD_FULL_CM       10.0f
+
+// 技巧: 间隔超过该值视为连击中断，变异系数达到CV_FULL时为0分
+#define COMBAT_COMBO_GAP_MS         1000
+#define COMBAT_COMBO_MIN_GAPS       3
+#define COMBAT_CV_FULL              0.5f
+
+// 指数加权平均系数 (约等于最近10次打击)
+#define COMBAT_EW_ALPHA             0.1f
+
+#define COMBAT_DEFAULT_SCORE        50
+
+static struct {
+    uint16_t rate_bucket[COMBAT_RATE_BUCKETS];
+    uint32_t rate_idx;
+    uint32_t rate_bucket_ms;    // 当前桶的起始时刻
+    uint32_t rate_total;
+    float rise_ms;
+
+    gk_p2_quantile_t power;
+
+    float baseline_sum;
+    float force_recent;
+
+    float pos_mean[2];
+    float pos_var[2];
+
+    bool has_last;
+    uint32_t last_ms;
+    uint32_t combo_gaps;
+    float gap_mean;
+    float gap_var;
+
+    uint32_t punches;
+    gk_combat_stats_t stats;
+    gk_combat_stats_t published;
+    bool ever_published;
+    uint32_t last_publish_ms;
+} g_combat;
+
+// ---------------------------------------------------------------------------
+// P²分位数估计
+
+void gk_p2_init(gk_p2_quantile_t* est, float p)
+{
+    memset(est, 0, sizeof(gk_p2_quantile_t));
+    est->p = p;
+    for (int i = 0; i < 5; i++) {
+        est->n[i] = i;
+    }
+    est->np[0] = 0.0f;
+    est->np[1] = 2.0f * p;
+    est->np[2] = 4.0f * p;
+    est->np[3] = 2.0f + 2.0f * p;
+    est->np[4] = 4.0f;
+    est->dn[0] = 0.0f;
+    est->dn[1] = p / 2.0f;
+    est->dn[2] = p;
+    est->dn[3] = (1.0f + p) / 2.0f;
+    est->dn[4] = 1.0f;
+}
+
+static float p2_parabolic(const gk_p2_quantile_t* est, int i, float d)
+{
+    const float* q = est->q;
+    const float* n = est->n;
+
+    return q[i] + d / (n[i + 1] - n[i - 1]) *
+                      ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+                       (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+void gk_p2_add(gk_p2_quantile_t* est, float x)
+{
+    float* q = est->q;
+    float* n = est->n;
+
+    // 前5个样本直接插入排序
+    if (est->count < 5) {
+        int i = est->count++;
+        while (i > 0 && q[i - 1] > x) {
+            q[i] = q[i - 1];
+            i--;
+        }
+        q[i] = x;
+        return;
+    }
+    est->count++;
+
+    int k;
+    if (x < q[0]) {
+        q[0] = x;
+        k = 0;
+    } else if (x >= q[4]) {
+        q[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= q[k + 1]) {
+            k++;
+        }
+    }
+
+    for (int i = k + 1; i < 5; i++) {
+        n[i] += 1.0f;
+    }
+    for (int i = 0; i < 5; i++) {
+        est->np[i] += est->dn[i];
+    }
+
+    // 调整中间3个标记点的高度
+    for (int i = 1; i <= 3; i++) {
+        float d = est->np[i] - n[i];
+        if ((d >= 1.0f && n[i + 1] - n[i] > 1.0f) || (d <= -1.0f && n[i - 1] - n[i] < -1.0f)) {
+            float ds = (d > 0.0f) ? 1.0f : -1.0f;
+            float qp = p2_parabolic(est, i, ds);
+            if (q[i - 1] < qp && qp < q[i + 1]) {
+                q[i] = qp;
+            } else {
+                int j = i + (int)ds;
+                q[i] += ds * (q[j] - q[i]) / (n[j] - n[i]);
+            }
+            n[i] += ds;
+        }
+    }
+}
+
+float gk_p2_get(const gk_p2_quantile_t* est)
+{
+    if (est->count == 0) {
+        return 0.0f;
+    }
+    if (est->count < 5) {
+        // 样本不足时取已排序样本中最接近的位置
+        return est->q[(int)(est->p * (est->count - 1) + 0.5f)];
+    }
+    return est->q[2];
+}
+
+// ---------------------------------------------------------------------------
+// 战力统计
+
+static int combat_score(float ratio)
+{
+    if (ratio <= 0.0f) {
+        return 0;
+    }
+    if (ratio >= 1.0f) {
+        return 100;
+    }
+    return (int)(ratio * 100.0f + 0.5f);
+}
+
+// 指数加权均值和方差
+static void combat_ew_update(float* mean, float* var, float x)
+{
+    float diff = x - *mean;
+    float incr = COMBAT_EW_ALPHA * diff;
+    *mean += incr;
+    *var = (1.0f - COMBAT_EW_ALPHA) * (*var + diff * incr);
+}
+
+// 把频率窗口推进到now_ms，跳过的桶清零 (最多清一遍整个窗口)
+// 打击在释放时才送入，起始时刻可能早于上一次poll推进到的桶，此时不推进，计入当前桶
+static void combat_rate_advance(uint32_t now_ms)
+{
+    int32_t elapsed = (int32_t)(now_ms - g_combat.rate_bucket_ms);
+    if (elapsed < COMBAT_RATE_BUCKET_MS) {
+        return;
+    }
+
+    uint32_t steps = (uint32_t)elapsed / COMBAT_RATE_BUCKET_MS;
+    if (steps >= COMBAT_RATE_BUCKETS) {
+        memset(g_combat.rate_bucket, 0, sizeof(g_combat.rate_bucket));
+        g_combat.rate_total = 0;
+    } else {
+        for (uint32_t i = 0; i < steps; i++) {
+            g_combat.rate_idx = (g_combat.rate_idx + 1) % COMBAT_RATE_BUCKETS;
+            g_combat.rate_total -= g_combat.rate_bucket[g_combat.rate_idx];
+            g_combat.rate_bucket[g_combat.rate_idx] = 0;
+        }
+    }
+    g_combat.rate_bucket_ms += steps * COMBAT_RATE_BUCKET_MS;
+}
+
+static void combat_compute(void)
+{
+    gk_combat_stats_t* s = &g_combat.stats;
+
+    if (g_combat.punches == 0) {
+        s->speed = s->power = s->endurance = s->accuracy = s->technique = COMBAT_DEFAULT_SCORE;
+        return;
+    }
+
+    float rate = (float)g_combat.rate_total / (COMBAT_RATE_BUCKETS * COMBAT_RATE_BUCKET_MS / 1000.0f);
+    float rise = (COMBAT_RISE_SLOW_MS - g_combat.rise_ms) / (COMBAT_RISE_SLOW_MS - COMBAT_RISE_FAST_MS);
+    s->speed = combat_score(0.7f * fminf(rate / COMBAT_RATE_FULL, 1.0f) + 0.3f * fmaxf(0.0f, fminf(rise, 1.0f)));
+
+    s->power = combat_score(gk_p2_get(&g_combat.power) / COMBAT_POWER_FULL_N);
+
+    if (g_combat.punches >= COMBAT_BASELINE_PUNCHES) {
+        float baseline = g_combat.baseline_sum / COMBAT_BASELINE_PUNCHES;
+        float retention = fminf(g_combat.force_recent / baseline, 1.0f);
+        float volume = fminf((float)g_combat.punches / COMBAT_ENDURANCE_VOLUME, 1.0f);
+        s->endurance = combat_score(retention * (0.5f + 0.5f * volume));
+    } else {
+        s->endurance = COMBAT_DEFAULT_SCORE;
+    }
+
+    if (g_combat.punches >= 2) {
+        float spread = sqrtf(g_combat.pos_var[0] + g_combat.pos_var[1]);
+        s->accuracy = combat_score(1.0f - spread / COMBAT_SPREAD_FULL_CM);
+    } else {
+        s->accuracy = COMBAT_DEFAULT_SCORE;
+    }
+
+    if (g_combat.combo_gaps >= COMBAT_COMBO_MIN_GAPS && g_combat.gap_mean > 0.0f) {
+        float cv = sqrtf(g_combat.gap_var) / g_combat.gap_mean;
+        s->technique = combat_score(1.0f - cv / COMBAT_CV_FULL);
+    } else {
+        s->technique = COMBAT_DEFAULT_SCORE;
+    }
+}
+
+void gk_combat_stats_reset(void)
+{
+    memset(&g_combat, 0, sizeof(g_combat));
+    gk_p2_init(&g_combat.power, COMBAT_POWER_QUANTILE);
+    combat_compute();
+}
+
+void gk_combat_stats_init(void)
+{
+    gk_combat_stats_reset();
+}
+
+void gk_combat_stats_feed(const gk_punch_event_t* event, uint32_t time_ms)
+{
+    if (!event) {
+        return;
+    }
+
+    if (g_combat.punches == 0) {
+        g_combat.rate_bucket_ms = time_ms;
+        g_combat.rise_ms = event->rise_time_ms;
+        g_combat.force_recent = event->peak_force;
+        g_combat.pos_mean[0] = event->hit.x;
+        g_combat.pos_mean[1] = event->hit.y;
+    }
+
+    combat_rate_advance(time_ms);
+    g_combat.rate_bucket[g_combat.rate_idx]++;
+    g_combat.rate_total++;
+    g_combat.rise_ms += COMBAT_EW_ALPHA * (event->rise_time_ms - g_combat.rise_ms);
+
+    gk_p2_add(&g_combat.power, event->peak_force);
+
+    if (g_combat.punches < COMBAT_BASELINE_PUNCHES) {
+        g_combat.baseline_sum += event->peak_force;
+    }
+    g_combat.force_recent += COMBAT_EW_ALPHA * (event->peak_force - g_combat.force_recent);
+
+    combat_ew_update(&g_combat.pos_mean[0], &g_combat.pos_var[0], event->hit.x);
+    combat_ew_update(&g_combat.pos_mean[1], &g_combat.pos_var[1], event->hit.y);
+
+    if (g_combat.has_last) {
+        uint32_t gap = time_ms - g_combat.last_ms;
+        if (gap <= COMBAT_COMBO_GAP_MS) {
+            if (g_combat.combo_gaps == 0) {
+                g_combat.gap_mean = (float)gap;
+            }
+            combat_ew_update(&g_combat.gap_mean, &g_combat.gap_var, (float)gap);
+            g_combat.combo_gaps++;
+        }
+    }
+    g_combat.has_last = true;
+    g_combat.last_ms = time_ms;
+
+    g_combat.punches++;
+}
+
+void gk_combat_stats_poll(uint32_t now_ms)
+{
+    if (g_combat.ever_published && now_ms - g_combat.last_publish_ms < COMBAT_PUBLISH_INTERVAL_MS) {
+        return;
+    }
+
+    if (g_combat.punches > 0) {
+        combat_rate_advance(now_ms);
+    }
+    combat_compute();
+    g_combat.last_publish_ms = now_ms;
+
+    // 得分没有变化时不重绘五边形
+    if (g_combat.ever_published && memcmp(&g_combat.stats, &g_combat.published, sizeof(gk_combat_stats_t)) == 0) {
+        return;
+    }
+    g_combat.published = g_combat.stats;
+    g_combat.ever_published = true;
+    gk_gui_update_combat_stats(&g_combat.published);
+}
+
+void gk_combat_stats_get(gk_combat_stats_t* stats)
+{
+    if (stats) {
+        *stats = g_combat.stats;
+    }
+}
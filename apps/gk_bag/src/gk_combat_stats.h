@@ -0,0 +1,49 @@
+#ifndef __GK_COMBAT_STATS_H__
+#define __GK_COMBAT_STATS_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// P²分位数估计 (Jain & Chlamtac): 5个标记点，固定内存，每个样本O(1)更新
+typedef struct {
+    float p;
+    float q[5];                // 标记点高度
+    float n[5];                // 标记点实际位置
+    float np[5];               // 标记点期望位置
+    float dn[5];               // 期望位置的增量
+    uint32_t count;
+} gk_p2_quantile_t;
+
+void gk_p2_init(gk_p2_quantile_t* est, float p);
+void gk_p2_add(gk_p2_quantile_t* est, float x);
+float gk_p2_get(const gk_p2_quantile_t* est);
+
+/*
+ * 战力统计引擎: 逐次打击流式更新五边形五项得分，所有状态固定大小，不分配内存
+ *   速度   - 滑动窗口内的打击频率 + 上升时间
+ *   爆发力 - 峰值力的P90 (P²分位数估计)
+ *   耐力   - 近期平均力相对开始阶段的保持率 + 训练量
+ *   准确度 - 打击位置的离散程度 (指数加权方差)
+ *   技巧   - 连击间隔的规律性 (指数加权变异系数)
+ */
+void gk_combat_stats_init(void);
+void gk_combat_stats_reset(void);
+
+// 输入一次打击事件，time_ms为打击发生的毫秒时刻
+void gk_combat_stats_feed(const gk_punch_event_t* event, uint32_t time_ms);
+
+// 由主循环周期调用: 距上次发布超过COMBAT_STATS_UPDATE_INTERVAL且得分有变化时
+// 发布到gk_gui_update_combat_stats
+void gk_combat_stats_poll(uint32_t now_ms);
+
+// 最近一次gk_combat_stats_poll计算的得分
+void gk_combat_stats_get(gk_combat_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_COMBAT_STATS_H__ */
@@ -0,0 +1,350 @@
+#include "gk_drill.h"
+#include "gk_filter.h"
+#include "tal_log.h"
+#include "tal_mutex.h"
+
+#define TAG "GK_DRILL"
+
+#ifdef FORCE_SENSOR_SAMPLE_RATE
+#define DRILL_SAMPLE_RATE_HZ    FORCE_SENSOR_SAMPLE_RATE
+#else
+#define DRILL_SAMPLE_RATE_HZ    1000
+#endif
+// 打击事件的时间戳是滤波后越过阈值的一帧，减去滤波器组的群延迟对齐到采集时刻
+#define DRILL_ONSET_DELAY_US    ((uint64_t)GK_FILTER_DELAY_SAMPLES * 1000000 / DRILL_SAMPLE_RATE_HZ)
+#define DRILL_MS_TO_US(ms)      ((uint64_t)(ms) * 1000)
+#define DRILL_MIN(a, b)         (((a) < (b)) ? (a) : (b))
+
+const gk_drill_program_t gk_drill_programs[GK_DRILL_PROGRAM_MAX] = {
+    [GK_DRILL_STRENGTH] = {"力量训练", 3, 60000, 30000, 2500, 4000, 1500, GK_DRILL_ZONE_BIT(GK_DRILL_ZONE_ANY)},
+    [GK_DRILL_SPEED] = {"速度训练", 3, 30000, 20000, 800, 2000, 700, GK_DRILL_ZONE_BIT(GK_DRILL_ZONE_ANY)},
+    [GK_DRILL_ACCURACY] = {"精准训练", 3, 45000, 20000, 1500, 3000, 1200, GK_DRILL_ZONES_QUAD},
+    [GK_DRILL_ENDURANCE] = {"耐力训练", 5, 120000, 30000, 2000, 3000, 1000, GK_DRILL_ZONE_BIT(GK_DRILL_ZONE_ANY)},
+    [GK_DRILL_COMBO] = {"组合技训练", 3, 60000, 30000, 1000, 2000, 1000, GK_DRILL_ZONES_QUAD},
+};
+
+typedef struct {
+    uint64_t due_us;            // 计划显示时刻
+    uint64_t shown_us;          // 包含提示的一帧送显完成的时刻，0为尚未送显
+    uint8_t zone;
+    bool resolved;              // 已匹配到打击或已记为未击中
+} drill_cue_t;
+
+static struct {
+    MUTEX_HANDLE mutex;         // 保护以下状态，显示线程和主任务各自持有很短的时间
+    const gk_drill_program_t* program;
+    gk_drill_phase_t phase;
+    uint8_t round;
+    uint64_t phase_end_us;
+    uint32_t rng;
+    drill_cue_t cues[GK_DRILL_MAX_CUES];    // 当前 (或刚结束的) 回合的提示计划
+    uint16_t n_cues;
+    uint16_t next_cue;          // 下一个待显示的提示
+    int16_t on_screen;          // 正在显示的提示，-1表示没有
+    uint32_t cue_seq;           // 上屏的提示计数
+    gk_drill_result_t result;
+} g_drill = {.on_screen = -1};
+
+static uint32_t drill_rand(void)
+{
+    uint32_t x = g_drill.rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_drill.rng = x;
+    return x;
+}
+
+static bool drill_zone_match(uint8_t zone, const gk_hit_point_t* hit)
+{
+    switch (zone) {
+    case GK_DRILL_ZONE_UPPER_LEFT:
+        return hit->x < 0.0f && hit->y >= 0.0f;
+    case GK_DRILL_ZONE_UPPER_RIGHT:
+        return hit->x >= 0.0f && hit->y >= 0.0f;
+    case GK_DRILL_ZONE_LOWER_LEFT:
+        return hit->x < 0.0f && hit->y < 0.0f;
+    case GK_DRILL_ZONE_LOWER_RIGHT:
+        return hit->x >= 0.0f && hit->y < 0.0f;
+    default:
+        return true;
+    }
+}
+
+// 已送显、时间窗和等待期都已过去而没有打击的提示记为未击中
+// force为true时不等待 (新回合开始或计划结束)
+static void drill_settle(uint64_t now_us, bool force)
+{
+    uint64_t window = DRILL_MS_TO_US(g_drill.program->cue_timeout_ms + GK_DRILL_FEED_GRACE_MS);
+
+    for (uint16_t i = 0; i < g_drill.next_cue; i++) {
+        drill_cue_t* cue = &g_drill.cues[i];
+        if (cue->resolved || !cue->shown_us) {
+            continue;
+        }
+        if (force || now_us >= cue->shown_us + window) {
+            cue->resolved = true;
+            g_drill.result.misses++;
+        }
+    }
+}
+
+// 回合开始时一次生成整个回合的提示计划
+static void drill_plan_round(uint64_t start_us)
+{
+    const gk_drill_program_t* prog = g_drill.program;
+    uint32_t zones[GK_DRILL_ZONE_MAX];
+    uint32_t n_zones = 0;
+
+    for (uint32_t z = GK_DRILL_ZONE_ANY; z < GK_DRILL_ZONE_MAX; z++) {
+        if (prog->zones & GK_DRILL_ZONE_BIT(z)) {
+            zones[n_zones++] = z;
+        }
+    }
+    if (n_zones == 0) {
+        zones[n_zones++] = GK_DRILL_ZONE_ANY;
+    }
+
+    uint32_t gap_min = (prog->cue_gap_min_ms > prog->cue_timeout_ms) ? prog->cue_gap_min_ms : prog->cue_timeout_ms;
+    uint32_t gap_span = (prog->cue_gap_max_ms > gap_min) ? prog->cue_gap_max_ms - gap_min : 0;
+    uint32_t t_ms = 0;
+
+    g_drill.n_cues = 0;
+    g_drill.next_cue = 0;
+    g_drill.on_screen = -1;
+    while (g_drill.n_cues < GK_DRILL_MAX_CUES) {
+        t_ms += gap_min + (gap_span ? drill_rand() % (gap_span + 1) : 0);
+        if (t_ms + prog->cue_timeout_ms > prog->round_ms) {
+            break; // 时间窗必须在回合内结束
+        }
+        drill_cue_t* cue = &g_drill.cues[g_drill.n_cues++];
+        cue->due_us = start_us + DRILL_MS_TO_US(t_ms);
+        cue->shown_us = 0;
+        cue->zone = (uint8_t)zones[drill_rand() % n_zones];
+        cue->resolved = false;
+    }
+}
+
+// 按计划时刻切换阶段，一次调用可能跨越多个阶段 (显示线程长时间阻塞时)
+static void drill_advance_phase(uint64_t now_us)
+{
+    const gk_drill_program_t* prog = g_drill.program;
+
+    while (g_drill.phase != GK_DRILL_DONE && now_us >= g_drill.phase_end_us) {
+        uint64_t start = g_drill.phase_end_us;
+
+        if (g_drill.phase == GK_DRILL_ROUND) {
+            g_drill.on_screen = -1;
+            if (g_drill.round >= prog->rounds) {
+                g_drill.phase = GK_DRILL_DONE;
+                TAL_PR_INFO(TAG, "%s结束", prog->name);
+                break;
+            }
+            g_drill.phase = GK_DRILL_REST;
+            g_drill.phase_end_us = start + DRILL_MS_TO_US(prog->rest_ms);
+        } else {
+            // 倒计时或休息结束，开始下一回合
+            drill_settle(now_us, true);
+            g_drill.round++;
+            g_drill.phase = GK_DRILL_ROUND;
+            g_drill.phase_end_us = start + DRILL_MS_TO_US(prog->round_ms);
+            drill_plan_round(start);
+            TAL_PR_INFO(TAG, "%s 第%u回合: %u次提示", prog->name, g_drill.round, g_drill.n_cues);
+        }
+    }
+}
+
+int gk_drill_init(void)
+{
+    if (g_drill.mutex) {
+        return OPRT_OK;
+    }
+    if (tal_mutex_create_init(&g_drill.mutex) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "互斥锁创建失败");
+        return OPRT_COM_ERROR;
+    }
+    return OPRT_OK;
+}
+
+int gk_drill_start(const gk_drill_program_t* program, uint32_t seed, uint64_t now_us)
+{
+    if (!program || program->rounds == 0 || !g_drill.mutex) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(g_drill.mutex);
+    g_drill.program = program;
+    g_drill.phase = GK_DRILL_READY;
+    g_drill.round = 0;
+    g_drill.phase_end_us = now_us + DRILL_MS_TO_US(GK_DRILL_READY_MS);
+    g_drill.rng = seed ? seed : 1;
+    g_drill.n_cues = 0;
+    g_drill.next_cue = 0;
+    g_drill.on_screen = -1;
+    memset(&g_drill.result, 0, sizeof(g_drill.result));
+    tal_mutex_unlock(g_drill.mutex);
+
+    TAL_PR_INFO(TAG, "开始%s: %u回合 x %us，休息%us", program->name, program->rounds,
+                (unsigned int)(program->round_ms / 1000), (unsigned int)(program->rest_ms / 1000));
+    return OPRT_OK;
+}
+
+void gk_drill_stop(void)
+{
+    if (!g_drill.mutex) {
+        return;
+    }
+    tal_mutex_lock(g_drill.mutex);
+    g_drill.phase = GK_DRILL_IDLE;
+    g_drill.program = NULL;
+    g_drill.on_screen = -1;
+    tal_mutex_unlock(g_drill.mutex);
+}
+
+uint64_t gk_drill_poll(uint64_t now_us, gk_drill_view_t* view)
+{
+    uint64_t next_us = 0;
+
+    if (!g_drill.mutex) {
+        return 0;
+    }
+
+    tal_mutex_lock(g_drill.mutex);
+    const gk_drill_program_t* prog = g_drill.program;
+    if (prog && g_drill.phase != GK_DRILL_IDLE) {
+        drill_advance_phase(now_us);
+        drill_settle(now_us, false);
+
+        if (g_drill.phase == GK_DRILL_ROUND) {
+            // 当前提示被击中或时间窗结束后撤下
+            if (g_drill.on_screen >= 0) {
+                drill_cue_t* cue = &g_drill.cues[g_drill.on_screen];
+                if (cue->resolved ||
+                    (cue->shown_us && now_us >= cue->shown_us + DRILL_MS_TO_US(prog->cue_timeout_ms))) {
+                    g_drill.on_screen = -1;
+                }
+            }
+            // 到达计划时刻的提示上屏，送显时刻由gk_drill_cue_flushed记录
+            // 显示线程延误超过一个时间窗的提示直接跳过，不计入统计
+            while (g_drill.on_screen < 0 && g_drill.next_cue < g_drill.n_cues &&
+                   now_us >= g_drill.cues[g_drill.next_cue].due_us) {
+                drill_cue_t* cue = &g_drill.cues[g_drill.next_cue];
+                g_drill.next_cue++;
+                if (now_us < cue->due_us + DRILL_MS_TO_US(prog->cue_timeout_ms)) {
+                    g_drill.on_screen = (int16_t)(g_drill.next_cue - 1);
+                    g_drill.cue_seq++;
+                } else {
+                    cue->resolved = true;
+                }
+            }
+        }
+
+        // 下一个需要处理的时刻: 阶段结束、提示到期、当前提示的时间窗结束
+        if (g_drill.phase != GK_DRILL_DONE) {
+            next_us = g_drill.phase_end_us;
+        }
+        if (g_drill.phase == GK_DRILL_ROUND) {
+            if (g_drill.on_screen < 0 && g_drill.next_cue < g_drill.n_cues) {
+                next_us = DRILL_MIN(next_us, g_drill.cues[g_drill.next_cue].due_us);
+            } else if (g_drill.on_screen >= 0 && g_drill.cues[g_drill.on_screen].shown_us) {
+                next_us = DRILL_MIN(next_us, g_drill.cues[g_drill.on_screen].shown_us +
+                                                 DRILL_MS_TO_US(prog->cue_timeout_ms));
+            }
+        }
+        if (g_drill.phase == GK_DRILL_DONE && g_drill.next_cue > 0) {
+            // 结束后继续等待最后一个提示的打击送达
+            drill_cue_t* last = &g_drill.cues[g_drill.next_cue - 1];
+            if (!last->resolved && last->shown_us) {
+                next_us = last->shown_us + DRILL_MS_TO_US(prog->cue_timeout_ms + GK_DRILL_FEED_GRACE_MS);
+            }
+        }
+    }
+
+    if (view) {
+        memset(view, 0, sizeof(gk_drill_view_t));
+        view->phase = prog ? g_drill.phase : GK_DRILL_IDLE;
+        view->program = prog;
+        view->round = g_drill.round;
+        if (prog && g_drill.phase != GK_DRILL_DONE && g_drill.phase_end_us > now_us) {
+            view->remaining_ms = (uint32_t)((g_drill.phase_end_us - now_us) / 1000);
+        }
+        if (g_drill.on_screen >= 0) {
+            view->cue = (gk_drill_zone_t)g_drill.cues[g_drill.on_screen].zone;
+            view->cue_seq = g_drill.cue_seq;
+        }
+        view->result = g_drill.result;
+    }
+    tal_mutex_unlock(g_drill.mutex);
+
+    return next_us;
+}
+
+void gk_drill_cue_flushed(uint64_t flush_us)
+{
+    if (!g_drill.mutex) {
+        return;
+    }
+
+    tal_mutex_lock(g_drill.mutex);
+    if (g_drill.on_screen >= 0) {
+        drill_cue_t* cue = &g_drill.cues[g_drill.on_screen];
+        if (!cue->shown_us) {
+            cue->shown_us = flush_us;
+            g_drill.result.cues++;
+        }
+    }
+    tal_mutex_unlock(g_drill.mutex);
+}
+
+int gk_drill_feed_punch(const gk_punch_event_t* event)
+{
+    int rt = OPRT_NOT_FOUND;
+    uint32_t reaction = 0;
+
+    if (!event || !g_drill.mutex) {
+        return OPRT_INVALID_PARM;
+    }
+
+    // 开机后不到一个群延迟的打击按时钟零点处理，避免无符号下溢后落到所有时间窗之外
+    uint64_t onset_us = (event->timestamp > DRILL_ONSET_DELAY_US) ? event->timestamp - DRILL_ONSET_DELAY_US : 0;
+
+    tal_mutex_lock(g_drill.mutex);
+    const gk_drill_program_t* prog = g_drill.program;
+    if (!prog || g_drill.phase == GK_DRILL_IDLE) {
+        tal_mutex_unlock(g_drill.mutex);
+        return OPRT_NOT_FOUND;
+    }
+
+    // 时间窗包含起始时刻的第一个未匹配提示
+    uint64_t timeout = DRILL_MS_TO_US(prog->cue_timeout_ms);
+    for (uint16_t i = 0; i < g_drill.next_cue; i++) {
+        drill_cue_t* cue = &g_drill.cues[i];
+        if (cue->resolved || !cue->shown_us || onset_us < cue->shown_us || onset_us >= cue->shown_us + timeout) {
+            continue;
+        }
+
+        reaction = (uint32_t)(onset_us - cue->shown_us);
+        cue->resolved = true;
+        g_drill.result.hits++;
+        if (drill_zone_match(cue->zone, &event->hit)) {
+            g_drill.result.zone_hits++;
+        }
+        g_drill.result.reaction_last_us = reaction;
+        g_drill.result.reaction_sum_us += reaction;
+        if (g_drill.result.hits == 1 || reaction < g_drill.result.reaction_best_us) {
+            g_drill.result.reaction_best_us = reaction;
+        }
+        rt = OPRT_OK;
+        break;
+    }
+
+    if (rt != OPRT_OK && g_drill.phase == GK_DRILL_ROUND) {
+        g_drill.result.extra++;
+    }
+    tal_mutex_unlock(g_drill.mutex);
+
+    if (rt == OPRT_OK) {
+        TAL_PR_INFO(TAG, "反应时间 %.1fms", reaction / 1000.0f);
+    }
+    return rt;
+}
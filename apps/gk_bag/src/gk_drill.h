@@ -0,0 +1,116 @@
+#ifndef __GK_DRILL_H__
+#define __GK_DRILL_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 训练计划引擎: 回合、休息、目标区域提示和随机提示序列
+ *
+ * 所有时刻使用tal_system_get_microsecond的单调时钟 (微秒)，与打击事件的时间戳相同。
+ * 每个回合开始时一次性生成整个回合的提示计划 (时刻和目标区域)，不在循环中休眠等待，
+ * gk_drill_poll返回下一个需要处理的时刻，由调用者 (LVGL定时器) 按这个时刻重新定时。
+ *
+ * 反应时间 = 打击起始时刻 - 提示的送显时刻:
+ *   - 送显时刻由显示刷新回调在包含提示的一帧送到显示屏后通过gk_drill_cue_flushed给出，
+ *     不是计划时刻，LVGL线程的调度延迟不计入反应时间
+ *   - 打击起始时刻为打击事件的采集时间戳减去滤波器组的群延迟
+ * 主任务按自己的节奏批量送入打击，匹配只看时间戳，提示消失后GK_DRILL_FEED_GRACE_MS内送入的打击仍可匹配。
+ */
+
+#define GK_DRILL_MAX_CUES       64      // 每回合最多的提示数
+#define GK_DRILL_FEED_GRACE_MS  200     // 提示时间窗结束后等待打击事件送达的时间，之后记为未击中
+#define GK_DRILL_READY_MS       3000    // 开始前的倒计时
+
+typedef enum {
+    GK_DRILL_IDLE = 0,
+    GK_DRILL_READY,             // 倒计时
+    GK_DRILL_ROUND,
+    GK_DRILL_REST,
+    GK_DRILL_DONE,
+} gk_drill_phase_t;
+
+// 目标区域，打击点按显示坐标系 (x向右，y向上) 判定
+typedef enum {
+    GK_DRILL_ZONE_NONE = 0,     // 没有提示
+    GK_DRILL_ZONE_ANY,          // 任意位置
+    GK_DRILL_ZONE_UPPER_LEFT,
+    GK_DRILL_ZONE_UPPER_RIGHT,
+    GK_DRILL_ZONE_LOWER_LEFT,
+    GK_DRILL_ZONE_LOWER_RIGHT,
+    GK_DRILL_ZONE_MAX
+} gk_drill_zone_t;
+
+#define GK_DRILL_ZONE_BIT(z)    (1u << (z))
+#define GK_DRILL_ZONES_QUAD                                                                                            \
+    (GK_DRILL_ZONE_BIT(GK_DRILL_ZONE_UPPER_LEFT) | GK_DRILL_ZONE_BIT(GK_DRILL_ZONE_UPPER_RIGHT) |                      \
+     GK_DRILL_ZONE_BIT(GK_DRILL_ZONE_LOWER_LEFT) | GK_DRILL_ZONE_BIT(GK_DRILL_ZONE_LOWER_RIGHT))
+
+typedef struct {
+    const char* name;
+    uint8_t rounds;
+    uint32_t round_ms;
+    uint32_t rest_ms;
+    uint32_t cue_gap_min_ms;    // 相邻两次提示计划时刻的间隔范围，不小于cue_timeout_ms
+    uint32_t cue_gap_max_ms;
+    uint32_t cue_timeout_ms;    // 提示显示的时间窗，窗内的第一次打击计入反应时间
+    uint32_t zones;             // 提示的目标区域 (GK_DRILL_ZONE_BIT)，每次提示随机选择一个
+} gk_drill_program_t;
+
+// 训练模式页面的内置计划: 力量、速度、精准、耐力、组合技
+typedef enum {
+    GK_DRILL_STRENGTH = 0,
+    GK_DRILL_SPEED,
+    GK_DRILL_ACCURACY,
+    GK_DRILL_ENDURANCE,
+    GK_DRILL_COMBO,
+    GK_DRILL_PROGRAM_MAX
+} gk_drill_program_id_t;
+
+extern const gk_drill_program_t gk_drill_programs[GK_DRILL_PROGRAM_MAX];
+
+typedef struct {
+    uint16_t cues;              // 已送显的提示数
+    uint16_t hits;              // 时间窗内有打击的提示数
+    uint16_t zone_hits;         // 其中打在目标区域的次数
+    uint16_t misses;            // 时间窗内没有打击的提示数
+    uint16_t extra;             // 回合中没有对应提示的打击 (抢拳或多余的出拳)
+    uint32_t reaction_last_us;
+    uint32_t reaction_best_us;
+    uint64_t reaction_sum_us;   // 除以hits为平均反应时间
+} gk_drill_result_t;
+
+typedef struct {
+    gk_drill_phase_t phase;
+    const gk_drill_program_t* program;
+    uint8_t round;              // 从1开始
+    uint32_t remaining_ms;      // 当前阶段剩余时间
+    gk_drill_zone_t cue;        // 应显示的提示，GK_DRILL_ZONE_NONE时不显示
+    uint32_t cue_seq;           // 提示的序号，相同区域的相邻两次提示也不相同
+    gk_drill_result_t result;
+} gk_drill_view_t;
+
+int gk_drill_init(void);
+
+// 开始一个计划，进行中的计划被替换
+int gk_drill_start(const gk_drill_program_t* program, uint32_t seed, uint64_t now_us);
+void gk_drill_stop(void);
+
+// 推进阶段和提示，填充view，返回下一个需要再次调用的时刻 (0表示没有进行中的计划)
+// 在显示线程中调用: view.cue变化后应立即刷新显示，使提示所在的一帧尽快送显
+uint64_t gk_drill_poll(uint64_t now_us, gk_drill_view_t* view);
+
+// 显示刷新回调: 包含当前提示的一帧已送到显示屏
+void gk_drill_cue_flushed(uint64_t flush_us);
+
+// 主任务送入打击事件，与已送显的提示按时间戳匹配，匹配到提示时返回OPRT_OK
+int gk_drill_feed_punch(const gk_punch_event_t* event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_DRILL_H__ */
@@ -0,0 +1,196 @@
+#include "gk_filter.h"
+
+#if (GK_FILTER_MEDIAN_WIDTH != 3) && (GK_FILTER_MEDIAN_WIDTH != 5) && (GK_FILTER_MEDIAN_WIDTH != 7) && \
+    (GK_FILTER_MEDIAN_WIDTH != 9)
+#error "FORCE_FILTER_MEDIAN_WIDTH must be 3, 5, 7 or 9"
+#endif
+
+#if (GK_FILTER_AVG_WIDTH < 1) || (GK_FILTER_AVG_WIDTH > 65535)
+#error "FORCE_FILTER_AVG_WIDTH out of range"
+#endif
+
+// 比较交换，编译为无分支的min/max
+#define FILTER_SORT(a, b)                                                                                              \
+    do {                                                                                                               \
+        FILTER_SAMPLE_T _lo = (p[a] < p[b]) ? p[a] : p[b];                                                             \
+        FILTER_SAMPLE_T _hi = (p[a] < p[b]) ? p[b] : p[a];                                                             \
+        p[a] = _lo;                                                                                                    \
+        p[b] = _hi;                                                                                                    \
+    } while (0)
+
+// 固定宽度中值排序网络 (只求中值，不做完整排序)
+#if GK_FILTER_MEDIAN_WIDTH == 3
+#define FILTER_MEDIAN_NETWORK()                                                                                        \
+    do {                                                                                                               \
+        FILTER_SORT(0, 1); FILTER_SORT(1, 2); FILTER_SORT(0, 1);                                                       \
+    } while (0)
+#elif GK_FILTER_MEDIAN_WIDTH == 5
+#define FILTER_MEDIAN_NETWORK()                                                                                        \
+    do {                                                                                                               \
+        FILTER_SORT(0, 1); FILTER_SORT(3, 4); FILTER_SORT(0, 3);                                                       \
+        FILTER_SORT(1, 4); FILTER_SORT(1, 2); FILTER_SORT(2, 3);                                                       \
+        FILTER_SORT(1, 2);                                                                                             \
+    } while (0)
+#elif GK_FILTER_MEDIAN_WIDTH == 7
+#define FILTER_MEDIAN_NETWORK()                                                                                        \
+    do {                                                                                                               \
+        FILTER_SORT(0, 5); FILTER_SORT(0, 3); FILTER_SORT(1, 6);                                                       \
+        FILTER_SORT(2, 4); FILTER_SORT(0, 1); FILTER_SORT(3, 5);                                                       \
+        FILTER_SORT(2, 6); FILTER_SORT(2, 3); FILTER_SORT(3, 6);                                                       \
+        FILTER_SORT(4, 5); FILTER_SORT(1, 4); FILTER_SORT(1, 3);                                                       \
+        FILTER_SORT(3, 4);                                                                                             \
+    } while (0)
+#else
+#define FILTER_MEDIAN_NETWORK()                                                                                        \
+    do {                                                                                                               \
+        FILTER_SORT(1, 2); FILTER_SORT(4, 5); FILTER_SORT(7, 8);                                                       \
+        FILTER_SORT(0, 1); FILTER_SORT(3, 4); FILTER_SORT(6, 7);                                                       \
+        FILTER_SORT(1, 2); FILTER_SORT(4, 5); FILTER_SORT(7, 8);                                                       \
+        FILTER_SORT(0, 3); FILTER_SORT(5, 8); FILTER_SORT(4, 7);                                                       \
+        FILTER_SORT(3, 6); FILTER_SORT(1, 4); FILTER_SORT(2, 5);                                                       \
+        FILTER_SORT(4, 7); FILTER_SORT(4, 2); FILTER_SORT(6, 4);                                                       \
+        FILTER_SORT(4, 2);                                                                                             \
+    } while (0)
+#endif
+
+// 浮点和定点两个版本共用同一份网络定义
+static float median_network(float* p)
+{
+#define FILTER_SAMPLE_T float
+    FILTER_MEDIAN_NETWORK();
+#undef FILTER_SAMPLE_T
+    return p[GK_FILTER_MEDIAN_WIDTH / 2];
+}
+
+static gk_q16_t median_network_q16(gk_q16_t* p)
+{
+#define FILTER_SAMPLE_T gk_q16_t
+    FILTER_MEDIAN_NETWORK();
+#undef FILTER_SAMPLE_T
+    return p[GK_FILTER_MEDIAN_WIDTH / 2];
+}
+
+void gk_filter_bank_reset(gk_filter_bank_t* bank)
+{
+    memset(bank, 0, sizeof(gk_filter_bank_t));
+}
+
+// 首个样本填满全部窗口，避免启动阶段的变长窗口处理
+static void filter_bank_prime(gk_filter_bank_t* bank, const float in[GK_FILTER_CHANNELS])
+{
+    for (int ch = 0; ch < GK_FILTER_CHANNELS; ch++) {
+        for (int i = 0; i < GK_FILTER_MEDIAN_WIDTH; i++) {
+            bank->median_win[ch][i] = in[ch];
+        }
+        for (int i = 0; i < GK_FILTER_AVG_WIDTH; i++) {
+            bank->avg_win[ch][i] = in[ch];
+        }
+        bank->avg_sum[ch] = in[ch] * GK_FILTER_AVG_WIDTH;
+    }
+    bank->median_pos = 0;
+    bank->avg_pos = 0;
+    bank->primed = true;
+}
+
+void gk_filter_bank_process(gk_filter_bank_t* bank, const float in[GK_FILTER_CHANNELS],
+                            float out[GK_FILTER_CHANNELS])
+{
+    if (!bank->primed) {
+        filter_bank_prime(bank, in);
+    }
+
+    uint16_t mpos = bank->median_pos;
+    uint16_t apos = bank->avg_pos;
+
+    for (int ch = 0; ch < GK_FILTER_CHANNELS; ch++) {
+        // 步骤1: 中值滤波
+        float scratch[GK_FILTER_MEDIAN_WIDTH];
+        bank->median_win[ch][mpos] = in[ch];
+        memcpy(scratch, bank->median_win[ch], sizeof(scratch));
+        float median = median_network(scratch);
+
+        // 步骤2: 移动平均，维护滑动和
+        bank->avg_sum[ch] += median - bank->avg_win[ch][apos];
+        bank->avg_win[ch][apos] = median;
+        out[ch] = bank->avg_sum[ch] * (1.0f / GK_FILTER_AVG_WIDTH);
+    }
+
+    if (++mpos >= GK_FILTER_MEDIAN_WIDTH) {
+        mpos = 0;
+    }
+    bank->median_pos = mpos;
+
+    if (++apos >= GK_FILTER_AVG_WIDTH) {
+        apos = 0;
+        // 每绕一圈重新求和一次，消除浮点累加误差 (均摊O(1))
+        for (int ch = 0; ch < GK_FILTER_CHANNELS; ch++) {
+            float sum = 0.0f;
+            for (int i = 0; i < GK_FILTER_AVG_WIDTH; i++) {
+                sum += bank->avg_win[ch][i];
+            }
+            bank->avg_sum[ch] = sum;
+        }
+    }
+    bank->avg_pos = apos;
+}
+
+// 定点版本: 滑动和使用int64精确累加，无需周期性重新求和
+// 除以窗口宽度用Q24倒数乘法代替，避免32位MCU上的64位除法
+#define FILTER_AVG_RECIP_Q24    ((int64_t)((1 << GK_Q24_SHIFT) + GK_FILTER_AVG_WIDTH / 2) / GK_FILTER_AVG_WIDTH)
+
+void gk_filter_bank_q16_reset(gk_filter_bank_q16_t* bank)
+{
+    memset(bank, 0, sizeof(gk_filter_bank_q16_t));
+}
+
+static void filter_bank_q16_prime(gk_filter_bank_q16_t* bank, const gk_q16_t in[GK_FILTER_CHANNELS])
+{
+    for (int ch = 0; ch < GK_FILTER_CHANNELS; ch++) {
+        for (int i = 0; i < GK_FILTER_MEDIAN_WIDTH; i++) {
+            bank->median_win[ch][i] = in[ch];
+        }
+        for (int i = 0; i < GK_FILTER_AVG_WIDTH; i++) {
+            bank->avg_win[ch][i] = in[ch];
+        }
+        bank->avg_sum[ch] = (int64_t)in[ch] * GK_FILTER_AVG_WIDTH;
+    }
+    bank->median_pos = 0;
+    bank->avg_pos = 0;
+    bank->primed = true;
+}
+
+void gk_filter_bank_q16_process(gk_filter_bank_q16_t* bank, const gk_q16_t in[GK_FILTER_CHANNELS],
+                                gk_q16_t out[GK_FILTER_CHANNELS])
+{
+    if (!bank->primed) {
+        filter_bank_q16_prime(bank, in);
+    }
+
+    uint16_t mpos = bank->median_pos;
+    uint16_t apos = bank->avg_pos;
+
+    for (int ch = 0; ch < GK_FILTER_CHANNELS; ch++) {
+        gk_q16_t scratch[GK_FILTER_MEDIAN_WIDTH];
+        bank->median_win[ch][mpos] = in[ch];
+        memcpy(scratch, bank->median_win[ch], sizeof(scratch));
+        gk_q16_t median = median_network_q16(scratch);
+
+        bank->avg_sum[ch] += (int64_t)median - bank->avg_win[ch][apos];
+        bank->avg_win[ch][apos] = median;
+#if (GK_FILTER_AVG_WIDTH & (GK_FILTER_AVG_WIDTH - 1)) == 0
+        out[ch] = (gk_q16_t)(bank->avg_sum[ch] / GK_FILTER_AVG_WIDTH);
+#else
+        out[ch] = (gk_q16_t)((bank->avg_sum[ch] * FILTER_AVG_RECIP_Q24) >> GK_Q24_SHIFT);
+#endif
+    }
+
+    if (++mpos >= GK_FILTER_MEDIAN_WIDTH) {
+        mpos = 0;
+    }
+    bank->median_pos = mpos;
+
+    if (++apos >= GK_FILTER_AVG_WIDTH) {
+        apos = 0;
+    }
+    bank->avg_pos = apos;
+}
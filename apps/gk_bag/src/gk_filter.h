@@ -0,0 +1,66 @@
+#ifndef __GK_FILTER_H__
+#define __GK_FILTER_H__
+
+#include "tuya_cloud_types.h"
+#include "gk_fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GK_FILTER_CHANNELS  6   // Fx Fy Fz Mx My Mz
+
+// 中值窗口宽度 (3/5/7/9，使用固定排序网络)
+#ifdef FORCE_FILTER_MEDIAN_WIDTH
+#define GK_FILTER_MEDIAN_WIDTH  FORCE_FILTER_MEDIAN_WIDTH
+#else
+#define GK_FILTER_MEDIAN_WIDTH  5
+#endif
+
+// 移动平均窗口宽度
+#ifdef FORCE_FILTER_AVG_WIDTH
+#define GK_FILTER_AVG_WIDTH     FORCE_FILTER_AVG_WIDTH
+#else
+#define GK_FILTER_AVG_WIDTH     5
+#endif
+
+// 群延迟 (样本数): 中值和移动平均各使输出落后(宽度-1)/2个样本，滤波后帧的时间戳减去它才是对应的采集时刻
+#define GK_FILTER_DELAY_SAMPLES ((GK_FILTER_MEDIAN_WIDTH - 1) / 2 + (GK_FILTER_AVG_WIDTH - 1) / 2)
+
+// 六通道流式滤波器组: 中值滤波 + 移动平均
+// 结构数组布局，每个通道的窗口在内存中连续
+typedef struct {
+    float median_win[GK_FILTER_CHANNELS][GK_FILTER_MEDIAN_WIDTH];
+    float avg_win[GK_FILTER_CHANNELS][GK_FILTER_AVG_WIDTH];
+    float avg_sum[GK_FILTER_CHANNELS];
+    uint16_t median_pos;
+    uint16_t avg_pos;
+    bool primed;
+} gk_filter_bank_t;
+
+void gk_filter_bank_reset(gk_filter_bank_t* bank);
+
+// 一次处理全部六个通道，每样本O(1)
+void gk_filter_bank_process(gk_filter_bank_t* bank, const float in[GK_FILTER_CHANNELS],
+                            float out[GK_FILTER_CHANNELS]);
+
+// 定点版本 (Q16)，用于无硬件FPU的平台
+typedef struct {
+    gk_q16_t median_win[GK_FILTER_CHANNELS][GK_FILTER_MEDIAN_WIDTH];
+    gk_q16_t avg_win[GK_FILTER_CHANNELS][GK_FILTER_AVG_WIDTH];
+    int64_t avg_sum[GK_FILTER_CHANNELS];
+    uint16_t median_pos;
+    uint16_t avg_pos;
+    bool primed;
+} gk_filter_bank_q16_t;
+
+void gk_filter_bank_q16_reset(gk_filter_bank_q16_t* bank);
+
+void gk_filter_bank_q16_process(gk_filter_bank_q16_t* bank, const gk_q16_t in[GK_FILTER_CHANNELS],
+                                gk_q16_t out[GK_FILTER_CHANNELS]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_FILTER_H__ */
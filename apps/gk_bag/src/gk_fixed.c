@@ -0,0 +1,210 @@
+#include "gk_fixed.h"
+
+// 求解器常量 (与浮点实现一致)，直接写成整数，求解过程不经过浮点
+#define FIXED_SENSOR_OFFSET_X   13107       // 0.20 m (Q16)，Mx补偿
+#define FIXED_SENSOR_OFFSET_Y   9830        // 0.15 m (Q16)，My补偿
+#define FIXED_BAG_RADIUS_Q24    1677722     // 0.10 m (Q24)
+#define FIXED_HIT_LIMIT_CM      (15 * GK_Q16_ONE)
+// γ⊥的饱和范围 (±32 m)，保证所有二次项在int64内不溢出
+#define FIXED_LEN_LIMIT_Q24     ((int32_t)32 << GK_Q24_SHIFT)
+// k的饱和范围: 力接近垂直时k可以很大，但k·ux、k·uy仍然有限
+#define FIXED_K_LIMIT_Q24       ((int64_t)1 << 60)
+// 求解输入的幅值上限 (Q16下2048 N / N·m): |F|²和F×τ保持在2^56以内
+#define FIXED_INPUT_LIMIT_BITS  27
+// 校准增益归一化区间的下限，gain在[2^29, 2^30)内
+#define FIXED_GAIN_NORM         ((float)(1 << 29))
+#define FIXED_GAIN_MAX_SHIFT    62
+
+uint32_t gk_isqrt32(uint32_t v)
+{
+    uint32_t res = 0;
+    uint32_t bit = (uint32_t)1 << 30;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return res;
+}
+
+uint32_t gk_isqrt64(uint64_t v)
+{
+    if (v <= 0xFFFFFFFFu) {
+        return gk_isqrt32((uint32_t)v);
+    }
+
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > v) {
+        bit >>= 2;
+    }
+
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)res;
+}
+
+static int32_t fixed_saturate(int64_t v, int32_t limit)
+{
+    if (v > limit) {
+        return limit;
+    }
+    if (v < -limit) {
+        return -limit;
+    }
+    return (int32_t)v;
+}
+
+void gk_fixed_cal_set(gk_fixed_cal_t* cal, int ch, float offset, float gain)
+{
+    // 每计数对应的Q16值，左移到[2^29, 2^30)并记录移位数
+    float g = gain * (float)GK_Q16_ONE;
+    uint8_t shift = 0;
+
+    while (g != 0.0f && g < FIXED_GAIN_NORM && g > -FIXED_GAIN_NORM && shift < FIXED_GAIN_MAX_SHIFT) {
+        g *= 2.0f;
+        shift++;
+    }
+
+    cal->offset[ch] = GK_FLOAT_TO_Q(offset, 0);
+    cal->gain[ch] = GK_FLOAT_TO_Q(g, 0);
+    cal->shift[ch] = shift;
+}
+
+void gk_fixed_calibrate(const gk_fixed_cal_t* cal, const int32_t raw[GK_FIXED_CHANNELS],
+                        gk_q16_t out[GK_FIXED_CHANNELS])
+{
+    for (int ch = 0; ch < GK_FIXED_CHANNELS; ch++) {
+        // |diff| < 2^32，|gain| <= 2^31，乘积在int64内
+        int64_t diff = (int64_t)raw[ch] - cal->offset[ch];
+        out[ch] = fixed_saturate((diff * cal->gain[ch]) >> cal->shift[ch], INT32_MAX);
+    }
+}
+
+// (v * q) >> 30，q为Q30值 (|q| <= 1.0)；拆成高低32位相乘，|v| < 2^61时不溢出
+static int64_t fixed_mul_q30(int64_t v, gk_q30_t q)
+{
+    int64_t hi = v >> 32;
+    uint64_t lo = (uint64_t)v & 0xFFFFFFFFu;
+    uint64_t q_abs = (q < 0) ? (uint64_t)(-(int64_t)q) : (uint64_t)q;
+    int64_t lo_part = (int64_t)((lo * q_abs) >> GK_Q30_SHIFT);
+
+    return hi * q * 4 + ((q < 0) ? -lo_part : lo_part);
+}
+
+int gk_fixed_solve_hit_point(const gk_q16_t ft[GK_FIXED_CHANNELS], gk_q16_t threshold, gk_q16_t* x_cm,
+                             gk_q16_t* y_cm, gk_q16_t* force)
+{
+    if (!ft || !x_cm || !y_cm || !force) {
+        return OPRT_INVALID_PARM;
+    }
+
+    int64_t F[3] = {ft[0], ft[1], ft[2]};
+    int64_t tau[3] = {ft[3], ft[4], ft[5]};
+
+    // 传感器位置补偿
+    tau[0] += (F[1] * FIXED_SENSOR_OFFSET_X) >> GK_Q16_SHIFT;
+    tau[1] += (F[0] * FIXED_SENSOR_OFFSET_Y) >> GK_Q16_SHIFT;
+
+    // 预缩放: 最大分量超过2^27时F和τ一起右移，γ⊥ = F×τ/|F|²和方向u不变
+    int64_t max_abs = 0;
+    for (int i = 0; i < 3; i++) {
+        int64_t f_abs = (F[i] < 0) ? -F[i] : F[i];
+        int64_t t_abs = (tau[i] < 0) ? -tau[i] : tau[i];
+        max_abs = (f_abs > max_abs) ? f_abs : max_abs;
+        max_abs = (t_abs > max_abs) ? t_abs : max_abs;
+    }
+    int prescale = 0;
+    while ((max_abs >> prescale) >= ((int64_t)1 << FIXED_INPUT_LIMIT_BITS)) {
+        prescale++;
+    }
+    for (int i = 0; i < 3; i++) {
+        F[i] >>= prescale;
+        tau[i] >>= prescale;
+    }
+
+    // |F|² (Q32，预缩放后 < 3·2^54)
+    int64_t f_norm_sq = F[0] * F[0] + F[1] * F[1] + F[2] * F[2];
+    gk_q16_t force_magnitude = (gk_q16_t)gk_isqrt64((uint64_t)f_norm_sq);
+    int64_t force_full = (int64_t)force_magnitude << prescale;
+    if (force_full < threshold) {
+        return OPRT_COM_ERROR; // 不是显著的打击
+    }
+
+    int64_t f_norm_sq_q8 = f_norm_sq >> GK_Q24_SHIFT; // Q32 -> Q8
+    if (f_norm_sq_q8 == 0) {
+        return OPRT_COM_ERROR;
+    }
+
+    // γ⊥ = F × τ / |F|²: Q32 / Q8 = Q24 (米)
+    gk_q24_t gamma_perp[3];
+    gamma_perp[0] = fixed_saturate((F[1] * tau[2] - F[2] * tau[1]) / f_norm_sq_q8, FIXED_LEN_LIMIT_Q24);
+    gamma_perp[1] = fixed_saturate((F[2] * tau[0] - F[0] * tau[2]) / f_norm_sq_q8, FIXED_LEN_LIMIT_Q24);
+    gamma_perp[2] = fixed_saturate((F[0] * tau[1] - F[1] * tau[0]) / f_norm_sq_q8, FIXED_LEN_LIMIT_Q24);
+
+    // 以单位方向u = F/|F|重写方程: γ = k·u + γ⊥，k = k1·|F| (米)
+    // 各系数均为有界的小量，避免F²·γ²级别的溢出
+    gk_q30_t u[3];
+    for (int i = 0; i < 3; i++) {
+        u[i] = (gk_q30_t)((F[i] * GK_Q30_ONE) / force_magnitude);
+    }
+
+    // a = ux² + uy² (Q30)，b = 2(ux·γx + uy·γy) (Q24)，c = γx² + γy² - r² (Q48)
+    int64_t a = ((int64_t)u[0] * u[0] + (int64_t)u[1] * u[1]) >> GK_Q30_SHIFT;
+    int64_t b = (((int64_t)u[0] * gamma_perp[0] + (int64_t)u[1] * gamma_perp[1]) >> GK_Q30_SHIFT) * 2;
+    int64_t c = (int64_t)gamma_perp[0] * gamma_perp[0] + (int64_t)gamma_perp[1] * gamma_perp[1] -
+                (int64_t)FIXED_BAG_RADIUS_Q24 * FIXED_BAG_RADIUS_Q24;
+
+    int64_t k; // Q24
+    if (a < 2) {
+        // 力向量几乎垂直
+        if (u[2] == 0) {
+            return OPRT_COM_ERROR;
+        }
+        k = -(((int64_t)gamma_perp[2] * GK_Q30_ONE) / u[2]);
+    } else {
+        int64_t discriminant = b * b - 4 * fixed_mul_q30(c, (gk_q30_t)a); // Q48
+        if (discriminant >= 0) {
+            int64_t sqrt_disc = gk_isqrt64((uint64_t)discriminant); // Q24
+            k = ((-b - sqrt_disc) * GK_Q30_ONE) / (2 * a);        // 取物理上有意义的解
+        } else {
+            // 无解，取最近点
+            k = (-b * (GK_Q30_ONE / 2)) / a;
+        }
+    }
+    if (k > FIXED_K_LIMIT_Q24) {
+        k = FIXED_K_LIMIT_Q24;
+    } else if (k < -FIXED_K_LIMIT_Q24) {
+        k = -FIXED_K_LIMIT_Q24;
+    }
+
+    // γ = k·u + γ⊥ (Q24)，只需要x/y分量
+    int64_t gamma0 = fixed_saturate(fixed_mul_q30(k, u[0]) + gamma_perp[0], FIXED_LEN_LIMIT_Q24);
+    int64_t gamma1 = fixed_saturate(fixed_mul_q30(k, u[1]) + gamma_perp[1], FIXED_LEN_LIMIT_Q24);
+
+    // 转换为左手坐标系 (交换x,y用于显示)，米(Q24) -> 厘米(Q16)
+    *x_cm = fixed_saturate((gamma1 * 100) >> (GK_Q24_SHIFT - GK_Q16_SHIFT), FIXED_HIT_LIMIT_CM);
+    *y_cm = fixed_saturate((gamma0 * 100) >> (GK_Q24_SHIFT - GK_Q16_SHIFT), FIXED_HIT_LIMIT_CM);
+    *force = fixed_saturate(force_full, INT32_MAX);
+
+    return OPRT_OK;
+}
@@ -0,0 +1,81 @@
+#ifndef __GK_FIXED_H__
+#define __GK_FIXED_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 定点数格式
+// Q16: s15.16，力(N)、力矩(N·m)、厘米坐标
+// Q24: s7.24，米制长度 (接触点求解内部)
+// Q30: s1.30，单位向量和校准缩放系数
+typedef int32_t gk_q16_t;
+typedef int32_t gk_q24_t;
+typedef int32_t gk_q30_t;
+
+#define GK_Q16_SHIFT    16
+#define GK_Q24_SHIFT    24
+#define GK_Q30_SHIFT    30
+#define GK_Q16_ONE      (1 << GK_Q16_SHIFT)
+#define GK_Q30_ONE      (1 << GK_Q30_SHIFT)
+
+// 浮点转定点，超出int32范围时饱和 (如GK_FLOAT_TO_Q30(2.0f)得到INT32_MAX)，NaN转为0
+#define GK_FLOAT_TO_Q(f, shift) gk_float_to_q((float)(f), (shift))
+#define GK_FLOAT_TO_Q16(f)      GK_FLOAT_TO_Q(f, GK_Q16_SHIFT)
+#define GK_FLOAT_TO_Q30(f)      GK_FLOAT_TO_Q(f, GK_Q30_SHIFT)
+#define GK_Q16_TO_FLOAT(q)      ((float)(q) * (1.0f / GK_Q16_ONE))
+
+#define GK_Q16_MUL(a, b)        ((gk_q16_t)(((int64_t)(a) * (b)) >> GK_Q16_SHIFT))
+
+#define GK_FIXED_CHANNELS       6
+
+static inline int32_t gk_float_to_q(float f, int shift)
+{
+    float v = f * (float)((int64_t)1 << shift);
+
+    if (v != v) {
+        return 0;
+    }
+    if (v >= 2147483647.0f) {
+        return INT32_MAX;
+    }
+    if (v <= -2147483648.0f) {
+        return INT32_MIN;
+    }
+    return (int32_t)(v + ((v >= 0) ? 0.5f : -0.5f));
+}
+
+// 定点校准参数: out = ((raw - offset) * gain) >> shift
+// raw为ADC计数，out为Q16物理量；gain按通道归一化到[2^29, 2^30)，
+// 使每计数对应的物理量无论大小都保留约30位有效精度
+typedef struct {
+    int32_t offset[GK_FIXED_CHANNELS];   // 零点 (计数)
+    int32_t gain[GK_FIXED_CHANNELS];
+    uint8_t shift[GK_FIXED_CHANNELS];
+} gk_fixed_cal_t;
+
+// 整数平方根，向下取整，不使用除法
+uint32_t gk_isqrt32(uint32_t v);
+uint32_t gk_isqrt64(uint64_t v);
+
+// 设置通道ch的校准参数: offset为零点 (计数)，gain为每计数对应的物理量
+// 只在加载校准或零点更新时调用，采样路径上不使用浮点
+void gk_fixed_cal_set(gk_fixed_cal_t* cal, int ch, float offset, float gain);
+
+void gk_fixed_calibrate(const gk_fixed_cal_t* cal, const int32_t raw[GK_FIXED_CHANNELS],
+                        gk_q16_t out[GK_FIXED_CHANNELS]);
+
+// 定点接触点求解 γ = k1·F + γ⊥，与gk_calculate_hit_point的浮点实现对应
+// ft: Fx Fy Fz Mx My Mz (Q16)，threshold: 最小力 (Q16 N)
+// 输入按需整体右移预缩放 (求解的几何结果与F、τ的共同缩放无关)，满量程int32输入也不会溢出
+// 输出x/y为厘米 (Q16)，force为力大小 (Q16 N)
+int gk_fixed_solve_hit_point(const gk_q16_t ft[GK_FIXED_CHANNELS], gk_q16_t threshold, gk_q16_t* x_cm,
+                             gk_q16_t* y_cm, gk_q16_t* force);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_FIXED_H__ */
@@ -0,0 +1,68 @@
+#include "gk_frame_ring.h"
+
+// 跨核可见性: 生产者发布head前保证帧数据已写入(release)，
+// 消费者读取head后再读帧数据(acquire)；tail同理
+#define RING_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RING_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define RING_LOAD_RELAXED(p)      __atomic_load_n((p), __ATOMIC_RELAXED)
+
+int gk_frame_ring_init(gk_frame_ring_t* ring, gk_force_data_t* storage, uint32_t capacity)
+{
+    if (!ring || !storage || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memset(ring, 0, sizeof(gk_frame_ring_t));
+    ring->frames = storage;
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+
+    return OPRT_OK;
+}
+
+bool gk_frame_ring_push(gk_frame_ring_t* ring, const gk_force_data_t* frame)
+{
+    uint32_t head = ring->head;
+    uint32_t tail = RING_LOAD_ACQUIRE(&ring->tail);
+    uint32_t used = head - tail;
+
+    if (used >= ring->capacity) {
+        ring->dropped++;
+        return false;
+    }
+
+    ring->frames[head & ring->mask] = *frame;
+    RING_STORE_RELEASE(&ring->head, head + 1);
+
+    if (used + 1 > ring->high_water) {
+        ring->high_water = used + 1;
+    }
+
+    return true;
+}
+
+uint32_t gk_frame_ring_pop(gk_frame_ring_t* ring, gk_force_data_t* frames, uint32_t max_frames)
+{
+    uint32_t tail = ring->tail;
+    uint32_t head = RING_LOAD_ACQUIRE(&ring->head);
+    uint32_t count = head - tail;
+
+    if (count > max_frames) {
+        count = max_frames;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        frames[i] = ring->frames[(tail + i) & ring->mask];
+    }
+
+    if (count > 0) {
+        RING_STORE_RELEASE(&ring->tail, tail + count);
+    }
+
+    return count;
+}
+
+uint32_t gk_frame_ring_count(const gk_frame_ring_t* ring)
+{
+    return RING_LOAD_RELAXED(&ring->head) - RING_LOAD_RELAXED(&ring->tail);
+}
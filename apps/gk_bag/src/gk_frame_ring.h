@@ -0,0 +1,37 @@
+#ifndef __GK_FRAME_RING_H__
+#define __GK_FRAME_RING_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 单生产者/单消费者无锁帧环形缓冲区
+// 生产者(采集线程)只写head，消费者(主任务)只写tail，
+// 索引自由递增，容量必须为2的幂
+typedef struct {
+    gk_force_data_t* frames;
+    uint32_t capacity;
+    uint32_t mask;
+    uint32_t head;        // 下一个写入位置 (仅生产者修改)
+    uint32_t tail;        // 下一个读取位置 (仅消费者修改)
+    uint32_t dropped;     // 缓冲区满时丢弃的帧数 (仅生产者修改)
+    uint32_t high_water;  // 最高占用 (仅生产者修改)
+} gk_frame_ring_t;
+
+int gk_frame_ring_init(gk_frame_ring_t* ring, gk_force_data_t* storage, uint32_t capacity);
+
+// 生产者: 写入一帧，缓冲区满时丢弃该帧并返回false
+bool gk_frame_ring_push(gk_frame_ring_t* ring, const gk_force_data_t* frame);
+
+// 消费者: 最多取出max_frames帧，返回实际帧数
+uint32_t gk_frame_ring_pop(gk_frame_ring_t* ring, gk_force_data_t* frames, uint32_t max_frames);
+
+uint32_t gk_frame_ring_count(const gk_frame_ring_t* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_FRAME_RING_H__ */
@@ -0,0 +1,159 @@
+#include "gk_gui_canvas.h"
+#include "tal_log.h"
+#include "tkl_memory.h"
+#include "tdl_display_manage.h"
+
+#define TAG "GUI_CANVAS"
+
+#define GUI_CANVAS_ALIGN(x)     (((x) + LV_DRAW_BUF_ALIGN - 1) & ~(LV_DRAW_BUF_ALIGN - 1))
+
+static struct {
+    int32_t disp_w;
+    int32_t disp_h;
+    uint8_t* raw;               // 分配得到的指针，base为按LV_DRAW_BUF_ALIGN对齐后的起始地址
+    uint8_t* base;
+    gk_gui_canvas_stats_t stats;
+} g_gui_canvas = {0};
+
+static void* gui_canvas_malloc(uint32_t size)
+{
+#if defined(ENABLE_EXT_RAM) && (ENABLE_EXT_RAM == 1)
+    return tkl_system_psram_malloc(size);
+#else
+    return tkl_system_malloc(size);
+#endif
+}
+
+static void gui_canvas_free(void* ptr)
+{
+#if defined(ENABLE_EXT_RAM) && (ENABLE_EXT_RAM == 1)
+    tkl_system_psram_free(ptr);
+#else
+    tkl_system_free(ptr);
+#endif
+}
+
+int gk_gui_canvas_init(void)
+{
+    int32_t w = 0, h = 0;
+
+#ifdef DISPLAY_NAME
+    TDL_DISP_HANDLE_T disp = tdl_disp_find_dev(DISPLAY_NAME);
+    TDL_DISP_DEV_INFO_T info;
+    if (disp && tdl_disp_dev_get_info(disp, &info) == OPRT_OK) {
+        w = info.width;
+        h = info.height;
+        if (info.rotation == TUYA_DISPLAY_ROTATION_90 || info.rotation == TUYA_DISPLAY_ROTATION_270) {
+            w = info.height;
+            h = info.width;
+        }
+    }
+#endif
+
+    // 没有指定显示设备时使用LVGL显示对象的分辨率，它由lv_port_disp按同一个设备信息创建
+    if (w <= 0 || h <= 0) {
+        w = LV_HOR_RES;
+        h = LV_VER_RES;
+    }
+    if (w <= 0 || h <= 0) {
+        TAL_PR_ERR(TAG, "无法获取显示屏分辨率");
+        return OPRT_COM_ERROR;
+    }
+
+    g_gui_canvas.disp_w = w;
+    g_gui_canvas.disp_h = h;
+    TAL_PR_INFO(TAG, "显示屏 %dx%d", (int)w, (int)h);
+    return OPRT_OK;
+}
+
+void gk_gui_canvas_get_display(int32_t* width, int32_t* height)
+{
+    *width = g_gui_canvas.disp_w;
+    *height = g_gui_canvas.disp_h;
+}
+
+uint32_t gk_gui_canvas_bytes(int32_t w, int32_t h)
+{
+    if (w <= 0 || h <= 0) {
+        return 0;
+    }
+    return GUI_CANVAS_ALIGN(lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_RGB565) * (uint32_t)h);
+}
+
+int gk_gui_canvas_reserve(uint32_t bytes)
+{
+    if (bytes <= g_gui_canvas.stats.capacity) {
+        return OPRT_OK;
+    }
+    if (g_gui_canvas.stats.used) {
+        TAL_PR_ERR(TAG, "区域使用中，不能扩大到%u字节", (unsigned int)bytes);
+        return OPRT_COM_ERROR;
+    }
+
+    // 先释放再分配，避免新旧两块同时存在
+    if (g_gui_canvas.raw) {
+        gui_canvas_free(g_gui_canvas.raw);
+        g_gui_canvas.raw = NULL;
+        g_gui_canvas.base = NULL;
+        g_gui_canvas.stats.capacity = 0;
+    }
+
+    g_gui_canvas.raw = gui_canvas_malloc(bytes + LV_DRAW_BUF_ALIGN - 1);
+    if (!g_gui_canvas.raw) {
+        g_gui_canvas.stats.failures++;
+        TAL_PR_ERR(TAG, "画布缓冲区分配失败: %u字节", (unsigned int)bytes);
+        return OPRT_MALLOC_FAILED;
+    }
+    g_gui_canvas.base = (uint8_t*)GUI_CANVAS_ALIGN((uintptr_t)g_gui_canvas.raw);
+    g_gui_canvas.stats.capacity = bytes;
+    g_gui_canvas.stats.allocs++;
+    TAL_PR_INFO(TAG, "画布缓冲区 %u字节", (unsigned int)bytes);
+    return OPRT_OK;
+}
+
+void* gk_gui_canvas_alloc(uint32_t bytes)
+{
+    bytes = GUI_CANVAS_ALIGN(bytes);
+    if (!g_gui_canvas.base || g_gui_canvas.stats.used + bytes > g_gui_canvas.stats.capacity) {
+        g_gui_canvas.stats.failures++;
+        return NULL;
+    }
+
+    void* ptr = g_gui_canvas.base + g_gui_canvas.stats.used;
+    g_gui_canvas.stats.used += bytes;
+    g_gui_canvas.stats.peak = LV_MAX(g_gui_canvas.stats.peak, g_gui_canvas.stats.used);
+    return ptr;
+}
+
+int gk_gui_canvas_attach(lv_obj_t* canvas, int32_t w, int32_t h)
+{
+    void* buf = gk_gui_canvas_alloc(gk_gui_canvas_bytes(w, h));
+    if (!buf) {
+        TAL_PR_ERR(TAG, "画布%dx%d没有可用缓冲区", (int)w, (int)h);
+        return OPRT_MALLOC_FAILED;
+    }
+    lv_canvas_set_buffer(canvas, buf, w, h, LV_COLOR_FORMAT_RGB565);
+    return OPRT_OK;
+}
+
+void gk_gui_canvas_reset(void)
+{
+    g_gui_canvas.stats.used = 0;
+}
+
+void gk_gui_canvas_trim(void)
+{
+    if (g_gui_canvas.stats.used || !g_gui_canvas.raw) {
+        return;
+    }
+    gui_canvas_free(g_gui_canvas.raw);
+    g_gui_canvas.raw = NULL;
+    g_gui_canvas.base = NULL;
+    g_gui_canvas.stats.capacity = 0;
+    TAL_PR_INFO(TAG, "释放画布缓冲区");
+}
+
+void gk_gui_canvas_get_stats(gk_gui_canvas_stats_t* stats)
+{
+    *stats = g_gui_canvas.stats;
+}
@@ -0,0 +1,50 @@
+#ifndef __GK_GUI_CANVAS_H__
+#define __GK_GUI_CANVAS_H__
+
+#include "gk_bag.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 画布缓冲区管理: 所有页面共用一块按需分配的区域 (开启ENABLE_EXT_RAM时在PSRAM中)
+// 只有当前显示的页面持有画布缓冲区。切换页面时先由隐藏的页面删除画布并gk_gui_canvas_reset，
+// 再由显示的页面gk_gui_canvas_reserve自己需要的总字节数并逐个gk_gui_canvas_attach，
+// 最后gk_gui_canvas_trim: 新页面没有画布时释放整块区域，否则留给下一个页面复用。
+// 以下函数都只能在LVGL线程或持有lv_vendor_disp_lock时调用。
+
+typedef struct {
+    uint32_t capacity;          // 当前区域大小 (字节)，0为未分配
+    uint32_t used;              // 当前页面已占用的字节数
+    uint32_t peak;              // 历史最大占用
+    uint32_t allocs;            // 区域分配次数 (首次分配或需要扩大)
+    uint32_t failures;          // 分配失败次数
+} gk_gui_canvas_stats_t;
+
+// 读取显示屏分辨率 (已按旋转方向换算)，不分配内存
+int gk_gui_canvas_init(void);
+void gk_gui_canvas_get_display(int32_t* width, int32_t* height);
+
+// w*h的RGB565画布缓冲区字节数 (含行跨度和对齐)
+uint32_t gk_gui_canvas_bytes(int32_t w, int32_t h);
+
+// 保证区域至少有bytes字节可用，必须在gk_gui_canvas_reset之后、本页面第一次分配之前调用
+int gk_gui_canvas_reserve(uint32_t bytes);
+// 从区域中取出bytes字节，空间不足时返回NULL
+void* gk_gui_canvas_alloc(uint32_t bytes);
+// 为canvas分配w*h的RGB565缓冲区并设置给它，空间不足时返回OPRT_MALLOC_FAILED
+int gk_gui_canvas_attach(lv_obj_t* canvas, int32_t w, int32_t h);
+
+// 页面隐藏、其画布已删除后调用，归还本页面占用的全部空间
+void gk_gui_canvas_reset(void);
+// 没有页面占用时释放整块区域
+void gk_gui_canvas_trim(void);
+
+void gk_gui_canvas_get_stats(gk_gui_canvas_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_GUI_CANVAS_H__ */
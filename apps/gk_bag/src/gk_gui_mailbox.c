@@ -0,0 +1,150 @@
+#include "gk_gui_mailbox.h"
+#include "tal_log.h"
+#include "tal_mutex.h"
+#include "lvgl.h"
+
+#define TAG "GUI_MAILBOX"
+
+// 取出周期与显示刷新周期相同。LVGL新建的定时器插在链表头部，
+// 所以取出定时器在同一次lv_task_handler中先于刷新定时器执行，应用的更新在本帧即可显示
+#define GUI_MAILBOX_PERIOD_MS       LV_DEF_REFR_PERIOD
+
+#define GUI_MAILBOX_PAGE            (1u << 0)
+#define GUI_MAILBOX_STATS           (1u << 1)
+#define GUI_MAILBOX_HIT             (1u << 2)
+
+static struct {
+    MUTEX_HANDLE mutex;         // 只保护下面的槽位，持有时间为一次结构体拷贝，不会阻塞在LVGL绘制上
+    lv_timer_t* timer;
+    uint32_t dirty;             // GUI_MAILBOX_*，取出后清零
+    gk_page_t page;
+    gk_combat_stats_t stats;
+    gk_hit_point_t hit;         // 最新一次打击，用于标记和统计标签
+    gk_hit_point_t heat[GK_GUI_MAILBOX_HEAT_MAX];   // 本周期内的打击，按投递顺序循环写入
+    uint32_t heat_total;        // 本周期内投递的打击数
+    gk_gui_mailbox_stats_t counters;
+} g_mailbox = {0};
+
+// LVGL线程: 取出所有有更新的槽位并应用，按页面、战力图、打击的顺序
+static void gui_mailbox_timer_cb(lv_timer_t* timer)
+{
+    static gk_hit_point_t heat[GK_GUI_MAILBOX_HEAT_MAX];
+    gk_combat_stats_t stats;
+    gk_hit_point_t hit;
+    gk_page_t page;
+    uint32_t heat_count = 0;
+    uint32_t dirty;
+
+    (void)timer;
+
+    tal_mutex_lock(g_mailbox.mutex);
+    dirty = g_mailbox.dirty;
+    if (dirty) {
+        page = g_mailbox.page;
+        stats = g_mailbox.stats;
+        hit = g_mailbox.hit;
+        if (dirty & GUI_MAILBOX_HIT) {
+            heat_count = LV_MIN(g_mailbox.heat_total, GK_GUI_MAILBOX_HEAT_MAX);
+            memcpy(heat, g_mailbox.heat, heat_count * sizeof(gk_hit_point_t));
+            g_mailbox.counters.hits_coalesced += g_mailbox.heat_total - 1;
+            g_mailbox.heat_total = 0;
+        }
+        g_mailbox.dirty = 0;
+        g_mailbox.counters.applied++;
+    }
+    tal_mutex_unlock(g_mailbox.mutex);
+
+    if (!dirty) {
+        return;
+    }
+
+    if (dirty & GUI_MAILBOX_PAGE) {
+        gk_gui_apply_page(page);
+    }
+    if (dirty & GUI_MAILBOX_STATS) {
+        gk_gui_apply_combat_stats(&stats);
+    }
+    if (dirty & GUI_MAILBOX_HIT) {
+        gk_gui_apply_hit_visual(&hit, heat, heat_count);
+    }
+}
+
+int gk_gui_mailbox_init(void)
+{
+    if (g_mailbox.timer) {
+        return OPRT_OK;
+    }
+
+    if (tal_mutex_create_init(&g_mailbox.mutex) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "邮箱互斥锁创建失败");
+        return OPRT_COM_ERROR;
+    }
+
+    g_mailbox.timer = lv_timer_create(gui_mailbox_timer_cb, GUI_MAILBOX_PERIOD_MS, NULL);
+    if (!g_mailbox.timer) {
+        TAL_PR_ERR(TAG, "邮箱定时器创建失败");
+        tal_mutex_release(g_mailbox.mutex);
+        g_mailbox.mutex = NULL;
+        return OPRT_MALLOC_FAILED;
+    }
+
+    return OPRT_OK;
+}
+
+void gk_gui_mailbox_get_stats(gk_gui_mailbox_stats_t* stats)
+{
+    if (!stats || !g_mailbox.mutex) {
+        return;
+    }
+
+    tal_mutex_lock(g_mailbox.mutex);
+    *stats = g_mailbox.counters;
+    tal_mutex_unlock(g_mailbox.mutex);
+}
+
+void gk_gui_show_page(gk_page_t page)
+{
+    if (page >= GK_PAGE_MAX) {
+        TAL_PR_ERR(TAG, "无效页面: %d", page);
+        return;
+    }
+    if (!g_mailbox.mutex) {
+        return; // GUI尚未初始化
+    }
+
+    tal_mutex_lock(g_mailbox.mutex);
+    g_mailbox.page = page;
+    g_mailbox.dirty |= GUI_MAILBOX_PAGE;
+    g_mailbox.counters.posted++;
+    tal_mutex_unlock(g_mailbox.mutex);
+}
+
+void gk_gui_update_combat_stats(gk_combat_stats_t* stats)
+{
+    if (!stats || !g_mailbox.mutex) {
+        return;
+    }
+
+    tal_mutex_lock(g_mailbox.mutex);
+    g_mailbox.stats = *stats;
+    g_mailbox.dirty |= GUI_MAILBOX_STATS;
+    g_mailbox.counters.posted++;
+    tal_mutex_unlock(g_mailbox.mutex);
+}
+
+void gk_gui_update_hit_visual(gk_hit_point_t* hit_point)
+{
+    if (!hit_point || !g_mailbox.mutex) {
+        return;
+    }
+
+    tal_mutex_lock(g_mailbox.mutex);
+    g_mailbox.hit = *hit_point;
+    g_mailbox.heat[g_mailbox.heat_total % GK_GUI_MAILBOX_HEAT_MAX] = *hit_point;
+    if (++g_mailbox.heat_total > GK_GUI_MAILBOX_HEAT_MAX) {
+        g_mailbox.counters.heat_dropped++;
+    }
+    g_mailbox.dirty |= GUI_MAILBOX_HIT;
+    g_mailbox.counters.posted++;
+    tal_mutex_unlock(g_mailbox.mutex);
+}
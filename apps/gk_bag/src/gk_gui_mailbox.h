@@ -0,0 +1,33 @@
+#ifndef __GK_GUI_MAILBOX_H__
+#define __GK_GUI_MAILBOX_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// GUI更新邮箱: 非GUI线程通过gk_gui_show_page / gk_gui_update_hit_visual / gk_gui_update_combat_stats
+// 只投递状态，不调用任何LVGL接口。LVGL线程每个刷新周期取出一次，由gk_gui_apply_*统一应用。
+// 每个槽位只保留最新值，一个刷新周期内的多次打击合并为一次重绘。
+
+// 一个刷新周期内保留多少次打击用于热力图累加，超出时丢弃最旧的
+#define GK_GUI_MAILBOX_HEAT_MAX     16
+
+typedef struct {
+    uint32_t posted;            // 投递次数 (所有槽位)
+    uint32_t applied;           // 实际应用次数，即取出时至少有一个槽位有更新的刷新周期数
+    uint32_t hits_coalesced;    // 被同一周期内更新的打击覆盖、没有单独绘制标记的打击数
+    uint32_t heat_dropped;      // 超出GK_GUI_MAILBOX_HEAT_MAX未计入热力图的打击数
+} gk_gui_mailbox_stats_t;
+
+// 创建邮箱和取出定时器，必须在LVGL线程或持有lv_vendor_disp_lock时调用
+int gk_gui_mailbox_init(void);
+
+void gk_gui_mailbox_get_stats(gk_gui_mailbox_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_GUI_MAILBOX_H__ */
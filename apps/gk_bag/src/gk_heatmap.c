@@ -0,0 +1,105 @@
+#include "gk_heatmap.h"
+#include "math.h"
+
+// 网格左上角在显示坐标系中的位置 (厘米)
+#define HEATMAP_X_MIN           (-(GK_HEATMAP_COLS * GK_HEATMAP_CELL_CM) / 2.0f)
+#define HEATMAP_Y_MAX           ((GK_HEATMAP_ROWS * GK_HEATMAP_CELL_CM) / 2.0f)
+
+// 存放值的放大倍数超过2^16时整体缩放，保证float精度和不溢出
+#define HEATMAP_REBASE_HALF_LIVES 16
+
+void gk_heatmap_init(gk_heatmap_t* hm, uint32_t half_life_ms)
+{
+    memset(hm, 0, sizeof(gk_heatmap_t));
+    hm->half_life_ms = half_life_ms ? half_life_ms : UINT32_MAX; // 0表示不衰减
+}
+
+void gk_heatmap_clear(gk_heatmap_t* hm)
+{
+    memset(hm->cell, 0, sizeof(hm->cell));
+    hm->hits = 0;
+}
+
+static float heatmap_half_lives(const gk_heatmap_t* hm, uint32_t now_ms)
+{
+    return (float)(uint32_t)(now_ms - hm->base_ms) / (float)hm->half_life_ms;
+}
+
+// 把所有格子换算到now_ms时刻的真实值，并以now_ms为新基准
+static void heatmap_rebase(gk_heatmap_t* hm, uint32_t now_ms)
+{
+    float decay = exp2f(-heatmap_half_lives(hm, now_ms));
+    float* cell = &hm->cell[0][0];
+
+    for (int i = 0; i < GK_HEATMAP_ROWS * GK_HEATMAP_COLS; i++) {
+        cell[i] *= decay;
+    }
+    hm->base_ms = now_ms;
+}
+
+void gk_heatmap_add(gk_heatmap_t* hm, float x_cm, float y_cm, float weight, uint32_t now_ms,
+                    gk_heatmap_rect_t* changed)
+{
+    float age = heatmap_half_lives(hm, now_ms);
+    if (age >= HEATMAP_REBASE_HALF_LIVES) {
+        heatmap_rebase(hm, now_ms);
+        age = 0.0f;
+    }
+    float w = weight * exp2f(age);
+
+    // 格子中心坐标系下的连续位置，超出网格的打击计入边缘格子
+    float fx = (x_cm - HEATMAP_X_MIN) / GK_HEATMAP_CELL_CM - 0.5f;
+    float fy = (HEATMAP_Y_MAX - y_cm) / GK_HEATMAP_CELL_CM - 0.5f;
+    fx = fmaxf(0.0f, fminf(fx, GK_HEATMAP_COLS - 1));
+    fy = fmaxf(0.0f, fminf(fy, GK_HEATMAP_ROWS - 1));
+
+    int x0 = (int)fx;
+    int y0 = (int)fy;
+    if (x0 > GK_HEATMAP_COLS - 2) {
+        x0 = GK_HEATMAP_COLS - 2;
+    }
+    if (y0 > GK_HEATMAP_ROWS - 2) {
+        y0 = GK_HEATMAP_ROWS - 2;
+    }
+    float tx = fx - x0;
+    float ty = fy - y0;
+
+    hm->cell[y0][x0] += w * (1.0f - tx) * (1.0f - ty);
+    hm->cell[y0][x0 + 1] += w * tx * (1.0f - ty);
+    hm->cell[y0 + 1][x0] += w * (1.0f - tx) * ty;
+    hm->cell[y0 + 1][x0 + 1] += w * tx * ty;
+    hm->hits++;
+
+    if (changed) {
+        changed->col0 = x0;
+        changed->row0 = y0;
+        changed->col1 = x0 + 1;
+        changed->row1 = y0 + 1;
+    }
+}
+
+uint8_t gk_heatmap_render(const gk_heatmap_t* hm, uint32_t now_ms, const gk_heatmap_rect_t* area, uint8_t* out,
+                          uint32_t stride)
+{
+    static const gk_heatmap_rect_t full = {0, 0, GK_HEATMAP_COLS - 1, GK_HEATMAP_ROWS - 1};
+    float gain = exp2f(-heatmap_half_lives(hm, now_ms)) * (255.0f / GK_HEATMAP_SATURATION);
+    uint8_t max_level = 0;
+
+    if (!area) {
+        area = &full;
+    }
+
+    for (int y = area->row0; y <= area->row1; y++) {
+        uint8_t* row = out + y * stride;
+        for (int x = area->col0; x <= area->col1; x++) {
+            float v = hm->cell[y][x] * gain;
+            uint8_t level = (v >= 255.0f) ? 255 : (uint8_t)v;
+            row[x] = level;
+            if (level > max_level) {
+                max_level = level;
+            }
+        }
+    }
+
+    return max_level;
+}
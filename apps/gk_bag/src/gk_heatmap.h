@@ -0,0 +1,55 @@
+#ifndef __GK_HEATMAP_H__
+#define __GK_HEATMAP_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 打击热力图: 固定大小的空间累加网格，按指数衰减淡化旧打击
+// 网格覆盖显示坐标系 x∈[-16,16) cm, y∈[-20,20) cm，每格1cm，行0对应最上方 (y最大)
+#define GK_HEATMAP_COLS         32
+#define GK_HEATMAP_ROWS         40
+#define GK_HEATMAP_CELL_CM      1.0f
+
+// 一个格子累计多少次打击 (衰减后) 时显示为最高强度
+#define GK_HEATMAP_SATURATION   4.0f
+
+/*
+ * 惰性衰减: 格子中存放的是以base_ms时刻为基准的值，真实值 = 存放值 × 2^(-(now-base)/half_life)。
+ * 新打击按 2^((now-base)/half_life) 放大后累加，所以每次打击只修改2x2个格子，
+ * 只有放大倍数过大时才整体缩放一次并移动基准时刻。
+ */
+typedef struct {
+    float cell[GK_HEATMAP_ROWS][GK_HEATMAP_COLS];
+    uint32_t base_ms;
+    uint32_t half_life_ms;
+    uint32_t hits;              // 累计打击次数 (不衰减)
+} gk_heatmap_t;
+
+void gk_heatmap_init(gk_heatmap_t* hm, uint32_t half_life_ms);
+void gk_heatmap_clear(gk_heatmap_t* hm);
+
+// 网格中的矩形区域 (格子序号，包含两端)
+typedef struct {
+    int16_t col0, row0;
+    int16_t col1, row1;
+} gk_heatmap_rect_t;
+
+// 累加一次打击 (x/y为厘米，与gk_hit_point_t一致)，按双线性权重分到相邻的2x2个格子
+// changed非NULL时返回被修改的格子区域
+void gk_heatmap_add(gk_heatmap_t* hm, float x_cm, float y_cm, float weight, uint32_t now_ms,
+                    gk_heatmap_rect_t* changed);
+
+// 输出now_ms时刻area内格子的强度 (0-255)，area为NULL时输出整个网格
+// out为整个网格的缓冲区，按行存放，行跨度为stride字节
+// 返回区域内的最大强度，为0表示该区域已完全消退
+uint8_t gk_heatmap_render(const gk_heatmap_t* hm, uint32_t now_ms, const gk_heatmap_rect_t* area, uint8_t* out,
+                          uint32_t stride);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_HEATMAP_H__ */
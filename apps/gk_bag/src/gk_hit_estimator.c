@@ -0,0 +1,168 @@
+#include "gk_hit_estimator.h"
+#include "math.h"
+
+// 几何参数 (与gk_calculate_hit_point一致)
+#define HIT_EST_SENSOR_OFFSET_X 0.20f   // Mx补偿 (m)
+#define HIT_EST_SENSOR_OFFSET_Y 0.15f   // My补偿 (m)
+#define HIT_EST_BAG_RADIUS      0.10f   // 沙袋半径 (m)
+
+// ΣF·Fᵀ对角元素之和的下限 (N²)，低于此值认为没有有效受力
+#define HIT_EST_MIN_FORCE_SQ    1e-3f
+#define HIT_EST_POWER_ITERS     4
+
+enum { S_XX = 0, S_YY, S_ZZ, S_XY, S_XZ, S_YZ };
+
+void gk_hit_estimator_reset(gk_hit_estimator_t* est)
+{
+    memset(est, 0, sizeof(gk_hit_estimator_t));
+}
+
+void gk_hit_estimator_add(gk_hit_estimator_t* est, const gk_force_data_t* frame)
+{
+    float fx = frame->fx, fy = frame->fy, fz = frame->fz;
+    float tx = frame->mx + fy * HIT_EST_SENSOR_OFFSET_X;
+    float ty = frame->my + fx * HIT_EST_SENSOR_OFFSET_Y;
+    float tz = frame->mz;
+
+    est->sum_f[0] += fx;
+    est->sum_f[1] += fy;
+    est->sum_f[2] += fz;
+
+    est->s[S_XX] += fx * fx;
+    est->s[S_YY] += fy * fy;
+    est->s[S_ZZ] += fz * fz;
+    est->s[S_XY] += fx * fy;
+    est->s[S_XZ] += fx * fz;
+    est->s[S_YZ] += fy * fz;
+
+    est->v[0] += fy * tz - fz * ty;
+    est->v[1] += fz * tx - fx * tz;
+    est->v[2] += fx * ty - fy * tx;
+
+    est->tau_sq += tx * tx + ty * ty + tz * tz;
+    est->frames++;
+}
+
+static void hit_est_sym_mul(const float m[6], const float x[3], float out[3])
+{
+    out[0] = m[S_XX] * x[0] + m[S_XY] * x[1] + m[S_XZ] * x[2];
+    out[1] = m[S_XY] * x[0] + m[S_YY] * x[1] + m[S_YZ] * x[2];
+    out[2] = m[S_XZ] * x[0] + m[S_YZ] * x[1] + m[S_ZZ] * x[2];
+}
+
+static bool hit_est_normalize(float x[3])
+{
+    float n = sqrtf(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+    if (n < 1e-12f) {
+        return false;
+    }
+    x[0] /= n;
+    x[1] /= n;
+    x[2] /= n;
+    return true;
+}
+
+// 对称正定3x3系统 (伴随矩阵法)
+static bool hit_est_solve3(const float a[6], const float b[3], float x[3], float scale)
+{
+    float c00 = a[S_YY] * a[S_ZZ] - a[S_YZ] * a[S_YZ];
+    float c01 = a[S_XZ] * a[S_YZ] - a[S_XY] * a[S_ZZ];
+    float c02 = a[S_XY] * a[S_YZ] - a[S_XZ] * a[S_YY];
+    float c11 = a[S_XX] * a[S_ZZ] - a[S_XZ] * a[S_XZ];
+    float c12 = a[S_XY] * a[S_XZ] - a[S_XX] * a[S_YZ];
+    float c22 = a[S_XX] * a[S_YY] - a[S_XY] * a[S_XY];
+    float det = a[S_XX] * c00 + a[S_XY] * c01 + a[S_XZ] * c02;
+
+    // 正则化后的特征值都接近scale，行列式过小说明数据退化
+    if (det < 1e-6f * scale * scale * scale) {
+        return false;
+    }
+
+    x[0] = (c00 * b[0] + c01 * b[1] + c02 * b[2]) / det;
+    x[1] = (c01 * b[0] + c11 * b[1] + c12 * b[2]) / det;
+    x[2] = (c02 * b[0] + c12 * b[1] + c22 * b[2]) / det;
+    return true;
+}
+
+int gk_hit_estimator_solve(const gk_hit_estimator_t* est, gk_hit_point_t* hit)
+{
+    if (!est || !hit) {
+        return OPRT_INVALID_PARM;
+    }
+
+    const float* s = est->s;
+    float tr = s[S_XX] + s[S_YY] + s[S_ZZ];
+    if (est->frames == 0 || tr < HIT_EST_MIN_FORCE_SQ) {
+        return OPRT_COM_ERROR;
+    }
+
+    // 力作用线方向d: ΣF·Fᵀ的主特征向量 (以ΣF为初值做幂迭代)，指向与ΣF一致
+    float d[3] = {est->sum_f[0], est->sum_f[1], est->sum_f[2]};
+    if (!hit_est_normalize(d)) {
+        d[0] = 0.0f;
+        d[1] = 0.0f;
+        d[2] = 1.0f;
+    }
+    for (int i = 0; i < HIT_EST_POWER_ITERS; i++) {
+        float t[3];
+        hit_est_sym_mul(s, d, t);
+        if (!hit_est_normalize(t)) {
+            return OPRT_COM_ERROR;
+        }
+        d[0] = t[0];
+        d[1] = t[1];
+        d[2] = t[2];
+    }
+    if (d[0] * est->sum_f[0] + d[1] * est->sum_f[1] + d[2] * est->sum_f[2] < 0.0f) {
+        d[0] = -d[0];
+        d[1] = -d[1];
+        d[2] = -d[2];
+    }
+
+    // 法矩阵 M = tr·I - ΣF·Fᵀ 沿d方向奇异，加上tr·d·dᵀ后求出作用线上离原点最近的点p0
+    float a[6] = {
+        tr - s[S_XX] + tr * d[0] * d[0], tr - s[S_YY] + tr * d[1] * d[1], tr - s[S_ZZ] + tr * d[2] * d[2],
+        -s[S_XY] + tr * d[0] * d[1],     -s[S_XZ] + tr * d[0] * d[2],     -s[S_YZ] + tr * d[1] * d[2],
+    };
+    float p[3];
+    if (!hit_est_solve3(a, est->v, p, tr)) {
+        return OPRT_COM_ERROR;
+    }
+
+    // 沿作用线 p0 + k·d 与沙袋圆柱面求交，取力进入沙袋的一侧
+    float qa = d[0] * d[0] + d[1] * d[1];
+    if (qa > 1e-6f) {
+        float qb = 2.0f * (p[0] * d[0] + p[1] * d[1]);
+        float qc = p[0] * p[0] + p[1] * p[1] - HIT_EST_BAG_RADIUS * HIT_EST_BAG_RADIUS;
+        float disc = qb * qb - 4.0f * qa * qc;
+        float k;
+        if (disc >= 0.0f) {
+            k = (-qb - sqrtf(disc)) / (2.0f * qa);
+        } else {
+            k = -qb / (2.0f * qa); // 作用线不经过沙袋: 取离轴线最近的点，再径向投影到表面
+        }
+        p[0] += k * d[0];
+        p[1] += k * d[1];
+        p[2] += k * d[2];
+
+        if (disc < 0.0f) {
+            float r = sqrtf(p[0] * p[0] + p[1] * p[1]);
+            p[0] *= HIT_EST_BAG_RADIUS / r;
+            p[1] *= HIT_EST_BAG_RADIUS / r;
+        }
+    }
+    // 力几乎竖直时x/y已由p0确定
+
+    // 残差: Σ|τ - p×F|² = Σ|τ|² - 2p·v + pᵀMp，折算为RMS力臂误差
+    float sp[3];
+    hit_est_sym_mul(s, p, sp);
+    float p_sq = p[0] * p[0] + p[1] * p[1] + p[2] * p[2];
+    float ptmp = tr * p_sq - (p[0] * sp[0] + p[1] * sp[1] + p[2] * sp[2]);
+    float cost = est->tau_sq - 2.0f * (p[0] * est->v[0] + p[1] * est->v[1] + p[2] * est->v[2]) + ptmp;
+
+    // 转换为左手坐标系 (交换x,y用于显示)，单位厘米
+    hit->x = p[1] * 100.0f;
+    hit->y = p[0] * 100.0f;
+    hit->residual = sqrtf(fmaxf(cost, 0.0f) / tr) * 100.0f;
+    return OPRT_OK;
+}
@@ -0,0 +1,41 @@
+#ifndef __GK_HIT_ESTIMATOR_H__
+#define __GK_HIT_ESTIMATOR_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 多帧最小二乘打击点估计
+ *
+ * 一次打击中接触点p不变，每帧满足 τ = p × F (τ已做传感器安装偏移补偿)，
+ * 即 τ = -[F]× p。对所有帧求最小二乘，法方程为:
+ *   Σ(|F|²I - F·Fᵀ) p = Σ F × τ
+ * 每帧只累加ΣF·Fᵀ、ΣF×τ、Σ|τ|²等10余个标量，释放时求解一次3x3系统。
+ * 力方向基本不变时沿力作用线方向不可观测，该分量由沙袋圆柱面约束确定。
+ */
+typedef struct {
+    uint32_t frames;
+    float sum_f[3];            // ΣF，用于确定力作用线的指向
+    float s[6];                // ΣF·Fᵀ: xx yy zz xy xz yz
+    float v[3];                // ΣF × τ
+    float tau_sq;              // Σ|τ|²，用于计算残差
+} gk_hit_estimator_t;
+
+void gk_hit_estimator_reset(gk_hit_estimator_t* est);
+
+// 累加一帧滤波后的数据
+void gk_hit_estimator_add(gk_hit_estimator_t* est, const gk_force_data_t* frame);
+
+// 求解打击点，填充hit的x、y (厘米，显示坐标系) 和residual
+// residual为所有帧力矩拟合误差的RMS折算成的力臂误差 (厘米)，越小越可信
+// 没有有效数据时返回OPRT_COM_ERROR
+int gk_hit_estimator_solve(const gk_hit_estimator_t* est, gk_hit_point_t* hit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_HIT_ESTIMATOR_H__ */
@@ -0,0 +1,112 @@
+#include "gk_punch_classifier.h"
+#include "math.h"
+
+// 与gk_calculate_hit_point一致的几何参数
+#define PUNCH_BAG_RADIUS        0.10f   // 沙袋半径 (m)
+#define PUNCH_TILT_ARM          0.20f   // 俯仰力矩的归一化力臂 (m)
+#define PUNCH_MIN_CONTACT_CM    1.0f    // 打击点离轴线太近时方位不可靠，改用冲量的水平方向作为径向
+
+void gk_punch_features_extract(const gk_punch_event_t* event, const float impulse_ft[6], gk_punch_features_t* feat)
+{
+    const float eps = 1e-6f;
+    const float* J = impulse_ft;
+    const float* L = impulse_ft + 3;
+
+    memset(feat, 0, sizeof(gk_punch_features_t));
+
+    float j_norm = sqrtf(J[0] * J[0] + J[1] * J[1] + J[2] * J[2]);
+    if (j_norm < eps) {
+        return;
+    }
+    float inv = 1.0f / j_norm;
+
+    // 径向单位向量 (传感器坐标系，指向沙袋外侧)。打击点为显示坐标系，x/y交换
+    float rx = event->hit.y;
+    float ry = event->hit.x;
+    float r_norm = sqrtf(rx * rx + ry * ry);
+    if (r_norm < PUNCH_MIN_CONTACT_CM) {
+        rx = -J[0];
+        ry = -J[1];
+        r_norm = sqrtf(rx * rx + ry * ry);
+    }
+    if (r_norm > eps) {
+        rx /= r_norm;
+        ry /= r_norm;
+        feat->v[0] = -(J[0] * rx + J[1] * ry) * inv;
+        feat->v[1] = fabsf(J[0] * ry - J[1] * rx) * inv;
+    }
+    feat->v[2] = J[2] * inv;
+    feat->v[3] = fabsf(L[2]) * inv / PUNCH_BAG_RADIUS;
+    feat->v[4] = sqrtf(L[0] * L[0] + L[1] * L[1]) * inv / PUNCH_TILT_ARM;
+
+    if (event->duration_ms > 0.0f) {
+        feat->v[5] = event->rise_time_ms / event->duration_ms;
+    }
+    feat->v[6] = event->duration_ms / 30.0f;
+    if (event->impulse > eps) {
+        feat->v[7] = event->peak_force * event->duration_ms * 0.001f / event->impulse;
+    }
+    feat->v[8] = event->peak_force / 100.0f;
+}
+
+void gk_punch_features_quantize(const gk_punch_model_t* model, const gk_punch_features_t* feat,
+                                int8_t q[GK_PUNCH_FEATURES])
+{
+    for (int i = 0; i < GK_PUNCH_FEATURES; i++) {
+        float v = (feat->v[i] - model->feat_offset[i]) * model->feat_scale[i];
+        v = fmaxf(-127.0f, fminf(127.0f, v));
+        q[i] = (int8_t)lrintf(v);
+    }
+}
+
+// int8点积，累加到int32
+static int32_t punch_dot_i8(const int8_t* a, const int8_t* b, int n)
+{
+    int32_t acc = 0;
+    for (int i = 0; i < n; i++) {
+        acc += (int32_t)a[i] * (int32_t)b[i];
+    }
+    return acc;
+}
+
+gk_punch_type_t gk_punch_classify_model(const gk_punch_model_t* model, const gk_punch_features_t* feat,
+                                        int32_t logits[GK_PUNCH_CLASSES])
+{
+    int8_t x[GK_PUNCH_FEATURES];
+    int8_t h[GK_PUNCH_HIDDEN];
+
+    gk_punch_features_quantize(model, feat, x);
+
+    // 隐藏层: 累加 -> ReLU -> 定点乘数重新量化到int8 (四舍五入)
+    int64_t half = (int64_t)1 << (model->shift1 - 1);
+    for (int j = 0; j < GK_PUNCH_HIDDEN; j++) {
+        int32_t acc = model->b1[j] + punch_dot_i8(model->w1[j], x, GK_PUNCH_FEATURES);
+        if (acc <= 0) {
+            h[j] = 0;
+            continue;
+        }
+        int64_t v = ((int64_t)acc * model->mult1 + half) >> model->shift1;
+        h[j] = (int8_t)((v > 127) ? 127 : v);
+    }
+
+    // 输出层只需比较大小，不再重新量化
+    int best = 0;
+    int32_t best_logit = INT32_MIN;
+    for (int k = 0; k < GK_PUNCH_CLASSES; k++) {
+        int32_t logit = model->b2[k] + punch_dot_i8(model->w2[k], h, GK_PUNCH_HIDDEN);
+        if (logits) {
+            logits[k] = logit;
+        }
+        if (logit > best_logit) {
+            best_logit = logit;
+            best = k;
+        }
+    }
+    return (gk_punch_type_t)(GK_PUNCH_JAB + best);
+}
+
+const char* gk_punch_type_name(gk_punch_type_t type)
+{
+    static const char* names[GK_PUNCH_TYPE_MAX] = {"unknown", "jab", "cross", "hook", "uppercut"};
+    return (type < GK_PUNCH_TYPE_MAX) ? names[type] : names[GK_PUNCH_UNKNOWN];
+}
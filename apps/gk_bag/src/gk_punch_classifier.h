@@ -0,0 +1,78 @@
+#ifndef __GK_PUNCH_CLASSIFIER_H__
+#define __GK_PUNCH_CLASSIFIER_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(ENABLE_PUNCH_CLASSIFIER) && (ENABLE_PUNCH_CLASSIFIER == 1)
+#define GK_PUNCH_CLASSIFIER_ENABLE  1
+#else
+#define GK_PUNCH_CLASSIFIER_ENABLE  0
+#endif
+
+/*
+ * 拳法分类: 每次打击提取一组与打击方位无关的特征，由int8量化的两层感知机分类
+ *
+ * 特征 (gk_punch_features_t.v):
+ *   0 radial      冲量沿接触点径向 (指向沙袋中心) 的方向余弦
+ *   1 tangential  冲量沿沙袋切向的方向余弦 (绝对值)
+ *   2 vertical    冲量的竖直方向余弦，向上为正
+ *   3 yaw         |∫Mz| / (|∫F| · 沙袋半径)，切向打击产生的扭转
+ *   4 tilt        |∫Mxy| / (|∫F| · 0.2m)，竖直分量和打击高度产生的俯仰
+ *   5 rise        上升时间 / 持续时间
+ *   6 duration    持续时间 / 30ms
+ *   7 sharpness   峰值力 · 持续时间 / 冲量，半正弦脉冲为π/2
+ *   8 force       峰值力 / 100N
+ *
+ * 网络: 特征按模型中的偏移和比例量化为int8 -> 全连接(GK_PUNCH_HIDDEN) + ReLU -> 全连接(4)，
+ * 取最大的输出。隐藏层的int32累加结果以定点乘数和移位重新量化为int8，网络部分没有浮点运算，
+ * 一次分类约200次乘加。模型参数由主机端训练程序生成 (bench/src/gk_punch_train.c -> gk_punch_model.c)。
+ */
+#define GK_PUNCH_FEATURES       9
+#define GK_PUNCH_CLASSIFY_BUDGET_US 1000                    // 每次打击特征提取+分类的耗时预算 (T5AI)
+#define GK_PUNCH_HIDDEN         16
+#define GK_PUNCH_CLASSES        (GK_PUNCH_TYPE_MAX - 1)     // 不含GK_PUNCH_UNKNOWN
+
+typedef struct {
+    float v[GK_PUNCH_FEATURES];
+} gk_punch_features_t;
+
+typedef struct {
+    float feat_offset[GK_PUNCH_FEATURES];           // 量化: q = round((v - offset) * scale)，饱和到±127
+    float feat_scale[GK_PUNCH_FEATURES];
+    int8_t w1[GK_PUNCH_HIDDEN][GK_PUNCH_FEATURES];
+    int32_t b1[GK_PUNCH_HIDDEN];                    // 与累加结果同一量化单位
+    int32_t mult1;                                  // 隐藏层重新量化: h = (acc * mult1) >> shift1
+    int32_t shift1;
+    int8_t w2[GK_PUNCH_CLASSES][GK_PUNCH_HIDDEN];
+    int32_t b2[GK_PUNCH_CLASSES];
+} gk_punch_model_t;
+
+// 随固件发布的模型 (gk_punch_model.c)
+extern const gk_punch_model_t gk_punch_model;
+
+// event为分段器输出的打击事件 (hit含打击点)，impulse_ft为打击期间各通道的积分
+void gk_punch_features_extract(const gk_punch_event_t* event, const float impulse_ft[6], gk_punch_features_t* feat);
+
+void gk_punch_features_quantize(const gk_punch_model_t* model, const gk_punch_features_t* feat,
+                                int8_t q[GK_PUNCH_FEATURES]);
+
+// 返回拳法类型，logits可为NULL
+gk_punch_type_t gk_punch_classify_model(const gk_punch_model_t* model, const gk_punch_features_t* feat,
+                                        int32_t logits[GK_PUNCH_CLASSES]);
+
+static inline gk_punch_type_t gk_punch_classify(const gk_punch_features_t* feat)
+{
+    return gk_punch_classify_model(&gk_punch_model, feat, NULL);
+}
+
+const char* gk_punch_type_name(gk_punch_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_PUNCH_CLASSIFIER_H__ */
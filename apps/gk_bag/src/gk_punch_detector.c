@@ -0,0 +1,132 @@
+#include "gk_punch_detector.h"
+#include "math.h"
+
+void gk_punch_detector_init(gk_punch_detector_t* det, const gk_punch_detector_cfg_t* cfg)
+{
+    memset(det, 0, sizeof(gk_punch_detector_t));
+    det->cfg = *cfg;
+
+    // 释放阈值必须低于起始阈值，否则迟滞失效
+    if (det->cfg.release_threshold > det->cfg.onset_threshold) {
+        det->cfg.release_threshold = det->cfg.onset_threshold;
+    }
+    if (det->cfg.max_samples == 0) {
+        det->cfg.max_samples = 1;
+    }
+
+    det->state = GK_PUNCH_STATE_IDLE;
+}
+
+void gk_punch_detector_reset(gk_punch_detector_t* det)
+{
+    det->state = GK_PUNCH_STATE_IDLE;
+    det->samples = 0;
+    det->wait_release = false;
+}
+
+static void punch_detector_emit(gk_punch_detector_t* det, gk_punch_event_t* event, gk_force_data_t* event_peak)
+{
+    float dt = det->cfg.sample_period_s;
+
+    memset(event, 0, sizeof(gk_punch_event_t));
+    event->peak_force = det->peak_force;
+    event->impulse = det->impulse;
+    event->rise_time_ms = det->peak_sample * dt * 1000.0f;
+    event->duration_ms = det->samples * dt * 1000.0f;
+    event->sample_count = det->samples;
+    event->timestamp = det->onset_frame.timestamp;
+    event->hit.force = det->peak_force;
+    event->hit.timestamp = det->peak_frame.timestamp;
+
+    // 释放时对整次打击求解一次打击点
+    if (gk_hit_estimator_solve(&det->hit_est, &event->hit) != OPRT_OK) {
+        gk_hit_point_t hit;
+        if (gk_calculate_hit_point(&det->peak_frame, &hit) == OPRT_OK) {
+            event->hit.x = hit.x;
+            event->hit.y = hit.y;
+        }
+    }
+
+    if (event_peak) {
+        *event_peak = det->peak_frame;
+    }
+}
+
+bool gk_punch_detector_feed(gk_punch_detector_t* det, const gk_force_data_t* frame, gk_punch_event_t* event,
+                            gk_force_data_t* event_peak)
+{
+    float f_sq = frame->fx * frame->fx + frame->fy * frame->fy + frame->fz * frame->fz;
+    float onset_sq = det->cfg.onset_threshold * det->cfg.onset_threshold;
+
+    switch (det->state) {
+    case GK_PUNCH_STATE_REFRACTORY:
+        if (++det->samples < det->cfg.refractory_samples) {
+            return false;
+        }
+        det->state = GK_PUNCH_STATE_IDLE;
+        det->samples = 0;
+        // 不应期结束的这一帧按空闲处理
+        // fall through
+
+    case GK_PUNCH_STATE_IDLE:
+        // 强制释放后需先回落到释放阈值以下才重新布防
+        if (det->wait_release) {
+            if (f_sq < det->cfg.release_threshold * det->cfg.release_threshold) {
+                det->wait_release = false;
+            }
+            return false;
+        }
+        // 空闲时只比较平方值，避免每帧开方
+        if (f_sq < onset_sq) {
+            return false;
+        }
+        det->state = GK_PUNCH_STATE_ACTIVE;
+        det->samples = 0;
+        det->peak_sample = 0;
+        det->peak_force = 0.0f;
+        det->impulse = 0.0f;
+        memset(det->impulse_ft, 0, sizeof(det->impulse_ft));
+        det->onset_frame = *frame;
+        gk_hit_estimator_reset(&det->hit_est);
+        // 起始帧计入本次打击
+        // fall through
+
+    case GK_PUNCH_STATE_ACTIVE: {
+        // 释放和峰值同样比较平方值，开方只用于冲量积分
+        if (det->samples > 0 && f_sq < det->cfg.release_threshold * det->cfg.release_threshold) {
+            punch_detector_emit(det, event, event_peak);
+            det->state = GK_PUNCH_STATE_REFRACTORY;
+            det->samples = 0;
+            return true;
+        }
+
+        float force = sqrtf(f_sq);
+        if (force > det->peak_force) {
+            det->peak_force = force;
+            det->peak_sample = det->samples;
+            det->peak_frame = *frame;
+        }
+        det->impulse += force * det->cfg.sample_period_s;
+        const float* ft = &frame->fx;
+        for (int i = 0; i < 6; i++) {
+            det->impulse_ft[i] += ft[i] * det->cfg.sample_period_s;
+        }
+        gk_hit_estimator_add(&det->hit_est, frame);
+        det->samples++;
+
+        // 持续受力(如倚靠沙袋)时强制结束，避免一直停留在打击状态
+        if (det->samples >= det->cfg.max_samples) {
+            punch_detector_emit(det, event, event_peak);
+            det->state = GK_PUNCH_STATE_REFRACTORY;
+            det->samples = 0;
+            det->wait_release = true;
+            return true;
+        }
+        return false;
+    }
+
+    default:
+        gk_punch_detector_reset(det);
+        return false;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef __GK_PUNCH_DETECTOR_H__
+#define __GK_PUNCH_DETECTOR_H__
+
+#include "gk_bag.h"
+#include "gk_hit_estimator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 打击分段状态机: 起始 -> 峰值 -> 释放 -> 不应期
+typedef enum {
+    GK_PUNCH_STATE_IDLE = 0,
+    GK_PUNCH_STATE_ACTIVE,
+    GK_PUNCH_STATE_REFRACTORY,
+} gk_punch_state_t;
+
+typedef struct {
+    float onset_threshold;        // 起始阈值 (N)
+    float release_threshold;      // 释放阈值 (N)，低于起始阈值形成迟滞
+    uint32_t refractory_samples;  // 释放后忽略新起始的样本数
+    uint32_t max_samples;         // 单次打击最长样本数，超出强制释放
+    float sample_period_s;        // 采样周期 (秒)
+} gk_punch_detector_cfg_t;
+
+typedef struct {
+    gk_punch_detector_cfg_t cfg;
+    gk_punch_state_t state;
+    uint32_t samples;             // 当前状态已持续的样本数
+    uint32_t peak_sample;         // 峰值相对起始的样本序号
+    bool wait_release;            // 强制释放后等待力回落
+    float peak_force;
+    float impulse;
+    float impulse_ft[6];          // 各通道对时间的积分 (N·s / N·m·s)，下一次起始前保持不变
+    gk_force_data_t onset_frame;
+    gk_force_data_t peak_frame;
+    gk_hit_estimator_t hit_est;   // 打击期间逐帧累加的打击点法方程
+} gk_punch_detector_t;
+
+void gk_punch_detector_init(gk_punch_detector_t* det, const gk_punch_detector_cfg_t* cfg);
+void gk_punch_detector_reset(gk_punch_detector_t* det);
+
+// 输入一帧滤波后的数据，一次打击结束时返回true并填充event
+// event->hit的位置和残差由打击期间所有帧的最小二乘估计给出，
+// 估计失败时退回到对峰值帧调用gk_calculate_hit_point (residual为0)
+bool gk_punch_detector_feed(gk_punch_detector_t* det, const gk_force_data_t* frame, gk_punch_event_t* event,
+                            gk_force_data_t* event_peak);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_PUNCH_DETECTOR_H__ */
@@ -0,0 +1,43 @@
+#include "gk_punch_classifier.h"
+
+// 由 gk_bag_bench -T 生成，不要手工修改
+// 训练数据: 合成打击8000次 (种子1)，测试集2000次 (种子2)
+// 测试集准确率: 浮点 99.1%, int8 99.1%
+const gk_punch_model_t gk_punch_model = {
+    .feat_offset = {
+        0.77283442f, 0.31237486f, 0.19702812f, 0.31268179f, 0.82068402f,
+        0.44740102f, 0.67502064f, 1.6668599f, 0.91978776f
+    },
+    .feat_scale = {
+        140.84233f, 104.54223f, 90.430176f, 104.56093f, 135.50085f,
+        570.92322f, 179.0592f, 630.13794f, 98.243736f
+    },
+    .w1 = {
+        {-56, -42, 89, -39, -1, 27, 5, -27, 12},
+        {31, -22, -35, -17, -40, 2, -7, -22, 110},
+        {-26, 80, -39, 74, 7, 10, -1, -15, 31},
+        {-28, -20, -3, -32, 8, -39, 29, -3, -2},
+        {5, 0, -13, 11, 7, 37, 8, 18, -9},
+        {29, 2, 4, -3, 2, 0, 127, -27, 8},
+        {15, -41, 10, -17, -9, 12, -16, -8, -120},
+        {2, -40, 32, 5, 26, 10, 19, 38, -58},
+        {47, -3, -28, -16, 9, -9, -9, 9, 27},
+        {7, 25, -65, -19, 35, -26, -4, -3, 94},
+        {-13, -29, 56, 13, -2, 7, 6, -18, 4},
+        {-21, 17, -39, 3, 12, -17, -1, 28, 15},
+        {-26, 29, 35, 23, -10, -28, 10, 14, 4},
+        {58, -36, 5, 13, 0, -7, -4, 0, -103},
+        {38, -23, -41, -9, 8, -21, -13, -5, 41},
+        {-8, -2, -6, -9, 3, 0, 64, -11, -4},
+    },
+    .b1 = {1493, 699, 711, -620, -500, 518, -165, 95, 241, 257, 916, -15, 683, -542, 332, 506},
+    .mult1 = 1090220431,
+    .shift1 = 37,
+    .w2 = {
+        {-63, -48, -27, -29, 40, -124, 83, 46, 38, -51, -33, -18, -53, 99, 14, -77},
+        {-36, 60, -60, 34, -25, 69, -24, -21, 68, 47, -38, 23, -10, 6, 60, 14},
+        {-32, -9, 127, -13, 4, 39, -37, -22, -25, 13, -5, 40, 19, -32, -57, 19},
+        {122, -24, -10, 5, -12, -11, 9, 28, -44, -29, 63, -24, 28, -35, -59, -1},
+    },
+    .b2 = {14, 275, -399, 110},
+};
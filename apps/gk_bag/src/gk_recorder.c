@@ -0,0 +1,761 @@
+#include "gk_recorder.h"
+
+#if GK_RECORDER_ENABLE
+
+#include "tal_log.h"
+#include "tal_system.h"
+#include "tal_thread.h"
+#include "tal_mutex.h"
+#include "tal_memory.h"
+#include "tal_cli.h"
+#include "crc32i.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TAG "GK_RECORDER"
+
+// 采集线程与写入线程之间的记录缓冲深度 (2的幂)
+// 需要覆盖一次flash擦写的延迟: 1kHz下512条约0.5秒
+#ifdef RECORDER_RING_DEPTH
+#define REC_RING_DEPTH          RECORDER_RING_DEPTH
+#else
+#define REC_RING_DEPTH          512
+#endif
+#if (REC_RING_DEPTH & (REC_RING_DEPTH - 1)) != 0
+#error "RECORDER_RING_DEPTH must be a power of two"
+#endif
+
+#define REC_RING_MASK           (REC_RING_DEPTH - 1)
+#define REC_PAYLOAD_MAX         ((uint32_t)(GK_REC_BLOCK_SIZE - sizeof(gk_rec_block_hdr_t)))
+#define REC_MAX_RECORD_BYTES    (GK_REC_CHANNELS * 5)   // 每通道最多5字节varint
+#define REC_SYNC_BLOCKS         8                       // 每写入N个块提交一次元数据
+#define REC_WRITER_BATCH        32
+#define REC_WRITER_IDLE_MS      20
+#define REC_PATH_LEN            32
+#define REC_EXPORT_LINE_BYTES   32
+
+#if (GK_REC_BLOCK_SIZE < 256) || (GK_REC_BLOCK_SIZE > 32768)
+#error "RECORDER_BLOCK_SIZE out of range"
+#endif
+
+#define RING_LOAD_ACQUIRE(p)      __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RING_STORE_RELEASE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+// 录制状态标志: 顺序一致的读写，采集线程与停止路径按"先写自己的标志再读对方的标志"握手
+#define REC_FLAG_LOAD(p)          __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define REC_FLAG_STORE(p, v)      __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+
+static struct {
+    bool initialized;
+    MUTEX_HANDLE mutex;        // 串行化开始/停止/删除等控制操作 (CLI、主任务可能并发调用)
+    THREAD_HANDLE thread;
+    bool active;               // 采集线程是否入队
+    bool pushing;              // 采集线程正在入队，写入线程停止前等待其完成
+    bool stopping;             // 写入线程排空后退出
+    uint32_t next_id;
+    uint32_t session_id;
+    uint16_t sample_rate_hz;
+    lfs_file_t file;
+
+    // 采集线程 -> 写入线程的单生产者/单消费者队列
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;
+
+    // 块编码器状态 (仅写入线程访问)
+    gk_rec_block_hdr_t hdr;
+    int32_t prev[GK_REC_CHANNELS];
+    uint32_t written;
+    uint32_t unsynced_blocks;
+    bool write_failed;
+} g_rec = {0};
+
+static gk_rec_sample_t g_rec_ring_buf[REC_RING_DEPTH];
+static uint8_t g_rec_block[GK_REC_BLOCK_SIZE];
+
+static void rec_session_path(char* path, uint32_t id)
+{
+    snprintf(path, REC_PATH_LEN, GK_REC_DIR "/%05u" GK_REC_SUFFIX, (unsigned int)id);
+}
+
+// 解析会话文件名，非会话文件返回0
+static uint32_t rec_parse_name(const char* name)
+{
+    char* end = NULL;
+    unsigned long id = strtoul(name, &end, 10);
+
+    if (end == name || strcmp(end, GK_REC_SUFFIX) != 0) {
+        return 0;
+    }
+    return (uint32_t)id;
+}
+
+/* ---------------------------- 编解码 ---------------------------- */
+
+static uint32_t rec_zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t rec_unzigzag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static uint32_t rec_put_varint(uint8_t* p, uint32_t v)
+{
+    uint32_t n = 0;
+
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static int rec_get_varint(const uint8_t* p, uint32_t len, uint32_t* pos, uint32_t* v)
+{
+    uint32_t result = 0;
+
+    for (uint32_t shift = 0; shift < 35; shift += 7) {
+        if (*pos >= len) {
+            return OPRT_COM_ERROR;
+        }
+        uint8_t byte = p[(*pos)++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *v = result;
+            return OPRT_OK;
+        }
+    }
+    return OPRT_COM_ERROR;
+}
+
+static int rec_check_block(const gk_rec_block_hdr_t* hdr, const uint8_t* payload)
+{
+    if (hdr->magic != GK_REC_MAGIC || hdr->version != GK_REC_VERSION || hdr->channels != GK_REC_CHANNELS) {
+        return OPRT_COM_ERROR;
+    }
+    if (hdr->payload_len > REC_PAYLOAD_MAX) {
+        return OPRT_COM_ERROR;
+    }
+    if (hash_crc32i_total(payload, hdr->payload_len) != hdr->crc) {
+        return OPRT_COM_ERROR;
+    }
+    return OPRT_OK;
+}
+
+// 从payload的pos处解码一条记录，prev为上一条记录的值 (块首为0)
+static int rec_decode_record(const gk_rec_block_hdr_t* hdr, const uint8_t* payload, uint32_t* pos,
+                             int32_t prev[GK_REC_CHANNELS], uint32_t index, gk_rec_sample_t* sample)
+{
+    for (int ch = 0; ch < GK_REC_CHANNELS; ch++) {
+        uint32_t zz;
+        if (rec_get_varint(payload, hdr->payload_len, pos, &zz) != OPRT_OK) {
+            return OPRT_COM_ERROR;
+        }
+        prev[ch] = (int32_t)((uint32_t)prev[ch] + (uint32_t)rec_unzigzag(zz));
+    }
+
+    sample->seq = hdr->first_seq + index;
+    sample->time_ms = hdr->time_ms + (uint32_t)(((uint64_t)index * 1000) / hdr->sample_rate_hz);
+    memcpy(sample->raw, &prev[0], sizeof(sample->raw));
+    memcpy(sample->filtered, &prev[6], sizeof(sample->filtered));
+    return OPRT_OK;
+}
+
+int gk_rec_decode_block(const uint8_t* block, uint32_t block_len, gk_rec_sample_t* samples, int max_samples)
+{
+    if (!block || !samples || block_len < sizeof(gk_rec_block_hdr_t)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    gk_rec_block_hdr_t hdr;
+    memcpy(&hdr, block, sizeof(hdr));
+    const uint8_t* payload = block + sizeof(hdr);
+    if (sizeof(hdr) + hdr.payload_len > block_len || rec_check_block(&hdr, payload) != OPRT_OK ||
+        hdr.sample_rate_hz == 0) {
+        return OPRT_COM_ERROR;
+    }
+
+    int32_t prev[GK_REC_CHANNELS] = {0};
+    uint32_t pos = 0;
+    int count = 0;
+    for (uint32_t i = 0; i < hdr.count && count < max_samples; i++) {
+        if (rec_decode_record(&hdr, payload, &pos, prev, i, &samples[count]) != OPRT_OK) {
+            return OPRT_COM_ERROR;
+        }
+        count++;
+    }
+    return count;
+}
+
+/* ---------------------------- 写入侧 ---------------------------- */
+
+void gk_recorder_push_q16(uint32_t seq, uint32_t time_ms, const gk_q16_t raw[6], const gk_q16_t filtered[6])
+{
+    // 先声明入队再检查active: 停止路径清除active后，要么这里看到未激活，要么写入线程看到pushing并等待，
+    // 已停止的会话不会在写入线程退出后再入队
+    REC_FLAG_STORE(&g_rec.pushing, true);
+    if (!REC_FLAG_LOAD(&g_rec.active)) {
+        REC_FLAG_STORE(&g_rec.pushing, false);
+        return;
+    }
+
+    uint32_t head = g_rec.head;
+    if (head - RING_LOAD_ACQUIRE(&g_rec.tail) >= REC_RING_DEPTH) {
+        g_rec.dropped++;
+        REC_FLAG_STORE(&g_rec.pushing, false);
+        return;
+    }
+
+    gk_rec_sample_t* s = &g_rec_ring_buf[head & REC_RING_MASK];
+    s->seq = seq;
+    s->time_ms = time_ms;
+    memcpy(s->raw, raw, sizeof(s->raw));
+    memcpy(s->filtered, filtered, sizeof(s->filtered));
+
+    RING_STORE_RELEASE(&g_rec.head, head + 1);
+    REC_FLAG_STORE(&g_rec.pushing, false);
+}
+
+void gk_recorder_push(uint32_t seq, uint32_t time_ms, const float raw[6], const gk_force_data_t* filtered)
+{
+    if (!REC_FLAG_LOAD(&g_rec.active)) {
+        return;
+    }
+
+    gk_q16_t raw_q16[6], filtered_q16[6];
+    const float* f = &filtered->fx;
+    for (int i = 0; i < 6; i++) {
+        raw_q16[i] = GK_FLOAT_TO_Q16(raw[i]);
+        filtered_q16[i] = GK_FLOAT_TO_Q16(f[i]);
+    }
+    gk_recorder_push_q16(seq, time_ms, raw_q16, filtered_q16);
+}
+
+static uint32_t rec_ring_pop(gk_rec_sample_t* out, uint32_t max)
+{
+    uint32_t tail = g_rec.tail;
+    uint32_t count = RING_LOAD_ACQUIRE(&g_rec.head) - tail;
+
+    if (count > max) {
+        count = max;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = g_rec_ring_buf[(tail + i) & REC_RING_MASK];
+    }
+    if (count > 0) {
+        RING_STORE_RELEASE(&g_rec.tail, tail + count);
+    }
+    return count;
+}
+
+// 补齐并写出当前块，整块写入使littlefs每次都编程完整的页
+static int rec_flush_block(void)
+{
+    if (g_rec.hdr.count == 0 || g_rec.write_failed) {
+        g_rec.hdr.count = 0;
+        return OPRT_OK;
+    }
+
+    uint8_t* payload = g_rec_block + sizeof(gk_rec_block_hdr_t);
+    g_rec.hdr.crc = hash_crc32i_total(payload, g_rec.hdr.payload_len);
+    memcpy(g_rec_block, &g_rec.hdr, sizeof(gk_rec_block_hdr_t));
+    memset(payload + g_rec.hdr.payload_len, 0, REC_PAYLOAD_MAX - g_rec.hdr.payload_len);
+
+    tal_lfs_lock();
+    lfs_ssize_t result = lfs_file_write(tal_lfs_get(), &g_rec.file, g_rec_block, GK_REC_BLOCK_SIZE);
+    if (result == GK_REC_BLOCK_SIZE && ++g_rec.unsynced_blocks >= REC_SYNC_BLOCKS) {
+        lfs_file_sync(tal_lfs_get(), &g_rec.file);
+        g_rec.unsynced_blocks = 0;
+    }
+    tal_lfs_unlock();
+
+    g_rec.written += g_rec.hdr.count;
+    g_rec.hdr.count = 0;
+
+    if (result != GK_REC_BLOCK_SIZE) {
+        // 通常是flash空间已满，停止录制，保留已写入的部分
+        TAL_PR_ERR(TAG, "会话%u写入失败 %d，停止录制", (unsigned int)g_rec.session_id, (int)result);
+        g_rec.write_failed = true;
+        REC_FLAG_STORE(&g_rec.active, false);
+        REC_FLAG_STORE(&g_rec.stopping, true);
+        return OPRT_COM_ERROR;
+    }
+    return OPRT_OK;
+}
+
+static void rec_encode(const gk_rec_sample_t* s)
+{
+    gk_rec_block_hdr_t* hdr = &g_rec.hdr;
+
+    // 采样序号不连续或块已满时另起新块
+    if (hdr->count > 0 && (s->seq != hdr->first_seq + hdr->count ||
+                           (uint32_t)hdr->payload_len + REC_MAX_RECORD_BYTES > REC_PAYLOAD_MAX)) {
+        rec_flush_block();
+    }
+
+    if (hdr->count == 0) {
+        hdr->magic = GK_REC_MAGIC;
+        hdr->version = GK_REC_VERSION;
+        hdr->channels = GK_REC_CHANNELS;
+        hdr->sample_rate_hz = g_rec.sample_rate_hz;
+        hdr->first_seq = s->seq;
+        hdr->time_ms = s->time_ms;
+        hdr->payload_len = 0;
+        memset(g_rec.prev, 0, sizeof(g_rec.prev));
+    }
+
+    uint8_t* p = g_rec_block + sizeof(gk_rec_block_hdr_t) + hdr->payload_len;
+    uint32_t len = 0;
+    for (int ch = 0; ch < GK_REC_CHANNELS; ch++) {
+        int32_t v = (ch < 6) ? s->raw[ch] : s->filtered[ch - 6];
+        len += rec_put_varint(p + len, rec_zigzag((int32_t)((uint32_t)v - (uint32_t)g_rec.prev[ch])));
+        g_rec.prev[ch] = v;
+    }
+    hdr->payload_len += len;
+    hdr->count++;
+}
+
+// 低优先级写入线程: 批量取出记录编码到块缓冲区，满一块写一次flash
+static void gk_recorder_task(void* arg)
+{
+    static gk_rec_sample_t batch[REC_WRITER_BATCH];
+
+    (void)arg;
+    while (1) {
+        // 停止后还要等采集线程完成进行中的入队，此后的出队为空时队列已排空
+        bool drained = REC_FLAG_LOAD(&g_rec.stopping) && !REC_FLAG_LOAD(&g_rec.pushing);
+        uint32_t count = rec_ring_pop(batch, REC_WRITER_BATCH);
+        for (uint32_t i = 0; i < count; i++) {
+            rec_encode(&batch[i]);
+        }
+
+        if (count == 0) {
+            if (drained) {
+                break;
+            }
+            tal_system_sleep(REC_FLAG_LOAD(&g_rec.stopping) ? 1 : REC_WRITER_IDLE_MS);
+        }
+    }
+
+    rec_flush_block();
+
+    tal_lfs_lock();
+    lfs_file_close(tal_lfs_get(), &g_rec.file);
+    tal_lfs_unlock();
+
+    TAL_PR_INFO(TAG, "会话%u录制结束: %u条记录, 丢弃%u条", (unsigned int)g_rec.session_id,
+                (unsigned int)g_rec.written, (unsigned int)g_rec.dropped);
+
+    tal_mutex_lock(g_rec.mutex);
+    REC_FLAG_STORE(&g_rec.stopping, false);
+    g_rec.thread = NULL;
+    tal_mutex_unlock(g_rec.mutex);
+}
+
+int gk_recorder_start(uint32_t* session_id)
+{
+    if (!g_rec.initialized) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
+
+    tal_mutex_lock(g_rec.mutex);
+    if (g_rec.active || g_rec.thread) {
+        tal_mutex_unlock(g_rec.mutex);
+        return OPRT_RESOURCE_NOT_READY; // 正在录制或上一个会话尚未写完
+    }
+
+    char path[REC_PATH_LEN];
+    uint32_t id = g_rec.next_id;
+    rec_session_path(path, id);
+
+    tal_lfs_lock();
+    int result = lfs_file_open(tal_lfs_get(), &g_rec.file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+    tal_lfs_unlock();
+    if (result < 0) {
+        tal_mutex_unlock(g_rec.mutex);
+        TAL_PR_ERR(TAG, "创建会话文件%s失败 %d", path, result);
+        return OPRT_COM_ERROR;
+    }
+
+    gk_sensor_stats_t stats;
+    gk_sensor_get_stats(&stats);
+
+    // 没有写入线程时采集线程也不会入队 (active为false，上一次的入队已由写入线程等待完成)
+    g_rec.session_id = id;
+    g_rec.next_id = id + 1;
+    g_rec.sample_rate_hz = (uint16_t)stats.sample_rate_hz;
+    g_rec.tail = g_rec.head; // 丢弃上次停止后残留的记录
+    g_rec.dropped = 0;
+    g_rec.written = 0;
+    g_rec.unsynced_blocks = 0;
+    g_rec.write_failed = false;
+    REC_FLAG_STORE(&g_rec.stopping, false);
+    memset(&g_rec.hdr, 0, sizeof(g_rec.hdr));
+
+    THREAD_CFG_T task_cfg = {
+        .priority = THREAD_PRIO_3,
+        .stackDepth = 3072,
+        .thrdname = "gk_recorder"
+    };
+    if (tal_thread_create_and_start(&g_rec.thread, NULL, NULL, gk_recorder_task, NULL, &task_cfg) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "创建录制线程失败");
+        tal_lfs_lock();
+        lfs_file_close(tal_lfs_get(), &g_rec.file);
+        lfs_remove(tal_lfs_get(), path);
+        tal_lfs_unlock();
+        g_rec.thread = NULL;
+        tal_mutex_unlock(g_rec.mutex);
+        return OPRT_COM_ERROR;
+    }
+
+    REC_FLAG_STORE(&g_rec.active, true);
+    tal_mutex_unlock(g_rec.mutex);
+
+    if (session_id) {
+        *session_id = id;
+    }
+    TAL_PR_INFO(TAG, "开始录制会话%u: %s", (unsigned int)id, path);
+    return OPRT_OK;
+}
+
+void gk_recorder_stop(void)
+{
+    if (!g_rec.initialized) {
+        return;
+    }
+
+    tal_mutex_lock(g_rec.mutex);
+    if (g_rec.thread) {
+        // 先停止入队，写入线程排空队列、写出最后一块后自行退出
+        REC_FLAG_STORE(&g_rec.active, false);
+        REC_FLAG_STORE(&g_rec.stopping, true);
+    }
+    tal_mutex_unlock(g_rec.mutex);
+}
+
+bool gk_recorder_is_active(void)
+{
+    return REC_FLAG_LOAD(&g_rec.active);
+}
+
+void gk_recorder_get_stats(uint32_t* written, uint32_t* dropped)
+{
+    if (written) {
+        *written = g_rec.written;
+    }
+    if (dropped) {
+        *dropped = g_rec.dropped;
+    }
+}
+
+/* ---------------------------- 会话管理 ---------------------------- */
+
+int gk_recorder_list(gk_rec_session_info_t* sessions, int max_sessions)
+{
+    if (!sessions || max_sessions <= 0) {
+        return 0;
+    }
+
+    lfs_dir_t dir;
+    struct lfs_info info;
+    int count = 0;
+
+    tal_lfs_lock();
+    if (lfs_dir_open(tal_lfs_get(), &dir, GK_REC_DIR) < 0) {
+        tal_lfs_unlock();
+        return 0;
+    }
+    while (lfs_dir_read(tal_lfs_get(), &dir, &info) > 0) {
+        uint32_t id = (info.type == LFS_TYPE_REG) ? rec_parse_name(info.name) : 0;
+        if (id == 0) {
+            continue;
+        }
+
+        // 按编号插入排序 (会话数量很少)
+        int i = (count < max_sessions) ? count : max_sessions;
+        count++;
+        while (i > 0 && sessions[i - 1].id > id) {
+            if (i < max_sessions) {
+                sessions[i] = sessions[i - 1];
+            }
+            i--;
+        }
+        if (i < max_sessions) {
+            sessions[i].id = id;
+            sessions[i].size = info.size;
+            sessions[i].blocks = info.size / GK_REC_BLOCK_SIZE;
+        }
+    }
+    lfs_dir_close(tal_lfs_get(), &dir);
+    tal_lfs_unlock();
+
+    return count;
+}
+
+int gk_recorder_delete(uint32_t session_id)
+{
+    if (!g_rec.initialized) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
+
+    // 持锁删除，避免与开始录制同一编号的会话交错
+    tal_mutex_lock(g_rec.mutex);
+    if (g_rec.thread && session_id == g_rec.session_id) {
+        tal_mutex_unlock(g_rec.mutex);
+        return OPRT_RESOURCE_NOT_READY;
+    }
+
+    char path[REC_PATH_LEN];
+    rec_session_path(path, session_id);
+
+    tal_lfs_lock();
+    int result = lfs_remove(tal_lfs_get(), path);
+    tal_lfs_unlock();
+    tal_mutex_unlock(g_rec.mutex);
+
+    return (result < 0) ? OPRT_NOT_FOUND : OPRT_OK;
+}
+
+/* ---------------------------- 读取侧 ---------------------------- */
+
+int gk_rec_reader_open(gk_rec_reader_t* reader, uint32_t session_id)
+{
+    if (!reader) {
+        return OPRT_INVALID_PARM;
+    }
+    if (g_rec.thread && session_id == g_rec.session_id) {
+        return OPRT_RESOURCE_NOT_READY; // 正在写入的会话
+    }
+
+    memset(reader, 0, sizeof(gk_rec_reader_t));
+    reader->block = tal_malloc(GK_REC_BLOCK_SIZE);
+    if (!reader->block) {
+        return OPRT_MALLOC_FAILED;
+    }
+
+    char path[REC_PATH_LEN];
+    rec_session_path(path, session_id);
+
+    tal_lfs_lock();
+    int result = lfs_file_open(tal_lfs_get(), &reader->file, path, LFS_O_RDONLY);
+    tal_lfs_unlock();
+    if (result < 0) {
+        tal_free(reader->block);
+        reader->block = NULL;
+        return OPRT_NOT_FOUND;
+    }
+
+    reader->opened = true;
+    return OPRT_OK;
+}
+
+int gk_rec_reader_next(gk_rec_reader_t* reader, gk_rec_sample_t* sample)
+{
+    if (!reader || !reader->opened || !sample) {
+        return OPRT_INVALID_PARM;
+    }
+
+    // 当前块已读完，读入下一块; 损坏的块整块跳过
+    while (reader->index >= reader->hdr.count) {
+        tal_lfs_lock();
+        lfs_ssize_t n = lfs_file_read(tal_lfs_get(), &reader->file, reader->block, GK_REC_BLOCK_SIZE);
+        tal_lfs_unlock();
+        if (n != GK_REC_BLOCK_SIZE) {
+            return OPRT_NOT_FOUND;
+        }
+
+        memcpy(&reader->hdr, reader->block, sizeof(gk_rec_block_hdr_t));
+        if (rec_check_block(&reader->hdr, reader->block + sizeof(gk_rec_block_hdr_t)) != OPRT_OK ||
+            reader->hdr.sample_rate_hz == 0) {
+            TAL_PR_ERR(TAG, "跳过损坏的记录块");
+            reader->hdr.count = 0;
+        }
+        reader->pos = 0;
+        reader->index = 0;
+        memset(reader->prev, 0, sizeof(reader->prev));
+    }
+
+    if (rec_decode_record(&reader->hdr, reader->block + sizeof(gk_rec_block_hdr_t), &reader->pos, reader->prev,
+                          reader->index, sample) != OPRT_OK) {
+        reader->hdr.count = 0; // 放弃该块剩余部分
+        return OPRT_COM_ERROR;
+    }
+    reader->index++;
+    return OPRT_OK;
+}
+
+void gk_rec_reader_close(gk_rec_reader_t* reader)
+{
+    if (!reader) {
+        return;
+    }
+    if (reader->opened) {
+        tal_lfs_lock();
+        lfs_file_close(tal_lfs_get(), &reader->file);
+        tal_lfs_unlock();
+        reader->opened = false;
+    }
+    if (reader->block) {
+        tal_free(reader->block);
+        reader->block = NULL;
+    }
+}
+
+/* ---------------------------- CLI ---------------------------- */
+
+// 原样导出会话文件，每行32字节十六进制:
+// 主机端 grep '^GKREC ' log | cut -d' ' -f2 | xxd -r -p > session.gkr
+static void rec_cli_export(uint32_t id)
+{
+    char path[REC_PATH_LEN];
+    lfs_file_t file;
+    uint8_t buf[REC_EXPORT_LINE_BYTES];
+    char line[REC_EXPORT_LINE_BYTES * 2 + 1];
+
+    rec_session_path(path, id);
+    tal_lfs_lock();
+    int result = lfs_file_open(tal_lfs_get(), &file, path, LFS_O_RDONLY);
+    tal_lfs_unlock();
+    if (result < 0) {
+        PR_DEBUG_RAW("session %u not found\r\n", (unsigned int)id);
+        return;
+    }
+
+    while (1) {
+        tal_lfs_lock();
+        lfs_ssize_t n = lfs_file_read(tal_lfs_get(), &file, buf, sizeof(buf));
+        tal_lfs_unlock();
+        if (n <= 0) {
+            break;
+        }
+        for (lfs_ssize_t i = 0; i < n; i++) {
+            snprintf(&line[i * 2], 3, "%02x", buf[i]);
+        }
+        PR_DEBUG_RAW("GKREC %s\r\n", line);
+    }
+
+    tal_lfs_lock();
+    lfs_file_close(tal_lfs_get(), &file);
+    tal_lfs_unlock();
+}
+
+// 解码导出为CSV: seq,time_ms,raw[6],filtered[6]
+static void rec_cli_dump(uint32_t id)
+{
+    gk_rec_reader_t reader;
+    gk_rec_sample_t s;
+
+    if (gk_rec_reader_open(&reader, id) != OPRT_OK) {
+        PR_DEBUG_RAW("session %u not readable\r\n", (unsigned int)id);
+        return;
+    }
+
+    PR_DEBUG_RAW("GKCSV seq,time_ms,fx,fy,fz,mx,my,mz,ffx,ffy,ffz,fmx,fmy,fmz\r\n");
+    int rt;
+    while ((rt = gk_rec_reader_next(&reader, &s)) == OPRT_OK) {
+        PR_DEBUG_RAW("GKCSV %u,%u", (unsigned int)s.seq, (unsigned int)s.time_ms);
+        for (int i = 0; i < 6; i++) {
+            PR_DEBUG_RAW(",%.4f", GK_Q16_TO_FLOAT(s.raw[i]));
+        }
+        for (int i = 0; i < 6; i++) {
+            PR_DEBUG_RAW(",%.4f", GK_Q16_TO_FLOAT(s.filtered[i]));
+        }
+        PR_DEBUG_RAW("\r\n");
+    }
+    if (rt != OPRT_NOT_FOUND) {
+        PR_DEBUG_RAW("session %u decode error %d, dump stopped\r\n", (unsigned int)id, rt);
+    }
+    gk_rec_reader_close(&reader);
+}
+
+static void rec_cli_cmd(int argc, char* argv[])
+{
+    if (argc < 2) {
+        PR_DEBUG_RAW("usage: gkrec <start|stop|stat|list|export <id>|dump <id>|del <id>>\r\n");
+        return;
+    }
+
+    if (0 == strcmp(argv[1], "start")) {
+        uint32_t id;
+        if (gk_recorder_start(&id) == OPRT_OK) {
+            PR_DEBUG_RAW("recording session %u\r\n", (unsigned int)id);
+        }
+    } else if (0 == strcmp(argv[1], "stop")) {
+        gk_recorder_stop();
+    } else if (0 == strcmp(argv[1], "stat")) {
+        PR_DEBUG_RAW("session %u active %d written %u dropped %u\r\n", (unsigned int)g_rec.session_id,
+                     gk_recorder_is_active(), (unsigned int)g_rec.written, (unsigned int)g_rec.dropped);
+    } else if (0 == strcmp(argv[1], "list")) {
+        gk_rec_session_info_t sessions[16];
+        int count = gk_recorder_list(sessions, 16);
+        for (int i = 0; i < count && i < 16; i++) {
+            PR_DEBUG_RAW("%05u  %u bytes  %u blocks\r\n", (unsigned int)sessions[i].id,
+                         (unsigned int)sessions[i].size, (unsigned int)sessions[i].blocks);
+        }
+        if (count > 16) {
+            PR_DEBUG_RAW("... %d sessions total\r\n", count);
+        }
+    } else if (argc >= 3 && 0 == strcmp(argv[1], "export")) {
+        rec_cli_export((uint32_t)strtoul(argv[2], NULL, 10));
+    } else if (argc >= 3 && 0 == strcmp(argv[1], "dump")) {
+        rec_cli_dump((uint32_t)strtoul(argv[2], NULL, 10));
+    } else if (argc >= 3 && 0 == strcmp(argv[1], "del")) {
+        gk_recorder_delete((uint32_t)strtoul(argv[2], NULL, 10));
+    }
+}
+
+static const cli_cmd_t s_rec_cli_cmd[] = {
+    {.name = "gkrec", .func = rec_cli_cmd, .help = "sandbag session recorder"},
+};
+
+int gk_recorder_init(void)
+{
+    if (g_rec.initialized) {
+        return OPRT_OK;
+    }
+
+    lfs_t* lfs = tal_lfs_get();
+    lfs_dir_t dir;
+    struct lfs_info info;
+    uint32_t max_id = 0;
+
+    if (g_rec.mutex == NULL && tal_mutex_create_init(&g_rec.mutex) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "创建录制器互斥锁失败");
+        return OPRT_COM_ERROR;
+    }
+    if (tal_lfs_lock() != OPRT_OK) {
+        TAL_PR_ERR(TAG, "文件系统未初始化");
+        return OPRT_RESOURCE_NOT_READY;
+    }
+    int result = lfs_mkdir(lfs, GK_REC_DIR);
+    if (result < 0 && result != LFS_ERR_EXIST) {
+        tal_lfs_unlock();
+        TAL_PR_ERR(TAG, "创建目录%s失败 %d", GK_REC_DIR, result);
+        return OPRT_COM_ERROR;
+    }
+
+    // 新会话编号接在已有会话之后
+    if (lfs_dir_open(lfs, &dir, GK_REC_DIR) >= 0) {
+        while (lfs_dir_read(lfs, &dir, &info) > 0) {
+            uint32_t id = rec_parse_name(info.name);
+            if (id > max_id) {
+                max_id = id;
+            }
+        }
+        lfs_dir_close(lfs, &dir);
+    }
+    tal_lfs_unlock();
+
+    g_rec.next_id = max_id + 1;
+    g_rec.initialized = true;
+
+    tal_cli_cmd_register(s_rec_cli_cmd, sizeof(s_rec_cli_cmd) / sizeof(s_rec_cli_cmd[0]));
+
+    TAL_PR_INFO(TAG, "会话录制器就绪，下一个会话编号%u", (unsigned int)g_rec.next_id);
+    return OPRT_OK;
+}
+
+#endif /* GK_RECORDER_ENABLE */
@@ -0,0 +1,122 @@
+#ifndef __GK_RECORDER_H__
+#define __GK_RECORDER_H__
+
+#include "gk_bag.h"
+#include "gk_fixed.h"
+#include "tal_kv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(ENABLE_SESSION_RECORDER) && (ENABLE_SESSION_RECORDER == 1)
+#define GK_RECORDER_ENABLE      1
+#else
+#define GK_RECORDER_ENABLE      0
+#endif
+
+// 会话文件存放在tal_kv挂载的littlefs中: /gkrec/NNNNN.gkr
+#define GK_REC_DIR              "/gkrec"
+#define GK_REC_SUFFIX           ".gkr"
+
+// 记录块大小 (字节)，应等于flash页/扇区大小，每次写入一个完整块
+#ifdef RECORDER_BLOCK_SIZE
+#define GK_REC_BLOCK_SIZE       RECORDER_BLOCK_SIZE
+#else
+#define GK_REC_BLOCK_SIZE       4096
+#endif
+
+/*
+ * 会话文件格式 (小端序，version 1)
+ *
+ * 文件由定长GK_REC_BLOCK_SIZE字节的块顺序组成，每个块可独立解码:
+ *   gk_rec_block_hdr_t | payload[payload_len] | 0填充至块大小
+ *
+ * 每条记录包含12个通道: 原始Fx Fy Fz Mx My Mz + 滤波后Fx Fy Fz Mx My Mz，
+ * 均为Q16定点值。块内第一条记录相对0做差分，之后每条相对上一条做差分，
+ * 差值经zigzag映射后以LEB128变长整数编码。
+ * 块内记录的采样序号连续 (first_seq, first_seq+1, ...)，
+ * 采样序号出现跳变(丢帧/overrun)时另起新块。
+ * crc为payload的CRC32。
+ */
+#define GK_REC_MAGIC            0x31524B47u     // "GKR1"
+#define GK_REC_VERSION          1
+#define GK_REC_CHANNELS         12
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t channels;
+    uint16_t sample_rate_hz;
+    uint32_t first_seq;        // 块内首条记录的采样序号
+    uint32_t time_ms;          // 首条记录的采集时刻 (单调微秒时钟折算为毫秒的低32位)
+    uint16_t count;            // 块内记录数
+    uint16_t payload_len;      // 编码数据长度
+    uint32_t crc;              // payload的CRC32
+} gk_rec_block_hdr_t;
+
+// 一条记录的解码结果
+typedef struct {
+    uint32_t seq;
+    uint32_t time_ms;
+    gk_q16_t raw[6];
+    gk_q16_t filtered[6];
+} gk_rec_sample_t;
+
+// 会话信息 (CLI列表和回放使用)
+typedef struct {
+    uint32_t id;
+    uint32_t size;             // 文件字节数
+    uint32_t blocks;
+} gk_rec_session_info_t;
+
+// 会话读取器: 逐块读入并增量解码，只占用一个块缓冲区
+typedef struct {
+    lfs_file_t file;
+    bool opened;
+    uint8_t* block;
+    gk_rec_block_hdr_t hdr;
+    uint32_t pos;              // payload内的读位置
+    uint32_t index;            // 块内已解码的记录数
+    int32_t prev[GK_REC_CHANNELS];
+} gk_rec_reader_t;
+
+int gk_recorder_init(void);
+
+// 开始一次新的会话录制，session_id可为NULL
+int gk_recorder_start(uint32_t* session_id);
+
+// 停止录制，写入线程写完剩余数据后关闭文件
+void gk_recorder_stop(void);
+
+bool gk_recorder_is_active(void);
+
+// 采集线程调用: 只做定点转换和无锁入队，不访问flash
+// seq为采样周期序号，raw为校准前原始数据
+void gk_recorder_push(uint32_t seq, uint32_t time_ms, const float raw[6], const gk_force_data_t* filtered);
+// 定点采集链路使用: raw、filtered已是Q16，直接入队
+void gk_recorder_push_q16(uint32_t seq, uint32_t time_ms, const gk_q16_t raw[6], const gk_q16_t filtered[6]);
+
+// 录制统计: 已写入记录数、入队失败而丢弃的记录数
+void gk_recorder_get_stats(uint32_t* written, uint32_t* dropped);
+
+// 按编号升序枚举会话，返回会话总数 (可能大于max_sessions，只填充前max_sessions个)
+int gk_recorder_list(gk_rec_session_info_t* sessions, int max_sessions);
+
+int gk_recorder_delete(uint32_t session_id);
+
+// 解码一个块中的全部记录，返回记录数，块损坏时返回负的错误码
+int gk_rec_decode_block(const uint8_t* block, uint32_t block_len, gk_rec_sample_t* samples, int max_samples);
+
+int gk_rec_reader_open(gk_rec_reader_t* reader, uint32_t session_id);
+
+// 读取下一条记录，会话结束时返回OPRT_NOT_FOUND
+int gk_rec_reader_next(gk_rec_reader_t* reader, gk_rec_sample_t* sample);
+
+void gk_rec_reader_close(gk_rec_reader_t* reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_RECORDER_H__ */
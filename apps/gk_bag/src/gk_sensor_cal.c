@@ -0,0 +1,172 @@
+#include "gk_sensor_cal.h"
+#include "tal_kv.h"
+#include "crc32i.h"
+#include "math.h"
+#include <stdio.h>
+
+#define TAG "GK_SENSOR_CAL"
+
+#define SENSOR_CAL_CRC_LEN      offsetof(gk_sensor_cal_blob_t, crc)
+
+// tal_kv未挂载时 (如主机基准测试) 不访问KV
+static bool sensor_cal_kv_ready(void)
+{
+    if (tal_lfs_lock() != OPRT_OK) {
+        return false;
+    }
+    tal_lfs_unlock();
+    return true;
+}
+
+static void sensor_cal_kv_key(uint8_t id, char* key, size_t size)
+{
+    if (id == 0) {
+        snprintf(key, size, "%s", GK_SENSOR_CAL_KV_KEY);
+    } else {
+        snprintf(key, size, "%s%u", GK_SENSOR_CAL_KV_KEY, (unsigned int)id);
+    }
+}
+
+int gk_sensor_cal_load(uint8_t id, float offset[GK_SENSOR_CAL_CHANNELS], float scale[GK_SENSOR_CAL_CHANNELS])
+{
+    gk_sensor_cal_blob_t blob;
+    char key[16];
+    uint8_t* value = NULL;
+    size_t length = 0;
+
+    if (!offset || !scale) {
+        return OPRT_INVALID_PARM;
+    }
+    if (!sensor_cal_kv_ready()) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
+    sensor_cal_kv_key(id, key, sizeof(key));
+    if (tal_kv_get(key, &value, &length) != OPRT_OK) {
+        return OPRT_NOT_FOUND;
+    }
+    if (length != sizeof(blob)) {
+        tal_kv_free(value);
+        TAL_PR_ERR(TAG, "校准数据长度不符: %u", (unsigned int)length);
+        return OPRT_COM_ERROR;
+    }
+    memcpy(&blob, value, sizeof(blob));
+    tal_kv_free(value);
+
+    if (blob.magic != GK_SENSOR_CAL_MAGIC || blob.version != GK_SENSOR_CAL_VERSION || blob.size != sizeof(blob)) {
+        TAL_PR_ERR(TAG, "校准数据版本不符: magic=%08x version=%u", (unsigned int)blob.magic,
+                   (unsigned int)blob.version);
+        return OPRT_COM_ERROR;
+    }
+    if (hash_crc32i_total(&blob, SENSOR_CAL_CRC_LEN) != blob.crc) {
+        TAL_PR_ERR(TAG, "校准数据CRC错误");
+        return OPRT_COM_ERROR;
+    }
+
+    memcpy(offset, blob.offset, sizeof(blob.offset));
+    memcpy(scale, blob.scale, sizeof(blob.scale));
+    return OPRT_OK;
+}
+
+int gk_sensor_cal_save(uint8_t id, const float offset[GK_SENSOR_CAL_CHANNELS],
+                       const float scale[GK_SENSOR_CAL_CHANNELS])
+{
+    gk_sensor_cal_blob_t blob;
+    char key[16];
+
+    if (!offset || !scale) {
+        return OPRT_INVALID_PARM;
+    }
+    if (!sensor_cal_kv_ready()) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
+
+    memset(&blob, 0, sizeof(blob));
+    blob.magic = GK_SENSOR_CAL_MAGIC;
+    blob.version = GK_SENSOR_CAL_VERSION;
+    blob.size = sizeof(blob);
+    memcpy(blob.offset, offset, sizeof(blob.offset));
+    memcpy(blob.scale, scale, sizeof(blob.scale));
+    blob.crc = hash_crc32i_total(&blob, SENSOR_CAL_CRC_LEN);
+
+    sensor_cal_kv_key(id, key, sizeof(key));
+    int rt = tal_kv_set(key, (const uint8_t*)&blob, sizeof(blob));
+    if (rt != OPRT_OK) {
+        TAL_PR_ERR(TAG, "校准数据保存失败 %d", rt);
+        return OPRT_COM_ERROR;
+    }
+    return OPRT_OK;
+}
+
+void gk_drift_tracker_init(gk_drift_tracker_t* trk, const gk_drift_tracker_cfg_t* cfg,
+                           const float baseline[GK_SENSOR_CAL_CHANNELS])
+{
+    memset(trk, 0, sizeof(gk_drift_tracker_t));
+    trk->cfg = *cfg;
+    if (trk->cfg.window_samples == 0) {
+        trk->cfg.window_samples = 1;
+    }
+    gk_drift_tracker_rebase(trk, baseline);
+}
+
+void gk_drift_tracker_rebase(gk_drift_tracker_t* trk, const float baseline[GK_SENSOR_CAL_CHANNELS])
+{
+    memcpy(trk->baseline, baseline, sizeof(trk->baseline));
+    memset(trk->sum, 0, sizeof(trk->sum));
+    trk->count = 0;
+    trk->window_quiet = true;
+    trk->has_pending = false;
+}
+
+bool gk_drift_tracker_feed_window(gk_drift_tracker_t* trk, const float mean[GK_SENSOR_CAL_CHANNELS], bool quiet,
+                                  float offset[GK_SENSOR_CAL_CHANNELS])
+{
+    bool updated = false;
+
+    if (!quiet) {
+        // 打击: 当前窗口和可能含起始前沿的上一个窗口都不采纳
+        trk->has_pending = false;
+        return false;
+    }
+
+    if (trk->has_pending) {
+        for (int i = 0; i < GK_SENSOR_CAL_CHANNELS; i++) {
+            float limit = (i < 3) ? trk->cfg.max_force_drift : trk->cfg.max_torque_drift;
+            float next = offset[i] + trk->cfg.gain * (trk->pending[i] - offset[i]);
+            offset[i] = fmaxf(trk->baseline[i] - limit, fminf(trk->baseline[i] + limit, next));
+        }
+        trk->updates++;
+        updated = true;
+    }
+    memcpy(trk->pending, mean, sizeof(trk->pending));
+    trk->has_pending = true;
+    return updated;
+}
+
+bool gk_drift_tracker_feed(gk_drift_tracker_t* trk, const float raw[GK_SENSOR_CAL_CHANNELS], bool quiet,
+                           float offset[GK_SENSOR_CAL_CHANNELS])
+{
+    if (!quiet) {
+        // 窗口未结束也立即丢弃尚未提交的窗口
+        trk->window_quiet = false;
+        trk->has_pending = false;
+    }
+
+    for (int i = 0; i < GK_SENSOR_CAL_CHANNELS; i++) {
+        trk->sum[i] += raw[i];
+    }
+    if (++trk->count < trk->cfg.window_samples) {
+        return false;
+    }
+
+    float mean[GK_SENSOR_CAL_CHANNELS];
+    float inv = 1.0f / (float)trk->count;
+    for (int i = 0; i < GK_SENSOR_CAL_CHANNELS; i++) {
+        mean[i] = trk->sum[i] * inv;
+    }
+    bool updated = gk_drift_tracker_feed_window(trk, mean, trk->window_quiet, offset);
+
+    memset(trk->sum, 0, sizeof(trk->sum));
+    trk->count = 0;
+    trk->window_quiet = true;
+    return updated;
+}
@@ -0,0 +1,86 @@
+#ifndef __GK_SENSOR_CAL_H__
+#define __GK_SENSOR_CAL_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GK_SENSOR_CAL_CHANNELS  6   // Fx Fy Fz Mx My Mz
+
+/*
+ * 持久化校准参数，保存在tal_kv中 (小端序)
+ *
+ * size为整个结构体的字节数，crc为crc之前所有字节的CRC32。
+ * magic、version、size任一不符或CRC校验失败时视为没有校准数据，使用默认值。
+ * 每个沙袋一条记录: 沙袋0的键为GK_SENSOR_CAL_KV_KEY (与单沙袋版本相同)，沙袋N为GK_SENSOR_CAL_KV_KEY后接N。
+ */
+#define GK_SENSOR_CAL_KV_KEY    "gk_ft_cal"
+#define GK_SENSOR_CAL_MAGIC     0x4C414347u     // "GCAL"
+#define GK_SENSOR_CAL_VERSION   1
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    float offset[GK_SENSOR_CAL_CHANNELS];   // 零点 (校准前单位)
+    float scale[GK_SENSOR_CAL_CHANNELS];
+    uint32_t crc;
+} gk_sensor_cal_blob_t;
+
+// 从tal_kv读取沙袋id的记录并校验，没有有效数据或tal_kv未初始化时返回非OPRT_OK，参数不变
+int gk_sensor_cal_load(uint8_t id, float offset[GK_SENSOR_CAL_CHANNELS], float scale[GK_SENSOR_CAL_CHANNELS]);
+int gk_sensor_cal_save(uint8_t id, const float offset[GK_SENSOR_CAL_CHANNELS],
+                       const float scale[GK_SENSOR_CAL_CHANNELS]);
+
+/*
+ * 零漂跟踪
+ *
+ * 应变片的零点随温度缓慢漂移。空闲时传感器读数的均值就是当前零点，
+ * 按window_samples个样本为一个窗口求均值，窗口内所有帧都空闲时才采纳，
+ * 以gain的比例向窗口均值靠近 (一阶低通，时间常数 = 窗口时长 / gain)。
+ * 打击的起始前沿可能落在前一个窗口中，因此每个空闲窗口要等到下一个窗口也空闲时才提交，
+ * 出现非空闲帧时当前窗口和尚未提交的窗口一起丢弃。
+ * 零点相对持久化的基准最多偏移max_force_drift / max_torque_drift，
+ * 避免缓慢加载的外力 (如低于阈值的倚靠) 被当作零点吸收。
+ */
+typedef struct {
+    uint32_t window_samples;   // 每个平均窗口的样本数
+    float gain;                // 每个窗口的跟踪比例 (0-1]
+    float max_force_drift;     // Fx Fy Fz相对基准的最大偏移 (N)
+    float max_torque_drift;    // Mx My Mz相对基准的最大偏移 (N·m)
+} gk_drift_tracker_cfg_t;
+
+typedef struct {
+    gk_drift_tracker_cfg_t cfg;
+    float baseline[GK_SENSOR_CAL_CHANNELS];  // 持久化的零点
+    float sum[GK_SENSOR_CAL_CHANNELS];       // 当前窗口的累加
+    float pending[GK_SENSOR_CAL_CHANNELS];   // 等待下一个窗口确认的窗口均值
+    uint32_t count;
+    bool window_quiet;
+    bool has_pending;
+    uint32_t updates;                        // 已提交的窗口数
+} gk_drift_tracker_t;
+
+void gk_drift_tracker_init(gk_drift_tracker_t* trk, const gk_drift_tracker_cfg_t* cfg,
+                           const float baseline[GK_SENSOR_CAL_CHANNELS]);
+
+// 重新校准后更换基准，丢弃进行中的窗口
+void gk_drift_tracker_rebase(gk_drift_tracker_t* trk, const float baseline[GK_SENSOR_CAL_CHANNELS]);
+
+// 输入一帧校准前的数据，quiet表示该帧校准后的受力低于空闲阈值
+// 提交了一个窗口时更新offset并返回true，每窗口最多一次，其余帧只做6次加法
+bool gk_drift_tracker_feed(gk_drift_tracker_t* trk, const float raw[GK_SENSOR_CAL_CHANNELS], bool quiet,
+                           float offset[GK_SENSOR_CAL_CHANNELS]);
+
+// 由调用者累加整个窗口 (如定点链路以整数累加)，每window_samples帧输入一次窗口均值
+// quiet表示窗口内所有帧都空闲，其余规则与gk_drift_tracker_feed相同
+bool gk_drift_tracker_feed_window(gk_drift_tracker_t* trk, const float mean[GK_SENSOR_CAL_CHANNELS], bool quiet,
+                                  float offset[GK_SENSOR_CAL_CHANNELS]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_SENSOR_CAL_H__ */
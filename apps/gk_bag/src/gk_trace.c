@@ -0,0 +1,235 @@
+#include "gk_trace.h"
+#include "math.h"
+
+// 与gk_calculate_hit_point一致的几何参数
+#define TRACE_BAG_RADIUS        0.10f   // 沙袋半径 (m)
+#define TRACE_SENSOR_OFFSET_X   0.20f   // Mx补偿 (m)
+#define TRACE_SENSOR_OFFSET_Y   0.15f   // My补偿 (m)
+#define TRACE_CONTACT_HEIGHT    0.05f   // 接触点高度范围 ±(m)
+#define TRACE_MAX_TILT          0.4f    // 力方向偏离水平法线的最大分量
+#define TRACE_MAX_SKEW          0.3f
+
+// 两次打击之间的最小间隔，保证打击分段器能区分相邻打击
+#define TRACE_MIN_GAP_MS        200
+
+// 拳法模型: 力方向在 (径向向内, 切向, 竖直) 基底下的分量范围，以及力度、时长和上升段比例
+// 数值是按动作特点给出的近似，用于产生带标签的训练和评估数据，不是实测统计
+typedef struct {
+    float radial[2];
+    float tangential[2];        // 绝对值范围，方向随机 (左右手)
+    float vertical[2];
+    float height[2];            // 接触点高度 (m)
+    float force[2];             // 峰值力 (N)
+    float duration_ms[2];
+    float rise[2];
+} trace_punch_profile_t;
+
+static const trace_punch_profile_t g_trace_profiles[GK_PUNCH_TYPE_MAX] = {
+    [GK_PUNCH_JAB] = {{1.0f, 1.0f}, {0.0f, 0.25f}, {-0.10f, 0.15f}, {0.00f, 0.05f},
+                      {35.0f, 90.0f}, {8.0f, 18.0f}, {0.35f, 0.50f}},
+    [GK_PUNCH_CROSS] = {{1.0f, 1.0f}, {0.0f, 0.30f}, {-0.15f, 0.10f}, {0.00f, 0.05f},
+                        {80.0f, 170.0f}, {12.0f, 24.0f}, {0.30f, 0.45f}},
+    [GK_PUNCH_HOOK] = {{0.3f, 0.8f}, {0.6f, 1.0f}, {-0.15f, 0.15f}, {-0.02f, 0.05f},
+                       {55.0f, 150.0f}, {16.0f, 32.0f}, {0.40f, 0.60f}},
+    [GK_PUNCH_UPPERCUT] = {{0.4f, 0.9f}, {0.0f, 0.35f}, {0.60f, 1.20f}, {-0.05f, 0.01f},
+                           {50.0f, 140.0f}, {14.0f, 28.0f}, {0.45f, 0.65f}},
+};
+
+// xorshift32，结果与平台的rand()实现无关
+static uint32_t trace_rand(gk_trace_synth_t* synth)
+{
+    uint32_t x = synth->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    synth->rng = x;
+    return x;
+}
+
+// [0, 1)
+static float trace_uniform(gk_trace_synth_t* synth)
+{
+    return (trace_rand(synth) >> 8) * (1.0f / 16777216.0f);
+}
+
+// [lo, hi)
+static float trace_range(gk_trace_synth_t* synth, float lo, float hi)
+{
+    return lo + (hi - lo) * trace_uniform(synth);
+}
+
+// 按平均打击频率安排下一次打击 (指数分布间隔)
+static void trace_schedule_next(gk_trace_synth_t* synth, uint32_t after)
+{
+    float rate = synth->cfg.hits_per_second;
+    uint32_t min_gap = TRACE_MIN_GAP_MS * synth->cfg.sample_rate_hz / 1000;
+
+    if (rate <= 0.0f) {
+        synth->next_onset = UINT32_MAX;
+        return;
+    }
+
+    float gap_s = -logf(1.0f - trace_uniform(synth)) / rate;
+    uint32_t gap = (uint32_t)(gap_s * synth->cfg.sample_rate_hz);
+    synth->next_onset = after + ((gap > min_gap) ? gap : min_gap);
+}
+
+static void trace_start_punch(gk_trace_synth_t* synth)
+{
+    const gk_trace_synth_cfg_t* cfg = &synth->cfg;
+
+    // 接触点在沙袋圆柱面上，力方向大致指向圆心，带有上下和切向分量
+    float theta = trace_range(synth, 0.0f, 2.0f * (float)M_PI);
+    float c = cosf(theta);
+    float s = sinf(theta);
+    float radial = 1.0f;
+    float tilt, skew, duration_ms;
+    gk_punch_type_t type = GK_PUNCH_UNKNOWN;
+
+    float radius = TRACE_BAG_RADIUS;
+    if (cfg->radius_error > 0.0f) {
+        radius += trace_range(synth, -cfg->radius_error, cfg->radius_error);
+    }
+    synth->contact[0] = radius * c;
+    synth->contact[1] = radius * s;
+
+    if (cfg->punch_types) {
+        type = (gk_punch_type_t)(GK_PUNCH_JAB + trace_rand(synth) % (GK_PUNCH_TYPE_MAX - GK_PUNCH_JAB));
+        const trace_punch_profile_t* prof = &g_trace_profiles[type];
+        radial = trace_range(synth, prof->radial[0], prof->radial[1]);
+        skew = trace_range(synth, prof->tangential[0], prof->tangential[1]);
+        if (trace_rand(synth) & 1) {
+            skew = -skew;
+        }
+        tilt = trace_range(synth, prof->vertical[0], prof->vertical[1]);
+        synth->contact[2] = trace_range(synth, prof->height[0], prof->height[1]);
+        duration_ms = trace_range(synth, prof->duration_ms[0], prof->duration_ms[1]);
+        synth->peak = trace_range(synth, prof->force[0], prof->force[1]);
+        synth->rise = trace_range(synth, prof->rise[0], prof->rise[1]);
+    } else {
+        tilt = trace_range(synth, -TRACE_MAX_TILT, TRACE_MAX_TILT);
+        skew = trace_range(synth, -TRACE_MAX_SKEW, TRACE_MAX_SKEW);
+        synth->contact[2] = trace_range(synth, -TRACE_CONTACT_HEIGHT, TRACE_CONTACT_HEIGHT);
+        duration_ms = trace_range(synth, cfg->min_duration_ms, cfg->max_duration_ms);
+        synth->peak = trace_range(synth, cfg->min_force, cfg->max_force);
+        synth->rise = 0.5f;
+    }
+
+    float d[3] = {-radial * c - skew * s, -radial * s + skew * c, tilt};
+    float norm = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    for (int i = 0; i < 3; i++) {
+        synth->dir[i] = d[i] / norm;
+    }
+
+    synth->punch_samples = (uint32_t)(duration_ms * cfg->sample_rate_hz / 1000.0f);
+    if (synth->punch_samples < 2) {
+        synth->punch_samples = 2;
+    }
+
+    // 显示坐标系交换x/y，单位厘米
+    synth->truth.index++;
+    synth->truth.onset_sample = synth->sample;
+    synth->truth.x = synth->contact[1] * 100.0f;
+    synth->truth.y = synth->contact[0] * 100.0f;
+    synth->truth.peak_force = synth->peak;
+    synth->truth.type = type;
+}
+
+void gk_trace_synth_init(gk_trace_synth_t* synth, const gk_trace_synth_cfg_t* cfg)
+{
+    memset(synth, 0, sizeof(gk_trace_synth_t));
+    synth->cfg = *cfg;
+    if (synth->cfg.sample_rate_hz == 0) {
+        synth->cfg.sample_rate_hz = 1000;
+    }
+    synth->rng = cfg->seed ? cfg->seed : 1;
+
+    // 失配参数在开始产生数据前一次取定，未开启时不消耗随机数，保证默认序列不变
+    synth->mismatch = (cfg->gain_error > 0.0f || cfg->crosstalk > 0.0f || cfg->mount_error > 0.0f);
+    if (synth->mismatch) {
+        for (int i = 0; i < 6; i++) {
+            for (int j = 0; j < 6; j++) {
+                synth->mix[i][j] = (i == j) ? 1.0f + trace_range(synth, -cfg->gain_error, cfg->gain_error)
+                                            : trace_range(synth, -cfg->crosstalk, cfg->crosstalk);
+            }
+        }
+        synth->mount[0] = trace_range(synth, -cfg->mount_error, cfg->mount_error);
+        synth->mount[1] = trace_range(synth, -cfg->mount_error, cfg->mount_error);
+    }
+    trace_schedule_next(synth, 0);
+}
+
+int gk_trace_synth_read(void* ctx, float raw[6])
+{
+    gk_trace_synth_t* synth = (gk_trace_synth_t*)ctx;
+    if (!synth || !raw) {
+        return OPRT_INVALID_PARM;
+    }
+
+    float half = synth->cfg.noise_level * 0.5f;
+    float noise[6];
+    for (int i = 0; i < 6; i++) {
+        noise[i] = trace_range(synth, -half, half);
+        raw[i] = noise[i];
+    }
+    raw[2] += synth->cfg.gravity;
+
+    if (synth->punch_samples == 0 && synth->sample >= synth->next_onset) {
+        trace_start_punch(synth);
+    }
+
+    if (synth->punch_samples > 0) {
+        uint32_t k = synth->sample - synth->truth.onset_sample;
+        if (k >= synth->punch_samples) {
+            synth->punch_samples = 0;
+            trace_schedule_next(synth, synth->sample);
+        } else {
+            // 力脉冲: 上升段和下降段各为四分之一正弦，rise为0.5时即半正弦
+            float t = (k + 0.5f) / synth->punch_samples;
+            float phase = (t < synth->rise) ? 0.5f * t / synth->rise
+                                            : 0.5f + 0.5f * (t - synth->rise) / (1.0f - synth->rise);
+            float mag = synth->peak * sinf((float)M_PI * phase);
+            float F[3] = {mag * synth->dir[0], mag * synth->dir[1], mag * synth->dir[2]};
+            const float* p = synth->contact;
+
+            // 传感器测得的力矩 τ = p × F，再减去求解器会补偿的安装偏移
+            float tau[3] = {
+                p[1] * F[2] - p[2] * F[1],
+                p[2] * F[0] - p[0] * F[2],
+                p[0] * F[1] - p[1] * F[0],
+            };
+            raw[0] += F[0];
+            raw[1] += F[1];
+            raw[2] += F[2];
+            raw[3] += tau[0] - F[1] * (TRACE_SENSOR_OFFSET_X + synth->mount[0]);
+            raw[4] += tau[1] - F[0] * (TRACE_SENSOR_OFFSET_Y + synth->mount[1]);
+            raw[5] += tau[2];
+        }
+    }
+
+    // 增益和串扰作用在信号上，噪声在其后叠加
+    if (synth->mismatch) {
+        float sig[6];
+        for (int i = 0; i < 6; i++) {
+            sig[i] = raw[i] - noise[i];
+        }
+        for (int i = 0; i < 6; i++) {
+            raw[i] = noise[i];
+            for (int j = 0; j < 6; j++) {
+                raw[i] += synth->mix[i][j] * sig[j];
+            }
+        }
+    }
+
+    synth->sample++;
+    return OPRT_OK;
+}
+
+bool gk_trace_synth_truth(const gk_trace_synth_t* synth, gk_trace_truth_t* truth)
+{
+    if (!synth || !truth || synth->truth.index == 0) {
+        return false;
+    }
+    *truth = synth->truth;
+    return true;
+}
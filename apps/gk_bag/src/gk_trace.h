@@ -0,0 +1,73 @@
+#ifndef __GK_TRACE_H__
+#define __GK_TRACE_H__
+
+#include "gk_bag.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 合成六轴力数据源: 可复现的噪声 + 已知打击点的打击脉冲
+// 用作无硬件时的传感器数据源，同时为主机基准测试提供打击点真值
+typedef struct {
+    uint32_t sample_rate_hz;
+    uint32_t seed;              // 相同种子产生相同序列
+    float noise_level;          // 每通道均匀噪声的峰峰值 (N / N·m)
+    float gravity;              // 静止时Fz读数 (N)，模拟未去皮的传感器
+    float hits_per_second;      // 平均打击频率
+    float min_force;            // 峰值力范围 (N)
+    float max_force;
+    float min_duration_ms;      // 单次打击接触时间范围
+    float max_duration_ms;
+    bool punch_types;           // 按拳法随机产生方向、力度、时长和波形，忽略上面的力度和时长范围
+    // 模型失配: 均为0时传感器与求解器的模型完全一致。非0时按种子随机取定，用于检验求解器对真实偏差的容忍度
+    float gain_error;           // 每通道增益误差范围 ±(比例)
+    float crosstalk;            // 通道间串扰范围 ±(比例)
+    float mount_error;          // 传感器安装偏移误差范围 ±(m)，求解器仍按标称偏移补偿
+    float radius_error;         // 每次打击接触点偏离标称半径的范围 ±(m)，模拟沙袋变形
+} gk_trace_synth_cfg_t;
+
+#define GK_TRACE_SYNTH_DEFAULT(rate)                                                                                   \
+    {                                                                                                                  \
+        .sample_rate_hz = (rate), .seed = 1, .noise_level = 0.1f, .gravity = -9.81f, .hits_per_second = 0.2f,         \
+        .min_force = 50.0f, .max_force = 150.0f, .min_duration_ms = 10.0f, .max_duration_ms = 30.0f,                  \
+    }
+
+// 一次合成打击的真值
+typedef struct {
+    uint32_t index;             // 第几次打击 (从1开始，0表示尚无打击)
+    uint32_t onset_sample;      // 起始样本序号
+    float x, y;                 // 显示坐标系中的打击点 (厘米)，与gk_calculate_hit_point一致
+    float peak_force;           // 峰值力 (N)
+    gk_punch_type_t type;       // 拳法，cfg.punch_types为false时为GK_PUNCH_UNKNOWN
+} gk_trace_truth_t;
+
+typedef struct {
+    gk_trace_synth_cfg_t cfg;
+    uint32_t rng;
+    uint32_t sample;            // 已产生的样本数
+    uint32_t next_onset;        // 下一次打击的起始样本
+    uint32_t punch_samples;     // 当前打击的持续样本数，0表示没有进行中的打击
+    float peak;
+    float rise;                 // 上升段占整个脉冲的比例
+    float dir[3];               // 力的单位方向
+    float contact[3];           // 接触点 (米，传感器坐标系)
+    bool mismatch;              // 是否施加下面的失配参数
+    float mix[6][6];            // 通道增益与串扰矩阵
+    float mount[2];             // 安装偏移误差 (m)
+    gk_trace_truth_t truth;     // 最近一次打击的真值
+} gk_trace_synth_t;
+
+void gk_trace_synth_init(gk_trace_synth_t* synth, const gk_trace_synth_cfg_t* cfg);
+
+// 数据源回调 (ctx为gk_trace_synth_t*)，产生一帧校准前的原始数据
+int gk_trace_synth_read(void* ctx, float raw[6]);
+
+// 最近一次已开始的打击的真值，尚无打击时返回false
+bool gk_trace_synth_truth(const gk_trace_synth_t* synth, gk_trace_truth_t* truth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GK_TRACE_H__ */
@@ -1,7 +1,9 @@
 #include "gk_bag.h"
+#include "gk_gui_canvas.h"
 #include "tal_log.h"
 #include "lvgl.h"
 #include "math.h"
+#include <stdio.h>
 
 #define TAG "GUI_GRAPHICS"
 
@@ -9,28 +11,82 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+// 画布尺寸按显示屏分辨率缩放，以800x480为参考: 火柴人200x300，战力图400x300
+// 缓冲区只在主统计页面显示期间从gk_gui_canvas借用
+#define STICK_REF_W     200
+#define STICK_REF_H     300
+#define COMBAT_REF_W    400
+#define COMBAT_REF_H    300
+
 // 战斗统计画布
 static lv_obj_t* g_combat_stats_canvas = NULL;
-static lv_draw_buf_t g_combat_draw_buf;
-static uint8_t g_combat_canvas_buf[400 * 300 * LV_COLOR_DEPTH / 8];
+static int32_t g_combat_w = COMBAT_REF_W;
+static int32_t g_combat_h = COMBAT_REF_H;
 
 // 火柴人画布
 static lv_obj_t* g_stick_figure_canvas = NULL;
-static lv_draw_buf_t g_stick_draw_buf;
-static uint8_t g_stick_canvas_buf[200 * 300 * LV_COLOR_DEPTH / 8];
+static int32_t g_stick_w = STICK_REF_W;
+static int32_t g_stick_h = STICK_REF_H;
 
 // 当前统计
 static gk_combat_stats_t g_current_stats = {50, 50, 50, 50, 50}; // Default values
 
+// 渲染缓存: 两个画布只依赖几个整数，输入与画布上已绘制的内容相同时不重绘
+// 画布重新创建 (页面重新显示) 时失效
+static struct {
+    bool valid;
+    int height;
+    int weight;
+    int gender;
+} g_stick_drawn = {0};
+
+static struct {
+    bool valid;                 // 画布上的数据多边形与stats一致
+    gk_combat_stats_t stats;
+    uint8_t* grid_cache;        // 网格、轴线和项目名称，与画布缓冲区格式和行跨度相同，NULL时每次重绘
+    bool grid_ready;
+    uint32_t renders;           // 完整重绘次数 (含网格)
+    uint32_t data_renders;      // 只重绘数据多边形的次数
+    uint32_t skipped;           // 输入未变化而跳过的次数
+} g_combat_drawn = {0};
+
+static void stick_draw_line(lv_layer_t* layer, lv_draw_line_dsc_t* dsc, const lv_point_t* a, const lv_point_t* b)
+{
+    dsc->p1.x = a->x;
+    dsc->p1.y = a->y;
+    dsc->p2.x = b->x;
+    dsc->p2.y = b->y;
+    lv_draw_line(layer, dsc);
+}
+
+static void stick_draw_arc(lv_layer_t* layer, lv_draw_arc_dsc_t* dsc, const lv_point_t* center, int radius,
+                           int start_angle, int end_angle)
+{
+    dsc->center = *center;
+    dsc->radius = radius;
+    dsc->start_angle = start_angle;
+    dsc->end_angle = end_angle;
+    lv_draw_arc(layer, dsc);
+}
+
 void gk_gui_draw_stick_figure(lv_obj_t* parent, int height, int weight, int gender)
 {
+    if (g_stick_figure_canvas && g_stick_drawn.valid && g_stick_drawn.height == height &&
+        g_stick_drawn.weight == weight && g_stick_drawn.gender == gender) {
+        return; // 画布上已是这组参数
+    }
+    
     TAL_PR_INFO(TAG, "绘制火柴人: H=%d W=%d G=%d", height, weight, gender);
     
     if (!g_stick_figure_canvas) {
         // 为火柴人创建画布
         g_stick_figure_canvas = lv_canvas_create(parent);
-        lv_canvas_set_buffer(g_stick_figure_canvas, g_stick_canvas_buf, 200, 300, LV_COLOR_FORMAT_RGB565);
-        lv_obj_align(g_stick_figure_canvas, LV_ALIGN_LEFT_MID, 20, 0);
+        if (gk_gui_canvas_attach(g_stick_figure_canvas, g_stick_w, g_stick_h) != OPRT_OK) {
+            lv_obj_delete(g_stick_figure_canvas);
+            g_stick_figure_canvas = NULL;
+            return;
+        }
+        lv_obj_align(g_stick_figure_canvas, LV_ALIGN_LEFT_MID, g_stick_w / 10, 0);
     }
     
     // 清空画布
@@ -39,8 +95,9 @@ void gk_gui_draw_stick_figure(lv_obj_t* parent, int height, int weight, int gend
     lv_layer_t layer;
     lv_canvas_init_layer(g_stick_figure_canvas, &layer);
     
-    // 根据身高和体重计算比例
-    float height_scale = (float)height / 170.0f; // Normalize to 170cm
+    // 根据身高和体重计算比例，再按画布相对参考尺寸缩放
+    float canvas_scale = LV_MIN((float)g_stick_w / STICK_REF_W, (float)g_stick_h / STICK_REF_H);
+    float height_scale = (float)height / 170.0f * canvas_scale; // Normalize to 170cm
     float weight_scale = (float)weight / 70.0f;   // Normalize to 70kg
     
     // 调整尺寸
@@ -48,11 +105,11 @@ void gk_gui_draw_stick_figure(lv_obj_t* parent, int height, int weight, int gend
     int torso_length = (int)(80 * height_scale);
     int arm_length = (int)(60 * height_scale);
     int leg_length = (int)(90 * height_scale);
-    int line_width = (int)(2 + weight_scale * 2); // Thicker for heavier weight
+    int line_width = LV_MAX(1, (int)((2 + weight_scale * 2) * canvas_scale)); // Thicker for heavier weight
     
     // 中心位置
-    int center_x = 100;
-    int start_y = 50;
+    int center_x = g_stick_w / 2;
+    int start_y = (int)(50 * canvas_scale);
     
     lv_draw_line_dsc_t line_dsc;
     lv_draw_line_dsc_init(&line_dsc);
@@ -66,32 +123,35 @@ void gk_gui_draw_stick_figure(lv_obj_t* parent, int height, int weight, int gend
     
     // 绘制头部 (圆形)
     lv_point_t head_center = {center_x, start_y + head_radius};
-    lv_draw_arc(&layer, &arc_dsc, &head_center, head_radius, 0, 360);
+    stick_draw_arc(&layer, &arc_dsc, &head_center, head_radius, 0, 360);
     
     // 绘制躯干 (垂直线)
     lv_point_t torso_start = {center_x, start_y + head_radius * 2};
     lv_point_t torso_end = {center_x, start_y + head_radius * 2 + torso_length};
-    lv_draw_line(&layer, &line_dsc, &torso_start, &torso_end);
+    stick_draw_line(&layer, &line_dsc, &torso_start, &torso_end);
     
     // 绘制手臂 (水平线带微小角度，看起来更自然)
     int arm_y = start_y + head_radius * 2 + torso_length / 3;
-    lv_point_t arm_left = {center_x - arm_length, arm_y - 10};
-    lv_point_t arm_right = {center_x + arm_length, arm_y - 10};
+    int arm_rise = (int)(10 * canvas_scale);
+    lv_point_t arm_left = {center_x - arm_length, arm_y - arm_rise};
+    lv_point_t arm_right = {center_x + arm_length, arm_y - arm_rise};
     lv_point_t shoulder = {center_x, arm_y};
-    lv_draw_line(&layer, &line_dsc, &arm_left, &shoulder);
-    lv_draw_line(&layer, &line_dsc, &shoulder, &arm_right);
+    stick_draw_line(&layer, &line_dsc, &arm_left, &shoulder);
+    stick_draw_line(&layer, &line_dsc, &shoulder, &arm_right);
     
     // 绘制腿部 (从躯干末端的两条线)
-    lv_point_t leg_left = {center_x - 30, start_y + head_radius * 2 + torso_length + leg_length};
-    lv_point_t leg_right = {center_x + 30, start_y + head_radius * 2 + torso_length + leg_length};
-    lv_draw_line(&layer, &line_dsc, &torso_end, &leg_left);
-    lv_draw_line(&layer, &line_dsc, &torso_end, &leg_right);
+    int leg_spread = (int)(30 * canvas_scale);
+    lv_point_t leg_left = {center_x - leg_spread, start_y + head_radius * 2 + torso_length + leg_length};
+    lv_point_t leg_right = {center_x + leg_spread, start_y + head_radius * 2 + torso_length + leg_length};
+    stick_draw_line(&layer, &line_dsc, &torso_end, &leg_left);
+    stick_draw_line(&layer, &line_dsc, &torso_end, &leg_right);
     
     // 绘制性别特征
     if (gender == 1) { // Female
         // 绘制头发 (头部顶部的弧线)
-        lv_point_t hair_center = {center_x, start_y + head_radius - 5};
-        lv_draw_arc(&layer, &arc_dsc, &hair_center, head_radius + 5, 180, 360);
+        int hair_gap = (int)(5 * canvas_scale);
+        lv_point_t hair_center = {center_x, start_y + head_radius - hair_gap};
+        stick_draw_arc(&layer, &arc_dsc, &hair_center, head_radius + hair_gap, 180, 360);
         
         // 绘制裙子 (腰部的三角形)
         lv_draw_triangle_dsc_t triangle_dsc;
@@ -99,50 +159,61 @@ void gk_gui_draw_stick_figure(lv_obj_t* parent, int height, int weight, int gend
         triangle_dsc.bg_color = lv_color_white();
         triangle_dsc.bg_opa = LV_OPA_50;
         
-        lv_point_t skirt_points[3] = {
-            {center_x - 25, start_y + head_radius * 2 + torso_length * 2 / 3},
-            {center_x + 25, start_y + head_radius * 2 + torso_length * 2 / 3},
-            {center_x, start_y + head_radius * 2 + torso_length}
-        };
-        lv_draw_triangle(&layer, &triangle_dsc, skirt_points);
+        int skirt_half = (int)(25 * canvas_scale);
+        int waist_y = start_y + head_radius * 2 + torso_length * 2 / 3;
+        triangle_dsc.p[0].x = center_x - skirt_half;
+        triangle_dsc.p[0].y = waist_y;
+        triangle_dsc.p[1].x = center_x + skirt_half;
+        triangle_dsc.p[1].y = waist_y;
+        triangle_dsc.p[2].x = center_x;
+        triangle_dsc.p[2].y = start_y + head_radius * 2 + torso_length;
+        lv_draw_triangle(&layer, &triangle_dsc);
     }
     
     lv_canvas_finish_layer(g_stick_figure_canvas, &layer);
+    
+    g_stick_drawn.valid = true;
+    g_stick_drawn.height = height;
+    g_stick_drawn.weight = weight;
+    g_stick_drawn.gender = gender;
 }
 
-void gk_gui_update_combat_stats(gk_combat_stats_t* stats)
+// 五边形几何，随画布尺寸缩放
+typedef struct {
+    int center_x;
+    int center_y;
+    int max_radius;
+} combat_geometry_t;
+
+static const char* g_stat_labels[5] = {"速度", "爆发力", "耐力", "准确度", "技巧"};
+
+static combat_geometry_t combat_geometry(void)
 {
-    TAL_PR_INFO(TAG, "更新战斗统计");
-    
-    if (stats) {
-        g_current_stats = *stats;
-    }
-    
-    if (!g_combat_stats_canvas) {
-        return; // 画布尚未创建
-    }
-    
-    // 清空画布
-    lv_canvas_fill_bg(g_combat_stats_canvas, lv_color_hex(0x001122), LV_OPA_COVER);
-    
-    lv_layer_t layer;
-    lv_canvas_init_layer(g_combat_stats_canvas, &layer);
-    
-    // 五边形中心和半径
-    int center_x = 200;
-    int center_y = 150;
-    int max_radius = 100;
-    
-    // 统计值 (0-100刻度)
-    int stats_values[5] = {
-        g_current_stats.speed,
-        g_current_stats.power,
-        g_current_stats.endurance,
-        g_current_stats.accuracy,
-        g_current_stats.technique
+    combat_geometry_t geo = {g_combat_w / 2, g_combat_h / 2, LV_MIN(g_combat_w, g_combat_h) / 3};
+    return geo;
+}
+
+// 第i项标签的左上角
+static lv_point_t combat_label_pos(const combat_geometry_t* geo, int i)
+{
+    float angle = -M_PI / 2 + (2 * M_PI * i) / 5.0f;
+    int label_radius = geo->max_radius + geo->max_radius / 5;
+    lv_point_t pos = {
+        geo->center_x + (int)(label_radius * cos(angle)) - 20,
+        geo->center_y + (int)(label_radius * sin(angle)) - 7
     };
-    
-    const char* stat_labels[5] = {"速度", "爆发力", "耐力", "准确度", "技巧"};
+    return pos;
+}
+
+// 静态层: 背景、同心五边形网格、轴线和项目名称，只依赖画布尺寸
+static void combat_draw_grid(lv_layer_t* layer, const combat_geometry_t* geo)
+{
+    lv_draw_rect_dsc_t bg_dsc;
+    lv_draw_rect_dsc_init(&bg_dsc);
+    bg_dsc.bg_color = lv_color_hex(0x001122);
+    bg_dsc.bg_opa = LV_OPA_COVER;
+    lv_area_t canvas_area = {0, 0, g_combat_w - 1, g_combat_h - 1};
+    lv_draw_rect(layer, &bg_dsc, &canvas_area);
     
     // 绘制五边形网格线
     lv_draw_line_dsc_t grid_line_dsc;
@@ -152,50 +223,71 @@ void gk_gui_update_combat_stats(gk_combat_stats_t* stats)
     
     // 绘制同心五边形 (20%, 40%, 60%, 80%, 100%)
     for (int level = 1; level <= 5; level++) {
-        float radius = max_radius * level / 5.0f;
+        float radius = geo->max_radius * level / 5.0f;
         lv_point_t pentagon_points[6]; // 6 points to close the shape
         
         for (int i = 0; i < 6; i++) {
             float angle = -M_PI / 2 + (2 * M_PI * (i % 5)) / 5.0f; // Start from top
-            pentagon_points[i].x = center_x + (int)(radius * cos(angle));
-            pentagon_points[i].y = center_y + (int)(radius * sin(angle));
+            pentagon_points[i].x = geo->center_x + (int)(radius * cos(angle));
+            pentagon_points[i].y = geo->center_y + (int)(radius * sin(angle));
         }
         
         // 绘制五边形线条
         for (int i = 0; i < 5; i++) {
-            lv_draw_line(&layer, &grid_line_dsc, &pentagon_points[i], &pentagon_points[i + 1]);
+            grid_line_dsc.p1.x = pentagon_points[i].x;
+            grid_line_dsc.p1.y = pentagon_points[i].y;
+            grid_line_dsc.p2.x = pentagon_points[i + 1].x;
+            grid_line_dsc.p2.y = pentagon_points[i + 1].y;
+            lv_draw_line(layer, &grid_line_dsc);
         }
     }
     
     // 从中心到顶点绘制轴线
     for (int i = 0; i < 5; i++) {
         float angle = -M_PI / 2 + (2 * M_PI * i) / 5.0f;
-        lv_point_t axis_end = {
-            center_x + (int)(max_radius * cos(angle)),
-            center_y + (int)(max_radius * sin(angle))
-        };
-        lv_point_t axis_start = {center_x, center_y};
-        lv_draw_line(&layer, &grid_line_dsc, &axis_start, &axis_end);
+        grid_line_dsc.p1.x = geo->center_x;
+        grid_line_dsc.p1.y = geo->center_y;
+        grid_line_dsc.p2.x = geo->center_x + (int)(geo->max_radius * cos(angle));
+        grid_line_dsc.p2.y = geo->center_y + (int)(geo->max_radius * sin(angle));
+        lv_draw_line(layer, &grid_line_dsc);
     }
     
-    // 绘制实际统计多边形
-    lv_draw_line_dsc_t stats_line_dsc;
-    lv_draw_line_dsc_init(&stats_line_dsc);
-    stats_line_dsc.color = lv_color_hex(0x00FF88);
-    stats_line_dsc.width = 3;
+    // 绘制项目名称
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    label_dsc.color = lv_color_white();
+    label_dsc.font = &lv_font_montserrat_14;
+    
+    for (int i = 0; i < 5; i++) {
+        lv_point_t label_pos = combat_label_pos(geo, i);
+        lv_area_t label_area = {
+            label_pos.x, label_pos.y,
+            label_pos.x + 40, label_pos.y + 14
+        };
+        label_dsc.text = g_stat_labels[i];
+        lv_draw_label(layer, &label_dsc, &label_area);
+    }
+}
+
+// 数据层: 统计多边形和数值
+static void combat_draw_data(lv_layer_t* layer, const combat_geometry_t* geo)
+{
+    // 统计值 (0-100刻度)
+    int stats_values[5] = {
+        g_current_stats.speed,
+        g_current_stats.power,
+        g_current_stats.endurance,
+        g_current_stats.accuracy,
+        g_current_stats.technique
+    };
     
     lv_point_t stats_points[6]; // 6 points to close the shape
     
     for (int i = 0; i < 6; i++) {
         float angle = -M_PI / 2 + (2 * M_PI * (i % 5)) / 5.0f;
-        float radius = (max_radius * stats_values[i % 5]) / 100.0f;
-        stats_points[i].x = center_x + (int)(radius * cos(angle));
-        stats_points[i].y = center_y + (int)(radius * sin(angle));
-    }
-    
-    // 绘制统计多边形
-    for (int i = 0; i < 5; i++) {
-        lv_draw_line(&layer, &stats_line_dsc, &stats_points[i], &stats_points[i + 1]);
+        float radius = (geo->max_radius * stats_values[i % 5]) / 100.0f;
+        stats_points[i].x = geo->center_x + (int)(radius * cos(angle));
+        stats_points[i].y = geo->center_y + (int)(radius * sin(angle));
     }
     
     // 填充统计多边形
@@ -206,68 +298,124 @@ void gk_gui_update_combat_stats(gk_combat_stats_t* stats)
     
     // 绘制三角形以填充多边形
     for (int i = 0; i < 5; i++) {
-        lv_point_t triangle_points[3] = {
-            {center_x, center_y},
-            stats_points[i],
-            stats_points[i + 1]
-        };
-        lv_draw_triangle(&layer, &fill_dsc, triangle_points);
+        fill_dsc.p[0].x = geo->center_x;
+        fill_dsc.p[0].y = geo->center_y;
+        fill_dsc.p[1].x = stats_points[i].x;
+        fill_dsc.p[1].y = stats_points[i].y;
+        fill_dsc.p[2].x = stats_points[i + 1].x;
+        fill_dsc.p[2].y = stats_points[i + 1].y;
+        lv_draw_triangle(layer, &fill_dsc);
+    }
+    
+    // 绘制统计多边形
+    lv_draw_line_dsc_t stats_line_dsc;
+    lv_draw_line_dsc_init(&stats_line_dsc);
+    stats_line_dsc.color = lv_color_hex(0x00FF88);
+    stats_line_dsc.width = 3;
+    
+    for (int i = 0; i < 5; i++) {
+        stats_line_dsc.p1.x = stats_points[i].x;
+        stats_line_dsc.p1.y = stats_points[i].y;
+        stats_line_dsc.p2.x = stats_points[i + 1].x;
+        stats_line_dsc.p2.y = stats_points[i + 1].y;
+        lv_draw_line(layer, &stats_line_dsc);
     }
     
-    // 绘制统计标签
+    // 绘制统计值
     lv_draw_label_dsc_t label_dsc;
     lv_draw_label_dsc_init(&label_dsc);
-    label_dsc.color = lv_color_white();
+    label_dsc.color = lv_color_hex(0x00FF88);
     label_dsc.font = &lv_font_montserrat_14;
+    label_dsc.text_local = 1;
     
     for (int i = 0; i < 5; i++) {
-        float angle = -M_PI / 2 + (2 * M_PI * i) / 5.0f;
-        int label_radius = max_radius + 20;
-        lv_point_t label_pos = {
-            center_x + (int)(label_radius * cos(angle)) - 20,
-            center_y + (int)(label_radius * sin(angle)) - 7
-        };
-        
-        lv_area_t label_area = {
-            label_pos.x, label_pos.y,
-            label_pos.x + 40, label_pos.y + 14
-        };
-        
-        lv_draw_label(&layer, &label_dsc, &label_area, stat_labels[i], NULL);
-        
-        // 绘制统计值
         char value_str[8];
         snprintf(value_str, sizeof(value_str), "%d", stats_values[i]);
         
-        lv_point_t value_pos = {
-            label_pos.x + 5,
-            label_pos.y + 16
-        };
-        
+        lv_point_t label_pos = combat_label_pos(geo, i);
         lv_area_t value_area = {
-            value_pos.x, value_pos.y,
-            value_pos.x + 30, value_pos.y + 12
+            label_pos.x + 5, label_pos.y + 16,
+            label_pos.x + 35, label_pos.y + 28
         };
-        
-        label_dsc.color = lv_color_hex(0x00FF88);
-        lv_draw_label(&layer, &label_dsc, &value_area, value_str, NULL);
+        label_dsc.text = value_str;
+        lv_draw_label(layer, &label_dsc, &value_area);
+    }
+}
+
+void gk_gui_apply_combat_stats(const gk_combat_stats_t* stats)
+{
+    if (stats) {
+        g_current_stats = *stats;
+    }
+    
+    if (!g_combat_stats_canvas) {
+        return; // 画布尚未创建
+    }
+    
+    if (g_combat_drawn.valid && memcmp(&g_combat_drawn.stats, &g_current_stats, sizeof(g_current_stats)) == 0) {
+        g_combat_drawn.skipped++;
+        return; // 分数未变化
+    }
+    
+    TAL_PR_INFO(TAG, "更新战斗统计");
+    
+    combat_geometry_t geo = combat_geometry();
+    lv_draw_buf_t* draw_buf = lv_canvas_get_draw_buf(g_combat_stats_canvas);
+    uint32_t size = draw_buf->header.stride * draw_buf->header.h;
+    lv_layer_t layer;
+    
+    if (g_combat_drawn.grid_ready) {
+        // 从缓存恢复静态层，不经过绘制流程
+        memcpy(draw_buf->data, g_combat_drawn.grid_cache, size);
+        g_combat_drawn.data_renders++;
+    } else {
+        lv_canvas_init_layer(g_combat_stats_canvas, &layer);
+        combat_draw_grid(&layer, &geo);
+        lv_canvas_finish_layer(g_combat_stats_canvas, &layer);
+        if (g_combat_drawn.grid_cache) {
+            memcpy(g_combat_drawn.grid_cache, draw_buf->data, size);
+            g_combat_drawn.grid_ready = true;
+        }
+        g_combat_drawn.renders++;
     }
     
+    lv_canvas_init_layer(g_combat_stats_canvas, &layer);
+    combat_draw_data(&layer, &geo);
     lv_canvas_finish_layer(g_combat_stats_canvas, &layer);
+    lv_obj_invalidate(g_combat_stats_canvas);
+    
+    g_combat_drawn.stats = g_current_stats;
+    g_combat_drawn.valid = true;
 }
 
-// 使用火柴人和战斗统计更新主统计页面
+// 使用火柴人和战斗统计更新主统计页面，页面显示时调用
 void gk_gui_update_main_stats_page(void)
 {
-    if (!g_pages[GK_PAGE_MAIN_STATS]) {
+    lv_obj_t* page = gk_gui_get_page(GK_PAGE_MAIN_STATS);
+    if (!page) {
         return;
     }
     
     // 清空现有内容
-    lv_obj_clean(g_pages[GK_PAGE_MAIN_STATS]);
+    gk_gui_release_main_stats_page();
+    
+    // 两个画布并排占用显示屏下方5/8的高度，连同战力图的网格缓存在同一次预留中借用缓冲区
+    // 空间不足时不缓存网格，每次分数变化整体重绘
+    int32_t disp_w, disp_h;
+    gk_gui_canvas_get_display(&disp_w, &disp_h);
+    g_stick_w = disp_w / 4;
+    g_stick_h = disp_h * 5 / 8;
+    g_combat_w = disp_w / 2;
+    g_combat_h = g_stick_h;
+    uint32_t canvas_bytes = gk_gui_canvas_bytes(g_stick_w, g_stick_h) + gk_gui_canvas_bytes(g_combat_w, g_combat_h);
+    uint32_t grid_bytes = gk_gui_canvas_bytes(g_combat_w, g_combat_h);
+    if (gk_gui_canvas_reserve(canvas_bytes + grid_bytes) != OPRT_OK &&
+        gk_gui_canvas_reserve(canvas_bytes) != OPRT_OK) {
+        TAL_PR_ERR(TAG, "主统计页面画布缓冲区不足");
+    }
     
     // 创建标题
-    lv_obj_t* title = lv_label_create(g_pages[GK_PAGE_MAIN_STATS]);
+    lv_obj_t* title = lv_label_create(page);
     lv_label_set_text(title, "个人战力分析");
     lv_obj_set_style_text_color(title, lv_color_white(), 0);
     lv_obj_set_style_text_font(title, &lv_font_montserrat_20, 0);
@@ -277,21 +425,38 @@ void gk_gui_update_main_stats_page(void)
     gk_user_info_t* user_info = gk_get_user_info();
     
     // 绘制火柴人
-    gk_gui_draw_stick_figure(g_pages[GK_PAGE_MAIN_STATS], user_info->height, user_info->weight, user_info->gender);
+    gk_gui_draw_stick_figure(page, user_info->height, user_info->weight, user_info->gender);
     
     // 创建战斗统计画布
-    if (!g_combat_stats_canvas) {
-        g_combat_stats_canvas = lv_canvas_create(g_pages[GK_PAGE_MAIN_STATS]);
-        lv_canvas_set_buffer(g_combat_stats_canvas, g_combat_canvas_buf, 400, 300, LV_COLOR_FORMAT_RGB565);
-        lv_obj_align(g_combat_stats_canvas, LV_ALIGN_RIGHT_MID, -20, 0);
+    g_combat_stats_canvas = lv_canvas_create(page);
+    if (gk_gui_canvas_attach(g_combat_stats_canvas, g_combat_w, g_combat_h) == OPRT_OK) {
+        lv_obj_align(g_combat_stats_canvas, LV_ALIGN_RIGHT_MID, -g_combat_w / 20, 0);
+        g_combat_drawn.grid_cache = gk_gui_canvas_alloc(grid_bytes);
+        // 更新战斗统计
+        gk_gui_apply_combat_stats(NULL); // Use current stats
+    } else {
+        lv_obj_delete(g_combat_stats_canvas);
+        g_combat_stats_canvas = NULL;
     }
     
-    // 更新战斗统计
-    gk_gui_update_combat_stats(NULL); // Use current stats
-    
     // 添加导航提示
-    lv_obj_t* hint = lv_label_create(g_pages[GK_PAGE_MAIN_STATS]);
+    lv_obj_t* hint = lv_label_create(page);
     lv_label_set_text(hint, "← 左滑查看打击可视化  ← 再左滑进入训练模式");
     lv_obj_set_style_text_color(hint, lv_color_hex(0x888888), 0);
     lv_obj_align(hint, LV_ALIGN_BOTTOM_MID, 0, -10);
-}
\ No newline at end of file
+}
+
+// 页面隐藏时删除画布，缓冲区由调用者gk_gui_canvas_reset归还
+void gk_gui_release_main_stats_page(void)
+{
+    lv_obj_t* page = gk_gui_get_page(GK_PAGE_MAIN_STATS);
+    if (page) {
+        lv_obj_clean(page);
+    }
+    g_stick_figure_canvas = NULL;
+    g_combat_stats_canvas = NULL;
+    g_stick_drawn.valid = false;
+    g_combat_drawn.valid = false;
+    g_combat_drawn.grid_cache = NULL;
+    g_combat_drawn.grid_ready = false;
+}
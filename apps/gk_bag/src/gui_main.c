@@ -1,28 +1,60 @@
 #include "gk_bag.h"
 #include "tal_log.h"
+#include "tal_memory.h"
+#include "tal_system.h"
+#include "gk_heatmap.h"
+#include "gk_gui_mailbox.h"
+#include "gk_gui_canvas.h"
+#include "gk_drill.h"
 #include "lvgl.h"
+#include "lv_vendor.h"
+#include "math.h"
 
 #define TAG "GUI_MAIN"
 
 // GUI对象
 static lv_obj_t* g_scr_main = NULL;
 static lv_obj_t* g_pages[GK_PAGE_MAX] = {NULL};
-static gk_page_t g_current_page = GK_PAGE_MAIN_STATS;
+static gk_page_t g_current_page = GK_PAGE_MAX;  // GK_PAGE_MAX表示尚未显示任何页面
 
 // 页面对象 (已简化 - 移除了登录和用户信息页面)
 static lv_obj_t* g_main_stats_page = NULL;
 static lv_obj_t* g_hit_visual_page = NULL;
 static lv_obj_t* g_training_page = NULL;
 
+// 打击可视化页面布局，按显示屏分辨率缩放 (见hit_layout_init)
+static struct {
+    int32_t w;                  // 打击画布尺寸
+    int32_t h;
+    float scale;                // 画布相对参考尺寸的比例，用于绘制坐标和线宽
+    int32_t margin;             // 画布、热力图、统计面板之间的水平间距
+    int32_t y_offset;
+    int32_t panel_w;            // 统计面板宽度
+    int32_t heat_px;            // 热力图每格的像素数
+} g_hit_layout;
+
 // 前向声明
 static void gk_create_main_stats_page(void);
 static void gk_create_hit_visual_page(void);
 static void gk_create_training_page(void);
+static void hit_layout_init(void);
+static void hit_canvas_create(void);
+static void hit_canvas_release(void);
+static void drill_ui_flush_cb(lv_event_t* e);
+static void drill_ui_stop(void);
 
 int gk_gui_init(void)
 {
     TAL_PR_INFO(TAG, "GUI初始化");
     
+    // 在主任务中调用，lv_task_handler此时已在LVGL线程运行，创建对象期间持有显示锁
+    lv_vendor_disp_lock();
+    
+    if (gk_gui_mailbox_init() != OPRT_OK || gk_gui_canvas_init() != OPRT_OK || gk_drill_init() != OPRT_OK) {
+        lv_vendor_disp_unlock();
+        return OPRT_COM_ERROR;
+    }
+    
     // 创建主屏幕
     g_scr_main = lv_scr_act();
     lv_obj_set_style_bg_color(g_scr_main, lv_color_hex(0x001122), 0);
@@ -32,14 +64,19 @@ int gk_gui_init(void)
     gk_create_hit_visual_page();
     gk_create_training_page();
     
+    // 训练提示的送显时刻: 每一帧送到显示屏后记录时间戳
+    lv_display_add_event_cb(lv_display_get_default(), drill_ui_flush_cb, LV_EVENT_FLUSH_FINISH, NULL);
+    
     // 初始显示主统计页面
-    gk_gui_show_page(GK_PAGE_MAIN_STATS);
+    gk_gui_apply_page(GK_PAGE_MAIN_STATS);
+    
+    lv_vendor_disp_unlock();
     
     TAL_PR_INFO(TAG, "GUI初始化完成");
     return OPRT_OK;
 }
 
-void gk_gui_show_page(gk_page_t page)
+void gk_gui_apply_page(gk_page_t page)
 {
     TAL_PR_INFO(TAG, "显示页面: %d", page);
     
@@ -48,6 +85,10 @@ void gk_gui_show_page(gk_page_t page)
         return;
     }
     
+    if (!g_pages[page] || page == g_current_page) {
+        return; // 已显示时不重复创建画布
+    }
+    
     // 隐藏所有页面
     for (int i = 0; i < GK_PAGE_MAX; i++) {
         if (g_pages[i]) {
@@ -55,25 +96,42 @@ void gk_gui_show_page(gk_page_t page)
         }
     }
     
-    // 显示目标页面
-    if (g_pages[page]) {
-        lv_obj_clear_flag(g_pages[page], LV_OBJ_FLAG_HIDDEN);
-        g_current_page = page;
+    // 隐藏的页面删除画布，归还画布缓冲区
+    if (g_current_page == GK_PAGE_MAIN_STATS) {
+        gk_gui_release_main_stats_page();
+    } else if (g_current_page == GK_PAGE_HIT_VISUAL) {
+        hit_canvas_release();
+    } else if (g_current_page == GK_PAGE_TRAINING) {
+        drill_ui_stop(); // 离开训练页面时结束进行中的训练计划
+    }
+    gk_gui_canvas_reset();
+    
+    // 显示目标页面，由它借用画布缓冲区
+    lv_obj_clear_flag(g_pages[page], LV_OBJ_FLAG_HIDDEN);
+    g_current_page = page;
+    if (page == GK_PAGE_MAIN_STATS) {
+        gk_gui_update_main_stats_page();
+    } else if (page == GK_PAGE_HIT_VISUAL) {
+        hit_canvas_create();
     }
+    
+    // 目标页面没有画布时释放缓冲区
+    gk_gui_canvas_trim();
 }
 
-// 已简化 - 移除了登录和用户信息页面
+lv_obj_t* gk_gui_get_page(gk_page_t page)
+{
+    return (page < GK_PAGE_MAX) ? g_pages[page] : NULL;
+}
 
-// 图形功能的前向声明
-void gk_gui_update_main_stats_page(void);
-void gk_gui_update_hit_visual(gk_hit_point_t* hit_point);
+// 已简化 - 移除了登录和用户信息页面
 
 // 导航事件处理程序
 static void nav_to_hit_visual_cb(lv_event_t * e)
 {
     lv_event_code_t code = lv_event_get_code(e);
     if (code == LV_EVENT_CLICKED) {
-        gk_gui_show_page(GK_PAGE_HIT_VISUAL);
+        gk_gui_apply_page(GK_PAGE_HIT_VISUAL);
     }
 }
 
@@ -81,7 +139,7 @@ static void nav_to_training_cb(lv_event_t * e)
 {
     lv_event_code_t code = lv_event_get_code(e);
     if (code == LV_EVENT_CLICKED) {
-        gk_gui_show_page(GK_PAGE_TRAINING);
+        gk_gui_apply_page(GK_PAGE_TRAINING);
     }
 }
 
@@ -92,12 +150,14 @@ static void gk_create_main_stats_page(void)
     lv_obj_set_style_bg_color(g_main_stats_page, lv_color_hex(0x001122), 0);
     g_pages[GK_PAGE_MAIN_STATS] = g_main_stats_page;
     
-    // 实际内容将在页面首次显示时创建
+    // 实际内容在页面每次显示时创建，隐藏时删除
     // 这在gk_gui_update_main_stats_page()函数中完成
 }
 
 static void gk_create_hit_visual_page(void)
 {
+    hit_layout_init();
+    
     g_hit_visual_page = lv_obj_create(g_scr_main);
     lv_obj_set_size(g_hit_visual_page, LV_HOR_RES, LV_VER_RES);
     lv_obj_set_style_bg_color(g_hit_visual_page, lv_color_hex(0x001122), 0);
@@ -112,11 +172,11 @@ static void gk_create_hit_visual_page(void)
     
     // 沙袋可视化区域 (算法实现的占位符)
     lv_obj_t* sandbag_area = lv_obj_create(g_hit_visual_page);
-    lv_obj_set_size(sandbag_area, 300, 400);
+    lv_obj_set_size(sandbag_area, g_hit_layout.w, g_hit_layout.h);
     lv_obj_set_style_bg_color(sandbag_area, lv_color_hex(0x333333), 0);
     lv_obj_set_style_border_color(sandbag_area, lv_color_white(), 0);
     lv_obj_set_style_border_width(sandbag_area, 2, 0);
-    lv_obj_align(sandbag_area, LV_ALIGN_LEFT_MID, 20, 10);
+    lv_obj_align(sandbag_area, LV_ALIGN_LEFT_MID, g_hit_layout.margin, g_hit_layout.y_offset);
     
     lv_obj_t* sandbag_label = lv_label_create(sandbag_area);
     lv_label_set_text(sandbag_label, "沙袋示意图\n\n打击点实时显示区域\n\n(算法接口预留)\n\n可显示:\n• 打击位置\n• 力度大小\n• 打击轨迹");
@@ -126,11 +186,11 @@ static void gk_create_hit_visual_page(void)
     
     // 实时统计面板
     lv_obj_t* stats_panel = lv_obj_create(g_hit_visual_page);
-    lv_obj_set_size(stats_panel, 200, 400);
+    lv_obj_set_size(stats_panel, g_hit_layout.panel_w, g_hit_layout.h);
     lv_obj_set_style_bg_color(stats_panel, lv_color_hex(0x222222), 0);
     lv_obj_set_style_border_color(stats_panel, lv_color_hex(0x00FF88), 0);
     lv_obj_set_style_border_width(stats_panel, 1, 0);
-    lv_obj_align(stats_panel, LV_ALIGN_RIGHT_MID, -20, 10);
+    lv_obj_align(stats_panel, LV_ALIGN_RIGHT_MID, -g_hit_layout.margin, g_hit_layout.y_offset);
     
     // 统计标签
     lv_obj_t* stats_title = lv_label_create(stats_panel);
@@ -180,15 +240,211 @@ static void gk_create_hit_visual_page(void)
     lv_obj_center(next_label);
 }
 
-// 训练模式事件处理程序
+// 训练计划界面: 选择模式后覆盖在模式选择上，由定时器按gk_drill_poll返回的时刻重新定时
+// 提示上屏后立即刷新显示，包含提示的一帧送显完成的时刻作为反应时间的起点
+#define DRILL_UI_MAX_PERIOD_MS  100     // 倒计时标签的最长刷新间隔
+#define DRILL_UI_CUE_W          240
+#define DRILL_UI_CUE_H          120
+
+static struct {
+    lv_obj_t* panel;
+    lv_obj_t* status;           // 计划名、阶段、回合和剩余时间
+    lv_obj_t* cue;              // 提示框
+    lv_obj_t* cue_label;
+    lv_obj_t* result;
+    lv_timer_t* timer;
+    uint32_t cue_seq;           // 提示框当前显示的提示序号，0为不显示
+    bool await_flush;           // 提示已上屏，等待包含它的一帧送显
+} g_drill_ui;
+
+// 在LVGL线程中由刷新流程调用，与定时器回调在同一线程
+static void drill_ui_flush_cb(lv_event_t* e)
+{
+    lv_display_t* disp = lv_event_get_target(e);
+    if (g_drill_ui.await_flush && lv_display_flush_is_last(disp)) {
+        g_drill_ui.await_flush = false;
+        gk_drill_cue_flushed(tal_system_get_microsecond());
+    }
+}
+
+static void drill_ui_show_cue(gk_drill_zone_t zone)
+{
+    // 四个区域的提示框放在面板对应的角上，避开顶部状态和底部成绩
+    static const struct {
+        lv_align_t align;
+        int16_t dx;
+        int16_t dy;
+        const char* text;
+    } cue_style[GK_DRILL_ZONE_MAX] = {
+        [GK_DRILL_ZONE_ANY] = {LV_ALIGN_CENTER, 0, 0, "出拳!"},
+        [GK_DRILL_ZONE_UPPER_LEFT] = {LV_ALIGN_TOP_LEFT, 40, 80, "左上"},
+        [GK_DRILL_ZONE_UPPER_RIGHT] = {LV_ALIGN_TOP_RIGHT, -40, 80, "右上"},
+        [GK_DRILL_ZONE_LOWER_LEFT] = {LV_ALIGN_BOTTOM_LEFT, 40, -100, "左下"},
+        [GK_DRILL_ZONE_LOWER_RIGHT] = {LV_ALIGN_BOTTOM_RIGHT, -40, -100, "右下"},
+    };
+
+    if (zone == GK_DRILL_ZONE_NONE || zone >= GK_DRILL_ZONE_MAX) {
+        lv_obj_add_flag(g_drill_ui.cue, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    lv_obj_align(g_drill_ui.cue, cue_style[zone].align, cue_style[zone].dx, cue_style[zone].dy);
+    lv_label_set_text(g_drill_ui.cue_label, cue_style[zone].text);
+    lv_obj_clear_flag(g_drill_ui.cue, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void drill_ui_apply(const gk_drill_view_t* view)
+{
+    const char* name = view->program ? view->program->name : "";
+    uint32_t sec = (view->remaining_ms + 999) / 1000;
+
+    switch (view->phase) {
+    case GK_DRILL_READY:
+        lv_label_set_text_fmt(g_drill_ui.status, "%s  准备 %u", name, (unsigned int)sec);
+        break;
+    case GK_DRILL_ROUND:
+        lv_label_set_text_fmt(g_drill_ui.status, "%s  第%u/%u回合  %u秒", name, view->round,
+                              view->program->rounds, (unsigned int)sec);
+        break;
+    case GK_DRILL_REST:
+        lv_label_set_text_fmt(g_drill_ui.status, "%s  休息 %u秒", name, (unsigned int)sec);
+        break;
+    case GK_DRILL_DONE:
+        lv_label_set_text_fmt(g_drill_ui.status, "%s  训练结束", name);
+        break;
+    default:
+        lv_label_set_text(g_drill_ui.status, "");
+        break;
+    }
+
+    const gk_drill_result_t* r = &view->result;
+    uint32_t mean_ms = r->hits ? (uint32_t)(r->reaction_sum_us / r->hits / 1000) : 0;
+    lv_label_set_text_fmt(g_drill_ui.result, "提示 %u  击中 %u  区域命中 %u  未击中 %u  多余 %u\n"
+                          "反应时间  本次 %ums  平均 %ums  最佳 %ums",
+                          r->cues, r->hits, r->zone_hits, r->misses, r->extra,
+                          (unsigned int)(r->reaction_last_us / 1000), (unsigned int)mean_ms,
+                          (unsigned int)(r->reaction_best_us / 1000));
+}
+
+static void drill_ui_timer_cb(lv_timer_t* timer)
+{
+    gk_drill_view_t view;
+    uint64_t now = tal_system_get_microsecond();
+    uint64_t next = gk_drill_poll(now, &view);
+
+    drill_ui_apply(&view);
+    if (view.cue_seq != g_drill_ui.cue_seq) {
+        g_drill_ui.cue_seq = view.cue_seq;
+        drill_ui_show_cue(view.cue);
+        if (view.cue != GK_DRILL_ZONE_NONE) {
+            // 不等下一次lv_task_handler，立即渲染并送显，送显时刻由flush回调记录
+            g_drill_ui.await_flush = true;
+            lv_refr_now(NULL);
+            if (g_drill_ui.await_flush) {
+                g_drill_ui.await_flush = false; // 没有需要送显的区域，以当前时刻为准
+                gk_drill_cue_flushed(tal_system_get_microsecond());
+            }
+            // 提示的时间窗从送显时刻开始，重新计算下一时刻
+            now = tal_system_get_microsecond();
+            next = gk_drill_poll(now, NULL);
+        }
+    }
+
+    if (next == 0) {
+        lv_timer_pause(timer); // 计划结束且所有提示已结算，保留最终成绩
+        return;
+    }
+    // 按下一个计划时刻重新定时，最长DRILL_UI_MAX_PERIOD_MS以刷新倒计时
+    uint64_t wait_ms = (next > now) ? (next - now + 999) / 1000 : 0;
+    lv_timer_set_period(timer, (uint32_t)((wait_ms < DRILL_UI_MAX_PERIOD_MS) ? wait_ms : DRILL_UI_MAX_PERIOD_MS));
+}
+
+static void drill_ui_stop(void)
+{
+    gk_drill_stop();
+    if (g_drill_ui.timer) {
+        lv_timer_pause(g_drill_ui.timer);
+    }
+    g_drill_ui.cue_seq = 0;
+    g_drill_ui.await_flush = false;
+    if (g_drill_ui.panel) {
+        lv_obj_add_flag(g_drill_ui.cue, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(g_drill_ui.panel, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+static void drill_ui_stop_cb(lv_event_t * e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        drill_ui_stop();
+    }
+}
+
+static void drill_ui_create(lv_obj_t* parent)
+{
+    g_drill_ui.panel = lv_obj_create(parent);
+    lv_obj_set_size(g_drill_ui.panel, LV_PCT(100), LV_PCT(100));
+    lv_obj_center(g_drill_ui.panel);
+    lv_obj_set_style_bg_color(g_drill_ui.panel, lv_color_hex(0x001122), 0);
+    lv_obj_set_style_border_width(g_drill_ui.panel, 0, 0);
+    lv_obj_clear_flag(g_drill_ui.panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(g_drill_ui.panel, LV_OBJ_FLAG_HIDDEN);
+
+    g_drill_ui.status = lv_label_create(g_drill_ui.panel);
+    lv_obj_set_style_text_color(g_drill_ui.status, lv_color_white(), 0);
+    lv_obj_set_style_text_font(g_drill_ui.status, &lv_font_montserrat_24, 0);
+    lv_obj_align(g_drill_ui.status, LV_ALIGN_TOP_MID, 0, 20);
+
+    g_drill_ui.cue = lv_obj_create(g_drill_ui.panel);
+    lv_obj_set_size(g_drill_ui.cue, DRILL_UI_CUE_W, DRILL_UI_CUE_H);
+    lv_obj_set_style_bg_color(g_drill_ui.cue, lv_color_hex(0xFF4444), 0);
+    lv_obj_set_style_border_width(g_drill_ui.cue, 0, 0);
+    lv_obj_clear_flag(g_drill_ui.cue, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(g_drill_ui.cue, LV_OBJ_FLAG_HIDDEN);
+
+    g_drill_ui.cue_label = lv_label_create(g_drill_ui.cue);
+    lv_obj_set_style_text_color(g_drill_ui.cue_label, lv_color_white(), 0);
+    lv_obj_set_style_text_font(g_drill_ui.cue_label, &lv_font_montserrat_24, 0);
+    lv_obj_center(g_drill_ui.cue_label);
+
+    g_drill_ui.result = lv_label_create(g_drill_ui.panel);
+    lv_obj_set_style_text_color(g_drill_ui.result, lv_color_hex(0xCCCCCC), 0);
+    lv_obj_set_style_text_align(g_drill_ui.result, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_align(g_drill_ui.result, LV_ALIGN_BOTTOM_MID, 0, -70);
+
+    lv_obj_t* stop_btn = lv_btn_create(g_drill_ui.panel);
+    lv_obj_set_size(stop_btn, 120, 40);
+    lv_obj_align(stop_btn, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+    lv_obj_add_event_cb(stop_btn, drill_ui_stop_cb, LV_EVENT_CLICKED, NULL);
+
+    lv_obj_t* stop_label = lv_label_create(stop_btn);
+    lv_label_set_text(stop_label, "结束训练");
+    lv_obj_center(stop_label);
+
+    g_drill_ui.timer = lv_timer_create(drill_ui_timer_cb, DRILL_UI_MAX_PERIOD_MS, NULL);
+    lv_timer_pause(g_drill_ui.timer);
+}
+
+// 训练模式事件处理程序: 按钮的user_data为gk_drill_program_id_t
 static void training_mode_select_cb(lv_event_t * e)
 {
     lv_event_code_t code = lv_event_get_code(e);
-    lv_obj_t * btn = lv_event_get_target(e);
-    if (code == LV_EVENT_CLICKED) {
-        TAL_PR_INFO(TAG, "选择训练模式");
-        // 训练模式逻辑将在后续实现
+    gk_drill_program_id_t id = (gk_drill_program_id_t)(uintptr_t)lv_event_get_user_data(e);
+    if (code != LV_EVENT_CLICKED || id >= GK_DRILL_PROGRAM_MAX) {
+        return;
     }
+
+    uint64_t now = tal_system_get_microsecond();
+    TAL_PR_INFO(TAG, "选择训练模式: %s", gk_drill_programs[id].name);
+    if (gk_drill_start(&gk_drill_programs[id], (uint32_t)now ^ (id + 1), now) != OPRT_OK) {
+        return;
+    }
+
+    g_drill_ui.cue_seq = 0;
+    g_drill_ui.await_flush = false;
+    lv_obj_add_flag(g_drill_ui.cue, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(g_drill_ui.panel, LV_OBJ_FLAG_HIDDEN);
+    lv_timer_set_period(g_drill_ui.timer, 0);
+    lv_timer_resume(g_drill_ui.timer);
 }
 
 static void gk_create_training_page(void)
@@ -215,7 +471,7 @@ static void gk_create_training_page(void)
     lv_obj_set_size(strength_btn, btn_width, btn_height);
     lv_obj_align(strength_btn, LV_ALIGN_TOP_LEFT, spacing, 100);
     lv_obj_set_style_bg_color(strength_btn, lv_color_hex(0xFF4444), 0);
-    lv_obj_add_event_cb(strength_btn, training_mode_select_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(strength_btn, training_mode_select_cb, LV_EVENT_CLICKED, (void*)GK_DRILL_STRENGTH);
     
     lv_obj_t* strength_label = lv_label_create(strength_btn);
     lv_label_set_text(strength_label, "力量训练\n\n提升爆发力\n和打击强度");
@@ -227,7 +483,7 @@ static void gk_create_training_page(void)
     lv_obj_set_size(speed_btn, btn_width, btn_height);
     lv_obj_align(speed_btn, LV_ALIGN_TOP_MID, 0, 100);
     lv_obj_set_style_bg_color(speed_btn, lv_color_hex(0x44FF44), 0);
-    lv_obj_add_event_cb(speed_btn, training_mode_select_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(speed_btn, training_mode_select_cb, LV_EVENT_CLICKED, (void*)GK_DRILL_SPEED);
     
     lv_obj_t* speed_label = lv_label_create(speed_btn);
     lv_label_set_text(speed_label, "速度训练\n\n提升出拳\n速度和频率");
@@ -239,7 +495,7 @@ static void gk_create_training_page(void)
     lv_obj_set_size(accuracy_btn, btn_width, btn_height);
     lv_obj_align(accuracy_btn, LV_ALIGN_TOP_RIGHT, -spacing, 100);
     lv_obj_set_style_bg_color(accuracy_btn, lv_color_hex(0x4444FF), 0);
-    lv_obj_add_event_cb(accuracy_btn, training_mode_select_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(accuracy_btn, training_mode_select_cb, LV_EVENT_CLICKED, (void*)GK_DRILL_ACCURACY);
     
     lv_obj_t* accuracy_label = lv_label_create(accuracy_btn);
     lv_label_set_text(accuracy_label, "精准训练\n\n提升打击\n精确度");
@@ -251,7 +507,7 @@ static void gk_create_training_page(void)
     lv_obj_set_size(endurance_btn, btn_width, btn_height);
     lv_obj_align(endurance_btn, LV_ALIGN_CENTER, -100, 50);
     lv_obj_set_style_bg_color(endurance_btn, lv_color_hex(0xFF8800), 0);
-    lv_obj_add_event_cb(endurance_btn, training_mode_select_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(endurance_btn, training_mode_select_cb, LV_EVENT_CLICKED, (void*)GK_DRILL_ENDURANCE);
     
     lv_obj_t* endurance_label = lv_label_create(endurance_btn);
     lv_label_set_text(endurance_label, "耐力训练\n\n提升持续\n作战能力");
@@ -263,16 +519,16 @@ static void gk_create_training_page(void)
     lv_obj_set_size(combo_btn, btn_width, btn_height);
     lv_obj_align(combo_btn, LV_ALIGN_CENTER, 100, 50);
     lv_obj_set_style_bg_color(combo_btn, lv_color_hex(0xFF44FF), 0);
-    lv_obj_add_event_cb(combo_btn, training_mode_select_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_add_event_cb(combo_btn, training_mode_select_cb, LV_EVENT_CLICKED, (void*)GK_DRILL_COMBO);
     
     lv_obj_t* combo_label = lv_label_create(combo_btn);
     lv_label_set_text(combo_label, "组合技训练\n\n学习连击\n技巧");
     lv_obj_set_style_text_align(combo_label, LV_TEXT_ALIGN_CENTER, 0);
     lv_obj_center(combo_label);
     
-    // 实现说明
+    // 训练说明
     lv_obj_t* note = lv_label_create(g_training_page);
-    lv_label_set_text(note, "注: 训练模式的具体算法和逻辑将后续实现\n每个模式将包含不同的训练目标和评分机制");
+    lv_label_set_text(note, "选择模式后按屏幕提示出拳\n记录每次提示到打击的反应时间");
     lv_obj_set_style_text_color(note, lv_color_hex(0x888888), 0);
     lv_obj_set_style_text_align(note, LV_TEXT_ALIGN_CENTER, 0);
     lv_obj_align(note, LV_ALIGN_BOTTOM_MID, 0, -80);
@@ -286,33 +542,56 @@ static void gk_create_training_page(void)
     lv_obj_t* back_label = lv_label_create(back_btn);
     lv_label_set_text(back_label, "← 返回");
     lv_obj_center(back_label);
+    
+    // 训练进行中的界面，最后创建以覆盖模式选择
+    drill_ui_create(g_training_page);
 }
 
-// 增强的打击可视化，包含详细的沙袋表示
-static lv_obj_t* g_hit_canvas = NULL;
-static lv_draw_buf_t g_hit_draw_buf;
-static uint8_t g_hit_canvas_buf[300 * 400 * LV_COLOR_DEPTH / 8];
+// 打击可视化画布: 分层增量渲染
+// 静态沙袋背景只渲染一次并缓存，每次打击只重绘打击标记所在的小矩形区域，
+// 标记由lv_timer分级淡出，淡出时同样只重绘该标记的区域
+// 画布缓冲区和背景缓存只在页面显示期间从gk_gui_canvas借用，页面隐藏时连同画布一起释放
+// 以下尺寸以800x480显示屏上的300x400画布为参考，按g_hit_layout.scale缩放
+#define HIT_CANVAS_REF_W        300
+#define HIT_CANVAS_REF_H        400
+#define HIT_CANVAS_BG_COLOR     0x333333
+#define HIT_CANVAS_PX_PER_CM    2.0f
+#define HIT_MARKER_MAX          8       // 同时显示的标记数，超出时淘汰最旧的标记
+#define HIT_MARKER_RAY_LEN      10      // 力度辐射线超出圆环的长度 (px)
+#define HIT_FADE_PERIOD_MS      400     // 淡出定时器周期，每个周期降低一级透明度
+#define HIT_FADE_LEVELS         4       // 标记从出现到消失经历的透明度级数
+
+typedef struct {
+    bool used;
+    uint8_t level;              // 当前透明度级别，0为最新 (完全不透明)
+    lv_point_t center;
+    int32_t radius;
+    bool rays;                  // 是否绘制力度辐射线
+    lv_area_t area;             // 标记占用的画布区域 (已裁剪到画布内)
+} hit_marker_t;
+
+static struct {
+    lv_obj_t* canvas;
+    lv_timer_t* fade_timer;
+    uint8_t* bg_cache;          // 静态背景缓存，与画布缓冲区格式和行跨度相同
+    hit_marker_t markers[HIT_MARKER_MAX];
+    uint32_t last_hit_pixels;   // 最近一次打击重绘的像素数
+} g_hit_vis = {0};
+
 static lv_obj_t* g_stats_labels[4] = {NULL}; // Force, Position, Combo, Max Force labels
 
-void gk_gui_update_hit_visual(gk_hit_point_t* hit_point)
+static const lv_opa_t g_hit_fade_opa[HIT_FADE_LEVELS] = {LV_OPA_COVER, LV_OPA_70, LV_OPA_40, LV_OPA_20};
+
+// 沙袋背景，clip之外的部分由LVGL裁剪掉
+static void hit_canvas_draw_background(lv_layer_t* layer)
 {
-    if (!hit_point || !g_pages[GK_PAGE_HIT_VISUAL]) {
-        return; // 无打击可显示或页面未创建
-    }
-    
-    // 如果画布不存在则创建
-    if (!g_hit_canvas) {
-        g_hit_canvas = lv_canvas_create(g_pages[GK_PAGE_HIT_VISUAL]);
-        lv_canvas_set_buffer(g_hit_canvas, g_hit_canvas_buf, 300, 400, LV_COLOR_FORMAT_RGB565);
-        lv_obj_align(g_hit_canvas, LV_ALIGN_LEFT_MID, 20, 10);
-    }
-    
-    // 清空画布并重绘沙袋
-    lv_canvas_fill_bg(g_hit_canvas, lv_color_hex(0x333333), LV_OPA_COVER);
-    
-    lv_layer_t layer;
-    lv_canvas_init_layer(g_hit_canvas, &layer);
-    
+    lv_draw_rect_dsc_t fill_dsc;
+    lv_draw_rect_dsc_init(&fill_dsc);
+    fill_dsc.bg_color = lv_color_hex(HIT_CANVAS_BG_COLOR);
+    fill_dsc.bg_opa = LV_OPA_COVER;
+    lv_area_t canvas_area = {0, 0, g_hit_layout.w - 1, g_hit_layout.h - 1};
+    lv_draw_rect(layer, &fill_dsc, &canvas_area);
+
     // 绘制沙袋轮廓 (圆柱形状)
     lv_draw_rect_dsc_t bag_dsc;
     lv_draw_rect_dsc_init(&bag_dsc);
@@ -320,56 +599,428 @@ void gk_gui_update_hit_visual(gk_hit_point_t* hit_point)
     bag_dsc.border_width = 2;
     bag_dsc.bg_opa = LV_OPA_TRANSP;
     bag_dsc.radius = 0;
-    
-    // 绘制沙袋主体 (简化为带圆角的矩形)
-    lv_area_t bag_area = {120, 50, 180, 350};  // 60px wide, 300px tall
-    lv_draw_rect(&layer, &bag_dsc, &bag_area);
-    
+
+    // 绘制沙袋主体 (简化为带圆角的矩形)，参考尺寸下宽60px高300px
+    int32_t cx = g_hit_layout.w / 2;
+    int32_t half_w = (int32_t)(30 * g_hit_layout.scale);
+    lv_area_t bag_area = {cx - half_w, g_hit_layout.h / 8, cx + half_w, g_hit_layout.h * 7 / 8};
+    lv_draw_rect(layer, &bag_dsc, &bag_area);
+
     // 绘制沙袋顶部和底部圆形
     lv_draw_arc_dsc_t circle_dsc;
     lv_draw_arc_dsc_init(&circle_dsc);
     circle_dsc.color = lv_color_white();
     circle_dsc.width = 2;
-    
-    lv_point_t top_center = {150, 60};
-    lv_point_t bottom_center = {150, 340};
-    lv_draw_arc(&layer, &circle_dsc, &top_center, 30, 0, 360);
-    lv_draw_arc(&layer, &circle_dsc, &bottom_center, 30, 0, 360);
-    
-    // 计算画布上的打击位置 (从真实坐标映射)
-    // hit_point->x,y以厘米为单位，映射到画布坐标
-    int hit_canvas_x = 150 + (int)(hit_point->x * 2.0f);  // Scale: 2px per cm
-    int hit_canvas_y = 200 - (int)(hit_point->y * 2.0f);  // Flip Y axis, offset to middle
-    
-    // 绘制打击点指示器
+    circle_dsc.radius = half_w;
+    circle_dsc.start_angle = 0;
+    circle_dsc.end_angle = 360;
+
+    circle_dsc.center.x = cx;
+    circle_dsc.center.y = bag_area.y1 + g_hit_layout.h / 40;
+    lv_draw_arc(layer, &circle_dsc);
+    circle_dsc.center.y = bag_area.y2 - g_hit_layout.h / 40;
+    lv_draw_arc(layer, &circle_dsc);
+}
+
+static void hit_canvas_draw_marker(lv_layer_t* layer, const hit_marker_t* marker)
+{
+    lv_opa_t opa = g_hit_fade_opa[marker->level];
+
     lv_draw_arc_dsc_t hit_dsc;
     lv_draw_arc_dsc_init(&hit_dsc);
     hit_dsc.color = lv_color_hex(0xFF4444);  // Red hit indicator
-    hit_dsc.width = 4;
-    
-    lv_point_t hit_center = {hit_canvas_x, hit_canvas_y};
-    int hit_radius = (int)(5 + hit_point->force * 0.2f);  // Scale radius with force
-    lv_draw_arc(&layer, &hit_dsc, &hit_center, hit_radius, 0, 360);
-    
+    hit_dsc.width = LV_MAX(1, (int32_t)(4 * g_hit_layout.scale));
+    hit_dsc.opa = opa;
+    hit_dsc.center = marker->center;
+    hit_dsc.radius = marker->radius;
+    hit_dsc.start_angle = 0;
+    hit_dsc.end_angle = 360;
+    lv_draw_arc(layer, &hit_dsc);
+
     // 将力大小绘制为辐射线
-    if (hit_point->force > 10.0f) {
+    if (marker->rays) {
         lv_draw_line_dsc_t force_line_dsc;
         lv_draw_line_dsc_init(&force_line_dsc);
         force_line_dsc.color = lv_color_hex(0xFF8844);
-        force_line_dsc.width = 2;
-        
-        int force_radius = hit_radius + 10;
+        force_line_dsc.width = LV_MAX(1, (int32_t)(2 * g_hit_layout.scale));
+        force_line_dsc.opa = opa;
+        force_line_dsc.p1.x = marker->center.x;
+        force_line_dsc.p1.y = marker->center.y;
+
+        int force_radius = marker->radius + (int)(HIT_MARKER_RAY_LEN * g_hit_layout.scale);
         for (int angle = 0; angle < 360; angle += 45) {
             float rad = (float)angle * M_PI / 180.0f;
-            lv_point_t line_end = {
-                hit_canvas_x + (int)(force_radius * cosf(rad)),
-                hit_canvas_y + (int)(force_radius * sinf(rad))
-            };
-            lv_draw_line(&layer, &force_line_dsc, &hit_center, &line_end);
+            force_line_dsc.p2.x = marker->center.x + (int)(force_radius * cosf(rad));
+            force_line_dsc.p2.y = marker->center.y + (int)(force_radius * sinf(rad));
+            lv_draw_line(layer, &force_line_dsc);
+        }
+    }
+}
+
+// 两个矩形的交集，不相交时返回false (只用lv_area_t的公开字段)
+static bool hit_area_intersect(lv_area_t* res, const lv_area_t* a, const lv_area_t* b)
+{
+    res->x1 = LV_MAX(a->x1, b->x1);
+    res->y1 = LV_MAX(a->y1, b->y1);
+    res->x2 = LV_MIN(a->x2, b->x2);
+    res->y2 = LV_MIN(a->y2, b->y2);
+    return (res->x1 <= res->x2) && (res->y1 <= res->y2);
+}
+
+// 重绘画布上的一个矩形区域: 恢复背景，再按从旧到新叠加与之相交的标记
+// 返回重绘的像素数
+static uint32_t hit_canvas_redraw_area(const lv_area_t* area)
+{
+    lv_area_t dirty;
+    lv_area_t canvas_area = {0, 0, g_hit_layout.w - 1, g_hit_layout.h - 1};
+    if (!g_hit_vis.canvas || !hit_area_intersect(&dirty, area, &canvas_area)) {
+        return 0;
+    }
+
+    lv_layer_t layer;
+    lv_canvas_init_layer(g_hit_vis.canvas, &layer);
+
+    if (g_hit_vis.bg_cache) {
+        // 从缓存逐行拷贝背景，不经过绘制流程
+        lv_draw_buf_t* draw_buf = lv_canvas_get_draw_buf(g_hit_vis.canvas);
+        uint32_t stride = draw_buf->header.stride;
+        uint32_t bpp = lv_color_format_get_size(draw_buf->header.cf);
+        uint32_t offset = dirty.y1 * stride + dirty.x1 * bpp;
+        uint32_t len = lv_area_get_width(&dirty) * bpp;
+        for (int32_t y = dirty.y1; y <= dirty.y2; y++) {
+            memcpy(draw_buf->data + offset, g_hit_vis.bg_cache + offset, len);
+            offset += stride;
+        }
+    } else {
+        hit_canvas_draw_background(&layer);
+    }
+
+    // level越大越旧
+    for (int level = HIT_FADE_LEVELS - 1; level >= 0; level--) {
+        for (int i = 0; i < HIT_MARKER_MAX; i++) {
+            hit_marker_t* marker = &g_hit_vis.markers[i];
+            lv_area_t overlap;
+            if (marker->used && marker->level == level && hit_area_intersect(&overlap, &marker->area, &dirty)) {
+                hit_canvas_draw_marker(&layer, marker);
+            }
+        }
+    }
+
+    // LVGL 9.1没有设置图层裁剪区的公开接口，改为收窄已加入的绘制任务的裁剪区。
+    // 画布图层不在显示器的图层链表中，任务在lv_canvas_finish_layer之前不会被执行
+    for (lv_draw_task_t* t = layer.draw_task_head; t != NULL; t = t->next) {
+        lv_area_t clip = t->clip_area;
+        hit_area_intersect(&t->clip_area, &clip, &dirty); // 不相交时为空区域，任务不绘制任何像素
+    }
+    lv_canvas_finish_layer(g_hit_vis.canvas, &layer);
+
+    // 只让该区域参与刷新 (屏幕绝对坐标)
+    lv_area_t coords;
+    lv_obj_get_coords(g_hit_vis.canvas, &coords);
+    lv_area_t inv = dirty;
+    lv_area_move(&inv, coords.x1, coords.y1);
+    lv_obj_invalidate_area(g_hit_vis.canvas, &inv);
+
+    return lv_area_get_size(&dirty);
+}
+
+static void hit_fade_timer_cb(lv_timer_t* timer)
+{
+    bool alive = false;
+
+    for (int i = 0; i < HIT_MARKER_MAX; i++) {
+        hit_marker_t* marker = &g_hit_vis.markers[i];
+        if (!marker->used) {
+            continue;
+        }
+        if (++marker->level >= HIT_FADE_LEVELS) {
+            marker->used = false;
+        } else {
+            alive = true;
+        }
+        hit_canvas_redraw_area(&marker->area);
+    }
+
+    if (!alive) {
+        lv_timer_pause(timer); // 没有可见标记时不再唤醒
+    }
+}
+
+// 页面显示时创建画布并绘制背景，背景缓存与画布共用一次预留，空间不足时只借用画布
+static void hit_canvas_create(void)
+{
+    if (g_hit_vis.canvas) {
+        return;
+    }
+
+    uint32_t canvas_bytes = gk_gui_canvas_bytes(g_hit_layout.w, g_hit_layout.h);
+    if (gk_gui_canvas_reserve(canvas_bytes * 2) != OPRT_OK && gk_gui_canvas_reserve(canvas_bytes) != OPRT_OK) {
+        return;
+    }
+
+    g_hit_vis.canvas = lv_canvas_create(g_pages[GK_PAGE_HIT_VISUAL]);
+    if (gk_gui_canvas_attach(g_hit_vis.canvas, g_hit_layout.w, g_hit_layout.h) != OPRT_OK) {
+        lv_obj_delete(g_hit_vis.canvas);
+        g_hit_vis.canvas = NULL;
+        return;
+    }
+    lv_obj_align(g_hit_vis.canvas, LV_ALIGN_LEFT_MID, g_hit_layout.margin, g_hit_layout.y_offset);
+
+    // 背景只渲染一次
+    lv_layer_t layer;
+    lv_canvas_init_layer(g_hit_vis.canvas, &layer);
+    hit_canvas_draw_background(&layer);
+    lv_canvas_finish_layer(g_hit_vis.canvas, &layer);
+    lv_obj_invalidate(g_hit_vis.canvas);
+
+    lv_draw_buf_t* draw_buf = lv_canvas_get_draw_buf(g_hit_vis.canvas);
+    uint32_t size = draw_buf->header.stride * draw_buf->header.h;
+    g_hit_vis.bg_cache = gk_gui_canvas_alloc(size);
+    if (g_hit_vis.bg_cache) {
+        memcpy(g_hit_vis.bg_cache, draw_buf->data, size);
+    } else {
+        TAL_PR_ERR(TAG, "背景缓存分配失败，改为按区域重绘背景");
+    }
+
+    if (!g_hit_vis.fade_timer) {
+        g_hit_vis.fade_timer = lv_timer_create(hit_fade_timer_cb, HIT_FADE_PERIOD_MS, NULL);
+        lv_timer_pause(g_hit_vis.fade_timer);
+    }
+}
+
+// 页面隐藏时删除画布，缓冲区由gk_gui_apply_page统一归还
+// 标记在两秒内就会淡出，隐藏期间不保留，热力图不使用画布缓冲区，继续累加
+static void hit_canvas_release(void)
+{
+    if (!g_hit_vis.canvas) {
+        return;
+    }
+    lv_timer_pause(g_hit_vis.fade_timer);
+    lv_obj_delete(g_hit_vis.canvas);
+    g_hit_vis.canvas = NULL;
+    g_hit_vis.bg_cache = NULL;
+    memset(g_hit_vis.markers, 0, sizeof(g_hit_vis.markers));
+}
+
+// 打击热力图: 32x40的I8索引图像 (256色调色板 + 每格1字节)，由LVGL放大显示
+// 每次打击只刷新被修改的格子，衰减由定时器按周期刷新，都只失效强度发生变化的格子所在区域
+#ifdef HEATMAP_HALF_LIFE_SEC
+#define HIT_HEATMAP_HALF_LIFE_MS    (HEATMAP_HALF_LIFE_SEC * 1000)
+#else
+#define HIT_HEATMAP_HALF_LIFE_MS    60000
+#endif
+#define HIT_HEATMAP_PX_PER_CELL     6       // 参考尺寸下每格的像素数
+#define HIT_HEATMAP_REFRESH_MS      1000    // 衰减的显示刷新周期
+
+static struct {
+    gk_heatmap_t map;
+    lv_obj_t* img;
+    lv_timer_t* timer;
+    lv_image_dsc_t dsc;
+} g_hit_heat = {0};
+
+// I8图像数据: 调色板在前，索引在后
+static struct {
+    lv_color32_t palette[256];
+    uint8_t index[GK_HEATMAP_ROWS][GK_HEATMAP_COLS];
+} g_hit_heat_data;
+
+// 画布占显示屏宽度的3/8、高度的5/6，800x480时即参考尺寸300x400
+static void hit_layout_init(void)
+{
+    int32_t disp_w, disp_h;
+    gk_gui_canvas_get_display(&disp_w, &disp_h);
+
+    g_hit_layout.w = LV_MAX(1, disp_w * 3 / 8);
+    g_hit_layout.h = LV_MAX(1, disp_h * 5 / 6);
+    g_hit_layout.scale = LV_MIN((float)g_hit_layout.w / HIT_CANVAS_REF_W, (float)g_hit_layout.h / HIT_CANVAS_REF_H);
+    g_hit_layout.margin = disp_w / 40;
+    g_hit_layout.y_offset = disp_h / 48;
+    g_hit_layout.panel_w = disp_w / 4;
+    g_hit_layout.heat_px = LV_MAX(1, (int32_t)(HIT_HEATMAP_PX_PER_CELL * g_hit_layout.scale));
+}
+
+// 0为背景色，1-255由蓝经青、绿、黄渐变到红
+static void hit_heatmap_init_palette(lv_color32_t* palette)
+{
+    static const uint8_t stops[5][3] = {
+        {0x00, 0x20, 0xC0}, {0x00, 0xC0, 0xE0}, {0x20, 0xE0, 0x20}, {0xF0, 0xE0, 0x00}, {0xFF, 0x30, 0x20},
+    };
+
+    palette[0] = lv_color32_make(0x33, 0x33, 0x33, LV_OPA_COVER);
+    for (int i = 1; i < 256; i++) {
+        int pos = (i - 1) * 4 * 256 / 254;  // 0 .. 4*256，8位小数
+        int seg = pos >> 8;
+        int frac = pos & 0xFF;
+        if (seg >= 4) {
+            seg = 3;
+            frac = 256;
+        }
+        const uint8_t* a = stops[seg];
+        const uint8_t* b = stops[seg + 1];
+        palette[i] = lv_color32_make(a[0] + (((b[0] - a[0]) * frac) >> 8), a[1] + (((b[1] - a[1]) * frac) >> 8),
+                                     a[2] + (((b[2] - a[2]) * frac) >> 8), LV_OPA_COVER);
+    }
+}
+
+// 重新计算area内的强度 (NULL为整个网格)，只失效强度变化的格子的外接矩形
+// 区域内已完全消退时返回false
+static bool hit_heatmap_refresh(const gk_heatmap_rect_t* area)
+{
+    static uint8_t level[GK_HEATMAP_ROWS][GK_HEATMAP_COLS];
+    static const gk_heatmap_rect_t full = {0, 0, GK_HEATMAP_COLS - 1, GK_HEATMAP_ROWS - 1};
+
+    if (!area) {
+        area = &full;
+    }
+    uint8_t max_level = gk_heatmap_render(&g_hit_heat.map, tal_system_get_millisecond(), area, &level[0][0],
+                                          GK_HEATMAP_COLS);
+
+    lv_area_t changed = {GK_HEATMAP_COLS, GK_HEATMAP_ROWS, -1, -1};
+    for (int y = area->row0; y <= area->row1; y++) {
+        for (int x = area->col0; x <= area->col1; x++) {
+            if (level[y][x] != g_hit_heat_data.index[y][x]) {
+                g_hit_heat_data.index[y][x] = level[y][x];
+                changed.x1 = LV_MIN(changed.x1, x);
+                changed.y1 = LV_MIN(changed.y1, y);
+                changed.x2 = LV_MAX(changed.x2, x);
+                changed.y2 = LV_MAX(changed.y2, y);
+            }
+        }
+    }
+
+    if (changed.x2 >= 0) {
+        lv_image_cache_drop(&g_hit_heat.dsc);
+
+        lv_area_t coords;
+        lv_obj_get_coords(g_hit_heat.img, &coords);
+        lv_area_t inv = {
+            coords.x1 + changed.x1 * g_hit_layout.heat_px,
+            coords.y1 + changed.y1 * g_hit_layout.heat_px,
+            coords.x1 + (changed.x2 + 1) * g_hit_layout.heat_px - 1,
+            coords.y1 + (changed.y2 + 1) * g_hit_layout.heat_px - 1,
+        };
+        lv_obj_invalidate_area(g_hit_heat.img, &inv);
+    }
+
+    return max_level > 0;
+}
+
+static void hit_heatmap_timer_cb(lv_timer_t* timer)
+{
+    if (!hit_heatmap_refresh(NULL)) {
+        lv_timer_pause(timer);
+    }
+}
+
+static void hit_heatmap_create(void)
+{
+    gk_heatmap_init(&g_hit_heat.map, HIT_HEATMAP_HALF_LIFE_MS);
+    hit_heatmap_init_palette(g_hit_heat_data.palette);
+    memset(g_hit_heat_data.index, 0, sizeof(g_hit_heat_data.index));
+
+    g_hit_heat.dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    g_hit_heat.dsc.header.cf = LV_COLOR_FORMAT_I8;
+    g_hit_heat.dsc.header.w = GK_HEATMAP_COLS;
+    g_hit_heat.dsc.header.h = GK_HEATMAP_ROWS;
+    g_hit_heat.dsc.header.stride = GK_HEATMAP_COLS;
+    g_hit_heat.dsc.data = (const uint8_t*)&g_hit_heat_data;
+    g_hit_heat.dsc.data_size = sizeof(g_hit_heat_data);
+
+    g_hit_heat.img = lv_image_create(g_pages[GK_PAGE_HIT_VISUAL]);
+    lv_image_set_src(g_hit_heat.img, &g_hit_heat.dsc);
+    lv_image_set_inner_align(g_hit_heat.img, LV_IMAGE_ALIGN_STRETCH);
+    lv_image_set_antialias(g_hit_heat.img, false);
+    lv_obj_set_size(g_hit_heat.img, GK_HEATMAP_COLS * g_hit_layout.heat_px,
+                    GK_HEATMAP_ROWS * g_hit_layout.heat_px);
+    lv_obj_align(g_hit_heat.img, LV_ALIGN_LEFT_MID, g_hit_layout.margin * 2 + g_hit_layout.w, g_hit_layout.y_offset);
+
+    g_hit_heat.timer = lv_timer_create(hit_heatmap_timer_cb, HIT_HEATMAP_REFRESH_MS, NULL);
+    lv_timer_pause(g_hit_heat.timer);
+}
+
+// 文本未变化时不触发标签重绘
+static void hit_label_update(lv_obj_t* label, const char* text)
+{
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+// 在画布上添加一个打击标记，返回重绘的像素数
+static uint32_t hit_canvas_add_marker(const gk_hit_point_t* hit_point)
+{
+    // 选择空闲槽位，没有时淘汰最旧的标记并擦除其区域
+    hit_marker_t* marker = NULL;
+    for (int i = 0; i < HIT_MARKER_MAX; i++) {
+        hit_marker_t* m = &g_hit_vis.markers[i];
+        if (!m->used) {
+            marker = m;
+            break;
+        }
+        if (!marker || m->level > marker->level) {
+            marker = m;
         }
     }
+    uint32_t pixels = 0;
+    if (marker->used) {
+        marker->used = false;
+        pixels += hit_canvas_redraw_area(&marker->area);
+    }
+    
+    // 计算画布上的打击位置 (从真实坐标映射)
+    // hit_point->x,y以厘米为单位，映射到画布坐标
+    float px_per_cm = HIT_CANVAS_PX_PER_CM * g_hit_layout.scale;
+    marker->center.x = g_hit_layout.w / 2 + (int)(hit_point->x * px_per_cm);
+    marker->center.y = g_hit_layout.h / 2 - (int)(hit_point->y * px_per_cm);  // Flip Y axis
+    marker->radius = LV_MAX(1, (int)((5 + hit_point->force * 0.2f) * g_hit_layout.scale));  // Scale radius with force
+    marker->rays = hit_point->force > 10.0f;
+    marker->level = 0;
+    marker->used = true;
     
-    lv_canvas_finish_layer(g_hit_canvas, &layer);
+    // 标记外接矩形 (含线宽)
+    int32_t extent = marker->radius + (marker->rays ? (int32_t)(HIT_MARKER_RAY_LEN * g_hit_layout.scale) : 0) +
+                     LV_MAX(2, (int32_t)(2 * g_hit_layout.scale));
+    lv_area_set(&marker->area, marker->center.x - extent, marker->center.y - extent, marker->center.x + extent,
+                marker->center.y + extent);
+    
+    pixels += hit_canvas_redraw_area(&marker->area);
+    g_hit_vis.last_hit_pixels = pixels;
+    lv_timer_resume(g_hit_vis.fade_timer);
+    return pixels;
+}
+
+void gk_gui_apply_hit_visual(const gk_hit_point_t* hit_point, const gk_hit_point_t* heat, uint32_t heat_count)
+{
+    if (!hit_point || !g_pages[GK_PAGE_HIT_VISUAL]) {
+        return; // 无打击可显示或页面未创建
+    }
+    
+    if (!g_hit_heat.img) {
+        hit_heatmap_create();
+    }
+    
+    // 画布只在打击可视化页面显示时存在，隐藏时只累加热力图、更新标签
+    uint32_t pixels = 0;
+    if (g_hit_vis.canvas) {
+        pixels = hit_canvas_add_marker(hit_point);
+    }
+    
+    // 热力图累加本周期内的全部打击，只刷新被修改的格子，其余格子的衰减由定时器统一刷新
+    uint32_t now_ms = tal_system_get_millisecond();
+    gk_heatmap_rect_t heat_changed = {GK_HEATMAP_COLS, GK_HEATMAP_ROWS, -1, -1};
+    for (uint32_t i = 0; i < heat_count; i++) {
+        gk_heatmap_rect_t rect;
+        gk_heatmap_add(&g_hit_heat.map, heat[i].x, heat[i].y, 1.0f, now_ms, &rect);
+        heat_changed.col0 = LV_MIN(heat_changed.col0, rect.col0);
+        heat_changed.row0 = LV_MIN(heat_changed.row0, rect.row0);
+        heat_changed.col1 = LV_MAX(heat_changed.col1, rect.col1);
+        heat_changed.row1 = LV_MAX(heat_changed.row1, rect.row1);
+    }
+    if (heat_changed.col1 >= 0) {
+        hit_heatmap_refresh(&heat_changed);
+        lv_timer_resume(g_hit_heat.timer);
+    }
     
     // 更新统计标签
     if (!g_stats_labels[0]) {
@@ -382,11 +1033,16 @@ void gk_gui_update_hit_visual(gk_hit_point_t* hit_point)
     }
     
     // 更新统计文本
-    lv_label_set_text_fmt(g_stats_labels[0], "打击力度: %.1f N", hit_point->force);
-    lv_label_set_text_fmt(g_stats_labels[1], "打击位置: (%.1f, %.1f)cm", hit_point->x, hit_point->y);
-    lv_label_set_text_fmt(g_stats_labels[2], "连击数: %d", gk_sensor_get_hit_count());
-    lv_label_set_text_fmt(g_stats_labels[3], "最大力度: %.1f N", gk_sensor_get_max_force_session());
-    
-    TAL_PR_INFO(TAG, "增强打击可视化: (%.1f,%.1f)cm F=%.1fN", 
-                hit_point->x, hit_point->y, hit_point->force);
-}
\ No newline at end of file
+    char text[48];
+    lv_snprintf(text, sizeof(text), "打击力度: %.1f N", hit_point->force);
+    hit_label_update(g_stats_labels[0], text);
+    lv_snprintf(text, sizeof(text), "打击位置: (%.1f, %.1f)cm", hit_point->x, hit_point->y);
+    hit_label_update(g_stats_labels[1], text);
+    lv_snprintf(text, sizeof(text), "连击数: %u", (unsigned int)gk_sensor_get_hit_count());
+    hit_label_update(g_stats_labels[2], text);
+    lv_snprintf(text, sizeof(text), "最大力度: %.1f N", gk_sensor_get_max_force_session());
+    hit_label_update(g_stats_labels[3], text);
+    
+    TAL_PR_INFO(TAG, "增强打击可视化: (%.1f,%.1f)cm F=%.1fN 本帧%u次打击 重绘%u像素", 
+                hit_point->x, hit_point->y, hit_point->force, (unsigned int)heat_count, (unsigned int)pixels);
+}
@@ -1,4 +1,8 @@
 #include "gk_bag.h"
+#include "gk_recorder.h"
+#include "gk_combat_stats.h"
+#include "gk_cloud_sync.h"
+#include "gk_drill.h"
 #include "tuya_cloud_types.h"
 #include "tuya_iot_config.h"
 #include "tal_log.h"
@@ -7,10 +11,17 @@
 
 #define TAG "GK_BAG_MAIN"
 
+// 主循环每次最多从采集环形缓冲区取出的帧数
+#define GK_MAIN_DRAIN_BATCH  32
+
 static void gk_bag_main_task(void *arg)
 {
+    (void)arg;
     TAL_PR_INFO(TAG, "智能AI沙袋启动中...");
     
+    // 主统计页面在GUI初始化时即绘制火柴人，先设置默认用户信息
+    gk_set_default_user_info();
+    
     // 初始化核心子系统
     if (gk_gui_init() != OPRT_OK) {
         TAL_PR_ERR(TAG, "GUI初始化失败");
@@ -22,24 +33,63 @@ static void gk_bag_main_task(void *arg)
         return;
     }
     
-    // 设置默认用户信息并直接显示主统计页面
-    gk_set_default_user_info();
+    gk_combat_stats_init();
+    
+#if GK_RECORDER_ENABLE
+    // 录制器依赖tal_kv挂载的littlefs，失败时不影响正常训练
+    if (gk_recorder_init() != OPRT_OK) {
+        TAL_PR_ERR(TAG, "会话录制器初始化失败");
+    }
+#endif
+    
+#if GK_CLOUD_SYNC_ENABLE
+    // 训练记录离线时暂存在同一个littlefs中，失败时只是不上报
+    if (gk_cloud_sync_init() != OPRT_OK) {
+        TAL_PR_ERR(TAG, "训练记录同步初始化失败");
+    }
+#endif
+    
+    if (gk_sensor_start_acquisition() != OPRT_OK) {
+        TAL_PR_ERR(TAG, "传感器采集线程启动失败");
+        return;
+    }
+    
+    // 直接显示主统计页面
     gk_gui_show_page(GK_PAGE_MAIN_STATS);
     
     TAL_PR_INFO(TAG, "智能AI沙袋初始化成功");
     
-    // 主循环
+    // 主循环: 采集线程以传感器采样率写入环形缓冲区，这里按GUI刷新节奏批量取出
+    static gk_force_data_t frames[GK_MAIN_DRAIN_BATCH];
     while (1) {
-        // 处理传感器数据和GUI更新
-        gk_force_data_t force_data;
-        if (gk_sensor_read_data(&force_data) == OPRT_OK) {
-            // 处理力传感器数据并根据需要更新GUI
-            gk_hit_point_t hit_point;
-            if (gk_calculate_hit_point(&force_data, &hit_point) == OPRT_OK) {
-                gk_gui_update_hit_visual(&hit_point);
+        int count;
+        while ((count = gk_sensor_fetch_frames(frames, GK_MAIN_DRAIN_BATCH)) > 0) {
+            for (int i = 0; i < count; i++) {
+                // 打击分段: 每次完整打击只产生一个事件
+                // 打击点投递到GUI邮箱，同一刷新周期内的多次打击由LVGL线程合并为一次重绘
+                gk_punch_event_t punch;
+                if (gk_sensor_detect_punch(&frames[i], &punch) == OPRT_OK) {
+                    gk_gui_update_hit_visual(&punch.hit);
+                    gk_combat_stats_feed(&punch, (uint32_t)(punch.timestamp / 1000));
+                    // 训练计划按打击时间戳匹配提示，批量送入的延迟不影响反应时间
+                    gk_drill_feed_punch(&punch);
+#if GK_CLOUD_SYNC_ENABLE
+                    gk_cloud_sync_feed(&punch);
+#endif
+                }
             }
         }
         
+        // 战力得分按COMBAT_STATS_UPDATE_INTERVAL限频刷新，与打击时间戳使用同一时钟
+        uint32_t now_ms = (uint32_t)(tal_system_get_microsecond() / 1000);
+        gk_combat_stats_poll(now_ms);
+#if GK_CLOUD_SYNC_ENABLE
+        gk_cloud_sync_poll(now_ms);
+#endif
+        
+        // 保存读取线程完成的零点校准，flash写入不占用采集线程
+        gk_sensor_poll_calibration();
+        
         // 任务延迟
         tal_system_sleep(50); // 20Hz update rate
     }
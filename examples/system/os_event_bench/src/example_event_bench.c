@@ -0,0 +1,241 @@
+/**
+ * @file example_event_bench.c
+ * @brief Benchmarks tal_event publish latency against the number of subscribers.
+ *
+ * The registry is filled with BENCH_EVENT_NUM events before the measured event is created, so the name lookup has
+ * to find it among them. For every subscriber count the benchmark reports the cost of a synchronous publish by name
+ * and by id, the time an asynchronous publish takes to return and the time until the subscribers of a burst of
+ * asynchronous publishes have all been called. A last round adds one subscriber that takes 1 ms to show how long a
+ * slow subscriber holds up the publisher in each mode.
+ *
+ * @copyright Copyright (c) 2021-2024 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+#include "tal_api.h"
+#include "tkl_output.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define BENCH_EVENT_NUM     128
+#define BENCH_EVENT_NAME    "bench_target"
+#define BENCH_SYNC_LOOPS    10000
+#define BENCH_ASYNC_BURST   50 // stays below the depth of the system work queue
+#define BENCH_ASYNC_ROUNDS  20
+#define BENCH_SLOW_MS       1
+#define BENCH_SLOW_LOOPS    100
+#define BENCH_PAYLOAD_SIZE  16
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static const uint8_t bench_subs[] = {1, 4, 16, 64};
+static volatile uint32_t bench_calls = 0;
+static volatile uint64_t bench_last_us = 0; // when a subscriber was last called
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+
+static int __bench_sub_cb(void *data)
+{
+    bench_calls++;
+    bench_last_us = tal_system_get_microsecond();
+    return OPRT_OK;
+}
+
+static int __bench_slow_cb(void *data)
+{
+    tal_system_sleep(BENCH_SLOW_MS);
+    return OPRT_OK;
+}
+
+static void __bench_subscribe(uint8_t num, BOOL_T subscribe)
+{
+    char desc[EVENT_DESC_MAX_LEN + 1];
+
+    for (uint8_t i = 0; i < num; i++) {
+        snprintf(desc, sizeof(desc), "bench_sub%d", i);
+        if (subscribe) {
+            tal_event_subscribe(BENCH_EVENT_NAME, desc, __bench_sub_cb, SUBSCRIBE_TYPE_NORMAL);
+        } else {
+            tal_event_unsubscribe(BENCH_EVENT_NAME, desc, __bench_sub_cb);
+        }
+    }
+}
+
+static void __bench_wait_calls(uint32_t expect)
+{
+    while (bench_calls < expect) {
+        tal_system_sleep(1);
+    }
+}
+
+static void __bench_run_subs(EVENT_ID id, uint8_t num)
+{
+    uint8_t payload[BENCH_PAYLOAD_SIZE] = {0};
+    uint64_t begin_us = 0;
+    uint64_t name_us = 0;
+    uint64_t id_us = 0;
+    uint64_t async_us = 0;
+    uint64_t deliver_us = 0;
+
+    __bench_subscribe(num, TRUE);
+
+    begin_us = tal_system_get_microsecond();
+    for (uint32_t i = 0; i < BENCH_SYNC_LOOPS; i++) {
+        tal_event_publish(BENCH_EVENT_NAME, payload);
+    }
+    name_us = tal_system_get_microsecond() - begin_us;
+
+    begin_us = tal_system_get_microsecond();
+    for (uint32_t i = 0; i < BENCH_SYNC_LOOPS; i++) {
+        tal_event_publish_by_id(id, payload);
+    }
+    id_us = tal_system_get_microsecond() - begin_us;
+
+    for (uint32_t round = 0; round < BENCH_ASYNC_ROUNDS; round++) {
+        uint32_t expect = bench_calls + BENCH_ASYNC_BURST * num;
+        uint64_t burst_us = tal_system_get_microsecond();
+        for (uint32_t i = 0; i < BENCH_ASYNC_BURST; i++) {
+            begin_us = tal_system_get_microsecond();
+            tal_event_publish_async_by_id(id, payload, sizeof(payload));
+            async_us += tal_system_get_microsecond() - begin_us;
+        }
+        __bench_wait_calls(expect);
+        deliver_us += bench_last_us - burst_us;
+    }
+
+    PR_NOTICE("subs %2d: sync %u ns, by id %u ns, async %u ns, burst of %d delivered in %u us", num,
+              (uint32_t)(name_us * 1000 / BENCH_SYNC_LOOPS), (uint32_t)(id_us * 1000 / BENCH_SYNC_LOOPS),
+              (uint32_t)(async_us * 1000 / (BENCH_ASYNC_ROUNDS * BENCH_ASYNC_BURST)), BENCH_ASYNC_BURST,
+              (uint32_t)(deliver_us / BENCH_ASYNC_ROUNDS));
+
+    __bench_subscribe(num, FALSE);
+}
+
+static void __bench_run_slow(EVENT_ID id)
+{
+    uint64_t begin_us = 0;
+    uint64_t sync_us = 0;
+    uint64_t async_us = 0;
+
+    __bench_subscribe(4, TRUE);
+    tal_event_subscribe(BENCH_EVENT_NAME, "bench_slow", __bench_slow_cb, SUBSCRIBE_TYPE_NORMAL);
+
+    begin_us = tal_system_get_microsecond();
+    for (uint32_t i = 0; i < BENCH_SLOW_LOOPS; i++) {
+        tal_event_publish_by_id(id, NULL);
+    }
+    sync_us = tal_system_get_microsecond() - begin_us;
+
+    for (uint32_t i = 0; i < BENCH_SLOW_LOOPS; i++) {
+        begin_us = tal_system_get_microsecond();
+        tal_event_publish_async_by_id(id, NULL, 0);
+        async_us += tal_system_get_microsecond() - begin_us;
+        if ((i + 1) % BENCH_ASYNC_BURST == 0) {
+            tal_system_sleep(BENCH_SLOW_MS * BENCH_ASYNC_BURST * 2);
+        }
+    }
+
+    PR_NOTICE("4 subs + one taking %d ms: sync %u ns, async %u ns", BENCH_SLOW_MS,
+              (uint32_t)(sync_us * 1000 / BENCH_SLOW_LOOPS), (uint32_t)(async_us * 1000 / BENCH_SLOW_LOOPS));
+
+    tal_event_unsubscribe(BENCH_EVENT_NAME, "bench_slow", __bench_slow_cb);
+    __bench_subscribe(4, FALSE);
+}
+
+static void __bench_run(void)
+{
+    char name[EVENT_NAME_MAX_LEN + 1];
+    EVENT_ID id = EVENT_ID_INVALID;
+
+    for (uint32_t i = 0; i < BENCH_EVENT_NUM; i++) {
+        snprintf(name, sizeof(name), "bench_ev%d", i);
+        tal_event_publish(name, NULL);
+    }
+    if (OPRT_OK != tal_event_get_id(BENCH_EVENT_NAME, &id)) {
+        PR_ERR("bench event create failed");
+        return;
+    }
+
+    PR_NOTICE("event bench: %d events registered", BENCH_EVENT_NUM + 1);
+    for (uint32_t i = 0; i < CNTSOF(bench_subs); i++) {
+        __bench_run_subs(id, bench_subs[i]);
+    }
+    __bench_run_slow(id);
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    /* basic init */
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    PR_NOTICE("Application information:");
+    PR_NOTICE("Project name:        %s", PROJECT_NAME);
+    PR_NOTICE("App version:         %s", PROJECT_VERSION);
+    PR_NOTICE("Compile time:        %s", __DATE__);
+    PR_NOTICE("TuyaOpen version:    %s", OPEN_VERSION);
+    PR_NOTICE("TuyaOpen commit-id:  %s", OPEN_COMMIT);
+    PR_NOTICE("Platform chip:       %s", PLATFORM_CHIP);
+    PR_NOTICE("Platform board:      %s", PLATFORM_BOARD);
+    PR_NOTICE("Platform commit-id:  %s", PLATFORM_COMMIT);
+
+    TUYA_CALL_ERR_GOTO(tal_workq_init(), __EXIT);
+    TUYA_CALL_ERR_GOTO(tal_event_init(), __EXIT);
+
+    __bench_run();
+
+__EXIT:
+    return;
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+    while (1) {
+        tal_system_sleep(500);
+    }
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
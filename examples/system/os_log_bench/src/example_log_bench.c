@@ -0,0 +1,171 @@
+/**
+ * @file example_log_bench.c
+ * @brief Benchmarks how long a log call holds up the calling thread behind a slow output terminal.
+ *
+ * The output terminal takes as long as a 115200 baud UART would to send each line. The benchmark logs a line shaped
+ * like the punch log of the sandbag app, first one every 20 ms and then in bursts, and reports the time each call
+ * takes to return and the time tal_log_flush takes to output a burst.
+ *
+ * Build it once with CONFIG_ENABLE_LOG_ASYNC=y and once with it disabled to compare the drain thread against
+ * printing on the caller's thread.
+ *
+ * @copyright Copyright (c) 2021-2024 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+#include "tal_api.h"
+#include "tkl_output.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define BENCH_UART_BAUD     115200
+#define BENCH_SPARSE_LOOPS  200
+#define BENCH_SPARSE_GAP_MS 20
+#define BENCH_BURST_LEN     16 // stays below LOG_ASYNC_RING_SIZE
+#define BENCH_BURST_ROUNDS  10
+
+#if defined(ENABLE_LOG_ASYNC) && (ENABLE_LOG_ASYNC == 1)
+#define BENCH_BACKEND "drain thread"
+#else
+#define BENCH_BACKEND "synchronous"
+#endif
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+
+/**
+ * @brief output terminal that takes as long as a UART to send the line, 10 bits per byte
+ */
+static void __bench_uart_output(const char *str)
+{
+    uint64_t end_us = tal_system_get_microsecond() + (uint64_t)strlen(str) * 10 * 1000000 / BENCH_UART_BAUD;
+
+    while (tal_system_get_microsecond() < end_us) {
+    }
+    tkl_log_output(str);
+}
+
+static uint64_t __bench_log_hit(uint32_t i)
+{
+    uint64_t begin_us = tal_system_get_microsecond();
+
+    PR_INFO("[gk_sensor] bag %u hit: jab at (%.1f,%.1f) cm, peak %.1f N, impulse %.3f N*s, rise %.1f ms", i % 4,
+            (i % 40) * 0.5f - 10.0f, (i % 30) * 0.5f - 7.5f, 800.0f + i, 12.5f + i * 0.01f, 4.2f);
+
+    return tal_system_get_microsecond() - begin_us;
+}
+
+static void __bench_run(void)
+{
+    uint64_t call_us = 0;
+    uint64_t sum_us = 0;
+    uint64_t max_us = 0;
+    uint64_t flush_us = 0;
+    uint64_t begin_us = 0;
+    TAL_LOG_ASYNC_STAT_T stat;
+
+    PR_NOTICE("log bench: %s, %d baud output", BENCH_BACKEND, BENCH_UART_BAUD);
+    tal_log_flush();
+
+    for (uint32_t i = 0; i < BENCH_SPARSE_LOOPS; i++) {
+        call_us = __bench_log_hit(i);
+        sum_us += call_us;
+        if (call_us > max_us) {
+            max_us = call_us;
+        }
+        tal_system_sleep(BENCH_SPARSE_GAP_MS);
+    }
+    tal_log_flush();
+    PR_NOTICE("one log every %d ms: call mean %u us, max %u us", BENCH_SPARSE_GAP_MS,
+              (uint32_t)(sum_us / BENCH_SPARSE_LOOPS), (uint32_t)max_us);
+
+    sum_us = 0;
+    max_us = 0;
+    for (uint32_t round = 0; round < BENCH_BURST_ROUNDS; round++) {
+        for (uint32_t i = 0; i < BENCH_BURST_LEN; i++) {
+            call_us = __bench_log_hit(i);
+            sum_us += call_us;
+            if (call_us > max_us) {
+                max_us = call_us;
+            }
+        }
+        begin_us = tal_system_get_microsecond();
+        tal_log_flush();
+        flush_us += tal_system_get_microsecond() - begin_us;
+    }
+    PR_NOTICE("bursts of %d: call mean %u us, max %u us, flush %u us", BENCH_BURST_LEN,
+              (uint32_t)(sum_us / (BENCH_BURST_ROUNDS * BENCH_BURST_LEN)), (uint32_t)max_us,
+              (uint32_t)(flush_us / BENCH_BURST_ROUNDS));
+
+    if (OPRT_OK == tal_log_async_get_stat(&stat)) {
+        PR_NOTICE("queued %u, dropped %u, formatted by the caller %u", stat.queued, stat.dropped, stat.text);
+    }
+    tal_log_flush();
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    /* basic init */
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, __bench_uart_output);
+
+    PR_NOTICE("Application information:");
+    PR_NOTICE("Project name:        %s", PROJECT_NAME);
+    PR_NOTICE("App version:         %s", PROJECT_VERSION);
+    PR_NOTICE("Compile time:        %s", __DATE__);
+    PR_NOTICE("TuyaOpen version:    %s", OPEN_VERSION);
+    PR_NOTICE("TuyaOpen commit-id:  %s", OPEN_COMMIT);
+    PR_NOTICE("Platform chip:       %s", PLATFORM_CHIP);
+    PR_NOTICE("Platform board:      %s", PLATFORM_BOARD);
+    PR_NOTICE("Platform commit-id:  %s", PLATFORM_COMMIT);
+
+    __bench_run();
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+    while (1) {
+        tal_system_sleep(500);
+    }
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
@@ -0,0 +1,298 @@
+/**
+ * @file example_sw_timer_bench.c
+ * @brief Benchmarks the software timer service with thousands of running timers.
+ *
+ * Half of the timers are cyclic with periods from 10 ms to 1 s, the other half are one-shot timers with long
+ * timeouts that a churn thread keeps restarting before they expire, the way keepalive and session timeouts are
+ * refreshed by the MQTT, LAN and AI client code. The benchmark reports the cost of tal_sw_timer_start and
+ * tal_sw_timer_stop, the dispatch lateness of the cyclic timers and the process CPU time.
+ *
+ * Build it once with CONFIG_ENABLE_SW_TIMER_WHEEL=y and once with it disabled to compare the timing wheel
+ * against the sorted list.
+ *
+ * @copyright Copyright (c) 2021-2024 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tuya_cloud_types.h"
+#include "tal_api.h"
+#include "tal_sw_timer.h"
+#include "tkl_output.h"
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+#include <time.h>
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define BENCH_TIMER_NUM       4000
+#define BENCH_RUN_MS          10000
+#define BENCH_CYCLE_MIN_MS    10
+#define BENCH_CYCLE_MAX_MS    1000
+#define BENCH_ONCE_MIN_MS     1000
+#define BENCH_ONCE_MAX_MS     5000
+#define BENCH_CHURN_PERIOD_MS 10
+#define BENCH_CHURN_NUM       100 // one-shot timers restarted per churn round
+#define BENCH_HIST_BUCKET_US  100
+#define BENCH_HIST_SIZE       500 // lateness above 50 ms lands in the last bucket
+
+#if defined(ENABLE_SW_TIMER_WHEEL) && (ENABLE_SW_TIMER_WHEEL == 1)
+#define BENCH_BACKEND "timing wheel"
+#else
+#define BENCH_BACKEND "sorted list"
+#endif
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    TIMER_ID id;
+    uint32_t period_ms;
+    uint64_t armed_us;
+} BENCH_TIMER_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static BENCH_TIMER_T *bench_timers = NULL;
+static uint32_t bench_hist[BENCH_HIST_SIZE];
+static uint32_t bench_fired = 0;
+static uint32_t bench_once_fired = 0;
+static uint64_t bench_late_sum_us = 0;
+static uint64_t bench_late_max_us = 0;
+static volatile BOOL_T bench_churn_running = FALSE;
+static uint32_t bench_churn_ops = 0;
+static uint64_t bench_churn_us = 0;
+static uint32_t bench_rand_seed = 1;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+
+static uint32_t __bench_rand(uint32_t min, uint32_t max)
+{
+    bench_rand_seed = bench_rand_seed * 1103515245 + 12345;
+    return min + (bench_rand_seed >> 8) % (max - min + 1);
+}
+
+/**
+ * @brief cyclic timer callback, records how late the timer fired
+ *
+ * The timer service re-arms a cyclic timer from the time it was dispatched, so the expected time of the next
+ * callback is one period after this one.
+ */
+static void __bench_cycle_cb(TIMER_ID timer_id, void *arg)
+{
+    BENCH_TIMER_T *timer = (BENCH_TIMER_T *)arg;
+    uint64_t now_us = tal_system_get_microsecond();
+    uint64_t expect_us = timer->armed_us + (uint64_t)timer->period_ms * 1000;
+    uint64_t late_us = (now_us > expect_us) ? now_us - expect_us : 0;
+    uint32_t bucket = late_us / BENCH_HIST_BUCKET_US;
+
+    bench_hist[(bucket < BENCH_HIST_SIZE) ? bucket : BENCH_HIST_SIZE - 1]++;
+    bench_fired++;
+    bench_late_sum_us += late_us;
+    if (late_us > bench_late_max_us) {
+        bench_late_max_us = late_us;
+    }
+    timer->armed_us = now_us;
+}
+
+static void __bench_once_cb(TIMER_ID timer_id, void *arg)
+{
+    bench_once_fired++;
+}
+
+/**
+ * @brief restarts random one-shot timers before they expire
+ */
+static void __bench_churn_task(void *arg)
+{
+    uint32_t once_base = BENCH_TIMER_NUM / 2;
+
+    while (bench_churn_running) {
+        uint64_t begin_us = tal_system_get_microsecond();
+        for (uint32_t i = 0; i < BENCH_CHURN_NUM; i++) {
+            BENCH_TIMER_T *timer = &bench_timers[once_base + __bench_rand(0, BENCH_TIMER_NUM / 2 - 1)];
+            tal_sw_timer_start(timer->id, timer->period_ms, TAL_TIMER_ONCE);
+        }
+        bench_churn_us += tal_system_get_microsecond() - begin_us;
+        bench_churn_ops += BENCH_CHURN_NUM;
+        tal_system_sleep(BENCH_CHURN_PERIOD_MS);
+    }
+}
+
+static uint32_t __bench_percentile_us(uint32_t percent)
+{
+    uint32_t target = (uint32_t)(((uint64_t)bench_fired * percent + 99) / 100);
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < BENCH_HIST_SIZE; i++) {
+        count += bench_hist[i];
+        if (count >= target) {
+            return (i + 1) * BENCH_HIST_BUCKET_US;
+        }
+    }
+
+    return BENCH_HIST_SIZE * BENCH_HIST_BUCKET_US;
+}
+
+static void __bench_run(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    THREAD_HANDLE churn_thread = NULL;
+    uint64_t begin_us = 0;
+    uint64_t start_us = 0;
+    uint64_t stop_us = 0;
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    clock_t cpu_begin = 0;
+    clock_t cpu_end = 0;
+#endif
+
+    bench_timers = (BENCH_TIMER_T *)tal_calloc(BENCH_TIMER_NUM, sizeof(BENCH_TIMER_T));
+    if (NULL == bench_timers) {
+        PR_ERR("bench timers malloc failed");
+        return;
+    }
+
+    for (uint32_t i = 0; i < BENCH_TIMER_NUM; i++) {
+        BENCH_TIMER_T *timer = &bench_timers[i];
+        if (i < BENCH_TIMER_NUM / 2) {
+            timer->period_ms = __bench_rand(BENCH_CYCLE_MIN_MS, BENCH_CYCLE_MAX_MS);
+            TUYA_CALL_ERR_GOTO(tal_sw_timer_create(__bench_cycle_cb, timer, &timer->id), __EXIT);
+        } else {
+            timer->period_ms = __bench_rand(BENCH_ONCE_MIN_MS, BENCH_ONCE_MAX_MS);
+            TUYA_CALL_ERR_GOTO(tal_sw_timer_create(__bench_once_cb, timer, &timer->id), __EXIT);
+        }
+    }
+
+    PR_NOTICE("sw timer bench: %s, %d timers, %d ms", BENCH_BACKEND, BENCH_TIMER_NUM, BENCH_RUN_MS);
+
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    cpu_begin = clock();
+#endif
+    begin_us = tal_system_get_microsecond();
+    for (uint32_t i = 0; i < BENCH_TIMER_NUM; i++) {
+        BENCH_TIMER_T *timer = &bench_timers[i];
+        timer->armed_us = tal_system_get_microsecond();
+        tal_sw_timer_start(timer->id, timer->period_ms, (i < BENCH_TIMER_NUM / 2) ? TAL_TIMER_CYCLE : TAL_TIMER_ONCE);
+    }
+    start_us = tal_system_get_microsecond() - begin_us;
+
+    bench_churn_running = TRUE;
+    THREAD_CFG_T thrd_param = {4096, THREAD_PRIO_2, "bench_churn"};
+    TUYA_CALL_ERR_GOTO(tal_thread_create_and_start(&churn_thread, NULL, NULL, __bench_churn_task, NULL, &thrd_param),
+                       __EXIT);
+
+    tal_system_sleep(BENCH_RUN_MS);
+    bench_churn_running = FALSE;
+    tal_system_sleep(BENCH_CHURN_PERIOD_MS * 2);
+
+    begin_us = tal_system_get_microsecond();
+    for (uint32_t i = 0; i < BENCH_TIMER_NUM; i++) {
+        tal_sw_timer_stop(bench_timers[i].id);
+    }
+    stop_us = tal_system_get_microsecond() - begin_us;
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    cpu_end = clock();
+#endif
+
+    PR_NOTICE("start: %u us total, %u ns per timer", (uint32_t)start_us,
+              (uint32_t)(start_us * 1000 / BENCH_TIMER_NUM));
+    PR_NOTICE("stop: %u us total, %u ns per timer", (uint32_t)stop_us, (uint32_t)(stop_us * 1000 / BENCH_TIMER_NUM));
+    if (bench_churn_ops) {
+        PR_NOTICE("restart under load: %u ops, %u ns per op", bench_churn_ops,
+                  (uint32_t)(bench_churn_us * 1000 / bench_churn_ops));
+    }
+    if (bench_fired) {
+        PR_NOTICE("cyclic dispatch: %u callbacks, late mean %u us, p50 <%u us, p99 <%u us, max %u us", bench_fired,
+                  (uint32_t)(bench_late_sum_us / bench_fired), __bench_percentile_us(50), __bench_percentile_us(99),
+                  (uint32_t)bench_late_max_us);
+    }
+    PR_NOTICE("one-shot expired: %u", bench_once_fired);
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+    PR_NOTICE("cpu: %lu ms for %d ms run", (unsigned long)((cpu_end - cpu_begin) * 1000 / CLOCKS_PER_SEC),
+              BENCH_RUN_MS);
+#endif
+
+__EXIT:
+    for (uint32_t i = 0; i < BENCH_TIMER_NUM; i++) {
+        if (bench_timers[i].id) {
+            tal_sw_timer_delete(bench_timers[i].id);
+        }
+    }
+    tal_free(bench_timers);
+    bench_timers = NULL;
+}
+
+/**
+ * @brief user_main
+ *
+ * @return none
+ */
+void user_main(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    /* basic init */
+    tal_log_init(TAL_LOG_LEVEL_DEBUG, 1024, (TAL_LOG_OUTPUT_CB)tkl_log_output);
+
+    PR_NOTICE("Application information:");
+    PR_NOTICE("Project name:        %s", PROJECT_NAME);
+    PR_NOTICE("App version:         %s", PROJECT_VERSION);
+    PR_NOTICE("Compile time:        %s", __DATE__);
+    PR_NOTICE("TuyaOpen version:    %s", OPEN_VERSION);
+    PR_NOTICE("TuyaOpen commit-id:  %s", OPEN_COMMIT);
+    PR_NOTICE("Platform chip:       %s", PLATFORM_CHIP);
+    PR_NOTICE("Platform board:      %s", PLATFORM_BOARD);
+    PR_NOTICE("Platform commit-id:  %s", PLATFORM_COMMIT);
+
+    TUYA_CALL_ERR_GOTO(tal_sw_timer_init(), __EXIT);
+
+    __bench_run();
+
+__EXIT:
+    return;
+}
+
+/**
+ * @brief main
+ *
+ * @param argc
+ * @param argv
+ * @return void
+ */
+#if OPERATING_SYSTEM == SYSTEM_LINUX
+void main(int argc, char *argv[])
+{
+    user_main();
+    while (1) {
+        tal_system_sleep(500);
+    }
+}
+#else
+
+/* Tuya thread handle */
+static THREAD_HANDLE ty_app_thread = NULL;
+
+/**
+ * @brief  task thread
+ *
+ * @param[in] arg:Parameters when creating a task
+ * @return none
+ */
+static void tuya_app_thread(void *arg)
+{
+    user_main();
+
+    tal_thread_delete(ty_app_thread);
+    ty_app_thread = NULL;
+}
+
+void tuya_app_main(void)
+{
+    THREAD_CFG_T thrd_param = {4096, 4, "tuya_app_main"};
+    tal_thread_create_and_start(&ty_app_thread, NULL, NULL, tuya_app_thread, NULL, &thrd_param);
+}
+#endif
@@ -56,6 +56,6 @@ void lv_port_log_print(lv_log_level_t level, const char *buf)
     } break;
     }
 
-    tal_log_print(log_level, "lvgl", __LINE__, (char *)buf);
+    tal_log_print(log_level, "lvgl", __LINE__, "%s", buf);
 }
 #endif
\ No newline at end of file
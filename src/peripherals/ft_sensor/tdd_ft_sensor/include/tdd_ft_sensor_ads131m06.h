@@ -0,0 +1,64 @@
+/**
+ * @file tdd_ft_sensor_ads131m06.h
+ * @brief ADS131M06 six-channel bridge ADC driver for force/torque sensors
+ *
+ * This header file defines the configuration and registration interface of the
+ * ADS131M06 TDD driver. The ADC samples all six strain gauge bridges of the
+ * sensor simultaneously, signals each conversion on its DRDY pin and returns
+ * the status word and all six channels in a single SPI frame, which is read
+ * with one DMA transfer.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDD_FT_SENSOR_ADS131M06_H__
+#define __TDD_FT_SENSOR_ADS131M06_H__
+
+#include "tuya_cloud_types.h"
+#include "tdl_ft_sensor_manage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define ADS131M06_WORD_SIZE     (3) /* 24-bit words after reset */
+#define ADS131M06_FRAME_WORDS   (8) /* status/response, 6 channels, CRC */
+#define ADS131M06_FRAME_SIZE    (ADS131M06_WORD_SIZE * ADS131M06_FRAME_WORDS)
+
+#define ADS131M06_CMD_NULL      (0x0000)
+#define ADS131M06_CMD_RESET     (0x0011)
+#define ADS131M06_CMD_RREG      (0xA000)
+#define ADS131M06_CMD_WREG      (0x6000)
+
+#define ADS131M06_REG_ID        (0x00)
+#define ADS131M06_REG_CLOCK     (0x03)
+
+#define ADS131M06_ID_MSB        (0x26) /* ID[15:8]: channel count 6 */
+#define ADS131M06_CLKIN_HZ      (8192000)
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    TUYA_SPI_NUM_E port;
+    uint32_t spi_clk;             /* SPI clock, up to 25 MHz */
+    TUYA_GPIO_NUM_E drdy_pin;     /* DRDY, active low */
+    TUYA_GPIO_NUM_E rst_pin;      /* SYNC/RESET, TUYA_GPIO_NUM_MAX if not connected */
+    uint32_t sample_rate_hz;      /* rounded up to the nearest supported data rate */
+    float lsb[TDL_FT_SENSOR_CHANNELS]; /* output units per ADC count for each channel */
+} TDD_FT_SENSOR_ADS131M06_CFG_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+OPERATE_RET tdd_ft_sensor_ads131m06_register(char *name, TDD_FT_SENSOR_ADS131M06_CFG_T *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDD_FT_SENSOR_ADS131M06_H__ */
@@ -0,0 +1,52 @@
+/**
+ * @file tdd_ft_sensor_trace.h
+ * @brief Trace file backed force/torque sensor driver for host builds
+ *
+ * This header file defines the configuration and registration interface of a
+ * TDD driver that replays a recorded text trace as a force/torque sensor. A
+ * pacing thread raises data-ready at the configured sample rate, so code built
+ * on the TDL interface runs unchanged on the Ubuntu board.
+ *
+ * Trace format: one frame per line, the six channels as numbers separated by
+ * commas or white space. Lines that do not hold six numbers (headers, comments)
+ * are skipped.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDD_FT_SENSOR_TRACE_H__
+#define __TDD_FT_SENSOR_TRACE_H__
+
+#include "tuya_cloud_types.h"
+#include "tdl_ft_sensor_manage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define FT_SENSOR_TRACE_PATH_MAX_LEN 128
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    char path[FT_SENSOR_TRACE_PATH_MAX_LEN];
+    uint32_t sample_rate_hz;
+    uint8_t skip_cols; /* leading columns before the six channels, e.g. sequence and time */
+    bool loop;         /* restart from the beginning at end of file */
+} TDD_FT_SENSOR_TRACE_CFG_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+OPERATE_RET tdd_ft_sensor_trace_register(char *name, TDD_FT_SENSOR_TRACE_CFG_T *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDD_FT_SENSOR_TRACE_H__ */
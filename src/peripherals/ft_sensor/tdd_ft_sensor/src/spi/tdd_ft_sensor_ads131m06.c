@@ -0,0 +1,329 @@
+/**
+ * @file tdd_ft_sensor_ads131m06.c
+ * @brief ADS131M06 six-channel bridge ADC driver implementation
+ *
+ * This file implements the TDD (Tuya Device Driver) layer for a six-axis
+ * force/torque sensor read through an ADS131M06 simultaneous-sampling ADC.
+ * The DRDY falling edge is forwarded to the TDL layer as the data-ready event.
+ * Each read clocks out one complete frame (status, six channels and CRC) in a
+ * single DMA transfer and checks the output CRC before converting the counts.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tal_api.h"
+
+#if defined(ENABLE_SPI) && (ENABLE_SPI == 1)
+#include "tkl_spi.h"
+#include "tkl_gpio.h"
+
+#include "tdl_ft_sensor_driver.h"
+#include "tdd_ft_sensor_ads131m06.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define ADS131M06_XFER_TIMEOUT_MS 100
+#define ADS131M06_OSR_NUM         8
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    TDD_FT_SENSOR_ADS131M06_CFG_T cfg;
+    TDD_FT_SENSOR_DRDY_CB drdy_cb;
+    void *drdy_arg;
+    uint8_t tx_buf[ADS131M06_FRAME_SIZE];
+    uint8_t rx_buf[ADS131M06_FRAME_SIZE];
+} TDD_FT_SENSOR_INFO_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static SEM_HANDLE sg_ads_xfer_sem[TUYA_SPI_NUM_MAX] = {0};
+
+/* data rate for OSR codes 0..7 at fCLKIN = 8.192 MHz */
+static const uint32_t sg_ads_data_rate[ADS131M06_OSR_NUM] = {32000, 16000, 8000, 4000, 2000, 1000, 500, 250};
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static void __ads_spi_isr_cb(TUYA_SPI_NUM_E port, TUYA_SPI_IRQ_EVT_E event)
+{
+    if (event == TUYA_SPI_EVENT_TRANSFER_COMPLETE) {
+        if (sg_ads_xfer_sem[port]) {
+            tal_semaphore_post(sg_ads_xfer_sem[port]);
+        }
+    }
+}
+
+static void __ads_drdy_isr_cb(void *args)
+{
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)args;
+
+    if (info->drdy_cb) {
+        info->drdy_cb(info->drdy_arg);
+    }
+}
+
+/* CRC-16-CCITT, polynomial 0x1021, seed 0xFFFF (device default) */
+static uint16_t __ads_crc16(const uint8_t *data, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int j = 0; j < 8; j++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/* one full frame in each direction, command in word 0 and optional register data in word 1 */
+static OPERATE_RET __ads_frame_xfer(TDD_FT_SENSOR_INFO_T *info, uint16_t cmd, uint16_t data)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    memset(info->tx_buf, 0, ADS131M06_FRAME_SIZE);
+    info->tx_buf[0] = (cmd >> 8) & 0xFF;
+    info->tx_buf[1] = cmd & 0xFF;
+    info->tx_buf[ADS131M06_WORD_SIZE] = (data >> 8) & 0xFF;
+    info->tx_buf[ADS131M06_WORD_SIZE + 1] = data & 0xFF;
+
+    TUYA_CALL_ERR_RETURN(tkl_spi_transfer(info->cfg.port, info->tx_buf, info->rx_buf, ADS131M06_FRAME_SIZE));
+    TUYA_CALL_ERR_RETURN(tal_semaphore_wait(sg_ads_xfer_sem[info->cfg.port], ADS131M06_XFER_TIMEOUT_MS));
+
+    return rt;
+}
+
+static uint16_t __ads_rx_word16(TDD_FT_SENSOR_INFO_T *info, uint32_t word)
+{
+    const uint8_t *p = &info->rx_buf[word * ADS131M06_WORD_SIZE];
+
+    return ((uint16_t)p[0] << 8) | p[1];
+}
+
+static OPERATE_RET __ads_read_reg(TDD_FT_SENSOR_INFO_T *info, uint8_t addr, uint16_t *value)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    TUYA_CALL_ERR_RETURN(__ads_frame_xfer(info, ADS131M06_CMD_RREG | ((uint16_t)addr << 7), 0));
+    /* the register content is returned in the response word of the next frame */
+    TUYA_CALL_ERR_RETURN(__ads_frame_xfer(info, ADS131M06_CMD_NULL, 0));
+    *value = __ads_rx_word16(info, 0);
+
+    return rt;
+}
+
+static OPERATE_RET __ads_write_reg(TDD_FT_SENSOR_INFO_T *info, uint8_t addr, uint16_t value)
+{
+    return __ads_frame_xfer(info, ADS131M06_CMD_WREG | ((uint16_t)addr << 7), value);
+}
+
+static uint8_t __ads_osr_code(uint32_t sample_rate_hz)
+{
+    for (int code = ADS131M06_OSR_NUM - 1; code > 0; code--) {
+        if (sg_ads_data_rate[code] >= sample_rate_hz) {
+            return code;
+        }
+    }
+
+    return 0;
+}
+
+static void __ads_hw_reset(TUYA_GPIO_NUM_E rst_pin)
+{
+    TUYA_GPIO_BASE_CFG_T pin_cfg = {
+        .mode = TUYA_GPIO_PUSH_PULL,
+        .direct = TUYA_GPIO_OUTPUT,
+        .level = TUYA_GPIO_LEVEL_HIGH,
+    };
+
+    if (rst_pin >= TUYA_GPIO_NUM_MAX) {
+        return;
+    }
+
+    tkl_gpio_init(rst_pin, &pin_cfg);
+
+    /* SYNC/RESET held low for more than 2048 CLKIN periods resets the device */
+    tkl_gpio_write(rst_pin, TUYA_GPIO_LEVEL_LOW);
+    tal_system_sleep(1);
+    tkl_gpio_write(rst_pin, TUYA_GPIO_LEVEL_HIGH);
+    tal_system_sleep(1);
+}
+
+static OPERATE_RET __tdd_ft_sensor_ads131m06_open(TDD_FT_SENSOR_DEV_HANDLE_T device, TDD_FT_SENSOR_DRDY_CB drdy_cb,
+                                                  void *arg)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)device;
+    uint16_t id = 0;
+    uint8_t osr = 0;
+
+    if (NULL == info) {
+        return OPRT_INVALID_PARM;
+    }
+
+    /* the ADS131M0x latches data on the falling SCLK edge: CPOL = 0, CPHA = 1 */
+    TUYA_SPI_BASE_CFG_T spi_cfg = {.mode = TUYA_SPI_MODE1,
+                                   .freq_hz = info->cfg.spi_clk,
+                                   .databits = TUYA_SPI_DATA_BIT8,
+                                   .bitorder = TUYA_SPI_ORDER_MSB2LSB,
+                                   .role = TUYA_SPI_ROLE_MASTER,
+                                   .type = TUYA_SPI_AUTO_TYPE,
+                                   .spi_dma_flags = 1};
+
+    if (NULL == sg_ads_xfer_sem[info->cfg.port]) {
+        TUYA_CALL_ERR_RETURN(tal_semaphore_create_init(&sg_ads_xfer_sem[info->cfg.port], 0, 1));
+    }
+
+    TUYA_CALL_ERR_RETURN(tkl_spi_init(info->cfg.port, &spi_cfg));
+    TUYA_CALL_ERR_RETURN(tkl_spi_irq_init(info->cfg.port, __ads_spi_isr_cb));
+    TUYA_CALL_ERR_RETURN(tkl_spi_irq_enable(info->cfg.port));
+
+    __ads_hw_reset(info->cfg.rst_pin);
+
+    TUYA_CALL_ERR_RETURN(__ads_read_reg(info, ADS131M06_REG_ID, &id));
+    if ((id >> 8) != ADS131M06_ID_MSB) {
+        PR_ERR("ads131m06 id err:0x%04x", id);
+        return OPRT_NOT_FOUND;
+    }
+
+    /* all six channels enabled, high-resolution power mode */
+    osr = __ads_osr_code(info->cfg.sample_rate_hz);
+    TUYA_CALL_ERR_RETURN(__ads_write_reg(info, ADS131M06_REG_CLOCK, 0x3F00 | (osr << 2) | 0x02));
+    PR_NOTICE("ads131m06 data rate %d Hz", sg_ads_data_rate[osr]);
+
+    info->drdy_cb = drdy_cb;
+    info->drdy_arg = arg;
+
+    TUYA_GPIO_BASE_CFG_T gpio_cfg = {
+        .direct = TUYA_GPIO_INPUT,
+        .mode = TUYA_GPIO_PULLUP,
+        .level = TUYA_GPIO_LEVEL_HIGH,
+    };
+    TUYA_CALL_ERR_RETURN(tkl_gpio_init(info->cfg.drdy_pin, &gpio_cfg));
+
+    TUYA_GPIO_IRQ_T irq_cfg = {
+        .mode = TUYA_GPIO_IRQ_FALL,
+        .cb = __ads_drdy_isr_cb,
+        .arg = info,
+    };
+    TUYA_CALL_ERR_RETURN(tkl_gpio_irq_init(info->cfg.drdy_pin, &irq_cfg));
+    TUYA_CALL_ERR_RETURN(tkl_gpio_irq_enable(info->cfg.drdy_pin));
+
+    return rt;
+}
+
+static OPERATE_RET __tdd_ft_sensor_ads131m06_read_raw(TDD_FT_SENSOR_DEV_HANDLE_T device,
+                                                      int32_t raw[TDL_FT_SENSOR_CHANNELS])
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)device;
+
+    if (NULL == info || NULL == raw) {
+        return OPRT_INVALID_PARM;
+    }
+
+    TUYA_CALL_ERR_RETURN(__ads_frame_xfer(info, ADS131M06_CMD_NULL, 0));
+
+    uint32_t crc_pos = (ADS131M06_FRAME_WORDS - 1) * ADS131M06_WORD_SIZE;
+    if (__ads_crc16(info->rx_buf, crc_pos) != __ads_rx_word16(info, ADS131M06_FRAME_WORDS - 1)) {
+        return OPRT_CRC32_FAILED;
+    }
+
+    for (int i = 0; i < TDL_FT_SENSOR_CHANNELS; i++) {
+        const uint8_t *p = &info->rx_buf[(i + 1) * ADS131M06_WORD_SIZE];
+        /* 24-bit two's complement, sign extended through the top byte */
+        raw[i] = (int32_t)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8)) >> 8;
+    }
+
+    return rt;
+}
+
+static OPERATE_RET __tdd_ft_sensor_ads131m06_read(TDD_FT_SENSOR_DEV_HANDLE_T device,
+                                                  float ch[TDL_FT_SENSOR_CHANNELS])
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)device;
+    int32_t raw[TDL_FT_SENSOR_CHANNELS];
+
+    if (NULL == info || NULL == ch) {
+        return OPRT_INVALID_PARM;
+    }
+
+    rt = __tdd_ft_sensor_ads131m06_read_raw(device, raw);
+    if (OPRT_OK != rt) {
+        return rt;
+    }
+
+    for (int i = 0; i < TDL_FT_SENSOR_CHANNELS; i++) {
+        ch[i] = raw[i] * info->cfg.lsb[i];
+    }
+
+    return rt;
+}
+
+static OPERATE_RET __tdd_ft_sensor_ads131m06_get_lsb(TDD_FT_SENSOR_DEV_HANDLE_T device,
+                                                     float lsb[TDL_FT_SENSOR_CHANNELS])
+{
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)device;
+
+    if (NULL == info || NULL == lsb) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memcpy(lsb, info->cfg.lsb, sizeof(info->cfg.lsb));
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __tdd_ft_sensor_ads131m06_close(TDD_FT_SENSOR_DEV_HANDLE_T device)
+{
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)device;
+
+    if (NULL == info) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tkl_gpio_irq_disable(info->cfg.drdy_pin);
+    tkl_gpio_deinit(info->cfg.drdy_pin);
+    tkl_spi_irq_disable(info->cfg.port);
+    tkl_spi_deinit(info->cfg.port);
+
+    info->drdy_cb = NULL;
+    info->drdy_arg = NULL;
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tdd_ft_sensor_ads131m06_register(char *name, TDD_FT_SENSOR_ADS131M06_CFG_T *cfg)
+{
+    TDD_FT_SENSOR_INFO_T *tdd_info = NULL;
+    TDD_FT_SENSOR_INTFS_T infs;
+
+    if (name == NULL || cfg == NULL) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tdd_info = (TDD_FT_SENSOR_INFO_T *)tal_malloc(sizeof(TDD_FT_SENSOR_INFO_T));
+    if (NULL == tdd_info) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(tdd_info, 0, sizeof(TDD_FT_SENSOR_INFO_T));
+    tdd_info->cfg = *cfg;
+
+    memset(&infs, 0, sizeof(TDD_FT_SENSOR_INTFS_T));
+    infs.open = __tdd_ft_sensor_ads131m06_open;
+    infs.read = __tdd_ft_sensor_ads131m06_read;
+    infs.close = __tdd_ft_sensor_ads131m06_close;
+    infs.read_raw = __tdd_ft_sensor_ads131m06_read_raw;
+    infs.get_lsb = __tdd_ft_sensor_ads131m06_get_lsb;
+
+    return tdl_ft_sensor_device_register(name, tdd_info, &infs);
+}
+
+#endif
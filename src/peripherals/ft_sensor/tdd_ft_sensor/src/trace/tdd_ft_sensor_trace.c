@@ -0,0 +1,308 @@
+/**
+ * @file tdd_ft_sensor_trace.c
+ * @brief Trace file backed force/torque sensor driver implementation
+ *
+ * This file implements a TDD (Tuya Device Driver) force/torque sensor that
+ * replays frames from a text trace. A pacing thread loads the next frame and
+ * raises data-ready at the configured sample rate, standing in for the DRDY
+ * interrupt of a real ADC. The thread hands over one frame at a time and waits
+ * for it to be read, so a replay is lossless as long as the reader keeps up.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tal_api.h"
+
+#include "tdl_ft_sensor_driver.h"
+#include "tdd_ft_sensor_trace.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define FT_TRACE_LINE_MAX_LEN 256
+#define FT_TRACE_RESYNC_US    100000 /* behind schedule by more than this: restart pacing from now */
+#define FT_TRACE_STACK_SIZE   4096
+#define FT_TRACE_RAW_SHIFT    16     /* raw reads carry the trace values as s15.16 counts */
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    TDD_FT_SENSOR_TRACE_CFG_T cfg;
+    FILE *fp;
+    THREAD_HANDLE thread;
+    volatile bool running;
+    MUTEX_HANDLE mutex;
+    SEM_HANDLE read_sem;
+    float cur[TDL_FT_SENSOR_CHANNELS];
+    int32_t cur_raw[TDL_FT_SENSOR_CHANNELS];
+    TDD_FT_SENSOR_DRDY_CB drdy_cb;
+    void *drdy_arg;
+} TDD_FT_SENSOR_INFO_T;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static bool __trace_is_sep(char c)
+{
+    return (c == ' ' || c == '\t' || c == ',');
+}
+
+static bool __trace_parse_line(const char *line, uint8_t skip_cols, float ch[TDL_FT_SENSOR_CHANNELS])
+{
+    const char *p = line;
+    int col = 0, num = 0;
+
+    while (num < TDL_FT_SENSOR_CHANNELS) {
+        while (__trace_is_sep(*p)) {
+            p++;
+        }
+        if (*p == '\0' || *p == '\r' || *p == '\n') {
+            break;
+        }
+
+        if (col++ < skip_cols) {
+            while (*p != '\0' && !__trace_is_sep(*p)) {
+                p++;
+            }
+            continue;
+        }
+
+        char *end = NULL;
+        float value = strtof(p, &end);
+        if (end == p) {
+            return false;
+        }
+        ch[num++] = value;
+        p = end;
+    }
+
+    return (num == TDL_FT_SENSOR_CHANNELS);
+}
+
+static bool __trace_next_frame(TDD_FT_SENSOR_INFO_T *info, float ch[TDL_FT_SENSOR_CHANNELS])
+{
+    char line[FT_TRACE_LINE_MAX_LEN];
+    bool rewound = false;
+
+    for (;;) {
+        if (NULL == fgets(line, sizeof(line), info->fp)) {
+            /* a second end of file without any frame means the trace holds no valid line */
+            if (!info->cfg.loop || rewound) {
+                return false;
+            }
+            rewind(info->fp);
+            rewound = true;
+            continue;
+        }
+        if (__trace_parse_line(line, info->cfg.skip_cols, ch)) {
+            return true;
+        }
+    }
+}
+
+/* trace values to s15.16 counts, saturated at the int32 range */
+static int32_t __trace_to_raw(float value)
+{
+    float v = value * (float)(1 << FT_TRACE_RAW_SHIFT);
+
+    if (v != v) {
+        return 0;
+    }
+    if (v >= 2147483647.0f) {
+        return INT32_MAX;
+    }
+    if (v <= -2147483648.0f) {
+        return INT32_MIN;
+    }
+    return (int32_t)(v + ((v >= 0) ? 0.5f : -0.5f));
+}
+
+static void __trace_pacing_task(void *args)
+{
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)args;
+    uint32_t period_us = 1000000 / info->cfg.sample_rate_hz;
+    uint32_t wait_ms = period_us / 1000 + 1;
+    uint64_t next_us = tal_system_get_microsecond();
+    float ch[TDL_FT_SENSOR_CHANNELS];
+    int32_t raw[TDL_FT_SENSOR_CHANNELS];
+
+    while (info->running) {
+        uint64_t now_us = tal_system_get_microsecond();
+        if (now_us < next_us) {
+            tal_system_sleep((uint32_t)((next_us - now_us + 999) / 1000));
+            continue;
+        }
+        if (now_us - next_us > FT_TRACE_RESYNC_US) {
+            next_us = now_us;
+        }
+
+        if (!__trace_next_frame(info, ch)) {
+            PR_NOTICE("ft sensor trace %s end", info->cfg.path);
+            break;
+        }
+
+        /* converted here so a raw read does no floating point in the reader's thread */
+        for (int i = 0; i < TDL_FT_SENSOR_CHANNELS; i++) {
+            raw[i] = __trace_to_raw(ch[i]);
+        }
+
+        tal_mutex_lock(info->mutex);
+        memcpy(info->cur, ch, sizeof(info->cur));
+        memcpy(info->cur_raw, raw, sizeof(info->cur_raw));
+        tal_mutex_unlock(info->mutex);
+
+        info->drdy_cb(info->drdy_arg);
+        next_us += period_us;
+
+        /* hand over one frame at a time; without a reader fall back to the nominal pace */
+        tal_semaphore_wait(info->read_sem, wait_ms);
+    }
+
+    info->running = false;
+    info->thread = NULL;
+}
+
+static OPERATE_RET __tdd_ft_sensor_trace_open(TDD_FT_SENSOR_DEV_HANDLE_T device, TDD_FT_SENSOR_DRDY_CB drdy_cb,
+                                              void *arg)
+{
+    OPERATE_RET rt = OPRT_OK;
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)device;
+
+    if (NULL == info || NULL == drdy_cb || 0 == info->cfg.sample_rate_hz) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (NULL == info->mutex) {
+        TUYA_CALL_ERR_RETURN(tal_mutex_create_init(&info->mutex));
+    }
+    if (NULL == info->read_sem) {
+        TUYA_CALL_ERR_RETURN(tal_semaphore_create_init(&info->read_sem, 0, 1));
+    }
+
+    info->fp = fopen(info->cfg.path, "r");
+    if (NULL == info->fp) {
+        PR_ERR("ft sensor trace %s open failed", info->cfg.path);
+        return OPRT_FILE_OPEN_FAILED;
+    }
+
+    info->drdy_cb = drdy_cb;
+    info->drdy_arg = arg;
+    info->running = true;
+
+    THREAD_CFG_T thrd_cfg = {
+        .priority = THREAD_PRIO_1,
+        .stackDepth = FT_TRACE_STACK_SIZE,
+        .thrdname = "ft_trace",
+    };
+    rt = tal_thread_create_and_start(&info->thread, NULL, NULL, __trace_pacing_task, info, &thrd_cfg);
+    if (OPRT_OK != rt) {
+        info->running = false;
+        fclose(info->fp);
+        info->fp = NULL;
+        return rt;
+    }
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __tdd_ft_sensor_trace_read(TDD_FT_SENSOR_DEV_HANDLE_T device, float ch[TDL_FT_SENSOR_CHANNELS])
+{
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)device;
+
+    if (NULL == info || NULL == ch) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(info->mutex);
+    memcpy(ch, info->cur, sizeof(info->cur));
+    tal_mutex_unlock(info->mutex);
+
+    tal_semaphore_post(info->read_sem);
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __tdd_ft_sensor_trace_read_raw(TDD_FT_SENSOR_DEV_HANDLE_T device,
+                                                   int32_t raw[TDL_FT_SENSOR_CHANNELS])
+{
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)device;
+
+    if (NULL == info || NULL == raw) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(info->mutex);
+    memcpy(raw, info->cur_raw, sizeof(info->cur_raw));
+    tal_mutex_unlock(info->mutex);
+
+    tal_semaphore_post(info->read_sem);
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __tdd_ft_sensor_trace_get_lsb(TDD_FT_SENSOR_DEV_HANDLE_T device,
+                                                 float lsb[TDL_FT_SENSOR_CHANNELS])
+{
+    if (NULL == device || NULL == lsb) {
+        return OPRT_INVALID_PARM;
+    }
+
+    for (int i = 0; i < TDL_FT_SENSOR_CHANNELS; i++) {
+        lsb[i] = 1.0f / (1 << FT_TRACE_RAW_SHIFT);
+    }
+
+    return OPRT_OK;
+}
+
+static OPERATE_RET __tdd_ft_sensor_trace_close(TDD_FT_SENSOR_DEV_HANDLE_T device)
+{
+    TDD_FT_SENSOR_INFO_T *info = (TDD_FT_SENSOR_INFO_T *)device;
+
+    if (NULL == info) {
+        return OPRT_INVALID_PARM;
+    }
+
+    info->running = false;
+    tal_semaphore_post(info->read_sem);
+    while (info->thread) {
+        tal_system_sleep(1);
+    }
+
+    if (info->fp) {
+        fclose(info->fp);
+        info->fp = NULL;
+    }
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tdd_ft_sensor_trace_register(char *name, TDD_FT_SENSOR_TRACE_CFG_T *cfg)
+{
+    TDD_FT_SENSOR_INFO_T *tdd_info = NULL;
+    TDD_FT_SENSOR_INTFS_T infs;
+
+    if (name == NULL || cfg == NULL) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tdd_info = (TDD_FT_SENSOR_INFO_T *)tal_malloc(sizeof(TDD_FT_SENSOR_INFO_T));
+    if (NULL == tdd_info) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(tdd_info, 0, sizeof(TDD_FT_SENSOR_INFO_T));
+    tdd_info->cfg = *cfg;
+
+    memset(&infs, 0, sizeof(TDD_FT_SENSOR_INTFS_T));
+    infs.open = __tdd_ft_sensor_trace_open;
+    infs.read = __tdd_ft_sensor_trace_read;
+    infs.close = __tdd_ft_sensor_trace_close;
+    infs.read_raw = __tdd_ft_sensor_trace_read_raw;
+    infs.get_lsb = __tdd_ft_sensor_trace_get_lsb;
+
+    return tdl_ft_sensor_device_register(name, tdd_info, &infs);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file tdl_ft_sensor_driver.h
+ * @brief Force/torque sensor driver interface definitions for TDL layer
+ *
+ * This header file defines the interface between the TDD (Tuya Device Driver)
+ * force/torque sensor drivers and the TDL management layer. A TDD driver
+ * raises the data-ready callback from its interrupt (or pacing) context and
+ * performs the burst read of all channels when the TDL layer asks for it.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDL_FT_SENSOR_DRIVER_H__
+#define __TDL_FT_SENSOR_DRIVER_H__
+
+#include "tuya_cloud_types.h"
+#include "tdl_ft_sensor_manage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define FT_SENSOR_DEV_NAME_MAX_LEN 32
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef void *TDD_FT_SENSOR_DEV_HANDLE_T;
+
+/* called by the tdd when a new frame is ready, may run in interrupt context */
+typedef void (*TDD_FT_SENSOR_DRDY_CB)(void *arg);
+
+typedef struct {
+    OPERATE_RET (*open)(TDD_FT_SENSOR_DEV_HANDLE_T device, TDD_FT_SENSOR_DRDY_CB drdy_cb, void *arg);
+    OPERATE_RET (*read)(TDD_FT_SENSOR_DEV_HANDLE_T device, float ch[TDL_FT_SENSOR_CHANNELS]);
+    OPERATE_RET (*close)(TDD_FT_SENSOR_DEV_HANDLE_T device);
+    /* optional, for integer pipelines: the burst read as ADC counts and the units per count of each channel */
+    OPERATE_RET (*read_raw)(TDD_FT_SENSOR_DEV_HANDLE_T device, int32_t raw[TDL_FT_SENSOR_CHANNELS]);
+    OPERATE_RET (*get_lsb)(TDD_FT_SENSOR_DEV_HANDLE_T device, float lsb[TDL_FT_SENSOR_CHANNELS]);
+} TDD_FT_SENSOR_INTFS_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+OPERATE_RET tdl_ft_sensor_device_register(char *name, TDD_FT_SENSOR_DEV_HANDLE_T tdd_hdl,
+                                          TDD_FT_SENSOR_INTFS_T *intfs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDL_FT_SENSOR_DRIVER_H__ */
@@ -0,0 +1,102 @@
+/**
+ * @file tdl_ft_sensor_manage.h
+ * @brief Six-axis force/torque sensor management layer interface definitions
+ *
+ * This header file defines the TDL (Tuya Device Library) layer interface for
+ * six-axis force/torque sensors. Frames are produced by the sensor at its own
+ * data rate and signalled through a data-ready interrupt; the reader blocks on
+ * that event, so no polling is required. Each frame carries the microsecond
+ * timestamp captured in the interrupt handler.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#ifndef __TDL_FT_SENSOR_MANAGE_H__
+#define __TDL_FT_SENSOR_MANAGE_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define TDL_FT_SENSOR_CHANNELS 6
+
+typedef void *TDL_FT_SENSOR_HANDLE_T;
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    float ch[TDL_FT_SENSOR_CHANNELS]; /* Fx Fy Fz Mx My Mz, in the units set by the tdd */
+    uint64_t timestamp_us;            /* data-ready time, tal_system_get_microsecond */
+} TDL_FT_FRAME_T;
+
+typedef struct {
+    int32_t raw[TDL_FT_SENSOR_CHANNELS]; /* ADC counts, raw * lsb gives the units of TDL_FT_FRAME_T */
+    uint64_t timestamp_us;               /* data-ready time, tal_system_get_microsecond */
+} TDL_FT_RAW_FRAME_T;
+
+typedef struct {
+    uint32_t frames;      /* frames read successfully */
+    uint32_t overruns;    /* data-ready events not read before the next one */
+    uint32_t read_errors; /* failed burst reads */
+} TDL_FT_SENSOR_STATS_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+TDL_FT_SENSOR_HANDLE_T tdl_ft_sensor_find_dev(char *name);
+
+OPERATE_RET tdl_ft_sensor_dev_open(TDL_FT_SENSOR_HANDLE_T sensor_hdl);
+
+/**
+ * @brief Wait for the next data-ready event and read the newest frame
+ *
+ * @param[in] sensor_hdl: sensor handle
+ * @param[out] frame: frame read from the sensor
+ * @param[in] timeout_ms: time to wait for data-ready, SEM_WAIT_FOREVER to block
+ *
+ * @return OPRT_OK on success, OPRT_TIMEOUT if no data became ready in time
+ */
+OPERATE_RET tdl_ft_sensor_dev_read(TDL_FT_SENSOR_HANDLE_T sensor_hdl, TDL_FT_FRAME_T *frame, uint32_t timeout_ms);
+
+/**
+ * @brief Wait for the next data-ready event and read the newest frame as ADC counts
+ *
+ * Same as tdl_ft_sensor_dev_read without the conversion to floating point, for targets
+ * that process the frames in fixed point.
+ *
+ * @param[in] sensor_hdl: sensor handle
+ * @param[out] frame: frame read from the sensor
+ * @param[in] timeout_ms: time to wait for data-ready, SEM_WAIT_FOREVER to block
+ *
+ * @return OPRT_OK on success, OPRT_TIMEOUT if no data became ready in time,
+ *         OPRT_NOT_SUPPORTED if the driver has no raw read
+ */
+OPERATE_RET tdl_ft_sensor_dev_read_raw(TDL_FT_SENSOR_HANDLE_T sensor_hdl, TDL_FT_RAW_FRAME_T *frame,
+                                       uint32_t timeout_ms);
+
+/**
+ * @brief Get the units per ADC count of each channel
+ *
+ * @param[in] sensor_hdl: sensor handle
+ * @param[out] lsb: Fx Fy Fz Mx My Mz units per count
+ *
+ * @return OPRT_OK on success, OPRT_NOT_SUPPORTED if the driver has no raw read
+ */
+OPERATE_RET tdl_ft_sensor_dev_get_lsb(TDL_FT_SENSOR_HANDLE_T sensor_hdl, float lsb[TDL_FT_SENSOR_CHANNELS]);
+
+OPERATE_RET tdl_ft_sensor_dev_get_stats(TDL_FT_SENSOR_HANDLE_T sensor_hdl, TDL_FT_SENSOR_STATS_T *stats);
+
+OPERATE_RET tdl_ft_sensor_dev_close(TDL_FT_SENSOR_HANDLE_T sensor_hdl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDL_FT_SENSOR_MANAGE_H__ */
@@ -0,0 +1,299 @@
+/**
+ * @file tdl_ft_sensor_manage.c
+ * @brief Six-axis force/torque sensor management layer implementation
+ *
+ * This file implements the TDL (Tuya Device Library) layer for force/torque
+ * sensors. It provides device registration, device discovery and the blocking
+ * frame read. The data-ready callback from the TDD driver only records the
+ * timestamp and wakes the reader; the burst read of all channels runs in the
+ * reader's thread.
+ *
+ * @copyright Copyright (c) 2021-2025 Tuya Inc. All Rights Reserved.
+ *
+ */
+
+#include "tal_api.h"
+#include "tuya_list.h"
+
+#include "tdl_ft_sensor_driver.h"
+#include "tdl_ft_sensor_manage.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    struct tuya_list_head node;
+    bool is_open;
+    char name[FT_SENSOR_DEV_NAME_MAX_LEN + 1];
+
+    SEM_HANDLE drdy_sem;
+    volatile uint32_t drdy_cnt; /* written in the data-ready callback */
+    volatile uint64_t drdy_us;
+    uint32_t read_cnt;          /* data-ready events consumed by the reader */
+    TDL_FT_SENSOR_STATS_T stats;
+
+    TDD_FT_SENSOR_DEV_HANDLE_T tdd_hdl;
+    TDD_FT_SENSOR_INTFS_T intfs;
+} FT_SENSOR_DEVICE_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static struct tuya_list_head sg_ft_sensor_list = LIST_HEAD_INIT(sg_ft_sensor_list);
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+static FT_SENSOR_DEVICE_T *__find_ft_sensor_device(char *name)
+{
+    FT_SENSOR_DEVICE_T *sensor_dev = NULL;
+    struct tuya_list_head *pos = NULL;
+
+    if (NULL == name) {
+        return NULL;
+    }
+
+    tuya_list_for_each(pos, &sg_ft_sensor_list)
+    {
+        sensor_dev = tuya_list_entry(pos, FT_SENSOR_DEVICE_T, node);
+        if (0 == strncmp(sensor_dev->name, name, FT_SENSOR_DEV_NAME_MAX_LEN)) {
+            return sensor_dev;
+        }
+    }
+
+    return NULL;
+}
+
+static void __ft_sensor_drdy_cb(void *arg)
+{
+    FT_SENSOR_DEVICE_T *sensor_dev = (FT_SENSOR_DEVICE_T *)arg;
+
+    sensor_dev->drdy_us = tal_system_get_microsecond();
+    sensor_dev->drdy_cnt++;
+
+    tal_semaphore_post(sensor_dev->drdy_sem);
+}
+
+TDL_FT_SENSOR_HANDLE_T tdl_ft_sensor_find_dev(char *name)
+{
+    return (TDL_FT_SENSOR_HANDLE_T)__find_ft_sensor_device(name);
+}
+
+OPERATE_RET tdl_ft_sensor_dev_open(TDL_FT_SENSOR_HANDLE_T sensor_hdl)
+{
+    OPERATE_RET rt = OPRT_OK;
+    FT_SENSOR_DEVICE_T *sensor_dev = NULL;
+
+    if (NULL == sensor_hdl) {
+        return OPRT_INVALID_PARM;
+    }
+
+    sensor_dev = (FT_SENSOR_DEVICE_T *)sensor_hdl;
+
+    if (sensor_dev->is_open) {
+        return OPRT_OK;
+    }
+
+    if (NULL == sensor_dev->drdy_sem) {
+        TUYA_CALL_ERR_RETURN(tal_semaphore_create_init(&sensor_dev->drdy_sem, 0, 1));
+    }
+
+    sensor_dev->drdy_cnt = 0;
+    sensor_dev->read_cnt = 0;
+    memset(&sensor_dev->stats, 0, sizeof(TDL_FT_SENSOR_STATS_T));
+
+    if (sensor_dev->intfs.open) {
+        TUYA_CALL_ERR_RETURN(sensor_dev->intfs.open(sensor_dev->tdd_hdl, __ft_sensor_drdy_cb, sensor_dev));
+    }
+
+    sensor_dev->is_open = true;
+
+    return OPRT_OK;
+}
+
+/* wait for data-ready and account the events skipped since the last read, the burst read follows */
+static OPERATE_RET __ft_sensor_wait_drdy(FT_SENSOR_DEVICE_T *sensor_dev, uint32_t timeout_ms, uint64_t *drdy_us)
+{
+    uint32_t drdy_cnt = 0;
+
+    if (OPRT_OK != tal_semaphore_wait(sensor_dev->drdy_sem, timeout_ms)) {
+        return OPRT_TIMEOUT;
+    }
+
+    TAL_ENTER_CRITICAL();
+    drdy_cnt = sensor_dev->drdy_cnt;
+    *drdy_us = sensor_dev->drdy_us;
+    TAL_EXIT_CRITICAL();
+
+    /* the sensor only holds the newest frame, every skipped data-ready is a lost sample */
+    if (drdy_cnt - sensor_dev->read_cnt > 1) {
+        sensor_dev->stats.overruns += drdy_cnt - sensor_dev->read_cnt - 1;
+    }
+    sensor_dev->read_cnt = drdy_cnt;
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tdl_ft_sensor_dev_read(TDL_FT_SENSOR_HANDLE_T sensor_hdl, TDL_FT_FRAME_T *frame, uint32_t timeout_ms)
+{
+    OPERATE_RET rt = OPRT_OK;
+    FT_SENSOR_DEVICE_T *sensor_dev = NULL;
+    uint64_t drdy_us = 0;
+
+    if (NULL == sensor_hdl || NULL == frame) {
+        return OPRT_INVALID_PARM;
+    }
+
+    sensor_dev = (FT_SENSOR_DEVICE_T *)sensor_hdl;
+
+    if (false == sensor_dev->is_open || NULL == sensor_dev->intfs.read) {
+        return OPRT_COM_ERROR;
+    }
+
+    /* a timeout is the normal way out of an idle wait, not worth an error log */
+    rt = __ft_sensor_wait_drdy(sensor_dev, timeout_ms, &drdy_us);
+    if (OPRT_OK != rt) {
+        return rt;
+    }
+
+    rt = sensor_dev->intfs.read(sensor_dev->tdd_hdl, frame->ch);
+    if (OPRT_OK != rt) {
+        sensor_dev->stats.read_errors++;
+        return rt;
+    }
+
+    frame->timestamp_us = drdy_us;
+    sensor_dev->stats.frames++;
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tdl_ft_sensor_dev_read_raw(TDL_FT_SENSOR_HANDLE_T sensor_hdl, TDL_FT_RAW_FRAME_T *frame,
+                                       uint32_t timeout_ms)
+{
+    OPERATE_RET rt = OPRT_OK;
+    FT_SENSOR_DEVICE_T *sensor_dev = NULL;
+    uint64_t drdy_us = 0;
+
+    if (NULL == sensor_hdl || NULL == frame) {
+        return OPRT_INVALID_PARM;
+    }
+
+    sensor_dev = (FT_SENSOR_DEVICE_T *)sensor_hdl;
+
+    if (NULL == sensor_dev->intfs.read_raw) {
+        return OPRT_NOT_SUPPORTED;
+    }
+    if (false == sensor_dev->is_open) {
+        return OPRT_COM_ERROR;
+    }
+
+    rt = __ft_sensor_wait_drdy(sensor_dev, timeout_ms, &drdy_us);
+    if (OPRT_OK != rt) {
+        return rt;
+    }
+
+    rt = sensor_dev->intfs.read_raw(sensor_dev->tdd_hdl, frame->raw);
+    if (OPRT_OK != rt) {
+        sensor_dev->stats.read_errors++;
+        return rt;
+    }
+
+    frame->timestamp_us = drdy_us;
+    sensor_dev->stats.frames++;
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tdl_ft_sensor_dev_get_lsb(TDL_FT_SENSOR_HANDLE_T sensor_hdl, float lsb[TDL_FT_SENSOR_CHANNELS])
+{
+    FT_SENSOR_DEVICE_T *sensor_dev = NULL;
+
+    if (NULL == sensor_hdl || NULL == lsb) {
+        return OPRT_INVALID_PARM;
+    }
+
+    sensor_dev = (FT_SENSOR_DEVICE_T *)sensor_hdl;
+
+    if (NULL == sensor_dev->intfs.read_raw || NULL == sensor_dev->intfs.get_lsb) {
+        return OPRT_NOT_SUPPORTED;
+    }
+
+    return sensor_dev->intfs.get_lsb(sensor_dev->tdd_hdl, lsb);
+}
+
+OPERATE_RET tdl_ft_sensor_dev_get_stats(TDL_FT_SENSOR_HANDLE_T sensor_hdl, TDL_FT_SENSOR_STATS_T *stats)
+{
+    if (NULL == sensor_hdl || NULL == stats) {
+        return OPRT_INVALID_PARM;
+    }
+
+    *stats = ((FT_SENSOR_DEVICE_T *)sensor_hdl)->stats;
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tdl_ft_sensor_dev_close(TDL_FT_SENSOR_HANDLE_T sensor_hdl)
+{
+    OPERATE_RET rt = OPRT_OK;
+    FT_SENSOR_DEVICE_T *sensor_dev = NULL;
+
+    if (NULL == sensor_hdl) {
+        return OPRT_INVALID_PARM;
+    }
+
+    sensor_dev = (FT_SENSOR_DEVICE_T *)sensor_hdl;
+
+    if (false == sensor_dev->is_open) {
+        return OPRT_OK;
+    }
+
+    if (sensor_dev->intfs.close) {
+        TUYA_CALL_ERR_RETURN(sensor_dev->intfs.close(sensor_dev->tdd_hdl));
+    }
+
+    sensor_dev->is_open = false;
+
+    /* wake a reader blocked in tdl_ft_sensor_dev_read, it sees is_open cleared on its next call */
+    tal_semaphore_post(sensor_dev->drdy_sem);
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tdl_ft_sensor_device_register(char *name, TDD_FT_SENSOR_DEV_HANDLE_T tdd_hdl,
+                                          TDD_FT_SENSOR_INTFS_T *intfs)
+{
+    FT_SENSOR_DEVICE_T *sensor_dev = NULL;
+
+    if (NULL == name || NULL == tdd_hdl || NULL == intfs) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (__find_ft_sensor_device(name)) {
+        return OPRT_COM_ERROR;
+    }
+
+    NEW_LIST_NODE(FT_SENSOR_DEVICE_T, sensor_dev);
+    if (NULL == sensor_dev) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(sensor_dev, 0, sizeof(FT_SENSOR_DEVICE_T));
+
+    strncpy(sensor_dev->name, name, FT_SENSOR_DEV_NAME_MAX_LEN);
+
+    sensor_dev->tdd_hdl = tdd_hdl;
+
+    memcpy(&sensor_dev->intfs, intfs, sizeof(TDD_FT_SENSOR_INTFS_T));
+
+    tuya_list_add(&sensor_dev->node, &sg_ft_sensor_list);
+
+    return OPRT_OK;
+}
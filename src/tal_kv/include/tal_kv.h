@@ -171,6 +171,26 @@ void tal_kv_cmd(int argc, char *argv[]);
  */
 lfs_t *tal_lfs_get();
 
+/**
+ * @brief Lock the LFS instance shared by the KV store and other users of
+ * tal_lfs_get()
+ *
+ * Any code that operates on the handle returned by tal_lfs_get() must hold
+ * this lock, the littlefs core is not thread safe.
+ *
+ * @return OPRT_OK on success, OPRT_RESOURCE_NOT_READY if the KV module is not
+ * initialized
+ */
+int tal_lfs_lock(void);
+
+/**
+ * @brief Unlock the LFS instance locked by tal_lfs_lock()
+ *
+ * @return OPRT_OK on success, OPRT_RESOURCE_NOT_READY if the KV module is not
+ * initialized
+ */
+int tal_lfs_unlock(void);
+
 #ifdef __cplusplus
 }
 #endif
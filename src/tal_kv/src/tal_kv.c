@@ -475,4 +475,38 @@ int tal_kv_serialize_get(const char *key, kv_db_t *db, size_t dbcnt)
 lfs_t *tal_lfs_get()
 {
     return &lfs;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Lock the LFS instance shared by the KV store and other users of
+ * tal_lfs_get()
+ *
+ * Any code that operates on the handle returned by tal_lfs_get() must hold
+ * this lock, the littlefs core is not thread safe.
+ *
+ * @return OPRT_OK on success, OPRT_RESOURCE_NOT_READY if the KV module is not
+ * initialized
+ */
+int tal_lfs_lock(void)
+{
+    if (NULL == lfs_mutex) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
+
+    return tal_mutex_lock(lfs_mutex);
+}
+
+/**
+ * @brief Unlock the LFS instance locked by tal_lfs_lock()
+ *
+ * @return OPRT_OK on success, OPRT_RESOURCE_NOT_READY if the KV module is not
+ * initialized
+ */
+int tal_lfs_unlock(void)
+{
+    if (NULL == lfs_mutex) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
+
+    return tal_mutex_unlock(lfs_mutex);
+}
@@ -50,6 +50,44 @@ extern "C" {
  */
 #define EVENT_DESC_MAX_LEN (32)
 
+/**
+ * @brief hash buckets of the event registry, power of 2
+ *
+ */
+#ifndef EVENT_HASH_SIZE
+#define EVENT_HASH_SIZE (32)
+#endif
+
+/**
+ * @brief event id table, allocated a page at a time. the page directory starts
+ * with EVENT_ID_PAGE_NUM pages and doubles when it is full, up to the range of
+ * EVENT_ID
+ *
+ */
+#ifndef EVENT_ID_PAGE_NUM
+#define EVENT_ID_PAGE_NUM (16)
+#endif
+#define EVENT_ID_PAGE_SIZE (32)
+
+/**
+ * @brief pooled messages of the asynchronous publish, larger payloads are
+ * allocated when published
+ *
+ */
+#ifndef EVENT_ASYNC_MSG_NUM
+#define EVENT_ASYNC_MSG_NUM (8)
+#endif
+#ifndef EVENT_ASYNC_MSG_SIZE
+#define EVENT_ASYNC_MSG_SIZE (64)
+#endif
+
+/**
+ * @brief the interned event name, 0 is invalid
+ *
+ */
+typedef uint16_t EVENT_ID;
+#define EVENT_ID_INVALID 0
+
 /**
  * @brief subscriber type
  *
@@ -85,6 +123,7 @@ typedef struct {
     char name[EVENT_NAME_MAX_LEN + 1]; // name, used to record the the event info
     char desc[EVENT_DESC_MAX_LEN + 1]; // description, used to record the subscribe info
     SUBSCRIBE_TYPE_E type;             // the subscribe type
+    uint8_t prio;                      // the dispatch priority, higher first, emergency before all
     EVENT_SUBSCRIBE_CB cb;             // the subscribe callback function
     struct tuya_list_head node;        // list node, used to attch to the event node
 } SUBSCRIBE_NODE_T;
@@ -93,14 +132,26 @@ typedef struct {
  * @brief the event node
  *
  */
-typedef struct {
+typedef struct event_node {
     MUTEX_HANDLE mutex; // mutex, protection the event publish and subscribe
 
     char name[EVENT_NAME_MAX_LEN + 1];    // name, the event name
+    EVENT_ID id;                          // id, the interned name
+    uint32_t hash;                        // hash, the hash of the name
+    struct event_node *hash_next;         // hash node, used to attach to the hash bucket
     struct tuya_list_head node;           // list node, used to attach to the event manage module
     struct tuya_list_head subscribe_root; // subscibe root, used to manage the subscriber
 } EVENT_NODE_T;
 
+/**
+ * @brief the page directory of the event id table
+ *
+ */
+typedef struct {
+    uint32_t page_num;         // pages the directory can hold
+    EVENT_NODE_T **page[];     // pages of EVENT_ID_PAGE_SIZE events, NULL until the first event in it
+} EVENT_ID_DIR_T;
+
 /**
  * @brief the event manage node
  *
@@ -112,6 +163,10 @@ typedef struct {
     struct tuya_list_head event_root;          // event root, used to manage the event
     struct tuya_list_head free_subscribe_root; // free subscriber list, used to manage the
                                                // subscribe which not found the event
+    EVENT_NODE_T *hash_bucket[EVENT_HASH_SIZE]; // hash buckets, used to find the event by name
+    EVENT_ID_DIR_T *id_dir;                     // id table, used to find the event by id
+    void *msg_pool;                             // pooled messages of the asynchronous publish
+    void *free_msg;                             // free list of the pooled messages
 } EVENT_MANAGE_T;
 
 /**
@@ -132,6 +187,51 @@ OPERATE_RET tal_event_init(void);
  */
 OPERATE_RET tal_event_publish(const char *name, void *data);
 
+/**
+ * @brief: get the id of event, the event is created if not exist
+ *
+ * @param[in] name: event name
+ * @param[out] id: event id, used to publish without looking up the name
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_event_get_id(const char *name, EVENT_ID *id);
+
+/**
+ * @brief: publish event by id
+ *
+ * @param[in] id: event id
+ * @param[in] data: event data
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_event_publish_by_id(EVENT_ID id, void *data);
+
+/**
+ * @brief: publish event asynchronously, the subscribers are called in the
+ * system work queue and the publisher does not wait for them
+ *
+ * @param[in] name: event name
+ * @param[in] data: event data
+ * @param[in] len: the data length. the data is copied and the subscribers get
+ * the copy. when len is 0, the subscribers get data itself, which must stay
+ * valid until they are called
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_event_publish_async(const char *name, const void *data, uint32_t len);
+
+/**
+ * @brief: publish event asynchronously by id
+ *
+ * @param[in] id: event id
+ * @param[in] data: event data
+ * @param[in] len: the data length, see tal_event_publish_async
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_event_publish_async_by_id(EVENT_ID id, const void *data, uint32_t len);
+
 /**
  * @brief: subscribe event
  *
@@ -144,6 +244,22 @@ OPERATE_RET tal_event_publish(const char *name, void *data);
  */
 OPERATE_RET tal_event_subscribe(const char *name, const char *desc, const EVENT_SUBSCRIBE_CB cb, SUBSCRIBE_TYPE_E type);
 
+/**
+ * @brief: subscribe event with dispatch priority
+ *
+ * @param[in] name: event name
+ * @param[in] desc: subscribe description
+ * @param[in] cb: subscribe callback function
+ * @param[in] type: subscribe type
+ * @param[in] prio: dispatch priority, higher is called first, subscribers of
+ * the same priority are called by the subscribe order. tal_event_subscribe
+ * uses 0
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_event_subscribe_prio(const char *name, const char *desc, const EVENT_SUBSCRIBE_CB cb,
+                                     SUBSCRIBE_TYPE_E type, uint8_t prio);
+
 /**
  * @brief: unsubscribe event
  *
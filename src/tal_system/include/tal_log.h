@@ -133,6 +133,14 @@ OPERATE_RET tal_log_print(const TAL_LOG_LEVEL_E level, const char *file, const i
 // prototype of log output function
 typedef void (*TAL_LOG_OUTPUT_CB)(const char *str);
 
+// statistics of the asynchronous log backend, see ENABLE_LOG_ASYNC
+typedef struct {
+    uint32_t queued;  // logs queued for the drain thread
+    uint32_t pending; // logs queued and not output yet
+    uint32_t dropped; // logs lost because the ring of the calling thread was full
+    uint32_t text;    // logs formatted by the caller because their arguments did not fit in a record
+} TAL_LOG_ASYNC_STAT_T;
+
 /***********************************************************************
  ********************* variable ****************************************
  **********************************************************************/
@@ -350,6 +358,37 @@ void tal_log_color_set(const TAL_LOG_LEVEL_E level, TAL_LOG_DISPLAY_MODE_E displ
 OPERATE_RET tal_log_color_print_raw(TAL_LOG_DISPLAY_MODE_E display_mode, TAL_LOG_FONT_COLOR_E font_color,
                                     TAL_LOG_BACKGROUND_COLOR_E background_color, const char *pFmt, ...);
 
+/**
+ * @brief output the logs queued for the drain thread
+ *
+ * @note With ENABLE_LOG_ASYNC, log calls queue the format pointer and the arguments and a low priority thread
+ * formats and outputs them. This API outputs what is queued on the calling thread, for example before a planned
+ * reset. It does nothing when logs are printed synchronously.
+ *
+ * @return NONE
+ */
+void tal_log_flush(void);
+
+/**
+ * @brief output the logs queued for the drain thread from a crash handler
+ *
+ * @note This API neither sleeps nor takes a lock, call it only when no other thread will run again. A log that was
+ * being output when the drain thread stopped may come out twice.
+ *
+ * @return NONE
+ */
+void tal_log_crash_flush(void);
+
+/**
+ * @brief get the statistics of the asynchronous log backend
+ *
+ * @param[out] stat, the statistics since tal_log_init
+ *
+ * @return OPRT_OK on success, OPRT_NOT_SUPPORTED if ENABLE_LOG_ASYNC is off. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_log_async_get_stat(TAL_LOG_ASYNC_STAT_T *stat);
+
 #ifdef __cplusplus
 }
 #endif /* __TAL_LOG_H__ */
@@ -116,6 +116,19 @@ SYS_TICK_T tal_system_get_tick_count(void);
  */
 SYS_TIME_T tal_system_get_millisecond(void);
 
+/**
+ * @brief Get monotonic system time in microseconds
+ *
+ * @param[in] param: none
+ *
+ * @note the 32-bit platform counter is extended to 64 bits, wraps are resolved
+ * against the millisecond clock so long gaps between calls are handled. falls
+ * back to millisecond resolution when the platform has no microsecond counter.
+ *
+ * @return microseconds since boot
+ */
+uint64_t tal_system_get_microsecond(void);
+
 /**
  * @brief Get system random data
  *
@@ -101,6 +101,17 @@ OPERATE_RET tal_workq_cancel(WORKQ_SERVICE_E service, WORKQUEUE_CB cb, void *dat
  */
 uint16_t tal_workq_get_num(WORKQ_SERVICE_E service);
 
+/**
+ * @brief get the statistics of the work queue
+ *
+ * @param[in] service the workqueue service
+ * @param[out] stat the statistics since the work queue was created
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workq_get_stat(WORKQ_SERVICE_E service, WORKQUEUE_STAT_T *stat);
+
 /**
  * @brief dump all work in work queue.
  *
@@ -39,6 +39,18 @@ typedef struct {
 } WORK_ITEM_T;
 typedef BOOL_T (*WORKQUEUE_TRAVERSE_CB)(WORK_ITEM_T *item, void *ctx);
 
+typedef struct {
+    uint8_t worker_num;
+    uint16_t used;        // items waiting now
+    uint16_t peak;        // most items waiting at once
+    uint32_t executed;    // callbacks run, cancelled items are not counted
+    uint32_t stolen;      // items a worker took from the queue of another worker
+    uint32_t wait_avg_us; // from schedule to the start of the callback
+    uint32_t wait_max_us;
+    uint32_t run_avg_us; // time spent in the callback
+    uint32_t run_max_us;
+} WORKQUEUE_STAT_T;
+
 /**
  * @brief create and initialize a workqueue which runs in thread context
  *
@@ -52,6 +64,26 @@ typedef BOOL_T (*WORKQUEUE_TRAVERSE_CB)(WORK_ITEM_T *item, void *ctx);
  */
 OPERATE_RET tal_workqueue_create(const uint16_t queue_len, THREAD_CFG_T *thread_cfg, WORKQUEUE_HANDLE *handle);
 
+/**
+ * @brief create and initialize a workqueue served by several threads
+ *
+ * @param[in] queue_len the maximum number of items that the workqueue can
+ * contain
+ * @param[in] worker_num the number of threads, 1 to 8
+ * @param[in] thread_cfg thread param, the name gets the worker index appended
+ * when worker_num is more than 1
+ * @param[out] handle the workqueue handle
+ *
+ * @note with more than one worker, callbacks run concurrently and only start
+ * in about the order they were scheduled. instant work still starts before
+ * work scheduled normally.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_create_pool(const uint16_t queue_len, const uint8_t worker_num, THREAD_CFG_T *thread_cfg,
+                                      WORKQUEUE_HANDLE *handle);
+
 /**
  * @brief put work task in workqueue
  *
@@ -109,6 +141,17 @@ OPERATE_RET tal_workqueue_traverse(WORKQUEUE_HANDLE handle, WORKQUEUE_TRAVERSE_C
  */
 uint16_t tal_workqueue_get_num(WORKQUEUE_HANDLE handle);
 
+/**
+ * @brief get the statistics of the workqueue
+ *
+ * @param[in] handle the workqueue handle
+ * @param[out] stat the statistics since the workqueue was created
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_get_stat(WORKQUEUE_HANDLE handle, WORKQUEUE_STAT_T *stat);
+
 /**
  * @brief release the workqueue
  *
@@ -124,7 +167,7 @@ OPERATE_RET tal_workqueue_release(WORKQUEUE_HANDLE handle);
  *
  * @param[in] handle the workqueue handle
  *
- * @return thread handle
+ * @return thread handle, the first worker of a pool
  */
 THREAD_HANDLE tal_workqueue_get_thread(WORKQUEUE_HANDLE handle);
 
@@ -18,7 +18,9 @@
  * - Event name and description validation
  * - Event node creation and initialization
  * - Subscription management (addition, deletion, retrieval)
- * - Event dispatching to subscribed listeners
+ * - Event dispatching to subscribed listeners, in the publisher or in the
+ *   system work queue, by subscriber priority
+ * - Hashed lookup of the event name and interned event ids
  * - Thread-safe operations through mutex locking
  * - Debugging utilities for event and subscription dumping
  *
@@ -34,6 +36,17 @@
 #include "tal_event.h"
 #include "tal_api.h"
 
+typedef struct event_msg {
+    struct event_msg *next; // free list node
+    EVENT_NODE_T *event;
+    void *data;     // the payload, or the data of the publisher when len is 0
+    BOOL_T pooled;
+    uint8_t payload[];
+} EVENT_MSG_T;
+
+// the largest directory the id range needs
+#define EVENT_ID_PAGE_MAX (((EVENT_ID)~0 + EVENT_ID_PAGE_SIZE - 1) / EVENT_ID_PAGE_SIZE)
+
 static EVENT_MANAGE_T g_event_manager = {0};
 
 BOOL_T _event_name_is_valid(const char *name)
@@ -62,25 +75,159 @@ BOOL_T _event_desc_is_valid(const char *desc)
     return TRUE;
 }
 
+// FNV-1a
+static uint32_t _event_name_hash(const char *name)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*name) {
+        hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+    return hash;
+}
+
+// add to different position according to the emergence flag and the priority
+static void _event_node_insert_subscribe(EVENT_NODE_T *event, SUBSCRIBE_NODE_T *subscribe)
+{
+    struct tuya_list_head *pos = NULL;
+    SUBSCRIBE_NODE_T *entry = NULL;
+
+    if (subscribe->type == SUBSCRIBE_TYPE_EMERGENCY) {
+        tuya_list_add(&subscribe->node, &event->subscribe_root);
+        return;
+    }
+
+    // behind the emergency ones and those of the same or higher priority
+    tuya_list_for_each(pos, &event->subscribe_root)
+    {
+        entry = tuya_list_entry(pos, SUBSCRIBE_NODE_T, node);
+        if (entry->type != SUBSCRIBE_TYPE_EMERGENCY && entry->prio < subscribe->prio) {
+            break;
+        }
+    }
+    tuya_list_add_tail(&subscribe->node, pos);
+}
+
+/*
+ * events are never freed, so the hash buckets and the id table are only ever added to. they are
+ * changed under the manager mutex and published with release stores, lookups run without a lock.
+ * a full page directory is replaced by a copy twice as large, the old one is kept since a lookup
+ * may still be reading it. the directories kept add up to less than the current one.
+ */
+EVENT_NODE_T *_event_node_get(const char *name)
+{
+    uint32_t hash = _event_name_hash(name);
+    EVENT_NODE_T *entry = __atomic_load_n(&g_event_manager.hash_bucket[hash & (EVENT_HASH_SIZE - 1)], __ATOMIC_ACQUIRE);
+
+    // find by hash, then by name
+    for (; entry; entry = entry->hash_next) {
+        if (entry->hash == hash && 0 == strcmp(entry->name, name)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+EVENT_NODE_T *_event_node_get_by_id(EVENT_ID id)
+{
+    EVENT_NODE_T **page = NULL;
+    EVENT_ID_DIR_T *dir = __atomic_load_n(&g_event_manager.id_dir, __ATOMIC_ACQUIRE);
+
+    if (id == EVENT_ID_INVALID || dir == NULL || id > dir->page_num * EVENT_ID_PAGE_SIZE) {
+        return NULL;
+    }
+
+    page = __atomic_load_n(&dir->page[(id - 1) / EVENT_ID_PAGE_SIZE], __ATOMIC_ACQUIRE);
+    if (page == NULL) {
+        return NULL;
+    }
+
+    return __atomic_load_n(&page[(id - 1) % EVENT_ID_PAGE_SIZE], __ATOMIC_ACQUIRE);
+}
+
+// called with the manager mutex held
+static EVENT_ID_DIR_T *_event_id_dir_grow(EVENT_ID_DIR_T *dir)
+{
+    EVENT_ID_DIR_T *grown = NULL;
+    uint32_t page_num = dir ? dir->page_num * 2 : EVENT_ID_PAGE_NUM;
+
+    if (page_num > EVENT_ID_PAGE_MAX) {
+        page_num = EVENT_ID_PAGE_MAX;
+    }
+
+    grown = tal_malloc(sizeof(EVENT_ID_DIR_T) + page_num * sizeof(EVENT_NODE_T **));
+    if (grown == NULL) {
+        return NULL;
+    }
+    memset(grown, 0, sizeof(EVENT_ID_DIR_T) + page_num * sizeof(EVENT_NODE_T **));
+    grown->page_num = page_num;
+    if (dir) {
+        memcpy(grown->page, dir->page, dir->page_num * sizeof(EVENT_NODE_T **));
+    }
+    __atomic_store_n(&g_event_manager.id_dir, grown, __ATOMIC_RELEASE);
+
+    return grown;
+}
+
 EVENT_NODE_T *_event_node_create_init(const char *name)
 {
+    EVENT_NODE_T *event = NULL;
+    EVENT_ID_DIR_T *dir = NULL;
+    EVENT_NODE_T **page = NULL;
+    EVENT_ID id = EVENT_ID_INVALID;
+    struct tuya_list_head *free_pos = NULL;
+    struct tuya_list_head *free_next = NULL;
+    SUBSCRIBE_NODE_T *free_entry = NULL;
+
+    tal_mutex_lock(g_event_manager.mutex);
+
+    // another publisher or subscriber may have created it
+    event = _event_node_get(name);
+    if (event) {
+        goto __EXIT;
+    }
+
+    // take an id, a page of the id table is allocated by the first event in it
+    if (g_event_manager.event_cnt >= (EVENT_ID)~0) {
+        PR_ERR("too many events, %s not created", name);
+        goto __EXIT;
+    }
+    id = g_event_manager.event_cnt + 1;
+    dir = g_event_manager.id_dir;
+    if (dir == NULL || id > dir->page_num * EVENT_ID_PAGE_SIZE) {
+        dir = _event_id_dir_grow(dir);
+        if (dir == NULL) {
+            goto __EXIT;
+        }
+    }
+    page = dir->page[(id - 1) / EVENT_ID_PAGE_SIZE];
+    if (page == NULL) {
+        page = tal_malloc(EVENT_ID_PAGE_SIZE * sizeof(EVENT_NODE_T *));
+        if (page == NULL) {
+            goto __EXIT;
+        }
+        memset(page, 0, EVENT_ID_PAGE_SIZE * sizeof(EVENT_NODE_T *));
+        __atomic_store_n(&dir->page[(id - 1) / EVENT_ID_PAGE_SIZE], page, __ATOMIC_RELEASE);
+    }
+
     // allocate memory
-    EVENT_NODE_T *event = tal_malloc(sizeof(EVENT_NODE_T));
-    TUYA_CHECK_NULL_RETURN(event, NULL);
+    event = tal_malloc(sizeof(EVENT_NODE_T));
+    if (event == NULL) {
+        goto __EXIT;
+    }
     memset(event, 0, sizeof(EVENT_NODE_T));
 
     // initialze the event node
     memcpy(event->name, name, strlen(name));
     event->name[strlen(name)] = '\0';
+    event->id = id;
+    event->hash = _event_name_hash(name);
     INIT_LIST_HEAD(&event->subscribe_root);
     tal_mutex_create_init(&event->mutex);
 
-    tal_mutex_lock(g_event_manager.mutex);
-
     // need check if there have free subscriber which subscribe this event
-    struct tuya_list_head *free_pos = NULL;
-    struct tuya_list_head *free_next = NULL;
-    SUBSCRIBE_NODE_T *free_entry = NULL;
     tuya_list_for_each_safe(free_pos, free_next, &g_event_manager.free_subscribe_root)
     {
         // find by event name, and add it to subscribe list
@@ -88,42 +235,23 @@ EVENT_NODE_T *_event_node_create_init(const char *name)
         if (0 == strcmp(free_entry->name, name)) {
             // del from free subscrbe list
             tuya_list_del(&free_entry->node);
-
-            // add to different position according to the emergence flag
-            if (free_entry->type == SUBSCRIBE_TYPE_EMERGENCY) {
-                tuya_list_add(&free_entry->node, &event->subscribe_root);
-            } else {
-                tuya_list_add_tail(&free_entry->node, &event->subscribe_root);
-            }
+            _event_node_insert_subscribe(event, free_entry);
         }
     }
 
-    // at last, need add this event to event manage root
+    // at last, need add this event to event manage root, the id table and the hash bucket
     tuya_list_add_tail(&event->node, &g_event_manager.event_root);
     g_event_manager.event_cnt++;
+    __atomic_store_n(&page[(id - 1) % EVENT_ID_PAGE_SIZE], event, __ATOMIC_RELEASE);
+    event->hash_next = g_event_manager.hash_bucket[event->hash & (EVENT_HASH_SIZE - 1)];
+    __atomic_store_n(&g_event_manager.hash_bucket[event->hash & (EVENT_HASH_SIZE - 1)], event, __ATOMIC_RELEASE);
 
+__EXIT:
     tal_mutex_unlock(g_event_manager.mutex);
 
     return event;
 }
 
-EVENT_NODE_T *_event_node_get(const char *name)
-{
-    // try to get event from event root
-    EVENT_NODE_T *entry = NULL;
-    struct tuya_list_head *pos = NULL;
-    tuya_list_for_each(pos, &g_event_manager.event_root)
-    {
-        // find by name
-        entry = tuya_list_entry(pos, EVENT_NODE_T, node);
-        if (0 == strcmp(entry->name, name)) {
-            return entry;
-        }
-    }
-
-    return NULL;
-}
-
 SUBSCRIBE_NODE_T *_event_node_get_free_subscribe(SUBSCRIBE_NODE_T *subscribe)
 {
     struct tuya_list_head *pos = NULL;
@@ -218,12 +346,8 @@ OPERATE_RET _event_node_add_subscribe(EVENT_NODE_T *event, SUBSCRIBE_NODE_T *sub
     TUYA_CHECK_NULL_RETURN(new_entry, OPRT_MALLOC_FAILED);
     memcpy(new_entry, subscribe, sizeof(SUBSCRIBE_NODE_T));
 
-    // try to add, if emergence, add to first, otherwise, add to tail
-    if (subscribe->type == SUBSCRIBE_TYPE_EMERGENCY) {
-        tuya_list_add(&new_entry->node, &event->subscribe_root);
-    } else {
-        tuya_list_add_tail(&new_entry->node, &event->subscribe_root);
-    }
+    // try to add, if emergence, add to first, otherwise, add by priority
+    _event_node_insert_subscribe(event, new_entry);
 
     return rt;
 }
@@ -262,6 +386,101 @@ OPERATE_RET _event_node_del_subscribe(EVENT_NODE_T *event, SUBSCRIBE_NODE_T *sub
     return rt;
 }
 
+EVENT_MSG_T *_event_msg_alloc(uint32_t len)
+{
+    EVENT_MSG_T *msg = NULL;
+
+    // the pool is allocated by the first asynchronous publish
+    if (len <= EVENT_ASYNC_MSG_SIZE) {
+        tal_mutex_lock(g_event_manager.mutex);
+        if (g_event_manager.msg_pool == NULL) {
+            uint32_t msg_size = sizeof(EVENT_MSG_T) + EVENT_ASYNC_MSG_SIZE;
+            g_event_manager.msg_pool = tal_malloc(EVENT_ASYNC_MSG_NUM * msg_size);
+            for (uint32_t i = 0; g_event_manager.msg_pool && i < EVENT_ASYNC_MSG_NUM; i++) {
+                msg = (EVENT_MSG_T *)((uint8_t *)g_event_manager.msg_pool + i * msg_size);
+                msg->pooled = TRUE;
+                msg->next = g_event_manager.free_msg;
+                g_event_manager.free_msg = msg;
+            }
+        }
+        msg = g_event_manager.free_msg;
+        if (msg) {
+            g_event_manager.free_msg = msg->next;
+        }
+        tal_mutex_unlock(g_event_manager.mutex);
+        if (msg) {
+            return msg;
+        }
+    }
+
+    // too large or pool exhausted
+    msg = tal_malloc(sizeof(EVENT_MSG_T) + len);
+    TUYA_CHECK_NULL_RETURN(msg, NULL);
+    msg->pooled = FALSE;
+
+    return msg;
+}
+
+void _event_msg_free(EVENT_MSG_T *msg)
+{
+    if (!msg->pooled) {
+        tal_free(msg);
+        return;
+    }
+
+    tal_mutex_lock(g_event_manager.mutex);
+    msg->next = g_event_manager.free_msg;
+    g_event_manager.free_msg = msg;
+    tal_mutex_unlock(g_event_manager.mutex);
+}
+
+OPERATE_RET _event_node_publish(EVENT_NODE_T *event, void *data)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    // to keep the consistency, dispatch will done in mutex lock
+    tal_mutex_lock(event->mutex);
+    // try to dispatch event to all subscribe
+    // if one of the subscribe failed, it will continue but will return failed
+    // to record the execute status
+    TUYA_CALL_ERR_LOG(_event_node_dispatch(event, data));
+
+    tal_mutex_unlock(event->mutex);
+
+    return rt;
+}
+
+void _event_async_dispatch_cb(void *data)
+{
+    EVENT_MSG_T *msg = (EVENT_MSG_T *)data;
+
+    _event_node_publish(msg->event, msg->data);
+    _event_msg_free(msg);
+}
+
+OPERATE_RET _event_node_publish_async(EVENT_NODE_T *event, const void *data, uint32_t len)
+{
+    OPERATE_RET rt = OPRT_OK;
+
+    EVENT_MSG_T *msg = _event_msg_alloc(len);
+    TUYA_CHECK_NULL_RETURN(msg, OPRT_MALLOC_FAILED);
+
+    msg->event = event;
+    if (len && data) {
+        memcpy(msg->payload, data, len);
+        msg->data = msg->payload;
+    } else {
+        msg->data = (void *)data;
+    }
+
+    rt = tal_workq_schedule(WORKQ_SYSTEM, _event_async_dispatch_cb, msg);
+    if (OPRT_OK != rt) {
+        _event_msg_free(msg);
+    }
+
+    return rt;
+}
+
 #if 0
 int _ty_event_dump()
 {
@@ -374,7 +593,6 @@ OPERATE_RET tal_event_publish(const char *name, void *data)
         return OPRT_BASE_EVENT_INVALID_EVENT_NAME;
     }
 
-    OPERATE_RET rt = OPRT_OK;
     // try to get event, if not exist, create and init.
     EVENT_NODE_T *event = _event_node_get(name);
     if (!event) {
@@ -382,16 +600,108 @@ OPERATE_RET tal_event_publish(const char *name, void *data)
         TUYA_CHECK_NULL_RETURN(event, OPRT_MALLOC_FAILED);
     }
 
-    // to keep the consistency, dispatch will done in mutex lock
-    tal_mutex_lock(event->mutex);
-    // try to dispatch event to all subscribe
-    // if one of the subscribe failed, it will continue but will return failed
-    // to record the execute status
-    TUYA_CALL_ERR_LOG(_event_node_dispatch(event, data));
+    return _event_node_publish(event, data);
+}
 
-    tal_mutex_unlock(event->mutex);
+/**
+ * @brief Gets the id of an event, creating the event if it does not exist.
+ *
+ * The id is the interned event name. Publishing by id skips validating and
+ * hashing the name.
+ *
+ * @param[in] name The name of the event.
+ * @param[out] id The id of the event.
+ * @return The operation result. Returns OPRT_OK on success, or an error code on
+ * failure.
+ */
+OPERATE_RET tal_event_get_id(const char *name, EVENT_ID *id)
+{
+    if (g_event_manager.inited != TRUE) {
+        tal_event_init();
+    }
 
-    return rt;
+    if (!_event_name_is_valid(name)) {
+        return OPRT_BASE_EVENT_INVALID_EVENT_NAME;
+    }
+
+    TUYA_CHECK_NULL_RETURN(id, OPRT_INVALID_PARM);
+
+    EVENT_NODE_T *event = _event_node_get(name);
+    if (!event) {
+        event = _event_node_create_init(name);
+        TUYA_CHECK_NULL_RETURN(event, OPRT_MALLOC_FAILED);
+    }
+
+    *id = event->id;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief Publishes an event with the given id and data.
+ *
+ * @param[in] id The id of the event, from tal_event_get_id.
+ * @param[in] data The data associated with the event.
+ * @return The operation result. Returns OPRT_OK on success, or an error code on
+ * failure.
+ */
+OPERATE_RET tal_event_publish_by_id(EVENT_ID id, void *data)
+{
+    EVENT_NODE_T *event = _event_node_get_by_id(id);
+    TUYA_CHECK_NULL_RETURN(event, OPRT_INVALID_PARM);
+
+    return _event_node_publish(event, data);
+}
+
+/**
+ * @brief Publishes an event without waiting for the subscribers.
+ *
+ * The data is copied into a message, pooled when it fits in
+ * EVENT_ASYNC_MSG_SIZE, and the subscribers are called from the system work
+ * queue in the same order as for tal_event_publish. A slow subscriber holds up
+ * the work queue instead of the publisher. Asynchronous publishes of an event
+ * are dispatched in order as long as the system work queue has one worker.
+ *
+ * @param[in] name The name of the event to publish.
+ * @param[in] data The data associated with the event.
+ * @param[in] len The number of bytes to copy, 0 to pass data itself.
+ * @return The operation result. Returns OPRT_OK on success, or an error code on
+ * failure.
+ */
+OPERATE_RET tal_event_publish_async(const char *name, const void *data, uint32_t len)
+{
+    if (g_event_manager.inited != TRUE) {
+        tal_event_init();
+    }
+
+    if (!_event_name_is_valid(name)) {
+        return OPRT_BASE_EVENT_INVALID_EVENT_NAME;
+    }
+
+    EVENT_NODE_T *event = _event_node_get(name);
+    if (!event) {
+        event = _event_node_create_init(name);
+        TUYA_CHECK_NULL_RETURN(event, OPRT_MALLOC_FAILED);
+    }
+
+    return _event_node_publish_async(event, data, len);
+}
+
+/**
+ * @brief Publishes an event by id without waiting for the subscribers.
+ *
+ * @param[in] id The id of the event, from tal_event_get_id.
+ * @param[in] data The data associated with the event.
+ * @param[in] len The number of bytes to copy, 0 to pass data itself.
+ * @return The operation result. Returns OPRT_OK on success, or an error code on
+ * failure.
+ */
+OPERATE_RET tal_event_publish_async_by_id(EVENT_ID id, const void *data, uint32_t len)
+{
+    EVENT_NODE_T *event = _event_node_get_by_id(id);
+    TUYA_CHECK_NULL_RETURN(event, OPRT_INVALID_PARM);
+
+    return _event_node_publish_async(event, data, len);
 }
 
 /**
@@ -410,6 +720,25 @@ OPERATE_RET tal_event_publish(const char *name, void *data)
  *         - OPRT_BASE_EVENT_INVALID_EVENT_NAME: Invalid event name.
  */
 OPERATE_RET tal_event_subscribe(const char *name, const char *desc, const EVENT_SUBSCRIBE_CB cb, SUBSCRIBE_TYPE_E type)
+{
+    return tal_event_subscribe_prio(name, desc, cb, type, 0);
+}
+
+/**
+ * @brief Subscribes to an event with a dispatch priority.
+ *
+ * Emergency subscribers are called first, the others by descending priority
+ * and by the subscribe order within a priority.
+ *
+ * @param name The name of the event to subscribe to.
+ * @param desc The description of the event.
+ * @param cb The callback function to be called when the event is triggered.
+ * @param type The type of subscription.
+ * @param prio The dispatch priority.
+ * @return The result of the operation, see tal_event_subscribe.
+ */
+OPERATE_RET tal_event_subscribe_prio(const char *name, const char *desc, const EVENT_SUBSCRIBE_CB cb,
+                                     SUBSCRIBE_TYPE_E type, uint8_t prio)
 {
     if (g_event_manager.inited != TRUE) {
         tal_event_init();
@@ -427,18 +756,22 @@ OPERATE_RET tal_event_subscribe(const char *name, const char *desc, const EVENT_
     SUBSCRIBE_NODE_T subscribe = {0};
     subscribe.cb = cb;
     subscribe.type = type;
+    subscribe.prio = prio;
     memcpy(subscribe.name, name, strlen(name));
     subscribe.name[strlen(name)] = '\0';
     memcpy(subscribe.desc, desc, strlen(desc));
     subscribe.desc[strlen(desc)] = '\0';
 
+    // look again under the manager mutex, the event may be created meanwhile
+    tal_mutex_lock(g_event_manager.mutex);
     EVENT_NODE_T *event = _event_node_get(name);
     if (!event) {
         // if not found the event, add to the free list
-        tal_mutex_lock(g_event_manager.mutex);
         TUYA_CALL_ERR_LOG(_event_node_add_free_subscribe(&subscribe));
-        tal_mutex_unlock(g_event_manager.mutex);
-    } else {
+    }
+    tal_mutex_unlock(g_event_manager.mutex);
+
+    if (event) {
         // if found the event, add to the subscribe list
         tal_mutex_lock(event->mutex);
         TUYA_CALL_ERR_LOG(_event_node_add_subscribe(event, &subscribe));
@@ -487,13 +820,15 @@ OPERATE_RET tal_event_unsubscribe(const char *name, const char *desc, EVENT_SUBS
     memcpy(subscribe.desc, desc, strlen(desc));
     subscribe.desc[strlen(desc)] = '\0';
 
+    tal_mutex_lock(g_event_manager.mutex);
     EVENT_NODE_T *event = _event_node_get(name);
     if (!event) {
         // if not found the event, del from the free list
-        tal_mutex_lock(g_event_manager.mutex);
         TUYA_CALL_ERR_LOG(_event_node_del_free_subscribe(&subscribe));
-        tal_mutex_unlock(g_event_manager.mutex);
-    } else {
+    }
+    tal_mutex_unlock(g_event_manager.mutex);
+
+    if (event) {
         // if found the event, del from the subscribe list
         tal_mutex_lock(event->mutex);
         TUYA_CALL_ERR_LOG(_event_node_del_subscribe(event, &subscribe));
@@ -13,6 +13,8 @@
  * - Configurable log levels ranging from debug to critical errors.
  * - Support for multiple log output destinations through callback registration.
  * - Thread-safe log message output using mutexes.
+ * - Optional asynchronous output (ENABLE_LOG_ASYNC): log calls queue the format
+ *   and its arguments in lock-free rings, a low priority thread formats them.
  * - Integration with Tuya's IoT SDK for memory management and system utilities.
  *
  * The logging system is implemented using a linked list to manage output
@@ -39,12 +41,105 @@
 #include "tal_time_service.h"
 #include "tal_memory.h"
 
+#if defined(ENABLE_LOG_ASYNC) && (ENABLE_LOG_ASYNC == 1)
+#include "tal_thread.h"
+#include "tal_semaphore.h"
+#include "tkl_thread.h"
+#define LOG_ASYNC 1
+#else
+#define LOG_ASYNC 0
+#endif
+
 /***********************************************************
 *************************micro define***********************
 ***********************************************************/
 #define LOG_LEVEL_MIN 0
 #define LOG_LEVEL_MAX 5
 
+#if LOG_ASYNC
+#ifndef LOG_ASYNC_RING_NUM
+#define LOG_ASYNC_RING_NUM 4
+#endif
+
+#ifndef LOG_ASYNC_RING_SIZE
+#define LOG_ASYNC_RING_SIZE 32
+#endif
+
+#ifndef LOG_ASYNC_RECORD_SIZE
+#define LOG_ASYNC_RECORD_SIZE 96
+#endif
+
+#ifndef STACK_SIZE_LOG_ASYNC
+#define STACK_SIZE_LOG_ASYNC (4 * 1024)
+#endif
+
+#if (LOG_ASYNC_RING_SIZE & (LOG_ASYNC_RING_SIZE - 1))
+#error "LOG_ASYNC_RING_SIZE must be a power of 2"
+#endif
+
+#define LOG_RING_MASK    (LOG_ASYNC_RING_SIZE - 1)
+#define LOG_SPEC_MAX_LEN 16 // longest conversion spec kept as arguments, "%-+08.3lld" is 10
+
+// how a record keeps its message
+#define LOG_REC_ARGS 0 // data holds the arguments of fmt, the drain thread formats them
+#define LOG_REC_TEXT 1 // data holds the message, formatted by the caller
+
+// how an argument is stored, in the order it is read from the va_list
+typedef enum {
+    LOG_ARG_INT = 0,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_SIZE,
+    LOG_ARG_PTRDIFF,
+    LOG_ARG_INTMAX,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_PTR,
+    LOG_ARG_STR, // copied with its terminator
+} LOG_ARG_E;
+
+typedef struct {
+    uint8_t star;   // widths and precisions given as '*', each an int argument before the value
+    LOG_ARG_E type; // type of the value
+} LOG_SPEC_S;
+
+typedef struct {
+    uint32_t seq; // ring position the record is ready for, see __log_async_write
+    uint8_t level;
+    uint8_t type;
+    uint32_t line;
+    uint64_t time_us;
+    const char *file;
+    const char *fmt;
+    uint8_t data[LOG_ASYNC_RECORD_SIZE];
+} LOG_RECORD_S;
+
+/**
+ * @brief bounded multi-producer ring of log records
+ *
+ * Threads are spread over the rings by their id, so a thread always writes the same ring and threads on
+ * different rings never touch the same position. Only the drain writes tail.
+ */
+typedef struct {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t drop; // records lost because the ring was full
+    uint32_t text; // records formatted by the caller
+    LOG_RECORD_S rec[LOG_ASYNC_RING_SIZE];
+} LOG_RING_S;
+
+typedef struct {
+    LOG_RING_S ring[LOG_ASYNC_RING_NUM];
+    THREAD_HANDLE thread;
+    SEM_HANDLE sem;
+    uint8_t kick;     // set once the drain thread has been posted, cleared when it starts a drain
+    uint8_t draining; // set while a drain owns the tails of the rings
+    uint32_t drop_reported;
+    SYS_TICK_T base_ms; // posix time in ms when tal_system_get_microsecond was 0, set by each drain
+    int buf_len;
+    char *buf; // the drain formats here, the caller side keeps log_buf for synchronous prints
+} LOG_ASYNC_S;
+#endif
+
 typedef struct {
     LIST_HEAD node;
     char *name;
@@ -73,6 +168,9 @@ typedef struct {
     int log_buf_len;
     BOOL_T ms_level;
     char *log_buf;
+#if LOG_ASYNC
+    LOG_ASYNC_S *async; // NULL until the drain thread runs, logs are printed synchronously then
+#endif
 } LOG_MANAGE, *P_LOG_MANAGE;
 
 #define DEF_OUTPUT_NAME "def_output"
@@ -91,6 +189,11 @@ const LOG_TEXT_STYLE_S sDefaultStyle[LOG_LEVEL_MAX + 1] = {
     {TAL_LOG_DISPLAY_MODE_DEFAULT, TAL_LOG_FONT_COLOR_GREEN, TAL_LOG_BACKGROUND_COLOR_DEFAULT},
     {TAL_LOG_DISPLAY_MODE_DEFAULT, TAL_LOG_FONT_COLOR_WHITE, TAL_LOG_BACKGROUND_COLOR_DEFAULT}};
 
+#if LOG_ASYNC
+static OPERATE_RET __log_async_create(void);
+static void __log_async_release(void);
+#endif
+
 /***********************************************************
 *************************function define********************
 ***********************************************************/
@@ -146,6 +249,12 @@ OPERATE_RET tal_log_init(const TAL_LOG_LEVEL_E level, const int buf_len, const T
             tal_free(tmp_log_mng);
             return op_ret;
         }
+
+#if LOG_ASYNC
+        if (OPRT_OK != __log_async_create()) {
+            PR_ERR("log drain thread start failed, logs are printed synchronously");
+        }
+#endif
     } else {
         pLogManage->curLogLevel = level;
     }
@@ -153,7 +262,7 @@ OPERATE_RET tal_log_init(const TAL_LOG_LEVEL_E level, const int buf_len, const T
     return OPRT_OK;
 }
 
-void __output_logManage_buf(void)
+void __output_logManage_buf(const char *buf)
 {
     P_LIST_HEAD pPos;
     LOG_OUT_NODE_S *output_node;
@@ -161,7 +270,7 @@ void __output_logManage_buf(void)
     {
         output_node = tuya_list_entry(pPos, LOG_OUT_NODE_S, node);
         if (output_node->out_term) {
-            output_node->out_term(pLogManage->log_buf);
+            output_node->out_term(buf);
         }
     }
 }
@@ -336,6 +445,656 @@ OPERATE_RET tal_log_get_level(TAL_LOG_LEVEL_E *level)
     return OPRT_OK;
 }
 
+static const char *__log_file_name(const char *file)
+{
+    int pos = 0;
+
+    if (NULL == file) {
+        return "Null";
+    }
+    pos = tal_log_strrchr((char *)file, '/');
+    if (pos < 0) {
+        pos = tal_log_strrchr((char *)file, '\\');
+    }
+
+    return (pos >= 0) ? file + pos + 1 : file;
+}
+
+/**
+ * @brief Formats the color prefix and the time, level and location head of a log line.
+ *
+ * @param buf The buffer to format into.
+ * @param size The size of the buffer.
+ * @param level The log level of the message.
+ * @param file The file name shown in the head.
+ * @param line The line number shown in the head.
+ * @param sec The posix time of the message in seconds, 0 for the current time.
+ * @param ms The millisecond part of the time, shown when the millisecond information is enabled.
+ * @return The length of the head, or -1 if formatting failed.
+ */
+static int __log_format_head(char *buf, int size, LOG_LEVEL level, const char *file, uint32_t line, TIME_T sec,
+                             uint32_t ms)
+{
+    int len = 0;
+    int cnt = 0;
+    const char *pTmpModuleName = "ty";
+    POSIX_TM_S tm;
+
+    // color prefix
+    if (pLogManage->log_color.enable_color) {
+        cnt = snprintf(buf, size, "\033[%d;%d;%dm", pLogManage->log_color.style[level].display_mode,
+                       pLogManage->log_color.style[level].font_color,
+                       pLogManage->log_color.style[level].background_color);
+        if (cnt <= 0) {
+            return -1;
+        }
+        len += cnt;
+    }
+
+    memset(&tm, 0, sizeof(tm));
+    tal_time_get_local_time_custom(sec, &tm);
+    if (pLogManage->ms_level == FALSE) {
+        cnt = snprintf(buf + len, size - len, "[%02d-%02d %02d:%02d:%02d %s %s][%s:%" PRIu32 "] ", tm.tm_mon + 1,
+                       tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, pTmpModuleName, sLevelStr[level], file, line);
+    } else {
+        cnt = snprintf(buf + len, size - len, "[%02d-%02d %02d:%02d:%02d:%" PRIu32 " %s %s][%s:%" PRIu32 "] ",
+                       tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, ms, pTmpModuleName,
+                       sLevelStr[level], file, line);
+    }
+    if (cnt <= 0) {
+        return -1;
+    }
+
+    return len + cnt;
+}
+
+/**
+ * @brief Appends the color suffix and line end to a log line, cutting the message if the buffer is full.
+ *
+ * @param buf The buffer holding the head and the message.
+ * @param size The size of the buffer.
+ * @param len The length of the head and the message, may be more than fits.
+ * @return The length of the log line, or -1 if formatting failed.
+ */
+static int __log_format_tail(char *buf, int size, int len)
+{
+    int cnt = 0;
+    char *p_suffix = (pLogManage->log_color.enable_color) ? "\033[0m\r\n" : "\r\n";
+
+    if (len > (int)(size - strlen(p_suffix) - 1)) { // 1 -> "\0"
+        len = size - strlen(p_suffix) - 1;
+    }
+    cnt = snprintf(buf + len, size - len, "%s", p_suffix);
+    if (cnt <= 0) {
+        return -1;
+    }
+    len += cnt;
+    buf[len] = '\0';
+
+    return len;
+}
+
+#if LOG_ASYNC
+typedef union {
+    int i;
+    long l;
+    long long ll;
+    size_t z;
+    ptrdiff_t t;
+    intmax_t j;
+    double d;
+    void *p;
+} LOG_ARG_U;
+
+static const uint8_t sArgSize[] = {sizeof(int),      sizeof(long),     sizeof(long long), sizeof(size_t),
+                                   sizeof(ptrdiff_t), sizeof(intmax_t), sizeof(double),    sizeof(void *)};
+
+/**
+ * @brief Parses the conversion spec after a '%'.
+ *
+ * The caller and the drain thread both walk the format with this, so they agree on the arguments. Conversions whose
+ * argument can not be kept, such as %n, %Lf and wide strings, make the caller format the record itself.
+ *
+ * @param p The character after the '%'.
+ * @param spec The arguments the conversion takes.
+ * @return The character after the spec, or NULL if the spec is not supported.
+ */
+static const char *__log_spec_parse(const char *p, LOG_SPEC_S *spec)
+{
+    const char *start = p - 1;
+    char modifier = 0;
+
+    spec->star = 0;
+    while ('-' == *p || '+' == *p || ' ' == *p || '#' == *p || '0' == *p) {
+        p++;
+    }
+    if ('*' == *p) {
+        spec->star++;
+        p++;
+    } else {
+        while (isdigit((uint8_t)*p)) {
+            p++;
+        }
+    }
+    if ('.' == *p) {
+        p++;
+        if ('*' == *p) {
+            spec->star++;
+            p++;
+        } else {
+            while (isdigit((uint8_t)*p)) {
+                p++;
+            }
+        }
+    }
+
+    switch (*p) {
+    case 'h': // char and short are passed as int
+        p += ('h' == p[1]) ? 2 : 1;
+        break;
+    case 'l':
+        modifier = ('l' == p[1]) ? 'q' : 'l';
+        p += ('l' == p[1]) ? 2 : 1;
+        break;
+    case 'z':
+    case 't':
+    case 'j':
+        modifier = *p++;
+        break;
+    default:
+        break;
+    }
+
+    switch (*p) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+        spec->type = ('l' == modifier)   ? LOG_ARG_LONG
+                     : ('q' == modifier) ? LOG_ARG_LLONG
+                     : ('z' == modifier) ? LOG_ARG_SIZE
+                     : ('t' == modifier) ? LOG_ARG_PTRDIFF
+                     : ('j' == modifier) ? LOG_ARG_INTMAX
+                                         : LOG_ARG_INT;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        spec->type = LOG_ARG_DOUBLE;
+        break;
+    case 'p':
+        spec->type = LOG_ARG_PTR;
+        break;
+    case 'c':
+    case 's':
+        if (modifier) {
+            return NULL;
+        }
+        spec->type = ('c' == *p) ? LOG_ARG_INT : LOG_ARG_STR;
+        break;
+    default: // %n, %L, unknown conversions and a '%' at the end of the format
+        return NULL;
+    }
+    p++;
+
+    return (p - start > LOG_SPEC_MAX_LEN) ? NULL : p;
+}
+
+static BOOL_T __log_arg_put(uint8_t *data, int *len, const void *arg, int size)
+{
+    if (*len + size > LOG_ASYNC_RECORD_SIZE) {
+        return FALSE;
+    }
+    memcpy(data + *len, arg, size);
+    *len += size;
+
+    return TRUE;
+}
+
+/**
+ * @brief Stores the arguments of a format in a record, strings are copied.
+ *
+ * @param data The argument area of the record.
+ * @param fmt The format string.
+ * @param ap The arguments of the format.
+ * @return The length of the arguments, or -1 if the format is not supported or the arguments do not fit.
+ */
+static int __log_args_pack(uint8_t *data, const char *fmt, va_list ap)
+{
+    LOG_SPEC_S spec;
+    LOG_ARG_U arg;
+    const char *p = fmt;
+    const char *str = NULL;
+    int str_len = 0;
+    int len = 0;
+    uint8_t i = 0;
+
+    while (NULL != (p = strchr(p, '%'))) {
+        if ('%' == p[1]) {
+            p += 2;
+            continue;
+        }
+        p = __log_spec_parse(p + 1, &spec);
+        if (NULL == p) {
+            return -1;
+        }
+
+        for (i = 0; i < spec.star; i++) {
+            arg.i = va_arg(ap, int);
+            if (!__log_arg_put(data, &len, &arg.i, sizeof(int))) {
+                return -1;
+            }
+        }
+
+        switch (spec.type) {
+        case LOG_ARG_INT:
+            arg.i = va_arg(ap, int);
+            break;
+        case LOG_ARG_LONG:
+            arg.l = va_arg(ap, long);
+            break;
+        case LOG_ARG_LLONG:
+            arg.ll = va_arg(ap, long long);
+            break;
+        case LOG_ARG_SIZE:
+            arg.z = va_arg(ap, size_t);
+            break;
+        case LOG_ARG_PTRDIFF:
+            arg.t = va_arg(ap, ptrdiff_t);
+            break;
+        case LOG_ARG_INTMAX:
+            arg.j = va_arg(ap, intmax_t);
+            break;
+        case LOG_ARG_DOUBLE:
+            arg.d = va_arg(ap, double);
+            break;
+        case LOG_ARG_PTR:
+            arg.p = va_arg(ap, void *);
+            break;
+        case LOG_ARG_STR:
+            str = va_arg(ap, const char *);
+            str = str ? str : "(null)";
+            for (str_len = 0; (len + str_len < LOG_ASYNC_RECORD_SIZE) && str[str_len]; str_len++) {
+            }
+            if (!__log_arg_put(data, &len, str, str_len + 1)) {
+                return -1;
+            }
+            continue;
+        }
+        if (!__log_arg_put(data, &len, &arg, sArgSize[spec.type])) {
+            return -1;
+        }
+    }
+
+    return len;
+}
+
+static int __log_arg_print(char *buf, int size, const char *spec, LOG_ARG_E type, const LOG_ARG_U *arg)
+{
+    switch (type) {
+    case LOG_ARG_INT:
+        return snprintf(buf, size, spec, arg->i);
+    case LOG_ARG_LONG:
+        return snprintf(buf, size, spec, arg->l);
+    case LOG_ARG_LLONG:
+        return snprintf(buf, size, spec, arg->ll);
+    case LOG_ARG_SIZE:
+        return snprintf(buf, size, spec, arg->z);
+    case LOG_ARG_PTRDIFF:
+        return snprintf(buf, size, spec, arg->t);
+    case LOG_ARG_INTMAX:
+        return snprintf(buf, size, spec, arg->j);
+    case LOG_ARG_DOUBLE:
+        return snprintf(buf, size, spec, arg->d);
+    case LOG_ARG_PTR:
+        return snprintf(buf, size, spec, arg->p);
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Formats the message of a record that keeps the arguments of its format.
+ *
+ * Each conversion is printed on its own with the arguments read back in the order __log_args_pack stored them.
+ *
+ * @param buf The buffer to format into.
+ * @param size The size of the buffer.
+ * @param fmt The format string.
+ * @param data The argument area of the record.
+ * @return The length of the message, at most size - 1.
+ */
+static int __log_args_format(char *buf, int size, const char *fmt, const uint8_t *data)
+{
+    LOG_SPEC_S spec;
+    LOG_ARG_U arg;
+    char spec_buf[LOG_SPEC_MAX_LEN + 2 * 11 + 1]; // each '*' becomes an int of up to 11 characters
+    const char *p = fmt;
+    const char *end = NULL;
+    int star = 0;
+    int pos = 0;
+    int len = 0;
+    int cnt = 0;
+    int n = 0;
+
+    if (size <= 0) {
+        return 0;
+    }
+
+    while (*p && len < size - 1) {
+        if ('%' != *p) {
+            buf[len++] = *p++;
+            continue;
+        }
+        if ('%' == p[1]) {
+            buf[len++] = '%';
+            p += 2;
+            continue;
+        }
+        end = __log_spec_parse(p + 1, &spec);
+        if (NULL == end) {
+            break; // the caller parsed the same format, so this does not happen
+        }
+
+        for (n = 0; p < end; p++) {
+            if ('*' == *p) {
+                memcpy(&star, data + pos, sizeof(int));
+                pos += sizeof(int);
+                n += snprintf(spec_buf + n, sizeof(spec_buf) - n, "%d", star);
+            } else {
+                spec_buf[n++] = *p;
+            }
+        }
+        spec_buf[n] = '\0';
+
+        if (LOG_ARG_STR == spec.type) {
+            cnt = snprintf(buf + len, size - len, spec_buf, (const char *)(data + pos));
+            pos += strlen((const char *)(data + pos)) + 1;
+        } else {
+            memset(&arg, 0, sizeof(arg));
+            memcpy(&arg, data + pos, sArgSize[spec.type]);
+            pos += sArgSize[spec.type];
+            cnt = __log_arg_print(buf + len, size - len, spec_buf, spec.type, &arg);
+        }
+        if (cnt > 0) {
+            len += (cnt < size - len) ? cnt : size - len - 1;
+        }
+    }
+    buf[len] = '\0';
+
+    return len;
+}
+
+static LOG_RING_S *__log_ring_self(LOG_ASYNC_S *async)
+{
+#if LOG_ASYNC_RING_NUM > 1
+    TKL_THREAD_HANDLE self = NULL;
+    uint32_t key = 0;
+
+    if (OPRT_OK == tkl_thread_get_id(&self)) {
+        key = (uint32_t)((uintptr_t)self >> 4) * 2654435761u; // spread handles that differ in a few bits
+        return &async->ring[(key >> 16) % LOG_ASYNC_RING_NUM];
+    }
+#endif
+
+    return &async->ring[0];
+}
+
+/**
+ * @brief Queues a log record for the drain thread, on the caller's thread.
+ *
+ * The record keeps the format pointer, the file pointer, the time and the arguments. A format without arguments is
+ * copied into the record, it may be a buffer of the caller rather than a literal. If the format has a conversion that
+ * can not be kept or the arguments do not fit, the caller formats the message into the record instead. Copied and
+ * formatted messages are cut to LOG_ASYNC_RECORD_SIZE.
+ *
+ * @return OPRT_OK if the record is queued, OPRT_EXCEED_UPPER_LIMIT if the ring is full and the record is dropped.
+ */
+static OPERATE_RET __log_async_write(LOG_ASYNC_S *async, LOG_LEVEL level, const char *file, uint32_t line,
+                                     const char *fmt, va_list ap)
+{
+    LOG_RING_S *ring = __log_ring_self(async);
+    LOG_RECORD_S *rec = NULL;
+    uint64_t time_us = tal_system_get_microsecond();
+    uint32_t pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    int32_t diff = 0;
+    int len = 0;
+    va_list args;
+
+    // the record at pos is free when its seq is pos and ready when it is pos + 1, the drain gives it back for the
+    // next lap as pos + LOG_ASYNC_RING_SIZE. claiming pos is the only write threads on one ring share
+    for (;;) {
+        rec = &ring->rec[pos & LOG_RING_MASK];
+        diff = (int32_t)(__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) - pos);
+        if (0 == diff) {
+            if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_add_fetch(&ring->drop, 1, __ATOMIC_RELAXED);
+            return OPRT_EXCEED_UPPER_LIMIT;
+        } else {
+            pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    rec->level = level;
+    rec->line = line;
+    rec->time_us = time_us;
+    rec->file = file;
+    rec->fmt = fmt;
+    va_copy(args, ap);
+    len = __log_args_pack(rec->data, fmt, args);
+    va_end(args);
+    if (len > 0) {
+        rec->type = LOG_REC_ARGS;
+    } else {
+        // without arguments this only copies the text, expanding "%%"
+        if (vsnprintf((char *)rec->data, LOG_ASYNC_RECORD_SIZE, fmt, ap) < 0) {
+            rec->data[0] = '\0';
+        }
+        rec->type = LOG_REC_TEXT;
+        if (len < 0) {
+            __atomic_add_fetch(&ring->text, 1, __ATOMIC_RELAXED);
+        }
+    }
+    __atomic_store_n(&rec->seq, pos + 1, __ATOMIC_RELEASE);
+
+    // one post per drain, the drain clears kick before it looks at the rings
+    if (!__atomic_exchange_n(&async->kick, 1, __ATOMIC_SEQ_CST)) {
+        tal_semaphore_post(async->sem);
+    }
+
+    return OPRT_OK;
+}
+
+static void __log_async_output(LOG_ASYNC_S *async, const LOG_RECORD_S *rec, BOOL_T lock)
+{
+    SYS_TICK_T time_ms = async->base_ms + rec->time_us / 1000;
+    int len = 0;
+
+    len = __log_format_head(async->buf, async->buf_len, (LOG_LEVEL)rec->level, __log_file_name(rec->file), rec->line,
+                            (TIME_T)(time_ms / 1000), (uint32_t)(time_ms % 1000));
+    if (len <= 0) {
+        return;
+    }
+    if (LOG_REC_TEXT == rec->type) {
+        len += snprintf(async->buf + len, async->buf_len - len, "%s", (const char *)rec->data);
+    } else {
+        len += __log_args_format(async->buf + len, async->buf_len - len, rec->fmt, rec->data);
+    }
+    if (__log_format_tail(async->buf, async->buf_len, len) <= 0) {
+        return;
+    }
+
+    if (lock) {
+        tal_mutex_lock(pLogManage->mutex);
+    }
+    __output_logManage_buf(async->buf);
+    if (lock) {
+        tal_mutex_unlock(pLogManage->mutex);
+    }
+}
+
+/**
+ * @brief Outputs all ready records, the caller must own the tails of the rings.
+ *
+ * The rings are merged by record time, so lines of different threads come out in the order they were logged. A ring
+ * stops at a record that is claimed but not yet written.
+ *
+ * @param async The asynchronous backend.
+ * @param lock Whether to take the log mutex around each output.
+ */
+static void __log_async_drain(LOG_ASYNC_S *async, BOOL_T lock)
+{
+    LOG_RING_S *ring = NULL;
+    LOG_RING_S *from = NULL;
+    LOG_RECORD_S *rec = NULL;
+    LOG_RECORD_S *oldest = NULL;
+    uint32_t drop = 0;
+    uint32_t tail = 0;
+    uint8_t i = 0;
+
+    for (;;) {
+        oldest = NULL;
+        for (i = 0; i < LOG_ASYNC_RING_NUM; i++) {
+            ring = &async->ring[i];
+            rec = &ring->rec[ring->tail & LOG_RING_MASK];
+            if (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) != ring->tail + 1) {
+                continue;
+            }
+            if ((NULL == oldest) || (rec->time_us < oldest->time_us)) {
+                oldest = rec;
+                from = ring;
+            }
+        }
+        if (NULL == oldest) {
+            break;
+        }
+
+        __log_async_output(async, oldest, lock);
+        tail = from->tail;
+        __atomic_store_n(&oldest->seq, tail + LOG_ASYNC_RING_SIZE, __ATOMIC_RELEASE);
+        __atomic_store_n(&from->tail, tail + 1, __ATOMIC_RELAXED);
+    }
+
+    for (i = 0; i < LOG_ASYNC_RING_NUM; i++) {
+        drop += __atomic_load_n(&async->ring[i].drop, __ATOMIC_RELAXED);
+    }
+    if (drop != async->drop_reported) {
+        LOG_RECORD_S report = {.level = TAL_LOG_LEVEL_WARN,
+                               .type = LOG_REC_TEXT,
+                               .line = __LINE__,
+                               .time_us = tal_system_get_microsecond(),
+                               .file = __FILE__};
+        snprintf((char *)report.data, sizeof(report.data), "%" PRIu32 " logs dropped, the ring was full",
+                 drop - async->drop_reported);
+        async->drop_reported = drop;
+        __log_async_output(async, &report, lock);
+    }
+}
+
+static BOOL_T __log_async_claim(LOG_ASYNC_S *async)
+{
+    return !__atomic_test_and_set(&async->draining, __ATOMIC_ACQUIRE);
+}
+
+static void __log_async_unclaim(LOG_ASYNC_S *async)
+{
+    __atomic_clear(&async->draining, __ATOMIC_RELEASE);
+}
+
+static void __log_async_sync_time(LOG_ASYNC_S *async)
+{
+    async->base_ms = tal_time_get_posix_ms() - tal_system_get_microsecond() / 1000;
+}
+
+static void __log_async_thread_cb(void *arg)
+{
+    LOG_ASYNC_S *async = (LOG_ASYNC_S *)arg;
+
+    while (THREAD_STATE_RUNNING == tal_thread_get_state(async->thread)) {
+        tal_semaphore_wait(async->sem, SEM_WAIT_FOREVER);
+        __atomic_store_n(&async->kick, 0, __ATOMIC_SEQ_CST);
+        // tal_log_flush drains on its own thread meanwhile, it takes what this post was for
+        if (__log_async_claim(async)) {
+            __log_async_sync_time(async);
+            __log_async_drain(async, TRUE);
+            __log_async_unclaim(async);
+        }
+    }
+}
+
+static OPERATE_RET __log_async_create(void)
+{
+    OPERATE_RET rt = OPRT_OK;
+    LOG_ASYNC_S *async = NULL;
+    THREAD_CFG_T thread_cfg = {
+        .stackDepth = STACK_SIZE_LOG_ASYNC,
+        .priority = THREAD_PRIO_5,
+        .thrdname = "log_drain",
+    };
+    uint32_t i = 0;
+    uint32_t j = 0;
+
+    async = (LOG_ASYNC_S *)tal_malloc(sizeof(LOG_ASYNC_S) + pLogManage->log_buf_len + 1);
+    if (NULL == async) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(async, 0, sizeof(LOG_ASYNC_S));
+    async->buf_len = pLogManage->log_buf_len;
+    async->buf = (char *)(async + 1);
+    for (i = 0; i < LOG_ASYNC_RING_NUM; i++) {
+        for (j = 0; j < LOG_ASYNC_RING_SIZE; j++) {
+            async->ring[i].rec[j].seq = j;
+        }
+    }
+
+    rt = tal_semaphore_create_init(&async->sem, 0, 1);
+    if (OPRT_OK != rt) {
+        tal_free(async);
+        return rt;
+    }
+    rt = tal_thread_create_and_start(&async->thread, NULL, NULL, __log_async_thread_cb, async, &thread_cfg);
+    if (OPRT_OK != rt) {
+        tal_semaphore_release(async->sem);
+        tal_free(async);
+        return rt;
+    }
+    pLogManage->async = async;
+
+    return OPRT_OK;
+}
+
+static void __log_async_release(void)
+{
+    LOG_ASYNC_S *async = pLogManage->async;
+
+    if (NULL == async) {
+        return;
+    }
+    pLogManage->async = NULL;
+
+    tal_thread_delete(async->thread);
+    tal_semaphore_post(async->sem);
+    while (THREAD_STATE_DELETE != tal_thread_get_state(async->thread)) {
+        tal_system_sleep(10);
+    }
+
+    __log_async_sync_time(async);
+    __log_async_drain(async, TRUE);
+    tal_semaphore_release(async->sem);
+    tal_free(async);
+}
+#endif
+
 /**
  * @brief Prints a log message with the specified log level, file name, line
  * number, and format string.
@@ -367,6 +1126,8 @@ OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char
 {
     int len = 0;
     int cnt = 0;
+    TIME_T sec = 0;
+    uint32_t ms = 0;
 
     if (!pLogManage) {
         return OPRT_INVALID_PARM;
@@ -378,77 +1139,37 @@ OPERATE_RET PrintLogV(LOG_LEVEL logLevel, char *pFile, uint32_t line, const char
     if (logLevel > tmpLogLevel) {
         return OPRT_BASE_LOG_MNG_PRINT_LOG_LEVEL_HIGHER;
     }
-    const char *pTmpModuleName = "ty";
-    const char *pTmpFilename = NULL;
 
-    if (NULL == pFile) {
-        pTmpFilename = "Null";
-    } else {
-        int pos = 0;
-        pTmpFilename = pFile;
-        pos = tal_log_strrchr((char *)pFile, '/');
-        if (pos < 0) {
-            pos = tal_log_strrchr((char *)pFile, '\\');
-            if (pos >= 0) {
-                pTmpFilename = pFile + pos + 1;
-            }
-        } else {
-            pTmpFilename = pFile + pos + 1;
-        }
+#if LOG_ASYNC
+    if (pLogManage->async) {
+        return __log_async_write(pLogManage->async, logLevel, pFile, line, pFmt, ap);
     }
-    tal_mutex_lock(pLogManage->mutex);
+#endif
 
-    // color prefix
-    if (pLogManage->log_color.enable_color) {
-        cnt = snprintf(pLogManage->log_buf, pLogManage->log_buf_len, "\033[%d;%d;%dm",
-                       pLogManage->log_color.style[logLevel].display_mode,
-                       pLogManage->log_color.style[logLevel].font_color,
-                       pLogManage->log_color.style[logLevel].background_color);
-        if (cnt <= 0) {
-            goto ERR_EXIT;
-        }
-        len += cnt;
+    if (pLogManage->ms_level) {
+        SYS_TICK_T time_ms = tal_time_get_posix_ms();
+        sec = (TIME_T)(time_ms / 1000);
+        ms = (uint32_t)(time_ms % 1000);
     }
 
-    POSIX_TM_S tm;
-    memset(&tm, 0, sizeof(tm));
+    tal_mutex_lock(pLogManage->mutex);
 
-    if (pLogManage->ms_level == FALSE) {
-        tal_time_get_local_time_custom(0, &tm);
-        cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len,
-                       "[%02d-%02d %02d:%02d:%02d %s %s][%s:%" PRIu32 "] ", tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
-                       tm.tm_min, tm.tm_sec, pTmpModuleName, sLevelStr[logLevel], pTmpFilename, line);
-    } else {
-        SYS_TICK_T time_ms = tal_time_get_posix_ms();
-        TIME_T sec = (TIME_T)(time_ms / 1000);
-        uint32_t ms = (uint32_t)(time_ms % 1000);
-        tal_time_get_local_time_custom(sec, &tm);
-        cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len,
-                       "[%02d-%02d %02d:%02d:%02d:%" PRIu32 " %s %s][%s:%" PRIu32 "] ", tm.tm_mon + 1, tm.tm_mday,
-                       tm.tm_hour, tm.tm_min, tm.tm_sec, ms, pTmpModuleName, sLevelStr[logLevel], pTmpFilename, line);
-    }
-    if (cnt <= 0) {
+    len = __log_format_head(pLogManage->log_buf, pLogManage->log_buf_len, logLevel, __log_file_name(pFile), line, sec,
+                            ms);
+    if (len <= 0) {
         goto ERR_EXIT;
     }
-    len += cnt;
     cnt = vsnprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len, pFmt, ap);
     if (cnt <= 0) {
         goto ERR_EXIT;
     }
     len += cnt;
 
-    char *p_suffix = (pLogManage->log_color.enable_color) ? "\033[0m\r\n" : "\r\n";
-    if (len > (int)(pLogManage->log_buf_len - strlen(p_suffix) - 1)) { // 1 -> "\0"
-        len = pLogManage->log_buf_len - strlen(p_suffix) - 1;
-    }
-    cnt = snprintf(pLogManage->log_buf + len, pLogManage->log_buf_len - len, "%s", p_suffix);
-    if (cnt <= 0) {
+    if (__log_format_tail(pLogManage->log_buf, pLogManage->log_buf_len, len) <= 0) {
         goto ERR_EXIT;
     }
-    len += cnt;
-    pLogManage->log_buf[len] = '\0';
 
-    __output_logManage_buf();
+    __output_logManage_buf(pLogManage->log_buf);
     tal_mutex_unlock(pLogManage->mutex);
 
     return OPRT_OK;
@@ -496,7 +1217,7 @@ static OPERATE_RET __PrintLogVRaw(const char *pFmt, va_list ap)
     if (cnt <= 0) {
         return OPRT_BASE_LOG_MNG_FORMAT_STRING_FAILED;
     }
-    __output_logManage_buf();
+    __output_logManage_buf(pLogManage->log_buf);
 
     return OPRT_OK;
 }
@@ -545,9 +1266,13 @@ void tal_log_release(void)
         return;
     }
 
+#if LOG_ASYNC
+    __log_async_release();
+#endif
+
     while (!tuya_list_empty(&(pLogManage->log_list))) {
         LOG_OUT_NODE_S *log_out_nd = NULL;
-        log_out_nd = tuya_list_entry(&(pLogManage->log_list.next), LOG_OUT_NODE_S, node);
+        log_out_nd = tuya_list_entry(pLogManage->log_list.next, LOG_OUT_NODE_S, node);
         tuya_list_del(&(log_out_nd->node));
         if (log_out_nd->name) {
             tal_free(log_out_nd->name);
@@ -594,6 +1319,7 @@ void tal_log_hex_dump(const TAL_LOG_LEVEL_E level, const char *file, const int l
         width = 64;
     }
     tal_log_print(level, file, line, "%s %d <%p>", title, size, buf);
+    tal_log_flush(); // the dump lines are printed synchronously, output the title first
 
     for (i = 0; i < size; i += width) {
         tal_log_print_raw("%04lX | ", i);
@@ -727,7 +1453,7 @@ OPERATE_RET tal_log_color_print_raw(TAL_LOG_DISPLAY_MODE_E display_mode, TAL_LOG
 
     pLogManage->log_buf[len] = 0;
 
-    __output_logManage_buf();
+    __output_logManage_buf(pLogManage->log_buf);
 
 __EXIT:
     va_end(ap);
@@ -735,3 +1461,85 @@ __EXIT:
 
     return opRet;
 }
+
+/**
+ * @brief Outputs the logs queued for the drain thread on the calling thread.
+ *
+ * This function waits for a drain running on the drain thread to finish and then formats and outputs every queued log
+ * before it returns, for example before a planned reset. It does nothing when logs are printed synchronously.
+ *
+ * @return NONE
+ */
+void tal_log_flush(void)
+{
+#if LOG_ASYNC
+    LOG_ASYNC_S *async = NULL;
+
+    if (NULL == pLogManage || NULL == (async = pLogManage->async)) {
+        return;
+    }
+
+    while (!__log_async_claim(async)) {
+        tal_system_sleep(1);
+    }
+    __log_async_sync_time(async);
+    __log_async_drain(async, TRUE);
+    __log_async_unclaim(async);
+#endif
+}
+
+/**
+ * @brief Outputs the logs queued for the drain thread from a crash handler.
+ *
+ * Unlike tal_log_flush, this function neither sleeps nor takes a lock: it takes the queued logs over even if the drain
+ * thread stopped in the middle of a drain, and writes the output terminals without the log mutex the crashed thread
+ * may hold. A log that was being output when the drain thread stopped may come out twice, and the logs of a thread
+ * that crashed while queueing one stop before that log. Use it only when no other thread will run again.
+ *
+ * @return NONE
+ */
+void tal_log_crash_flush(void)
+{
+#if LOG_ASYNC
+    if (NULL == pLogManage || NULL == pLogManage->async) {
+        return;
+    }
+
+    __log_async_drain(pLogManage->async, FALSE);
+#endif
+}
+
+/**
+ * @brief Gets the statistics of the asynchronous log backend.
+ *
+ * @param[out] stat The statistics, counted since tal_log_init.
+ *
+ * @return OPRT_OK on success, OPRT_INVALID_PARM if the drain thread is not running, OPRT_NOT_SUPPORTED if
+ * ENABLE_LOG_ASYNC is off.
+ */
+OPERATE_RET tal_log_async_get_stat(TAL_LOG_ASYNC_STAT_T *stat)
+{
+#if LOG_ASYNC
+    LOG_RING_S *ring = NULL;
+    uint32_t head = 0;
+    uint8_t i = 0;
+
+    if (NULL == stat || NULL == pLogManage || NULL == pLogManage->async) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memset(stat, 0, sizeof(TAL_LOG_ASYNC_STAT_T));
+    for (i = 0; i < LOG_ASYNC_RING_NUM; i++) {
+        ring = &pLogManage->async->ring[i];
+        head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        stat->queued += head;
+        stat->pending += head - __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        stat->dropped += __atomic_load_n(&ring->drop, __ATOMIC_RELAXED);
+        stat->text += __atomic_load_n(&ring->text, __ATOMIC_RELAXED);
+    }
+
+    return OPRT_OK;
+#else
+    return OPRT_NOT_SUPPORTED;
+#endif
+}
@@ -12,6 +12,28 @@
 #define STACK_SIZE_TIMERQ (4 * 1024)
 #endif
 
+#if defined(ENABLE_SW_TIMER_WHEEL) && (ENABLE_SW_TIMER_WHEEL == 1)
+#define SW_TIMER_WHEEL 1
+#else
+#define SW_TIMER_WHEEL 0
+#endif
+
+#if SW_TIMER_WHEEL
+/*
+ * hierarchical timing wheel, one tick is one millisecond of system time.
+ * level n has TW_SLOTS slots of 2^(TW_BITS*n) ticks each, TW_LEVELS levels cover 2^36 ms,
+ * more than the range of TIME_MS. a timer is hashed into the level that fits its remaining
+ * time and moved down one level (cascaded) when the lower levels wrap around, so start,
+ * stop and expire are O(1) and all timers of one tick expire together.
+ */
+#define TW_BITS      6
+#define TW_SLOTS     (1 << TW_BITS)
+#define TW_MASK      (TW_SLOTS - 1)
+#define TW_LEVELS    6
+#define TW_RANGE     ((uint64_t)1 << (TW_BITS * TW_LEVELS))
+#define TW_SLOT_NONE 0xFFFF
+#endif
+
 typedef struct {
     LIST_HEAD node;
 
@@ -23,10 +45,26 @@ typedef struct {
     BOOL_T is_running;
     TIMER_ID timer_id;
     TIMER_TYPE type;
+#if SW_TIMER_WHEEL
+    uint16_t slot; // level * TW_SLOTS + index of the last wheel slot, may be stale once expired
+#endif
 } TIMER_T;
 
+#if SW_TIMER_WHEEL
+typedef struct {
+    LIST_HEAD slot[TW_LEVELS][TW_SLOTS];
+    uint64_t map[TW_LEVELS]; // bit set for each non-empty slot
+    uint64_t tick;           // next tick to process
+} TIMER_WHEEL_T;
+#endif
+
 typedef struct {
+#if SW_TIMER_WHEEL
+    TIMER_WHEEL_T wheel;
+    LIST_HEAD list_expired; // expired timers waiting for their callbacks
+#else
     LIST_HEAD list_active;
+#endif
     LIST_HEAD list_standby;
     MUTEX_HANDLE mutex;
     uint16_t total_cnt;
@@ -40,10 +78,139 @@ typedef struct {
 
 static SW_TIMER_MGR_T s_timer_mgr;
 
-static void __timer_attach(TIMER_T *timer)
+#if SW_TIMER_WHEEL
+static uint64_t __wheel_rotr(uint64_t map, uint32_t n)
+{
+    return n ? ((map >> n) | (map << (64 - n))) : map;
+}
+
+static void __wheel_add(TIMER_T *timer)
+{
+    TIMER_WHEEL_T *wheel = &s_timer_mgr.wheel;
+    uint64_t expire = timer->expire_time;
+    uint32_t level = 0;
+    uint32_t index = 0;
+
+    if (expire < wheel->tick) {
+        expire = wheel->tick;
+    } else if (expire - wheel->tick >= TW_RANGE) {
+        expire = wheel->tick + TW_RANGE - 1;
+    }
+
+    while (level < TW_LEVELS - 1 && expire - wheel->tick >= ((uint64_t)1 << (TW_BITS * (level + 1)))) {
+        level++;
+    }
+
+    index = (expire >> (TW_BITS * level)) & TW_MASK;
+    timer->slot = level * TW_SLOTS + index;
+    tuya_list_add_tail(&(timer->node), &(wheel->slot[level][index]));
+    wheel->map[level] |= (uint64_t)1 << index;
+}
+
+/**
+ * @brief the earliest tick at which a slot has to be processed: level 0 slots expire,
+ * higher level slots cascade. UINT64_MAX if the wheel is empty
+ */
+static uint64_t __wheel_next_tick(void)
+{
+    TIMER_WHEEL_T *wheel = &s_timer_mgr.wheel;
+    uint64_t next = UINT64_MAX;
+
+    for (uint32_t level = 0; level < TW_LEVELS; level++) {
+        if (0 == wheel->map[level]) {
+            continue;
+        }
+        // slots of this level are processed on ticks that are multiples of its slot width
+        uint32_t shift = TW_BITS * level;
+        uint64_t base = (wheel->tick + ((uint64_t)1 << shift) - 1) >> shift;
+        uint64_t tick = (base + __builtin_ctzll(__wheel_rotr(wheel->map[level], base & TW_MASK))) << shift;
+        if (tick < next) {
+            next = tick;
+        }
+    }
+
+    return next;
+}
+
+static void __wheel_cascade(uint32_t level, uint32_t index)
+{
+    TIMER_WHEEL_T *wheel = &s_timer_mgr.wheel;
+    LIST_HEAD list;
+    struct tuya_list_head *p = NULL;
+    struct tuya_list_head *n = NULL;
+
+    INIT_LIST_HEAD(&list);
+    tuya_list_splice(&(wheel->slot[level][index]), &list);
+    INIT_LIST_HEAD(&(wheel->slot[level][index]));
+    wheel->map[level] &= ~((uint64_t)1 << index);
+
+    tuya_list_for_each_safe(p, n, &list)
+    {
+        __wheel_add(tuya_list_entry(p, TIMER_T, node));
+    }
+}
+
+/**
+ * @brief move all timers expired up to now_ms into list_expired, idle ticks are skipped
+ */
+static void __wheel_advance(uint64_t now_ms)
+{
+    TIMER_WHEEL_T *wheel = &s_timer_mgr.wheel;
+
+    while (wheel->tick <= now_ms) {
+        uint64_t next = __wheel_next_tick();
+        if (next > now_ms) {
+            wheel->tick = now_ms + 1;
+            break;
+        }
+        wheel->tick = next;
+
+        // cascade from level 1 upwards while the lower level wraps around
+        for (uint32_t level = 1; level < TW_LEVELS; level++) {
+            uint32_t shift = TW_BITS * level;
+            if (wheel->tick & (((uint64_t)1 << shift) - 1)) {
+                break;
+            }
+            uint32_t index = (wheel->tick >> shift) & TW_MASK;
+            if (wheel->map[level] & ((uint64_t)1 << index)) {
+                __wheel_cascade(level, index);
+            }
+        }
+
+        uint32_t index = wheel->tick & TW_MASK;
+        if (wheel->map[0] & ((uint64_t)1 << index)) {
+            tuya_list_splice(&(wheel->slot[0][index]), s_timer_mgr.list_expired.prev);
+            INIT_LIST_HEAD(&(wheel->slot[0][index]));
+            wheel->map[0] &= ~((uint64_t)1 << index);
+        }
+        wheel->tick++;
+    }
+}
+#endif
+
+static void __timer_detach(TIMER_T *timer)
 {
     tuya_list_del(&(timer->node));
 
+#if SW_TIMER_WHEEL
+    // a stale slot is harmless: it only clears a bit whose slot is already empty
+    if (TW_SLOT_NONE != timer->slot) {
+        LIST_HEAD *slot = &(s_timer_mgr.wheel.slot[timer->slot / TW_SLOTS][timer->slot % TW_SLOTS]);
+        if (tuya_list_empty(slot)) {
+            s_timer_mgr.wheel.map[timer->slot / TW_SLOTS] &= ~((uint64_t)1 << (timer->slot % TW_SLOTS));
+        }
+        timer->slot = TW_SLOT_NONE;
+    }
+#endif
+}
+
+static void __timer_attach(TIMER_T *timer)
+{
+    __timer_detach(timer);
+
+#if SW_TIMER_WHEEL
+    __wheel_add(timer);
+#else
     if (tuya_list_empty(&(s_timer_mgr.list_active))) {
         tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_active));
     } else {
@@ -63,15 +230,32 @@ static void __timer_attach(TIMER_T *timer)
             tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_active));
         }
     }
+#endif
 }
 
-static void __timer_dump(void)
+static void __timer_dump_list(LIST_HEAD *list)
 {
     struct tuya_list_head *p = NULL;
     TIMER_T *timer = NULL;
     TAL_TIMER_CB *cb = NULL;
     TIMER_ID *timer_id = NULL;
 
+    tuya_list_for_each(p, list)
+    {
+        timer = tuya_list_entry(p, TIMER_T, node);
+        cb = &(timer->cb);
+        if (timer->data) {
+            timer_id = timer->data;
+            if (*timer_id == timer->timer_id) {
+                cb = (TAL_TIMER_CB *)((char *)timer->data + sizeof(TIMER_ID));
+            }
+        }
+        PR_NOTICE("%08x %d %d %p", timer->timer_id, timer->type, timer->interval, *cb);
+    }
+}
+
+static void __timer_dump(void)
+{
     TIME_S nowSecTime = 0;
     TIME_MS nowMsTime = 0;
 
@@ -86,36 +270,81 @@ static void __timer_dump(void)
     tal_mutex_lock(s_timer_mgr.mutex);
 
     PR_NOTICE("running timers count:%d", s_timer_mgr.running_cnt);
-    tuya_list_for_each(p, &(s_timer_mgr.list_active))
-    {
-        timer = tuya_list_entry(p, TIMER_T, node);
-        cb = &(timer->cb);
-        if (timer->data) {
-            timer_id = timer->data;
-            if (*timer_id == timer->timer_id) {
-                cb = (TAL_TIMER_CB *)((char *)timer->data + sizeof(TIMER_ID));
-            }
+#if SW_TIMER_WHEEL
+    __timer_dump_list(&(s_timer_mgr.list_expired));
+    for (uint32_t level = 0; level < TW_LEVELS; level++) {
+        for (uint32_t index = 0; index < TW_SLOTS; index++) {
+            __timer_dump_list(&(s_timer_mgr.wheel.slot[level][index]));
         }
-        PR_NOTICE("%08x %d %d %p", timer->timer_id, timer->type, timer->interval, *cb);
     }
+#else
+    __timer_dump_list(&(s_timer_mgr.list_active));
+#endif
 
     PR_NOTICE("standby timers count:%d", s_timer_mgr.total_cnt - s_timer_mgr.running_cnt);
-    tuya_list_for_each(p, &(s_timer_mgr.list_standby))
-    {
-        timer = tuya_list_entry(p, TIMER_T, node);
-        cb = &(timer->cb);
-        if (timer->data) {
-            timer_id = timer->data;
-            if (*timer_id == timer->timer_id) {
-                cb = (TAL_TIMER_CB *)((char *)timer->data + sizeof(TIMER_ID));
+    __timer_dump_list(&(s_timer_mgr.list_standby));
+
+    tal_mutex_unlock(s_timer_mgr.mutex);
+}
+
+#if SW_TIMER_WHEEL
+static void __timer_dispatch(SYS_TIME_T *next_expired)
+{
+    TIME_S nowSecTime = 0;
+    TIME_MS nowMsTime = 0;
+    uint64_t nowMS = 0;
+    uint64_t next_tick = 0;
+    TIMER_T *timer = NULL;
+    TAL_TIMER_CB timer_cb = NULL;
+    TIMER_ID timer_id = NULL;
+    void *timer_data = NULL;
+
+    *next_expired = SEM_WAIT_FOREVER;
+
+    tal_mutex_lock(s_timer_mgr.mutex);
+    do {
+        tal_time_get_system_time(&nowSecTime, &nowMsTime);
+        nowMS = (uint64_t)nowSecTime * 1000 + (uint64_t)nowMsTime;
+
+        // expire every tick up to now in one batch, then run the callbacks one by one
+        __wheel_advance(nowMS);
+        while (!tuya_list_empty(&(s_timer_mgr.list_expired))) {
+            timer = tuya_list_entry(s_timer_mgr.list_expired.next, TIMER_T, node);
+
+            if (TAL_TIMER_ONCE == timer->type) {
+                timer->is_running = FALSE;
+                s_timer_mgr.running_cnt--;
+                __timer_detach(timer);
+                tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_standby));
+            } else {
+                timer->expire_time = nowMS + timer->interval;
+                __timer_attach(timer);
             }
+
+            timer_cb = timer->cb;
+            timer_id = timer->timer_id;
+            timer_data = timer->data;
+            tal_mutex_unlock(s_timer_mgr.mutex);
+
+            s_timer_mgr.last_cb = timer_cb;
+            timer_cb(timer_id, timer_data);
+            s_timer_mgr.last_cb = NULL;
+
+            tal_mutex_lock(s_timer_mgr.mutex);
         }
-        PR_NOTICE("%08x %d %d %p", timer->timer_id, timer->type, timer->interval, *cb);
-    }
 
+        // callbacks may have taken long enough for more ticks to be due
+        next_tick = __wheel_next_tick();
+        tal_time_get_system_time(&nowSecTime, &nowMsTime);
+        nowMS = (uint64_t)nowSecTime * 1000 + (uint64_t)nowMsTime;
+    } while (next_tick <= nowMS);
+
+    if (UINT64_MAX != next_tick) {
+        *next_expired = (next_tick - nowMS < SEM_WAIT_FOREVER) ? (SYS_TIME_T)(next_tick - nowMS) : SEM_WAIT_FOREVER - 1;
+    }
     tal_mutex_unlock(s_timer_mgr.mutex);
 }
-
+#else
 static void __timer_dispatch(SYS_TIME_T *next_expired)
 {
     TIME_S nowSecTime = 0;
@@ -168,6 +397,7 @@ static void __timer_dispatch(SYS_TIME_T *next_expired)
         }
     } while (p != &(s_timer_mgr.list_active));
 }
+#endif
 
 static void __timer_thread_cb(void *data)
 {
@@ -201,7 +431,16 @@ OPERATE_RET tal_sw_timer_init(void)
     tal_mutex_create_init(&s_timer_mgr.mutex);
     tal_semaphore_create_init(&s_timer_mgr.sem, 0, 2);
 
+#if SW_TIMER_WHEEL
+    for (uint32_t level = 0; level < TW_LEVELS; level++) {
+        for (uint32_t index = 0; index < TW_SLOTS; index++) {
+            INIT_LIST_HEAD(&(s_timer_mgr.wheel.slot[level][index]));
+        }
+    }
+    INIT_LIST_HEAD(&(s_timer_mgr.list_expired));
+#else
     INIT_LIST_HEAD(&(s_timer_mgr.list_active));
+#endif
     INIT_LIST_HEAD(&(s_timer_mgr.list_standby));
 
     THREAD_CFG_T thread_cfg = {.stackDepth = STACK_SIZE_TIMERQ, .priority = THREAD_PRIO_0, .thrdname = "sys_timer"};
@@ -240,6 +479,9 @@ OPERATE_RET tal_sw_timer_create(TAL_TIMER_CB func, void *arg, TIMER_ID *timer_id
     timer->cb = func;
     timer->data = arg;
     timer->timer_id = (TIMER_ID)timer;
+#if SW_TIMER_WHEEL
+    timer->slot = TW_SLOT_NONE;
+#endif
 
     tal_mutex_lock(s_timer_mgr.mutex);
     s_timer_mgr.total_cnt++;
@@ -270,7 +512,7 @@ OPERATE_RET tal_sw_timer_delete(TIMER_ID timer_id)
     TIMER_T *timer = (TIMER_T *)timer_id;
 
     tal_mutex_lock(s_timer_mgr.mutex);
-    tuya_list_del(&(timer->node));
+    __timer_detach(timer);
     s_timer_mgr.total_cnt--;
     if (timer->is_running) {
         s_timer_mgr.running_cnt--;
@@ -305,7 +547,7 @@ OPERATE_RET tal_sw_timer_stop(TIMER_ID timer_id)
         timer->is_running = FALSE;
 
         s_timer_mgr.running_cnt--;
-        tuya_list_del(&(timer->node));
+        __timer_detach(timer);
         tuya_list_add_tail(&(timer->node), &(s_timer_mgr.list_standby));
     }
     tal_mutex_unlock(s_timer_mgr.mutex);
@@ -413,6 +655,10 @@ OPERATE_RET tal_sw_timer_start(TIMER_ID timer_id, TIME_MS time_ms, TIMER_TYPE ti
 
     timer->type = timer_type;
     timer->expire_time = (uint64_t)secTime * 1000 + (uint64_t)msTime + timer->interval;
+#if SW_TIMER_WHEEL
+    // catch the wheel up first so the timer is hashed relative to the current time
+    __wheel_advance(timer->expire_time - timer->interval);
+#endif
     __timer_attach(timer);
 
     tal_mutex_unlock(s_timer_mgr.mutex);
@@ -442,8 +688,12 @@ OPERATE_RET tal_sw_timer_trigger(TIMER_ID timer_id)
     tal_mutex_lock(s_timer_mgr.mutex);
     timer->expire_time = 0;
     if (timer->is_running) {
-        tuya_list_del(&(timer->node));
+        __timer_detach(timer);
+#if SW_TIMER_WHEEL
+        tuya_list_add(&(timer->node), &(s_timer_mgr.list_expired));
+#else
         tuya_list_add(&(timer->node), &(s_timer_mgr.list_active));
+#endif
     }
     tal_mutex_unlock(s_timer_mgr.mutex);
     tal_semaphore_post(s_timer_mgr.sem);
@@ -127,6 +127,7 @@ void tal_system_sleep(uint32_t time_ms)
  */
 void tal_system_reset(void)
 {
+    tal_log_flush(); // logs queued for the drain thread would be lost
     tkl_system_reset();
 }
 
@@ -168,6 +169,67 @@ SYS_TIME_T tal_system_get_millisecond(void)
     return tkl_system_get_millisecond() + g_sys_time_offset;
 }
 
+/**
+ * @brief Default microsecond counter for platforms that do not provide one.
+ *
+ * Derived from the millisecond clock, so the resolution is one millisecond.
+ *
+ * @return The low 32 bits of the system time in microseconds.
+ */
+__attribute__((weak)) uint32_t tkl_system_get_microsecond(void)
+{
+    return (uint32_t)(tkl_system_get_millisecond() * 1000);
+}
+
+static struct {
+    bool started;
+    uint64_t last_us;
+    SYS_TIME_T last_ms;
+} s_us_clock;
+
+/**
+ * @brief Get the monotonic system time in microseconds.
+ *
+ * The platform counter is only 32 bits wide and wraps every ~71 minutes. The
+ * elapsed time measured by the millisecond clock since the previous call
+ * selects which 2^32 period the new raw value belongs to, so the result stays
+ * correct even if the function is not called for longer than one wrap period.
+ *
+ * @return The system time in microseconds.
+ */
+uint64_t tal_system_get_microsecond(void)
+{
+    uint64_t now_us;
+
+    TAL_ENTER_CRITICAL();
+    uint32_t raw = tkl_system_get_microsecond();
+    SYS_TIME_T now_ms = tkl_system_get_millisecond();
+
+    if (!s_us_clock.started) {
+        s_us_clock.started = true;
+        now_us = raw;
+    } else {
+        uint64_t expect = s_us_clock.last_us + (uint64_t)(SYS_TIME_T)(now_ms - s_us_clock.last_ms) * 1000;
+
+        // nearest value to the expected time whose low 32 bits equal raw
+        now_us = (expect & ~0xFFFFFFFFULL) | raw;
+        if (now_us + 0x80000000ULL < expect) {
+            now_us += 0x100000000ULL;
+        } else if (now_us > expect + 0x80000000ULL && now_us >= 0x100000000ULL) {
+            now_us -= 0x100000000ULL;
+        }
+        if (now_us < s_us_clock.last_us) {
+            now_us = s_us_clock.last_us;
+        }
+    }
+
+    s_us_clock.last_us = now_us;
+    s_us_clock.last_ms = now_ms;
+    TAL_EXIT_CRITICAL();
+
+    return now_us;
+}
+
 /**
  * @brief Get a random number within the specified range.
  *
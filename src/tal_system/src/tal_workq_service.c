@@ -41,6 +41,10 @@
 #define MAX_NODE_NUM_MSG_QUEUE 100
 #endif
 
+#ifndef WORKER_NUM_WORK_QUEUE
+#define WORKER_NUM_WORK_QUEUE 1
+#endif
+
 #ifndef STACK_SIZE_WORK_QUEUE
 #define STACK_SIZE_WORK_QUEUE (5 * 1024)
 #endif
@@ -73,7 +77,8 @@ OPERATE_RET tal_workq_init(void)
     thread_cfg.stackDepth += 1024;
 #endif
     thread_cfg.thrdname = "wq_system";
-    TUYA_CALL_ERR_GOTO(tal_workqueue_create(MAX_NODE_NUM_WORK_QUEUE, &thread_cfg, &wq_system), ERR_EXIT);
+    TUYA_CALL_ERR_GOTO(
+        tal_workqueue_create_pool(MAX_NODE_NUM_WORK_QUEUE, WORKER_NUM_WORK_QUEUE, &thread_cfg, &wq_system), ERR_EXIT);
 
     thread_cfg.priority = THREAD_PRIO_1;
     thread_cfg.stackDepth = STACK_SIZE_MSG_QUEUE;
@@ -180,6 +185,20 @@ uint16_t tal_workq_get_num(WORKQ_SERVICE_E service)
     return tal_workqueue_get_num(tal_workq_get_handle(service));
 }
 
+/**
+ * @brief get the statistics of the work queue
+ *
+ * @param[in] service the workqueue service
+ * @param[out] stat the statistics since the work queue was created
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workq_get_stat(WORKQ_SERVICE_E service, WORKQUEUE_STAT_T *stat)
+{
+    return tal_workqueue_get_stat(tal_workq_get_handle(service), stat);
+}
+
 // used for debug
 static BOOL_T _dump_cb(WORK_ITEM_T *item, void *ctx)
 {
@@ -189,8 +208,16 @@ static BOOL_T _dump_cb(WORK_ITEM_T *item, void *ctx)
 
 void tal_workq_dump(WORKQ_SERVICE_E service)
 {
+    WORKQUEUE_STAT_T stat;
+
     PR_NOTICE("---------workq-%d dump begin---------", service);
     tal_workqueue_traverse(tal_workq_get_handle(service), _dump_cb, NULL);
+    if (OPRT_OK == tal_workq_get_stat(service, &stat)) {
+        PR_NOTICE("workers:%d used:%d peak:%d executed:%u stolen:%u", stat.worker_num, stat.used, stat.peak,
+                  stat.executed, stat.stolen);
+        PR_NOTICE("wait avg:%uus max:%uus, run avg:%uus max:%uus", stat.wait_avg_us, stat.wait_max_us,
+                  stat.run_avg_us, stat.run_max_us);
+    }
     tal_thread_diagnose(tal_workqueue_get_thread(tal_workq_get_handle(service)));
     PR_NOTICE("---------workq-%d dump end---------", service);
 }
@@ -12,7 +12,8 @@
  *
  * Key components include:
  * - Definition of the work queue structure with queue, thread, and semaphore
- * handles.
+ * handles, served by one thread or by a pool of threads, each owning a deque
+ * that the others steal from.
  * - Implementation of the work queue thread callback for task execution.
  * - Synchronization mechanisms to ensure thread-safe operation and task
  * execution.
@@ -31,6 +32,7 @@
  *
  */
 
+#include <stdio.h>
 #include "tuya_queue.h"
 #include "tal_log.h"
 #include "tal_memory.h"
@@ -40,38 +42,218 @@
 #include "tal_workqueue.h"
 #include "tal_sw_timer.h"
 
+#define WORKQUEUE_WORKER_MAX 8
+
 typedef struct {
+    WORK_ITEM_T work; // must be first, traverse callbacks see WORK_ITEM_T
+    uint64_t sched_us;
+} WORK_NODE_T;
+
+struct tal_workqueue;
+
+typedef struct {
+    struct tal_workqueue *workqueue;
+    uint8_t index;
     TUYA_QUEUE_HANDLE queue;
     THREAD_HANDLE thread;
-    SEM_HANDLE sem;
     WORKQUEUE_CB last_cb; // used to debug which cb is blocked
+    char name[16];
+
+    // statistics, only written by the worker itself
+    uint32_t executed;
+    uint32_t stolen;
+    uint32_t wait_max_us;
+    uint32_t run_max_us;
+    uint64_t wait_sum_us;
+    uint64_t run_sum_us;
+} TAL_WORKER_T;
+
+/*
+ * every worker owns a deque and takes the oldest item from its head first, an idle worker steals the
+ * newest item from the tail of another worker's deque, away from where the owner works. work
+ * scheduled by a worker goes to its own deque, work scheduled from outside is spread round robin.
+ * schedule_instant goes to a shared lane that all workers drain before their own deques, so instant
+ * work still runs before everything scheduled normally. with one worker there is no lane and
+ * instant work is put at the front of the only queue, as before.
+ */
+typedef struct tal_workqueue {
+    TUYA_QUEUE_HANDLE instant;
+    SEM_HANDLE sem; // posted once per queued item
+    uint8_t worker_num;
+    uint32_t next;    // round robin for producers outside the pool
+    uint32_t pending; // items queued and not taken yet
+    uint32_t peak;
+
+    TAL_WORKER_T worker[];
 } TAL_WORKQUEUE_T;
 
+static BOOL_T __work_take(TAL_WORKQUEUE_T *workqueue, TAL_WORKER_T *worker, WORK_NODE_T *node)
+{
+    uint8_t i = 0;
+
+    if (workqueue->instant && (OPRT_OK == tuya_queue_output(workqueue->instant, node))) {
+        return TRUE;
+    }
+
+    if (OPRT_OK == tuya_queue_output(worker->queue, node)) {
+        return TRUE;
+    }
+
+    for (i = 1; i < workqueue->worker_num; i++) {
+        TAL_WORKER_T *victim = &workqueue->worker[(worker->index + i) % workqueue->worker_num];
+        if (OPRT_OK == tuya_queue_output_tail(victim->queue, node)) {
+            worker->stolen++;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
 static void __work_thread_cb(void *data)
 {
     OPERATE_RET op_ret = OPRT_OK;
-    TAL_WORKQUEUE_T *workqueue = (TAL_WORKQUEUE_T *)data;
-    WORK_ITEM_T work_item = {0};
-
-    while (THREAD_STATE_RUNNING == tal_thread_get_state(workqueue->thread)) {
+    TAL_WORKER_T *worker = (TAL_WORKER_T *)data;
+    TAL_WORKQUEUE_T *workqueue = worker->workqueue;
+    WORK_NODE_T node = {0};
+    uint64_t start_us = 0;
+    uint32_t wait_us = 0;
+    uint32_t run_us = 0;
+
+    while (THREAD_STATE_RUNNING == tal_thread_get_state(worker->thread)) {
         op_ret = tal_semaphore_wait(workqueue->sem, SEM_WAIT_FOREVER);
         if (OPRT_OK != op_ret) {
             tal_system_sleep(10);
             continue;
         }
 
-        op_ret = tuya_queue_output(workqueue->queue, &work_item);
-        if (OPRT_OK != op_ret) {
-            tal_system_sleep(10);
+        // every post follows a queued item, but another worker may have taken the item this post was
+        // for while the one left is in a queue already looked at, so look again right away, the item is
+        // queued. release posts without queuing anything, and the state check ends the loop then
+        while (!__work_take(workqueue, worker, &node)) {
+            if (THREAD_STATE_RUNNING != tal_thread_get_state(worker->thread)) {
+                return;
+            }
+        }
+        __atomic_sub_fetch(&workqueue->pending, 1, __ATOMIC_RELAXED);
+
+        if (node.work.cb) {
+            start_us = tal_system_get_microsecond();
+            wait_us = (uint32_t)(start_us - node.sched_us);
+
+            worker->last_cb = node.work.cb;
+            node.work.cb(node.work.data);
+            worker->last_cb = NULL;
+
+            run_us = (uint32_t)(tal_system_get_microsecond() - start_us);
+            worker->executed++;
+            worker->wait_sum_us += wait_us;
+            worker->run_sum_us += run_us;
+            if (wait_us > worker->wait_max_us) {
+                worker->wait_max_us = wait_us;
+            }
+            if (run_us > worker->run_max_us) {
+                worker->run_max_us = run_us;
+            }
+        }
+    }
+}
+
+static uint8_t __work_target(TAL_WORKQUEUE_T *workqueue)
+{
+    uint8_t i = 0;
+    BOOL_T is_self = FALSE;
+
+    if (1 == workqueue->worker_num) {
+        return 0;
+    }
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        if ((OPRT_OK == tal_thread_is_self(workqueue->worker[i].thread, &is_self)) && is_self) {
+            return i;
+        }
+    }
+
+    return __atomic_fetch_add(&workqueue->next, 1, __ATOMIC_RELAXED) % workqueue->worker_num;
+}
+
+static OPERATE_RET __work_schedule(TAL_WORKQUEUE_T *workqueue, WORKQUEUE_CB cb, void *data, BOOL_T instant)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    WORK_NODE_T node = {.work = {.cb = cb, .data = data}, .sched_us = tal_system_get_microsecond()};
+    uint32_t pending = 0;
+    uint32_t peak = 0;
+    uint8_t start = 0;
+    uint8_t i = 0;
+
+    // count the item before a worker can take it, so pending never goes below the items queued
+    pending = __atomic_add_fetch(&workqueue->pending, 1, __ATOMIC_RELAXED);
+    if (instant) {
+        op_ret = tuya_queue_input_instant(workqueue->instant ? workqueue->instant : workqueue->worker[0].queue,
+                                          &node);
+    } else {
+        start = __work_target(workqueue);
+        for (i = 0; i < workqueue->worker_num; i++) {
+            op_ret = tuya_queue_input(workqueue->worker[(start + i) % workqueue->worker_num].queue, &node);
+            if (OPRT_EXCEED_UPPER_LIMIT != op_ret) {
+                break;
+            }
+        }
+    }
+    if (OPRT_OK != op_ret) {
+        __atomic_sub_fetch(&workqueue->pending, 1, __ATOMIC_RELAXED);
+        return op_ret;
+    }
+
+    peak = __atomic_load_n(&workqueue->peak, __ATOMIC_RELAXED);
+    while ((pending > peak) &&
+           !__atomic_compare_exchange_n(&workqueue->peak, &peak, pending, FALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+
+    return tal_semaphore_post(workqueue->sem);
+}
+
+static void __workqueue_free(TAL_WORKQUEUE_T *workqueue)
+{
+    uint32_t count = 1;
+    uint8_t i = 0;
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        if (workqueue->worker[i].thread) {
+            tal_thread_delete(workqueue->worker[i].thread);
+        }
+    }
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        if (workqueue->worker[i].thread) {
+            tal_semaphore_post(workqueue->sem);
+        }
+    }
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        if (NULL == workqueue->worker[i].thread) {
             continue;
         }
+        while (THREAD_STATE_DELETE != tal_thread_get_state(workqueue->worker[i].thread)) {
+            tal_system_sleep(10);
+            if ((count++) % 500 == 0) {
+                PR_NOTICE("%p still running", workqueue->worker[i].thread);
+            }
+        }
+    }
 
-        if (work_item.cb) {
-            workqueue->last_cb = work_item.cb;
-            work_item.cb(work_item.data);
-            workqueue->last_cb = NULL;
+    for (i = 0; i < workqueue->worker_num; i++) {
+        if (workqueue->worker[i].queue) {
+            tuya_queue_release(workqueue->worker[i].queue);
         }
     }
+    if (workqueue->instant) {
+        tuya_queue_release(workqueue->instant);
+    }
+    if (workqueue->sem) {
+        tal_semaphore_release(workqueue->sem);
+    }
+    tal_free(workqueue);
 }
 
 static BOOL_T __work_cancel_traverse(void *item, void *ctx)
@@ -109,41 +291,90 @@ static BOOL_T __work_cancel_traverse(void *item, void *ctx)
  * tuya_error_code.h
  */
 OPERATE_RET tal_workqueue_create(const uint16_t queue_len, THREAD_CFG_T *thread_cfg, WORKQUEUE_HANDLE *handle)
+{
+    return tal_workqueue_create_pool(queue_len, 1, thread_cfg, handle);
+}
+
+/**
+ * @brief create and initialize a workqueue served by several threads
+ *
+ * @param[in] queue_len the maximum number of items that the workqueue can
+ * contain
+ * @param[in] worker_num the number of threads, 1 to 8
+ * @param[in] thread_cfg thread param, the name gets the worker index appended
+ * when worker_num is more than 1
+ * @param[out] handle the workqueue handle
+ *
+ * @note with more than one worker, callbacks run concurrently and only start
+ * in about the order they were scheduled. instant work still starts before
+ * work scheduled normally.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_create_pool(const uint16_t queue_len, const uint8_t worker_num, THREAD_CFG_T *thread_cfg,
+                                      WORKQUEUE_HANDLE *handle)
 {
     OPERATE_RET op_ret = OPRT_OK;
     TAL_WORKQUEUE_T *workqueue = NULL;
+    THREAD_CFG_T worker_cfg;
+    uint16_t lane_len = 0;
+    uint8_t i = 0;
 
-    if ((0 == queue_len) || (NULL == thread_cfg) || (NULL == handle)) {
+    if ((0 == queue_len) || (0 == worker_num) || (worker_num > WORKQUEUE_WORKER_MAX) || (NULL == thread_cfg) ||
+        (NULL == handle)) {
         return OPRT_INVALID_PARM;
     }
 
-    workqueue = (TAL_WORKQUEUE_T *)tal_calloc(1, sizeof(TAL_WORKQUEUE_T));
+    workqueue = (TAL_WORKQUEUE_T *)tal_calloc(1, sizeof(TAL_WORKQUEUE_T) + worker_num * sizeof(TAL_WORKER_T));
     if (NULL == workqueue) {
         return OPRT_MALLOC_FAILED;
     }
-
-    op_ret = tuya_queue_create(queue_len, sizeof(WORK_ITEM_T), &workqueue->queue);
-    if (OPRT_OK != op_ret) {
-        tal_free(workqueue);
-        return op_ret;
+    workqueue->worker_num = worker_num;
+
+    // queue_len is shared by the workers, the instant lane gets as much as one worker
+    lane_len = (queue_len + worker_num - 1) / worker_num;
+    for (i = 0; i < worker_num; i++) {
+        workqueue->worker[i].workqueue = workqueue;
+        workqueue->worker[i].index = i;
+        op_ret = tuya_queue_create(lane_len, sizeof(WORK_NODE_T), &workqueue->worker[i].queue);
+        if (OPRT_OK != op_ret) {
+            goto __EXIT;
+        }
+    }
+    if (worker_num > 1) {
+        op_ret = tuya_queue_create(lane_len, sizeof(WORK_NODE_T), &workqueue->instant);
+        if (OPRT_OK != op_ret) {
+            goto __EXIT;
+        }
     }
 
-    op_ret = tal_semaphore_create_init(&workqueue->sem, 0, queue_len);
+    op_ret = tal_semaphore_create_init(&workqueue->sem, 0, lane_len * (worker_num + (workqueue->instant ? 1 : 0)));
     if (OPRT_OK != op_ret) {
-        tuya_queue_release(workqueue->queue);
-        tal_free(workqueue);
-        return op_ret;
+        goto __EXIT;
     }
 
-    op_ret = tal_thread_create_and_start(&workqueue->thread, NULL, NULL, __work_thread_cb, workqueue, thread_cfg);
-    if (OPRT_OK != op_ret) {
-        tal_semaphore_release(workqueue->sem);
-        tuya_queue_release(workqueue->queue);
-        tal_free(workqueue);
-    } else {
-        *handle = workqueue;
+    for (i = 0; i < worker_num; i++) {
+        TAL_WORKER_T *worker = &workqueue->worker[i];
+
+        worker_cfg = *thread_cfg;
+        if (worker_num > 1) {
+            snprintf(worker->name, sizeof(worker->name), "%s%d", thread_cfg->thrdname ? thread_cfg->thrdname : "wq",
+                     i);
+            worker_cfg.thrdname = worker->name;
+        }
+        op_ret = tal_thread_create_and_start(&worker->thread, NULL, NULL, __work_thread_cb, worker, &worker_cfg);
+        if (OPRT_OK != op_ret) {
+            goto __EXIT;
+        }
     }
 
+    *handle = workqueue;
+
+    return OPRT_OK;
+
+__EXIT:
+    __workqueue_free(workqueue);
     return op_ret;
 }
 
@@ -159,21 +390,11 @@ OPERATE_RET tal_workqueue_create(const uint16_t queue_len, THREAD_CFG_T *thread_
  */
 OPERATE_RET tal_workqueue_schedule(WORKQUEUE_HANDLE handle, WORKQUEUE_CB cb, void *data)
 {
-    OPERATE_RET op_ret = OPRT_OK;
-
     if ((NULL == handle) || (NULL == cb)) {
         return OPRT_INVALID_PARM;
     }
 
-    TAL_WORKQUEUE_T *workqueue = (TAL_WORKQUEUE_T *)handle;
-    WORK_ITEM_T work_item = {.cb = cb, .data = data};
-
-    op_ret = tuya_queue_input(workqueue->queue, &work_item);
-    if (OPRT_OK == op_ret) {
-        op_ret = tal_semaphore_post(workqueue->sem);
-    }
-
-    return op_ret;
+    return __work_schedule((TAL_WORKQUEUE_T *)handle, cb, data, FALSE);
 }
 
 /**
@@ -188,21 +409,11 @@ OPERATE_RET tal_workqueue_schedule(WORKQUEUE_HANDLE handle, WORKQUEUE_CB cb, voi
  */
 OPERATE_RET tal_workqueue_schedule_instant(WORKQUEUE_HANDLE handle, WORKQUEUE_CB cb, void *data)
 {
-    OPERATE_RET op_ret = OPRT_OK;
-
     if ((NULL == handle) || (NULL == cb)) {
         return OPRT_INVALID_PARM;
     }
 
-    TAL_WORKQUEUE_T *workqueue = (TAL_WORKQUEUE_T *)handle;
-    WORK_ITEM_T work_item = {.cb = cb, .data = data};
-
-    op_ret = tuya_queue_input_instant(workqueue->queue, &work_item);
-    if (OPRT_OK == op_ret) {
-        op_ret = tal_semaphore_post(workqueue->sem);
-    }
-
-    return op_ret;
+    return __work_schedule((TAL_WORKQUEUE_T *)handle, cb, data, TRUE);
 }
 
 /**
@@ -221,10 +432,9 @@ OPERATE_RET tal_workqueue_cancel(WORKQUEUE_HANDLE handle, WORKQUEUE_CB cb, void
         return OPRT_INVALID_PARM;
     }
 
-    TAL_WORKQUEUE_T *workqueue = (TAL_WORKQUEUE_T *)handle;
     WORK_ITEM_T work_item = {.cb = cb, .data = data};
 
-    return tuya_queue_traverse(workqueue->queue, __work_cancel_traverse, &work_item);
+    return tal_workqueue_traverse(handle, (WORKQUEUE_TRAVERSE_CB)__work_cancel_traverse, &work_item);
 }
 
 /**
@@ -244,7 +454,16 @@ OPERATE_RET tal_workqueue_traverse(WORKQUEUE_HANDLE handle, WORKQUEUE_TRAVERSE_C
     }
 
     TAL_WORKQUEUE_T *workqueue = (TAL_WORKQUEUE_T *)handle;
-    return tuya_queue_traverse(workqueue->queue, (TRAVERSE_CB)cb, ctx);
+    uint8_t i = 0;
+
+    if (workqueue->instant) {
+        tuya_queue_traverse(workqueue->instant, (TRAVERSE_CB)cb, ctx);
+    }
+    for (i = 0; i < workqueue->worker_num; i++) {
+        tuya_queue_traverse(workqueue->worker[i].queue, (TRAVERSE_CB)cb, ctx);
+    }
+
+    return OPRT_OK;
 }
 
 /**
@@ -261,49 +480,88 @@ uint16_t tal_workqueue_get_num(WORKQUEUE_HANDLE handle)
     }
 
     TAL_WORKQUEUE_T *workqueue = (TAL_WORKQUEUE_T *)handle;
+    uint32_t num = 0;
+    uint8_t i = 0;
 
-    if (workqueue->last_cb) {
-        PR_NOTICE("%p:last_cb %p", workqueue->thread, workqueue->last_cb);
+    for (i = 0; i < workqueue->worker_num; i++) {
+        if (workqueue->worker[i].last_cb) {
+            PR_NOTICE("%p:last_cb %p", workqueue->worker[i].thread, workqueue->worker[i].last_cb);
+        }
+        num += tuya_queue_get_used_num(workqueue->worker[i].queue);
+    }
+    if (workqueue->instant) {
+        num += tuya_queue_get_used_num(workqueue->instant);
     }
 
-    return tuya_queue_get_used_num(workqueue->queue);
+    return num;
 }
 
 /**
- * @brief release the workqueue
+ * @brief get the statistics of the workqueue
  *
  * @param[in] handle the workqueue handle
+ * @param[out] stat the statistics since the workqueue was created
+ *
+ * @note the counters are read while the workers update them, a value may be
+ * one item behind the others
  *
  * @return OPRT_OK on success. Others on error, please refer to
  * tuya_error_code.h
  */
-OPERATE_RET tal_workqueue_release(WORKQUEUE_HANDLE handle)
+OPERATE_RET tal_workqueue_get_stat(WORKQUEUE_HANDLE handle, WORKQUEUE_STAT_T *stat)
 {
-    if (NULL == handle) {
+    if (NULL == handle || NULL == stat) {
         return OPRT_INVALID_PARM;
     }
 
-    OPERATE_RET op_ret = OPRT_OK;
-    uint32_t count = 1;
     TAL_WORKQUEUE_T *workqueue = (TAL_WORKQUEUE_T *)handle;
+    uint64_t wait_sum_us = 0;
+    uint64_t run_sum_us = 0;
+    uint8_t i = 0;
+
+    memset(stat, 0, sizeof(WORKQUEUE_STAT_T));
+    stat->worker_num = workqueue->worker_num;
+    stat->used = (uint16_t)__atomic_load_n(&workqueue->pending, __ATOMIC_RELAXED);
+    stat->peak = (uint16_t)__atomic_load_n(&workqueue->peak, __ATOMIC_RELAXED);
+
+    for (i = 0; i < workqueue->worker_num; i++) {
+        TAL_WORKER_T *worker = &workqueue->worker[i];
+
+        stat->executed += worker->executed;
+        stat->stolen += worker->stolen;
+        wait_sum_us += worker->wait_sum_us;
+        run_sum_us += worker->run_sum_us;
+        if (worker->wait_max_us > stat->wait_max_us) {
+            stat->wait_max_us = worker->wait_max_us;
+        }
+        if (worker->run_max_us > stat->run_max_us) {
+            stat->run_max_us = worker->run_max_us;
+        }
+    }
 
-    op_ret = tal_thread_delete(workqueue->thread);
-    if (OPRT_OK != op_ret) {
-        return op_ret;
+    if (stat->executed) {
+        stat->wait_avg_us = (uint32_t)(wait_sum_us / stat->executed);
+        stat->run_avg_us = (uint32_t)(run_sum_us / stat->executed);
     }
 
-    tal_semaphore_post(workqueue->sem);
+    return OPRT_OK;
+}
 
-    while (THREAD_STATE_DELETE != tal_thread_get_state(workqueue->thread)) {
-        tal_system_sleep(10);
-        if ((count++) % 500 == 0) {
-            PR_NOTICE("%p still running", workqueue->thread);
-        }
+/**
+ * @brief release the workqueue
+ *
+ * @param[in] handle the workqueue handle
+ *
+ * @return OPRT_OK on success. Others on error, please refer to
+ * tuya_error_code.h
+ */
+OPERATE_RET tal_workqueue_release(WORKQUEUE_HANDLE handle)
+{
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
     }
 
-    tuya_queue_release(workqueue->queue);
-    tal_semaphore_release(workqueue->sem);
-    tal_free(workqueue);
+    __workqueue_free((TAL_WORKQUEUE_T *)handle);
 
     return OPRT_OK;
 }
@@ -313,7 +571,7 @@ OPERATE_RET tal_workqueue_release(WORKQUEUE_HANDLE handle)
  *
  * @param[in] handle the workqueue handle
  *
- * @return thread handle
+ * @return thread handle, the first worker of a pool
  */
 THREAD_HANDLE tal_workqueue_get_thread(WORKQUEUE_HANDLE handle)
 {
@@ -322,7 +580,7 @@ THREAD_HANDLE tal_workqueue_get_thread(WORKQUEUE_HANDLE handle)
     }
 
     TAL_WORKQUEUE_T *workqueue = (TAL_WORKQUEUE_T *)handle;
-    return workqueue->thread;
+    return workqueue->worker[0].thread;
 }
 
 typedef struct {
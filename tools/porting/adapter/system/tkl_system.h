@@ -71,6 +71,19 @@ SYS_TICK_T tkl_system_get_tick_count(void);
  */
 SYS_TIME_T tkl_system_get_millisecond(void);
 
+/**
+ * @brief Get free-running microsecond counter
+ *
+ * @param none
+ *
+ * @note optional, the counter may wrap at 2^32 and is extended to 64 bits by
+ *       tal_system_get_microsecond. platforms without a microsecond source can
+ *       leave it unimplemented, tal_system falls back to the millisecond clock.
+ *
+ * @return system microsecond (low 32 bits)
+ */
+uint32_t tkl_system_get_microsecond(void);
+
 /**
  * @brief Get system random data
  *
@@ -32,6 +32,21 @@ typedef BOOL_T (*TRAVERSE_CB)(void *item, void *ctx);
  */
 OPERATE_RET tuya_queue_create(const uint32_t queue_len, const uint32_t item_size, TUYA_QUEUE_HANDLE *handle);
 
+/**
+ * @brief create a lock-free single producer single consumer queue (FIFO)
+ *
+ * @param[in] queue_len the maximum number of items that the queue can contain.
+ * @param[in] item_size the number of bytes each item in the queue will require.
+ * @param[out] handle the queue handle
+ *
+ * @note one context (a thread or an ISR) may only call tuya_queue_input, one other context may call
+ * the dequeue, peek, traverse, get and delete functions. tuya_queue_input_instant and tuya_queue_output_tail are
+ * not supported.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tuya_queue_create_spsc(const uint32_t queue_len, const uint32_t item_size, TUYA_QUEUE_HANDLE *handle);
+
 /**
  * @brief enqueue, append to the tail
  *
@@ -62,6 +77,16 @@ OPERATE_RET tuya_queue_input_instant(TUYA_QUEUE_HANDLE handle, const void *item)
  */
 OPERATE_RET tuya_queue_output(TUYA_QUEUE_HANDLE handle, const void *item);
 
+/**
+ * @brief dequeue the newest item, take from the tail
+ *
+ * @param[in] handle the queue handle
+ * @param[in] item the dequeue item buffer, NULL indicates discard the item
+ *
+ * @return OPRT_OK on success, others on failed, please refer to tuya_error_code.h
+ */
+OPERATE_RET tuya_queue_output_tail(TUYA_QUEUE_HANDLE handle, const void *item);
+
 /**
  * @brief get the peek item(not dequeue)
  *
@@ -11,7 +11,6 @@
 #include "tkl_system.h"
 #include "tkl_memory.h"
 
-#include "tuya_list.h"
 #include "tuya_queue.h"
 
 #if defined(OPERATING_SYSTEM) && (SYSTEM_NON_OS == OPERATING_SYSTEM)
@@ -30,11 +29,13 @@
 
 typedef enum { POLICY_SEND_TO_BACK, POLICY_SEND_TO_FRONT, POLICY_MAX } ENQUEUE_POLICY_E;
 
-typedef struct {
-    LIST_HEAD node;
-    uint8_t data[];
-} QUEUE_ITEM_T;
-
+/*
+ * items live in a ring of queue_len slots allocated together with the queue, nothing is
+ * allocated after create. head and tail run over [0, 2 * queue_len) so that a full ring
+ * and an empty ring can be told apart without a shared counter, which lets the SPSC mode
+ * publish them with plain acquire/release stores: only the producer writes tail and only
+ * the consumer writes head.
+ */
 typedef struct {
 #if defined(OPERATING_SYSTEM) && (SYSTEM_NON_OS != OPERATING_SYSTEM)
     TKL_MUTEX_HANDLE mutex;
@@ -42,11 +43,32 @@ typedef struct {
 
     uint32_t item_size;
     uint32_t queue_len;
-    uint32_t queue_free;
+    BOOL_T spsc;   // single producer single consumer, no lock
+    uint32_t head; // position of the oldest item
+    uint32_t tail; // position after the newest item
 
-    LIST_HEAD head;
+    uint8_t buf[];
 } TUYA_QUEUE_T;
 
+#define QUEUE_LOAD(pos)       __atomic_load_n(&(pos), __ATOMIC_ACQUIRE)
+#define QUEUE_STORE(pos, val) __atomic_store_n(&(pos), (val), __ATOMIC_RELEASE)
+
+static uint32_t __queue_pos_add(TUYA_QUEUE_T *queue, uint32_t pos, uint32_t n)
+{
+    pos += n;
+    return (pos >= 2 * queue->queue_len) ? pos - 2 * queue->queue_len : pos;
+}
+
+static uint32_t __queue_used(TUYA_QUEUE_T *queue, uint32_t head, uint32_t tail)
+{
+    return (tail >= head) ? tail - head : tail + 2 * queue->queue_len - head;
+}
+
+static uint8_t *__queue_slot(TUYA_QUEUE_T *queue, uint32_t pos)
+{
+    return queue->buf + (size_t)((pos < queue->queue_len) ? pos : pos - queue->queue_len) * queue->item_size;
+}
+
 static OPERATE_RET __enqueue(TUYA_QUEUE_HANDLE handle, const void *item, ENQUEUE_POLICY_E policy)
 {
     OPERATE_RET op_ret = OPRT_OK;
@@ -57,24 +79,31 @@ static OPERATE_RET __enqueue(TUYA_QUEUE_HANDLE handle, const void *item, ENQUEUE
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
 
-    QUEUE_ITEM_T *queue_item = (QUEUE_ITEM_T *)tkl_system_malloc(sizeof(QUEUE_ITEM_T) + queue->item_size);
-    if (NULL == queue_item) {
-        return OPRT_MALLOC_FAILED;
-    }
+    if (queue->spsc) {
+        // the producer owns tail, head only moves forward and frees slots
+        if (POLICY_SEND_TO_FRONT == policy) {
+            return OPRT_NOT_SUPPORTED;
+        }
 
-    INIT_LIST_HEAD(&(queue_item->node));
-    memcpy(queue_item->data, (void *)item, queue->item_size);
+        uint32_t tail = queue->tail;
+        if (__queue_used(queue, QUEUE_LOAD(queue->head), tail) >= queue->queue_len) {
+            return OPRT_EXCEED_UPPER_LIMIT;
+        }
+        memcpy(__queue_slot(queue, tail), item, queue->item_size);
+        QUEUE_STORE(queue->tail, __queue_pos_add(queue, tail, 1));
+        return OPRT_OK;
+    }
 
     QUEUE_LOCK(queue);
-    if (queue->queue_free > 0) {
+    if (__queue_used(queue, queue->head, queue->tail) < queue->queue_len) {
         if (POLICY_SEND_TO_BACK == policy) {
-            tuya_list_add_tail(&(queue_item->node), &(queue->head));
+            memcpy(__queue_slot(queue, queue->tail), item, queue->item_size);
+            queue->tail = __queue_pos_add(queue, queue->tail, 1);
         } else if (POLICY_SEND_TO_FRONT == policy) {
-            tuya_list_add(&(queue_item->node), &(queue->head));
+            queue->head = __queue_pos_add(queue, queue->head, 2 * queue->queue_len - 1);
+            memcpy(__queue_slot(queue, queue->head), item, queue->item_size);
         }
-        queue->queue_free--;
     } else {
-        tkl_system_free(queue_item);
         op_ret = OPRT_EXCEED_UPPER_LIMIT;
     }
     QUEUE_UNLOCK(queue);
@@ -82,47 +111,74 @@ static OPERATE_RET __enqueue(TUYA_QUEUE_HANDLE handle, const void *item, ENQUEUE
     return op_ret;
 }
 
-/**
- * @brief create and initialize a queue (FIFO)
- *
- * @param[in] queue_len the maximum number of items that the queue can contain.
- * @param[in] item_size the number of bytes each item in the queue will require.
- * @param[out] handle the queue handle
- *
- * @note items are queued by copy, not by reference. Each item on the queue must be the same size.
- *
- * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
- */
-OPERATE_RET tuya_queue_create(const uint32_t queue_len, const uint32_t item_size, TUYA_QUEUE_HANDLE *handle)
+static OPERATE_RET __queue_create(const uint32_t queue_len, const uint32_t item_size, BOOL_T spsc,
+                                  TUYA_QUEUE_HANDLE *handle)
 {
     OPERATE_RET op_ret = OPRT_OK;
     TUYA_QUEUE_T *queue = NULL;
 
-    if ((NULL == handle) || (0 == queue_len) || (0 == item_size)) {
+    if ((NULL == handle) || (0 == queue_len) || (0 == item_size) || (queue_len > UINT32_MAX / 2) ||
+        ((size_t)queue_len * item_size / item_size != queue_len)) {
         return OPRT_INVALID_PARM;
     }
 
-    queue = (TUYA_QUEUE_T *)tkl_system_malloc(sizeof(TUYA_QUEUE_T));
+    queue = (TUYA_QUEUE_T *)tkl_system_malloc(sizeof(TUYA_QUEUE_T) + (size_t)queue_len * item_size);
     if (!queue) {
         return OPRT_MALLOC_FAILED;
     }
 
-    op_ret = QUEUE_CREATE_LOCK(queue);
-    if (OPRT_OK != op_ret) {
-        tkl_system_free(queue);
-        return OPRT_COM_ERROR;
+    if (!spsc) {
+        op_ret = QUEUE_CREATE_LOCK(queue);
+        if (OPRT_OK != op_ret) {
+            tkl_system_free(queue);
+            return OPRT_COM_ERROR;
+        }
     }
 
     queue->item_size = item_size;
     queue->queue_len = queue_len;
-    queue->queue_free = queue_len;
-    INIT_LIST_HEAD(&(queue->head));
+    queue->spsc = spsc;
+    queue->head = 0;
+    queue->tail = 0;
 
     *handle = (TUYA_QUEUE_HANDLE)queue;
 
     return OPRT_OK;
 }
 
+/**
+ * @brief create and initialize a queue (FIFO)
+ *
+ * @param[in] queue_len the maximum number of items that the queue can contain.
+ * @param[in] item_size the number of bytes each item in the queue will require.
+ * @param[out] handle the queue handle
+ *
+ * @note items are queued by copy, not by reference. Each item on the queue must be the same size.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tuya_queue_create(const uint32_t queue_len, const uint32_t item_size, TUYA_QUEUE_HANDLE *handle)
+{
+    return __queue_create(queue_len, item_size, FALSE, handle);
+}
+
+/**
+ * @brief create a lock-free single producer single consumer queue (FIFO)
+ *
+ * @param[in] queue_len the maximum number of items that the queue can contain.
+ * @param[in] item_size the number of bytes each item in the queue will require.
+ * @param[out] handle the queue handle
+ *
+ * @note one context (a thread or an ISR) may only call tuya_queue_input, one other context may call
+ * the dequeue, peek, traverse, get and delete functions. tuya_queue_input_instant is not supported.
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tuya_queue_create_spsc(const uint32_t queue_len, const uint32_t item_size, TUYA_QUEUE_HANDLE *handle)
+{
+    return __queue_create(queue_len, item_size, TRUE, handle);
+}
+
 /**
  * @brief enqueue
  *
@@ -167,15 +223,61 @@ OPERATE_RET tuya_queue_output(TUYA_QUEUE_HANDLE handle, const void *item)
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
 
+    if (queue->spsc) {
+        // the consumer owns head, tail only moves forward and publishes items
+        uint32_t head = queue->head;
+        if (head == QUEUE_LOAD(queue->tail)) {
+            return OPRT_NOT_FOUND;
+        }
+        if (item) {
+            memcpy((void *)item, __queue_slot(queue, head), queue->item_size);
+        }
+        QUEUE_STORE(queue->head, __queue_pos_add(queue, head, 1));
+        return OPRT_OK;
+    }
+
     QUEUE_LOCK(queue);
-    if (queue->queue_free < queue->queue_len) {
-        QUEUE_ITEM_T *queue_item = tuya_list_entry(queue->head.next, QUEUE_ITEM_T, node);
+    if (queue->head != queue->tail) {
         if (item) {
-            memcpy((void *)item, queue_item->data, queue->item_size);
+            memcpy((void *)item, __queue_slot(queue, queue->head), queue->item_size);
+        }
+        queue->head = __queue_pos_add(queue, queue->head, 1);
+    } else {
+        op_ret = OPRT_NOT_FOUND;
+    }
+    QUEUE_UNLOCK(queue);
+
+    return op_ret;
+}
+
+/**
+ * @brief dequeue the newest item, take from the tail
+ *
+ * @param[in] handle the queue handle
+ * @param[in] item the dequeue item buffer, NULL indicates discard the item
+ *
+ * @return OPRT_OK on success, others on failed, please refer to tuya_error_code.h
+ */
+OPERATE_RET tuya_queue_output_tail(TUYA_QUEUE_HANDLE handle, const void *item)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+
+    TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
+
+    if (queue->spsc) {
+        return OPRT_NOT_SUPPORTED; // the tail belongs to the producer
+    }
+
+    QUEUE_LOCK(queue);
+    if (queue->head != queue->tail) {
+        queue->tail = __queue_pos_add(queue, queue->tail, 2 * queue->queue_len - 1);
+        if (item) {
+            memcpy((void *)item, __queue_slot(queue, queue->tail), queue->item_size);
         }
-        tuya_list_del(&(queue_item->node));
-        tkl_system_free(queue_item);
-        queue->queue_free++;
     } else {
         op_ret = OPRT_NOT_FOUND;
     }
@@ -202,14 +304,17 @@ OPERATE_RET tuya_queue_peek(TUYA_QUEUE_HANDLE handle, const void *item)
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
 
-    QUEUE_LOCK(queue);
-    if (queue->queue_free < queue->queue_len) {
-        QUEUE_ITEM_T *queue_item = tuya_list_entry(queue->head.next, QUEUE_ITEM_T, node);
-        memcpy((void *)item, queue_item->data, queue->item_size);
+    if (!queue->spsc) {
+        QUEUE_LOCK(queue);
+    }
+    if (queue->head != QUEUE_LOAD(queue->tail)) {
+        memcpy((void *)item, __queue_slot(queue, queue->head), queue->item_size);
     } else {
         op_ret = OPRT_NOT_FOUND;
     }
-    QUEUE_UNLOCK(queue);
+    if (!queue->spsc) {
+        QUEUE_UNLOCK(queue);
+    }
 
     return op_ret;
 }
@@ -228,18 +333,21 @@ OPERATE_RET tuya_queue_traverse(TUYA_QUEUE_HANDLE handle, TRAVERSE_CB cb, void *
     }
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
-    struct tuya_list_head *p = NULL;
-    QUEUE_ITEM_T *queue_item = NULL;
+    uint32_t pos = 0;
+    uint32_t tail = 0;
 
-    QUEUE_LOCK(queue);
-    tuya_list_for_each(p, &(queue->head))
-    {
-        queue_item = tuya_list_entry(p, QUEUE_ITEM_T, node);
-        if (!cb(queue_item->data, ctx)) {
+    if (!queue->spsc) {
+        QUEUE_LOCK(queue);
+    }
+    tail = QUEUE_LOAD(queue->tail);
+    for (pos = queue->head; pos != tail; pos = __queue_pos_add(queue, pos, 1)) {
+        if (!cb(__queue_slot(queue, pos), ctx)) {
             break;
         }
     }
-    QUEUE_UNLOCK(queue);
+    if (!queue->spsc) {
+        QUEUE_UNLOCK(queue);
+    }
 
     return OPRT_OK;
 }
@@ -258,18 +366,14 @@ OPERATE_RET tuya_queue_clear(TUYA_QUEUE_HANDLE handle)
     }
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
-    struct tuya_list_head *p = NULL;
-    struct tuya_list_head *n = NULL;
-    QUEUE_ITEM_T *queue_item = NULL;
 
-    QUEUE_LOCK(queue);
-    tuya_list_for_each_safe(p, n, &(queue->head))
-    {
-        queue_item = tuya_list_entry(p, QUEUE_ITEM_T, node);
-        tuya_list_del(&queue_item->node);
-        tkl_system_free(queue_item);
+    if (queue->spsc) {
+        QUEUE_STORE(queue->head, QUEUE_LOAD(queue->tail));
+        return OPRT_OK;
     }
-    queue->queue_free = queue->queue_len;
+
+    QUEUE_LOCK(queue);
+    queue->head = queue->tail;
     QUEUE_UNLOCK(queue);
 
     return OPRT_OK;
@@ -292,34 +396,34 @@ OPERATE_RET tuya_queue_get_batch(TUYA_QUEUE_HANDLE handle, const uint32_t start,
     }
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
-    struct tuya_list_head *p = NULL;
-    QUEUE_ITEM_T *queue_item = NULL;
-    uint32_t index = 0;
-    uint32_t count = 0;
-
-    QUEUE_LOCK(queue);
-    tuya_list_for_each(p, &(queue->head))
-    {
-        if (index < start) {
-            index++;
-            continue;
-        }
+    OPERATE_RET op_ret = OPRT_OK;
+    uint32_t pos = 0;
 
-        if (count >= num) {
-            break;
+    if (!queue->spsc) {
+        QUEUE_LOCK(queue);
+    }
+    if (__queue_used(queue, queue->head, QUEUE_LOAD(queue->tail)) < start + (uint64_t)num) {
+        op_ret = OPRT_NOT_FOUND;
+    } else {
+        // at most two contiguous runs, before and after the end of the ring
+        pos = __queue_pos_add(queue, queue->head, start);
+        for (uint32_t count = 0; count < num;) {
+            uint32_t index = (pos < queue->queue_len) ? pos : pos - queue->queue_len;
+            uint32_t run = queue->queue_len - index;
+            if (run > num - count) {
+                run = num - count;
+            }
+            memcpy((uint8_t *)items + (size_t)count * queue->item_size, __queue_slot(queue, pos),
+                   (size_t)run * queue->item_size);
+            pos = __queue_pos_add(queue, pos, run);
+            count += run;
         }
-
-        queue_item = tuya_list_entry(p, QUEUE_ITEM_T, node);
-        memcpy((uint8_t *)items + count * queue->item_size, queue_item->data, queue->item_size);
-        count++;
     }
-    QUEUE_UNLOCK(queue);
-
-    if (index != start || count != num) {
-        return OPRT_NOT_FOUND;
+    if (!queue->spsc) {
+        QUEUE_UNLOCK(queue);
     }
 
-    return OPRT_OK;
+    return op_ret;
 }
 
 /**
@@ -333,14 +437,25 @@ OPERATE_RET tuya_queue_get_batch(TUYA_QUEUE_HANDLE handle, const uint32_t start,
 OPERATE_RET tuya_queue_delete_batch(TUYA_QUEUE_HANDLE handle, const uint32_t num)
 {
     OPERATE_RET op_ret = OPRT_OK;
-    uint32_t count = num;
+    uint32_t used = 0;
 
     if (NULL == handle || 0 == num) {
         return OPRT_INVALID_PARM;
     }
 
-    while ((count-- > 0) && (OPRT_OK == op_ret)) {
-        op_ret = tuya_queue_output(handle, NULL);
+    TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
+
+    if (!queue->spsc) {
+        QUEUE_LOCK(queue);
+    }
+    // delete what is there, as many as num, and report the shortfall like repeated dequeues would
+    used = __queue_used(queue, queue->head, QUEUE_LOAD(queue->tail));
+    if (used < num) {
+        op_ret = OPRT_NOT_FOUND;
+    }
+    QUEUE_STORE(queue->head, __queue_pos_add(queue, queue->head, (used < num) ? used : num));
+    if (!queue->spsc) {
+        QUEUE_UNLOCK(queue);
     }
 
     return op_ret;
@@ -361,7 +476,7 @@ uint32_t tuya_queue_get_free_num(TUYA_QUEUE_HANDLE handle)
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
 
-    return queue->queue_free;
+    return queue->queue_len - __queue_used(queue, QUEUE_LOAD(queue->head), QUEUE_LOAD(queue->tail));
 }
 
 /**
@@ -380,9 +495,13 @@ uint32_t tuya_queue_get_used_num(TUYA_QUEUE_HANDLE handle)
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
     uint32_t used_num = 0;
 
-    QUEUE_LOCK(queue);
-    used_num = queue->queue_len - queue->queue_free;
-    QUEUE_UNLOCK(queue);
+    if (!queue->spsc) {
+        QUEUE_LOCK(queue);
+    }
+    used_num = __queue_used(queue, QUEUE_LOAD(queue->head), QUEUE_LOAD(queue->tail));
+    if (!queue->spsc) {
+        QUEUE_UNLOCK(queue);
+    }
 
     return used_num;
 }
@@ -422,9 +541,9 @@ OPERATE_RET tuya_queue_release(TUYA_QUEUE_HANDLE handle)
 
     TUYA_QUEUE_T *queue = (TUYA_QUEUE_T *)handle;
 
-    tuya_queue_clear(handle);
-
-    op_ret = QUEUE_RELEASE_LOCK(queue);
+    if (!queue->spsc) {
+        op_ret = QUEUE_RELEASE_LOCK(queue);
+    }
     tkl_system_free(queue);
 
     return op_ret;